@@ -155,6 +155,20 @@ check_cxx_source_compiles("
 if(NOT MSVC)
   include(CheckSourceCompilesWithFlags)
 
+  # Check for SSE2 intrinsics.
+  set(SSE2_CXXFLAGS -msse2)
+  check_cxx_source_compiles_with_flags("
+    #include <immintrin.h>
+
+    int main()
+    {
+      __m128i l = _mm_set1_epi32(1);
+      return _mm_cvtsi128_si32(_mm_add_epi32(l, l));
+    }
+    " HAVE_SSE2
+    CXXFLAGS ${SSE2_CXXFLAGS}
+  )
+
   # Check for SSE4.1 intrinsics.
   set(SSE41_CXXFLAGS -msse4.1)
   check_cxx_source_compiles_with_flags("
@@ -185,6 +199,21 @@ if(NOT MSVC)
     CXXFLAGS ${AVX2_CXXFLAGS}
   )
 
+  # Check for AVX-512 intrinsics.
+  set(AVX512_CXXFLAGS -mavx -mavx2 -mavx512f)
+  check_cxx_source_compiles_with_flags("
+    #include <immintrin.h>
+
+    int main()
+    {
+      __m512i l = _mm512_set1_epi32(1);
+      __m512i r = _mm512_ternarylogic_epi32(l, _mm512_ror_epi32(l, 7), l, 0x96);
+      return _mm512_reduce_add_epi32(r);
+    }
+    " HAVE_AVX512
+    CXXFLAGS ${AVX512_CXXFLAGS}
+  )
+
   # Check for x86 SHA-NI intrinsics.
   set(X86_SHANI_CXXFLAGS -msse4 -msha)
   check_cxx_source_compiles_with_flags("
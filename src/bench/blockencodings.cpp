@@ -0,0 +1,76 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <blockencodings.h>
+#include <consensus/amount.h>
+#include <kernel/cs_main.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+#include <txmempool.h>
+#include <util/check.h>
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+static CTransactionRef MakeTx(FastRandomContext& rng)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = COutPoint{Txid::FromUint256(rng.rand256()), 0};
+    tx.vin[0].scriptSig = CScript() << OP_1;
+    tx.vin[0].scriptWitness.stack.push_back({1});
+    tx.vout.resize(1);
+    tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+    tx.vout[0].nValue = COIN;
+    return MakeTransactionRef(tx);
+}
+
+// Reconstruct a block of 2000 transactions from a compact block, with all of
+// them among the 20000 transactions in the mempool.
+static void BlockEncodingInitData(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>();
+    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
+    FastRandomContext rng{/*fDeterministic=*/true};
+
+    CBlock block;
+    block.vtx.push_back(MakeTx(rng));
+    {
+        LOCK2(cs_main, pool.cs);
+        for (int i = 0; i < 20000; ++i) {
+            const CTransactionRef tx{MakeTx(rng)};
+            AddToMempool(pool, CTxMemPoolEntry(tx, /*fee=*/1000, /*time=*/0, /*entry_height=*/1, /*entry_sequence=*/0, /*spends_coinbase=*/false, /*sigops_cost=*/4, LockPoints{}));
+            if (i % 10 == 0) block.vtx.push_back(tx);
+        }
+    }
+    const CBlockHeaderAndShortTxIDs cmpctblock{block, rng.rand64()};
+
+    bench.run([&] {
+        PartiallyDownloadedBlock partial_block{&pool};
+        const auto status{partial_block.InitData(cmpctblock, {})};
+        assert(status == READ_STATUS_OK);
+    });
+}
+
+static void BlockEncodingShortIDs(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CBlock block;
+    for (int i = 0; i < 2000; ++i) block.vtx.push_back(MakeTx(rng));
+
+    bench.batch(block.vtx.size()).unit("tx").run([&] {
+        const CBlockHeaderAndShortTxIDs cmpctblock{block, rng.rand64()};
+        ankerl::nanobench::doNotOptimizeAway(cmpctblock.BlockTxCount());
+    });
+}
+
+BENCHMARK(BlockEncodingInitData, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockEncodingShortIDs, benchmark::PriorityLevel::HIGH);
@@ -7,6 +7,7 @@
 #include <crypto/chacha20.h>
 #include <crypto/chacha20poly1305.h>
 #include <span.h>
+#include <tinyformat.h>
 
 #include <cstddef>
 #include <cstdint>
@@ -56,6 +57,34 @@ static void CHACHA20_1MB(benchmark::Bench& bench)
     CHACHA20(bench, BUFFER_SIZE_LARGE);
 }
 
+static void CHACHA20_1MB_STANDARD(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' ChaCha20 implementation", __func__, ChaCha20AutoDetect(chacha20_implementation::STANDARD)));
+    CHACHA20(bench, BUFFER_SIZE_LARGE);
+    ChaCha20AutoDetect();
+}
+
+static void CHACHA20_1MB_SSE2(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' ChaCha20 implementation", __func__, ChaCha20AutoDetect(chacha20_implementation::USE_SSE2)));
+    CHACHA20(bench, BUFFER_SIZE_LARGE);
+    ChaCha20AutoDetect();
+}
+
+static void CHACHA20_1MB_AVX2(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' ChaCha20 implementation", __func__, ChaCha20AutoDetect(chacha20_implementation::USE_SSE2_AND_AVX2)));
+    CHACHA20(bench, BUFFER_SIZE_LARGE);
+    ChaCha20AutoDetect();
+}
+
+static void CHACHA20_1MB_AVX512(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' ChaCha20 implementation", __func__, ChaCha20AutoDetect(chacha20_implementation::USE_ALL)));
+    CHACHA20(bench, BUFFER_SIZE_LARGE);
+    ChaCha20AutoDetect();
+}
+
 static void FSCHACHA20POLY1305_64BYTES(benchmark::Bench& bench)
 {
     FSCHACHA20POLY1305(bench, BUFFER_SIZE_TINY);
@@ -74,6 +103,10 @@ static void FSCHACHA20POLY1305_1MB(benchmark::Bench& bench)
 BENCHMARK(CHACHA20_64BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(CHACHA20_256BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(CHACHA20_1MB, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CHACHA20_1MB_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CHACHA20_1MB_SSE2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CHACHA20_1MB_AVX2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CHACHA20_1MB_AVX512, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FSCHACHA20POLY1305_64BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FSCHACHA20POLY1305_256BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FSCHACHA20POLY1305_1MB, benchmark::PriorityLevel::HIGH);
@@ -39,6 +39,20 @@ static void DeserializeBlockTest(benchmark::Bench& bench)
     });
 }
 
+static void DeserializeBlockArenaTest(benchmark::Bench& bench)
+{
+    DataStream stream(benchmark::data::block413567);
+    std::byte a{0};
+    stream.write({&a, 1}); // Prevent compaction
+
+    bench.unit("block").run([&] {
+        CBlock block;
+        stream >> TX_WITH_WITNESS(Using<BlockArenaFormatter>(block));
+        bool rewound = stream.Rewind(benchmark::data::block413567.size());
+        assert(rewound);
+    });
+}
+
 static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
 {
     DataStream stream(benchmark::data::block413567);
@@ -60,5 +74,28 @@ static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
     });
 }
 
+static void DeserializeArenaAndCheckBlockTest(benchmark::Bench& bench)
+{
+    DataStream stream(benchmark::data::block413567);
+    std::byte a{0};
+    stream.write({&a, 1}); // Prevent compaction
+
+    ArgsManager bench_args;
+    const auto chainParams = CreateChainParams(bench_args, ChainType::MAIN);
+
+    bench.unit("block").run([&] {
+        CBlock block; // Note that CBlock caches its checked state, so we need to recreate it here
+        stream >> TX_WITH_WITNESS(Using<BlockArenaFormatter>(block));
+        bool rewound = stream.Rewind(benchmark::data::block413567.size());
+        assert(rewound);
+
+        BlockValidationState validationState;
+        bool checked = CheckBlock(block, validationState, chainParams->GetConsensus());
+        assert(checked);
+    });
+}
+
 BENCHMARK(DeserializeBlockTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeBlockArenaTest, benchmark::PriorityLevel::HIGH);
 BENCHMARK(DeserializeAndCheckBlockTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeArenaAndCheckBlockTest, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,47 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <coins.h>
+#include <dbwrapper.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <txdb.h>
+#include <util/fs.h>
+
+#include <cassert>
+
+// Flush several large coins caches to a fresh chainstate database in a row.
+// Each flush has to wait for the compactions triggered by the previous ones,
+// so the time taken depends on how fast LevelDB compacts.
+static void CoinsFlush(benchmark::Bench& bench, int compaction_threads)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const CScript script{CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 0x42) << OP_EQUALVERIFY << OP_CHECKSIG};
+
+    bench.epochIterations(1).run([&] {
+        CCoinsViewDB db{{.path = testing_setup->m_args.GetDataDirNet() / "coins_flush",
+                         .cache_bytes = 8 << 20,
+                         .wipe_data = true,
+                         .options = {.compaction_threads = compaction_threads}},
+                        CoinsViewOptions{}};
+        for (int flush{0}; flush < 8; ++flush) {
+            CCoinsViewCache cache{&db};
+            for (int i{0}; i < 100'000; ++i) {
+                cache.AddCoin(COutPoint{Txid::FromUint256(rng.rand256()), 0}, Coin{CTxOut{1000, script}, flush + 1, false}, false);
+            }
+            const bool success{cache.Flush()};
+            assert(success);
+        }
+    });
+}
+
+static void CoinsFlushSingleThreadedCompaction(benchmark::Bench& bench) { CoinsFlush(bench, 1); }
+static void CoinsFlushMultiThreadedCompaction(benchmark::Bench& bench) { CoinsFlush(bench, 4); }
+
+BENCHMARK(CoinsFlushSingleThreadedCompaction, benchmark::PriorityLevel::LOW);
+BENCHMARK(CoinsFlushMultiThreadedCompaction, benchmark::PriorityLevel::LOW);
@@ -11,6 +11,7 @@
 #include <crypto/sha3.h>
 #include <crypto/sha512.h>
 #include <crypto/siphash.h>
+#include <hash.h>
 #include <random.h>
 #include <span.h>
 #include <tinyformat.h>
@@ -181,6 +182,16 @@ static void SHA256D64_1024_SHANI(benchmark::Bench& bench)
     SHA256AutoDetect();
 }
 
+static void SHA256D64_1024_AVX512(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AND_AVX2_AND_AVX512)));
+    std::vector<uint8_t> in(64 * 1024, 0);
+    bench.batch(in.size()).unit("byte").run([&] {
+        SHA256D64(in.data(), in.data(), 1024);
+    });
+    SHA256AutoDetect();
+}
+
 static void SHA512(benchmark::Bench& bench)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -205,6 +216,47 @@ static void SipHash_32b(benchmark::Bench& bench)
     });
 }
 
+static void SipHash_32b_Batch(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    auto k0{rng.rand64()}, k1{rng.rand64()};
+    std::vector<uint256> vals(1024);
+    for (auto& val : vals) val = rng.rand256();
+    std::vector<const uint256*> ptrs;
+    for (const auto& val : vals) ptrs.push_back(&val);
+    std::vector<uint64_t> out(vals.size());
+    bench.batch(vals.size()).unit("hash").run([&] {
+        SipHashUint256Batch(k0, k1, ptrs, out);
+        ankerl::nanobench::doNotOptimizeAway(out);
+        ++k0;
+    });
+}
+
+static void HASH160_33b(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<std::vector<unsigned char>> keys;
+    for (int i = 0; i < 1024; ++i) keys.push_back(rng.randbytes(33));
+    std::vector<uint160> out(keys.size());
+    bench.batch(keys.size()).unit("hash").run([&] {
+        for (size_t i = 0; i < keys.size(); ++i) out[i] = Hash160(keys[i]);
+        ankerl::nanobench::doNotOptimizeAway(out);
+    });
+}
+
+static void HASH160_33b_Batch(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<std::vector<unsigned char>> keys;
+    for (int i = 0; i < 1024; ++i) keys.push_back(rng.randbytes(33));
+    std::vector<std::span<const unsigned char>> in(keys.begin(), keys.end());
+    std::vector<uint160> out(keys.size());
+    bench.batch(keys.size()).unit("hash").run([&] {
+        Hash160Batch(in, out);
+        ankerl::nanobench::doNotOptimizeAway(out);
+    });
+}
+
 static void MuHash(benchmark::Bench& bench)
 {
     MuHash3072 acc;
@@ -276,10 +328,14 @@ BENCHMARK(SHA256_32b_SSE4, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_32b_AVX2, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_32b_SHANI, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SipHash_32b, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SipHash_32b_Batch, benchmark::PriorityLevel::HIGH);
+BENCHMARK(HASH160_33b, benchmark::PriorityLevel::HIGH);
+BENCHMARK(HASH160_33b_Batch, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_STANDARD, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_SSE4, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_AVX2, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_SHANI, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256D64_1024_AVX512, benchmark::PriorityLevel::HIGH);
 
 BENCHMARK(MuHash, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashMul, benchmark::PriorityLevel::HIGH);
@@ -2,8 +2,11 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <addresstype.h>
 #include <bench/bench.h>
 #include <consensus/amount.h>
+#include <key.h>
+#include <node/mempool_persist.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <random.h>
@@ -14,6 +17,7 @@
 #include <txmempool.h>
 #include <validation.h>
 
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -126,5 +130,113 @@ static void MempoolCheck(benchmark::Bench& bench)
     });
 }
 
+/** Fan a mature coinbase out into num_outputs outputs of 9 CENT to spk, and confirm it. */
+static CTransactionRef CreateConfirmedFanout(TestChain100Setup& testing_setup, size_t num_outputs, const CScript& spk)
+{
+    const CTransactionRef& coinbase{testing_setup.m_coinbase_txns[0]};
+    const std::vector<CTxOut> outputs(num_outputs, CTxOut{9 * CENT, spk});
+    const auto fanout{MakeTransactionRef(testing_setup.CreateValidMempoolTransaction(
+        {coinbase}, {COutPoint{coinbase->GetHash(), 0}}, /*input_height=*/1, {testing_setup.coinbaseKey}, outputs, /*submit=*/false))};
+    testing_setup.CreateAndProcessBlock({CMutableTransaction{*fanout}}, spk);
+    return fanout;
+}
+
+static void MempoolAccept(benchmark::Bench& bench, bool batch)
+{
+    constexpr size_t NUM_TXS{500};
+    const auto testing_setup{MakeNoLogFileContext<TestChain100Setup>(ChainType::REGTEST)};
+    Chainstate& chainstate{testing_setup->m_node.chainman->ActiveChainstate()};
+    const CScript spk{GetScriptForDestination(PKHash(testing_setup->coinbaseKey.GetPubKey()))};
+    const auto fanout{CreateConfirmedFanout(*testing_setup, NUM_TXS, spk)};
+
+    std::vector<CTransactionRef> txs;
+    for (uint32_t n = 0; n < NUM_TXS; ++n) {
+        txs.push_back(MakeTransactionRef(testing_setup->CreateValidMempoolTransaction(
+            fanout, n, /*input_height=*/101, testing_setup->coinbaseKey, spk, 8 * CENT, /*submit=*/false)));
+    }
+
+    // Signatures are cached once verified, so only the first run is meaningful.
+    bench.epochs(1).epochIterations(1).run([&] {
+        LOCK(cs_main);
+        if (batch) {
+            for (const auto& result : AcceptToMemoryPoolBatch(chainstate, txs, GetTime(), /*bypass_limits=*/false, /*test_accept=*/false)) {
+                assert(result.m_result_type == MempoolAcceptResult::ResultType::VALID);
+            }
+        } else {
+            for (const auto& tx : txs) {
+                const auto result{AcceptToMemoryPool(chainstate, tx, GetTime(), /*bypass_limits=*/false, /*test_accept=*/false)};
+                assert(result.m_result_type == MempoolAcceptResult::ResultType::VALID);
+            }
+        }
+    });
+}
+
+static void MempoolLoadColdCache(benchmark::Bench& bench)
+{
+    constexpr size_t NUM_TXS{500};
+    const auto testing_setup{MakeNoLogFileContext<TestChain100Setup>(ChainType::REGTEST)};
+    Chainstate& chainstate{testing_setup->m_node.chainman->ActiveChainstate()};
+    CTxMemPool& pool{*testing_setup->m_node.mempool};
+    const CScript spk{GetScriptForDestination(PKHash(testing_setup->coinbaseKey.GetPubKey()))};
+    const auto fanout{CreateConfirmedFanout(*testing_setup, NUM_TXS, spk)};
+    const fs::path path{testing_setup->m_args.GetDataDirBase() / "mempool.dat"};
+
+    // Write a mempool.dat without validating its transactions, so that none of
+    // their signatures are cached.
+    std::vector<CTransactionRef> txs;
+    {
+        TestMemPoolEntryHelper entry;
+        LOCK2(cs_main, pool.cs);
+        for (uint32_t n = 0; n < NUM_TXS; ++n) {
+            txs.push_back(MakeTransactionRef(testing_setup->CreateValidMempoolTransaction(
+                fanout, n, /*input_height=*/101, testing_setup->coinbaseKey, spk, 8 * CENT, /*submit=*/false)));
+            AddToMempool(pool, entry.Fee(CENT).FromTx(txs.back()));
+        }
+    }
+    assert(node::DumpMempool(pool, path));
+    {
+        LOCK2(cs_main, pool.cs);
+        for (const auto& tx : txs) pool.removeRecursive(*tx, MemPoolRemovalReason::REPLACED);
+        // As after a restart, none of the spent coins are in the coins cache.
+        assert(chainstate.CoinsTip().Flush());
+    }
+
+    // Signatures are cached once verified, so only the first run is meaningful.
+    bench.epochs(1).epochIterations(1).run([&] {
+        assert(node::LoadMempool(pool, path, chainstate, {.use_current_time = true}));
+        assert(WITH_LOCK(pool.cs, return pool.size()) == NUM_TXS);
+    });
+}
+
+static void MempoolAcceptSequential(benchmark::Bench& bench) { MempoolAccept(bench, /*batch=*/false); }
+static void MempoolAcceptBatch(benchmark::Bench& bench) { MempoolAccept(bench, /*batch=*/true); }
+
+static void MempoolAcceptManyInputs(benchmark::Bench& bench)
+{
+    constexpr size_t NUM_INPUTS{500};
+    const auto testing_setup{MakeNoLogFileContext<TestChain100Setup>(ChainType::REGTEST)};
+    Chainstate& chainstate{testing_setup->m_node.chainman->ActiveChainstate()};
+    const CScript spk{GetScriptForDestination(PKHash(testing_setup->coinbaseKey.GetPubKey()))};
+    const auto fanout{CreateConfirmedFanout(*testing_setup, NUM_INPUTS, spk)};
+
+    // Consolidate all outputs of the fanout into one.
+    std::vector<COutPoint> inputs;
+    for (uint32_t n = 0; n < NUM_INPUTS; ++n) inputs.emplace_back(fanout->GetHash(), n);
+    const std::vector<CKey> keys(NUM_INPUTS, testing_setup->coinbaseKey);
+    const auto tx{MakeTransactionRef(testing_setup->CreateValidMempoolTransaction(
+        {fanout}, inputs, /*input_height=*/101, keys, {CTxOut{NUM_INPUTS * 8 * CENT, spk}}, /*submit=*/false))};
+
+    // Signatures are cached once verified, so only the first run is meaningful.
+    bench.epochs(1).epochIterations(1).run([&] {
+        LOCK(cs_main);
+        const auto result{AcceptToMemoryPool(chainstate, tx, GetTime(), /*bypass_limits=*/false, /*test_accept=*/false)};
+        assert(result.m_result_type == MempoolAcceptResult::ResultType::VALID);
+    });
+}
+
 BENCHMARK(ComplexMemPool, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolAcceptBatch, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolAcceptManyInputs, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolAcceptSequential, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MempoolCheck, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolLoadColdCache, benchmark::PriorityLevel::HIGH);
@@ -24,4 +24,21 @@ static void MerkleRoot(benchmark::Bench& bench)
     });
 }
 
+static void MerkleTreeUpdateCoinbase(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    std::vector<uint256> leaves;
+    leaves.resize(9001);
+    for (auto& item : leaves) {
+        item = rng.rand256();
+    }
+    MerkleTree tree{std::move(leaves)};
+    bench.run([&] {
+        // Replacing the coinbase only rehashes its path to the root.
+        tree.Update(0, tree.Root());
+        ankerl::nanobench::doNotOptimizeAway(tree.Root());
+    });
+}
+
 BENCHMARK(MerkleRoot, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MerkleTreeUpdateCoinbase, benchmark::PriorityLevel::HIGH);
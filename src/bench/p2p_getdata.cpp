@@ -0,0 +1,92 @@
+// Copyright (c) The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <net.h>
+#include <net_processing.h>
+#include <netmessagemaker.h>
+#include <node/connection_types.h>
+#include <node/context.h>
+#include <protocol.h>
+#include <sync.h>
+#include <test/util/net.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/** Serve getdata requests for the whole test chain to num_peers peers, with the peers spread over num_threads
+ *  message handler threads like CConnman does. */
+static void GetDataBlocks(benchmark::Bench& bench, int num_peers, int num_threads)
+{
+    const auto testing_setup = MakeNoLogFileContext<const TestChain100Setup>();
+    auto& node{testing_setup->m_node};
+    auto& connman{static_cast<ConnmanTestMsg&>(*node.connman)};
+    const auto peerman{PeerManager::make(connman, *node.addrman, /*banman=*/nullptr, *node.chainman, *node.mempool,
+                                         *node.warnings, {.deterministic_rng = true, .serve_blocks_concurrently = true})};
+    connman.SetMsgProc(peerman.get());
+
+    std::vector<CInv> invs;
+    {
+        LOCK(cs_main);
+        for (const CBlockIndex* index{node.chainman->ActiveChain().Tip()}; index; index = index->pprev) {
+            invs.emplace_back(MSG_WITNESS_BLOCK, index->GetBlockHash());
+        }
+    }
+
+    std::vector<std::unique_ptr<CNode>> peers;
+    for (NodeId id{0}; id < num_peers; ++id) {
+        peers.push_back(std::make_unique<CNode>(id,
+                                                /*sock=*/nullptr,
+                                                CAddress{},
+                                                /*nKeyedNetGroupIn=*/0,
+                                                /*nLocalHostNonceIn=*/0,
+                                                CAddress{},
+                                                /*addrNameIn=*/"",
+                                                ConnectionType::INBOUND,
+                                                /*inbound_onion=*/false));
+        LOCK(NetEventsInterface::g_msgproc_mutex);
+        connman.Handshake(*peers.back(),
+                          /*successfully_connected=*/true,
+                          /*remote_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                          /*local_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                          /*version=*/PROTOCOL_VERSION,
+                          /*relay_txs=*/false);
+    }
+
+    bench.batch(peers.size() * invs.size()).unit("block").run([&] {
+        for (const auto& peer : peers) {
+            (void)connman.ReceiveMsgFrom(*peer, NetMsg::Make(NetMsgType::GETDATA, invs));
+        }
+        std::vector<std::thread> threads;
+        for (int worker{0}; worker < num_threads; ++worker) {
+            threads.emplace_back([&, worker] {
+                for (const auto& peer : peers) {
+                    if (peer->GetId() % num_threads != worker) continue;
+                    bool more_work{true};
+                    while (more_work) {
+                        more_work = WITH_LOCK(NetEventsInterface::g_msgproc_mutex, return connman.ProcessMessagesOnce(*peer));
+                        more_work |= connman.ServeRequestsOnce(*peer);
+                        connman.FlushSendBuffer(*peer);
+                        peer->fPauseSend = false;
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+    });
+
+    for (const auto& peer : peers) peerman->FinalizeNode(*peer);
+    connman.SetMsgProc(node.peerman.get());
+}
+
+static void GetDataBlocks1Thread(benchmark::Bench& bench) { GetDataBlocks(bench, 8, 1); }
+static void GetDataBlocks4Threads(benchmark::Bench& bench) { GetDataBlocks(bench, 8, 4); }
+
+BENCHMARK(GetDataBlocks1Thread, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GetDataBlocks4Threads, benchmark::PriorityLevel::HIGH);
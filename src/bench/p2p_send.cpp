@@ -0,0 +1,97 @@
+// Copyright (c) The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <compat/compat.h>
+#include <net.h>
+#include <node/connection_types.h>
+#include <node/context.h>
+#include <protocol.h>
+#include <sync.h>
+#include <test/util/net.h>
+#include <test/util/setup_common.h>
+#include <util/check.h>
+#include <util/sock.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#ifndef WIN32 // Windows does not have socketpair(2).
+
+/** Exchange the handshake of two v2 transports until both are ready to send messages. */
+static void V2Handshake(Transport& a, Transport& b)
+{
+    while (a.GetInfo().transport_type != TransportProtocolType::V2 || b.GetInfo().transport_type != TransportProtocolType::V2) {
+        bool progress{false};
+        for (auto [from, to] : {std::pair{&a, &b}, std::pair{&b, &a}}) {
+            const auto& [to_send, _more, _msg_type] = from->GetBytesToSend(/*have_next_message=*/false);
+            const size_t size{to_send.size()};
+            std::span<const uint8_t> bytes{to_send};
+            while (!bytes.empty()) Assert(to->ReceivedBytes(bytes));
+            from->MarkBytesSent(size);
+            progress |= size > 0;
+        }
+        Assert(progress);
+    }
+}
+
+/** Send num_msgs messages of msg_size bytes each to a peer over a local socket, like CConnman does when
+ *  they were all queued while the socket was not writable. */
+static void P2PSend(benchmark::Bench& bench, bool use_v2transport, size_t num_msgs, size_t msg_size)
+{
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>();
+    auto& connman{static_cast<ConnmanTestMsg&>(*testing_setup->m_node.connman)};
+
+    int s[2];
+    Assert(socketpair(AF_UNIX, SOCK_STREAM, 0, s) == 0);
+    const Sock receiver(s[1]);
+    Assert(receiver.SetNonBlocking());
+    CNode node{/*id=*/0,
+               std::make_shared<Sock>(s[0]),
+               CAddress{},
+               /*nKeyedNetGroupIn=*/0,
+               /*nLocalHostNonceIn=*/0,
+               CAddress{},
+               /*addrNameIn=*/"",
+               ConnectionType::INBOUND,
+               /*inbound_onion=*/false,
+               CNodeOptions{.use_v2transport = use_v2transport}};
+    if (use_v2transport) {
+        V2Transport peer{/*nodeid=*/1, /*initiating=*/true};
+        V2Handshake(peer, *node.m_transport);
+    }
+
+    std::vector<uint8_t> buf(64 * 1024);
+    bench.batch(num_msgs * msg_size).unit("byte").run([&] {
+        LOCK(node.cs_vSend);
+        for (size_t i{0}; i < num_msgs; ++i) {
+            CSerializedNetMsg msg;
+            msg.m_type = NetMsgType::INV;
+            msg.data.resize(msg_size);
+            node.m_send_memusage += msg.GetMemoryUsage();
+            node.vSendMsg.push_back(std::move(msg));
+        }
+        while (true) {
+            const auto [_bytes_sent, data_left] = connman.SocketSendDataPublic(node);
+            while (receiver.Recv(buf.data(), buf.size(), MSG_DONTWAIT) > 0) {}
+            if (!data_left && node.vSendMsg.empty()) break;
+        }
+    });
+}
+
+static void P2PSendSmallV1(benchmark::Bench& bench) { P2PSend(bench, /*use_v2transport=*/false, 1000, 37); }
+static void P2PSendSmallV2(benchmark::Bench& bench) { P2PSend(bench, /*use_v2transport=*/true, 1000, 37); }
+static void P2PSendLargeV1(benchmark::Bench& bench) { P2PSend(bench, /*use_v2transport=*/false, 10, 100'000); }
+static void P2PSendLargeV2(benchmark::Bench& bench) { P2PSend(bench, /*use_v2transport=*/true, 10, 100'000); }
+
+BENCHMARK(P2PSendSmallV1, benchmark::PriorityLevel::HIGH);
+BENCHMARK(P2PSendSmallV2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(P2PSendLargeV1, benchmark::PriorityLevel::HIGH);
+BENCHMARK(P2PSendLargeV2, benchmark::PriorityLevel::HIGH);
+
+#endif // WIN32
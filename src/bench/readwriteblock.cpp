@@ -38,18 +38,22 @@ static void WriteBlockBench(benchmark::Bench& bench)
     });
 }
 
-static void ReadBlockBench(benchmark::Bench& bench)
+static void ReadBlock(benchmark::Bench& bench, bool use_arena)
 {
     const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
     auto& blockman{testing_setup->m_node.chainman->m_blockman};
     const auto pos{blockman.WriteBlock(CreateTestBlock(), 413'567)};
     CBlock block;
     bench.run([&] {
-        const auto success{blockman.ReadBlock(block, pos)};
+        // Reading into the same block also releases the transactions of the previous iteration.
+        const auto success{blockman.ReadBlock(block, pos, use_arena)};
         assert(success);
     });
 }
 
+static void ReadBlockBench(benchmark::Bench& bench) { ReadBlock(bench, /*use_arena=*/false); }
+static void ReadBlockArenaBench(benchmark::Bench& bench) { ReadBlock(bench, /*use_arena=*/true); }
+
 static void ReadRawBlockBench(benchmark::Bench& bench)
 {
     const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
@@ -63,6 +67,68 @@ static void ReadRawBlockBench(benchmark::Bench& bench)
     });
 }
 
+static void WriteBlockCompressedBench(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN, {.extra_args = {"-blockcompression"}})};
+    auto& blockman{testing_setup->m_node.chainman->m_blockman};
+    const CBlock block{CreateTestBlock()};
+    bench.run([&] {
+        const auto pos{blockman.WriteBlock(block, 413'567)};
+        assert(!pos.IsNull());
+    });
+}
+
+static void ReadBlockCompressedBench(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN, {.extra_args = {"-blockcompression"}})};
+    auto& blockman{testing_setup->m_node.chainman->m_blockman};
+    const auto pos{blockman.WriteBlock(CreateTestBlock(), 413'567)};
+    CBlock block;
+    bench.run([&] {
+        const auto success{blockman.ReadBlock(block, pos)};
+        assert(success);
+    });
+}
+
+static void ReadRawBlockCompressedBench(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN, {.extra_args = {"-blockcompression"}})};
+    auto& blockman{testing_setup->m_node.chainman->m_blockman};
+    const auto pos{blockman.WriteBlock(CreateTestBlock(), 413'567)};
+    std::vector<uint8_t> block_data;
+    blockman.ReadRawBlock(block_data, pos); // warmup
+    bench.batch(block_data.size()).unit("byte").run([&] {
+        const auto success{blockman.ReadRawBlock(block_data, pos)};
+        assert(success);
+    });
+}
+
+static void CompressBlockBench(benchmark::Bench& bench)
+{
+    const auto block_data{MakeUCharSpan(benchmark::data::block413567)};
+    std::vector<uint8_t> compressed;
+    bench.batch(block_data.size()).unit("byte").run([&] {
+        compressed = node::CompressBlockData(block_data);
+    });
+    assert(compressed.size() < block_data.size());
+}
+
+static void DecompressBlockBench(benchmark::Bench& bench)
+{
+    const auto compressed{node::CompressBlockData(MakeUCharSpan(benchmark::data::block413567))};
+    std::vector<uint8_t> block_data;
+    bench.batch(benchmark::data::block413567.size()).unit("byte").run([&] {
+        const auto success{node::DecompressBlockData(compressed, block_data)};
+        assert(success);
+    });
+}
+
 BENCHMARK(WriteBlockBench, benchmark::PriorityLevel::HIGH);
 BENCHMARK(ReadBlockBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReadBlockArenaBench, benchmark::PriorityLevel::HIGH);
 BENCHMARK(ReadRawBlockBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(WriteBlockCompressedBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReadBlockCompressedBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReadRawBlockCompressedBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CompressBlockBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DecompressBlockBench, benchmark::PriorityLevel::HIGH);
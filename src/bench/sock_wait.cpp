@@ -0,0 +1,105 @@
+// Copyright (c) The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <compat/compat.h>
+#include <random.h>
+#include <util/check.h>
+#include <util/fs_helpers.h>
+#include <util/sock.h>
+#include <util/sockepoll.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#ifndef WIN32 // Windows does not have socketpair(2).
+
+using namespace std::chrono_literals;
+
+/** Number of in-process connections, most of which stay idle. */
+static constexpr int NUM_SOCKS{2000};
+/** Number of connections that receive a byte in each iteration. */
+static constexpr int NUM_ACTIVE{20};
+
+struct SockPairs {
+    std::vector<std::shared_ptr<const Sock>> senders;
+    std::vector<std::shared_ptr<const Sock>> receivers;
+
+    SockPairs()
+    {
+        // Two descriptors per pair, plus some slack. Use fewer pairs if the limit cannot be raised.
+        const int num{std::min(NUM_SOCKS, (RaiseFileDescriptorLimit(2 * NUM_SOCKS + 64) - 64) / 2)};
+        for (int i{0}; i < num; ++i) {
+            int s[2];
+            Assert(socketpair(AF_UNIX, SOCK_STREAM, 0, s) == 0);
+            senders.push_back(std::make_shared<const Sock>(s[0]));
+            receivers.push_back(std::make_shared<const Sock>(s[1]));
+            Assert(receivers.back()->SetNonBlocking());
+        }
+    }
+
+    /** Make NUM_ACTIVE random receivers readable. */
+    void Activate(FastRandomContext& rng) const
+    {
+        for (int i{0}; i < NUM_ACTIVE; ++i) {
+            Assert(senders[rng.randrange(senders.size())]->Send("x", 1, 0) == 1);
+        }
+    }
+};
+
+/** Drain a receiver. */
+static void Consume(const Sock& sock)
+{
+    char buf[64];
+    while (sock.Recv(buf, sizeof(buf), MSG_DONTWAIT) > 0) {}
+}
+
+/** Like CConnman::SocketHandler() with poll: pass all sockets to the kernel in every round. */
+static void SockWaitManyPoll(benchmark::Bench& bench)
+{
+    const SockPairs pairs;
+    FastRandomContext rng{/*fDeterministic=*/true};
+    bench.run([&] {
+        pairs.Activate(rng);
+        Sock::EventsPerSock events_per_sock;
+        for (const auto& sock : pairs.receivers) {
+            events_per_sock.emplace(sock, Sock::Events{Sock::RECV});
+        }
+        Assert(pairs.receivers[0]->WaitMany(0ms, events_per_sock));
+        for (const auto& [sock, events] : events_per_sock) {
+            if (events.occurred & Sock::RECV) Consume(*sock);
+        }
+    });
+}
+
+#ifdef USE_EPOLL
+/** Like CConnman::SocketHandlerEpoll(): only the active sockets are returned. */
+static void SockWaitEpoll(benchmark::Bench& bench)
+{
+    const SockPairs pairs;
+    const auto epoll{SockEpoll::Create()};
+    Assert(epoll);
+    for (size_t i{0}; i < pairs.receivers.size(); ++i) {
+        Assert(epoll->Add(*pairs.receivers[i], i, Sock::RECV, /*edge_triggered=*/true));
+    }
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<SockEpoll::Ready> ready;
+    bench.run([&] {
+        pairs.Activate(rng);
+        Assert(epoll->Wait(0ms, ready));
+        for (const auto& [token, occurred] : ready) {
+            if (occurred & Sock::RECV) Consume(*pairs.receivers[token]);
+        }
+    });
+}
+
+BENCHMARK(SockWaitEpoll, benchmark::PriorityLevel::HIGH);
+#endif // USE_EPOLL
+
+BENCHMARK(SockWaitManyPoll, benchmark::PriorityLevel::HIGH);
+
+#endif // WIN32
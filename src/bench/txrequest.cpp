@@ -0,0 +1,57 @@
+// Copyright (c) The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <net.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <txrequest.h>
+#include <uint256.h>
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/** Simulate num_txs transactions being announced by each of num_peers peers (the first 8 of which are preferred,
+ *  the others delayed), and then downloaded: every 100ms all peers are asked for what to request, and each request
+ *  is answered with probability 1/2 or times out after 1s otherwise. */
+static void TxRequestCommon(benchmark::Bench& bench, int num_peers, int num_txs)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<uint256> txhashes(num_txs);
+    for (auto& txhash : txhashes) txhash = rng.rand256();
+
+    bench.batch(size_t(num_peers) * num_txs).unit("announcement").run([&] {
+        TxRequestTracker tracker{/*deterministic=*/true};
+        std::chrono::microseconds now{1s};
+        for (const uint256& txhash : txhashes) {
+            for (NodeId peer = 0; peer < num_peers; ++peer) {
+                const bool preferred{peer < 8};
+                tracker.ReceivedInv(peer, GenTxid::Wtxid(txhash), preferred, preferred ? now : now + 2s);
+            }
+        }
+        while (tracker.Size() > 0) {
+            for (NodeId peer = 0; peer < num_peers; ++peer) {
+                for (const GenTxid& gtxid : tracker.GetRequestable(peer, now)) {
+                    tracker.RequestedTx(peer, gtxid.GetHash(), now + 1s);
+                    if (rng.randbool()) {
+                        tracker.ReceivedResponse(peer, gtxid.GetHash());
+                        tracker.ForgetTxHash(gtxid.GetHash());
+                    }
+                }
+            }
+            now += 100ms;
+        }
+    });
+}
+
+static void TxRequest16Peers(benchmark::Bench& bench) { TxRequestCommon(bench, 16, 1000); }
+static void TxRequest128Peers(benchmark::Bench& bench) { TxRequestCommon(bench, 128, 1000); }
+static void TxRequest512Peers(benchmark::Bench& bench) { TxRequestCommon(bench, 512, 200); }
+
+BENCHMARK(TxRequest16Peers, benchmark::PriorityLevel::HIGH);
+BENCHMARK(TxRequest128Peers, benchmark::PriorityLevel::HIGH);
+BENCHMARK(TxRequest512Peers, benchmark::PriorityLevel::HIGH);
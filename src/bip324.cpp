@@ -72,18 +72,27 @@ void BIP324Cipher::Initialize(const EllSwiftPubKey& their_pubkey, bool initiator
 
 void BIP324Cipher::Encrypt(std::span<const std::byte> contents, std::span<const std::byte> aad, bool ignore, std::span<std::byte> output) noexcept
 {
-    assert(output.size() == contents.size() + EXPANSION);
+    Encrypt({}, contents, aad, ignore, output);
+}
+
+void BIP324Cipher::Encrypt(std::span<const std::byte> prefix, std::span<const std::byte> contents, std::span<const std::byte> aad, bool ignore, std::span<std::byte> output) noexcept
+{
+    assert(prefix.size() <= MAX_PREFIX_LEN);
+    const size_t contents_size{prefix.size() + contents.size()};
+    assert(output.size() == contents_size + EXPANSION);
 
     // Encrypt length.
     std::byte len[LENGTH_LEN];
-    len[0] = std::byte{(uint8_t)(contents.size() & 0xFF)};
-    len[1] = std::byte{(uint8_t)((contents.size() >> 8) & 0xFF)};
-    len[2] = std::byte{(uint8_t)((contents.size() >> 16) & 0xFF)};
+    len[0] = std::byte{(uint8_t)(contents_size & 0xFF)};
+    len[1] = std::byte{(uint8_t)((contents_size >> 8) & 0xFF)};
+    len[2] = std::byte{(uint8_t)((contents_size >> 16) & 0xFF)};
     m_send_l_cipher->Crypt(len, output.first(LENGTH_LEN));
 
-    // Encrypt plaintext.
-    std::byte header[HEADER_LEN] = {ignore ? IGNORE_BIT : std::byte{0}};
-    m_send_p_cipher->Encrypt(header, contents, aad, output.subspan(LENGTH_LEN));
+    // Encrypt plaintext. The header and the (short) prefix are concatenated on the stack, so
+    // that the contents are encrypted straight from the caller's buffer.
+    std::byte header[HEADER_LEN + MAX_PREFIX_LEN] = {ignore ? IGNORE_BIT : std::byte{0}};
+    std::copy(prefix.begin(), prefix.end(), header + HEADER_LEN);
+    m_send_p_cipher->Encrypt(std::span{header}.first(HEADER_LEN + prefix.size()), contents, aad, output.subspan(LENGTH_LEN));
 }
 
 uint32_t BIP324Cipher::DecryptLength(std::span<const std::byte> input) noexcept
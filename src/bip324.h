@@ -26,6 +26,7 @@ public:
     static constexpr unsigned HEADER_LEN{1};
     static constexpr unsigned EXPANSION = LENGTH_LEN + HEADER_LEN + FSChaCha20Poly1305::EXPANSION;
     static constexpr std::byte IGNORE_BIT{0x80};
+    static constexpr unsigned MAX_PREFIX_LEN{16};
 
 private:
     std::optional<FSChaCha20> m_send_l_cipher;
@@ -70,6 +71,14 @@ public:
      */
     void Encrypt(std::span<const std::byte> contents, std::span<const std::byte> aad, bool ignore, std::span<std::byte> output) noexcept;
 
+    /** Encrypt a packet whose contents are given split into prefix + contents. Only after Initialize().
+     *
+     * This avoids concatenating a short prefix (e.g. the encoded message type) with a large
+     * payload into an intermediate buffer. It must hold that prefix.size() <= MAX_PREFIX_LEN
+     * and output.size() == prefix.size() + contents.size() + EXPANSION.
+     */
+    void Encrypt(std::span<const std::byte> prefix, std::span<const std::byte> contents, std::span<const std::byte> aad, bool ignore, std::span<std::byte> output) noexcept;
+
     /** Decrypt the length of a packet. Only after Initialize().
      *
      * It must hold that input.size() == LENGTH_LEN.
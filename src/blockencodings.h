@@ -118,6 +118,10 @@ public:
 
     uint64_t GetShortID(const Wtxid& wtxid) const;
 
+    /** Compute the short IDs of several transactions at once, which is faster
+     *  than calling GetShortID for each of them. */
+    void GetShortIDs(std::span<const uint256* const> wtxids, std::span<uint64_t> shortids) const;
+
     size_t BlockTxCount() const { return shorttxids.size() + prefilledtxn.size(); }
 
     SERIALIZE_METHODS(CBlockHeaderAndShortTxIDs, obj)
@@ -22,5 +22,37 @@ void static inline GetCPUID(uint32_t leaf, uint32_t subleaf, uint32_t& a, uint32
 #endif
 }
 
+/** Check whether the OS has enabled the AVX registers. Only call this if CPUID reports XSAVE and AVX support. */
+bool static inline AVXEnabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+
+/** Check whether the OS has enabled the AVX-512 registers (opmask and all of ZMM0-31). Only call this if CPUID
+ *  reports XSAVE and AVX support. */
+bool static inline AVX512Enabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 0xe6) == 0xe6;
+}
+
+/** Whether AVX2 and AVX-512F can be used, i.e. the CPU supports them and the OS has enabled their registers. */
+struct X86VectorSupport {
+    bool avx2{false};
+    bool avx512f{false};
+};
+
+X86VectorSupport static inline GetX86VectorSupport()
+{
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    if (!((ecx >> 27) & 1) || !((ecx >> 28) & 1)) return {}; // XSAVE and AVX
+    GetCPUID(7, 0, eax, ebx, ecx, edx);
+    return {.avx2 = ((ebx >> 5) & 1) && AVXEnabled(), .avx512f = ((ebx >> 16) & 1) && AVX512Enabled()};
+}
+
 #endif // defined(__x86_64__) || defined(__amd64__) || defined(__i386__)
 #endif // BITCOIN_COMPAT_CPUID_H
@@ -189,3 +189,80 @@ std::vector<uint256> TransactionMerklePath(const CBlock& block, uint32_t positio
     }
     return ComputeMerklePath(leaves, position);
 }
+
+/** Compute the next level of a merkle tree, duplicating the last node if the level is odd. */
+static std::vector<uint256> MerkleParents(const std::vector<uint256>& level)
+{
+    std::vector<uint256> parents((level.size() + 1) / 2);
+    SHA256D64(parents[0].begin(), level[0].begin(), level.size() / 2);
+    if (level.size() & 1) parents.back() = Hash(level.back(), level.back());
+    return parents;
+}
+
+MerkleTree::MerkleTree(std::vector<uint256> leaves)
+{
+    if (leaves.empty()) return;
+    m_levels.push_back(std::move(leaves));
+    while (m_levels.back().size() > 1) {
+        // Not a reference: push_back may reallocate m_levels.
+        auto parents{MerkleParents(m_levels.back())};
+        m_levels.push_back(std::move(parents));
+    }
+}
+
+MerkleTree MerkleTree::FromBlock(const CBlock& block)
+{
+    std::vector<uint256> leaves;
+    leaves.reserve(block.vtx.size());
+    for (const auto& tx : block.vtx) {
+        leaves.push_back(tx->GetHash());
+    }
+    return MerkleTree{std::move(leaves)};
+}
+
+void MerkleTree::UpdatePath(size_t level, size_t pos)
+{
+    for (; m_levels[level].size() > 1; ++level, pos /= 2) {
+        const auto& nodes{m_levels[level]};
+        const size_t left{pos & ~size_t{1}};
+        const uint256& right{left + 1 < nodes.size() ? nodes[left + 1] : nodes[left]};
+        uint256 parent{Hash(nodes[left], right)};
+        if (level + 1 == m_levels.size()) m_levels.emplace_back();
+        auto& parents{m_levels[level + 1]};
+        if (pos / 2 == parents.size()) {
+            parents.push_back(parent);
+        } else {
+            parents[pos / 2] = parent;
+        }
+    }
+}
+
+void MerkleTree::Append(const uint256& leaf)
+{
+    if (m_levels.empty()) m_levels.emplace_back();
+    m_levels[0].push_back(leaf);
+    UpdatePath(0, m_levels[0].size() - 1);
+}
+
+void MerkleTree::Update(size_t pos, const uint256& leaf)
+{
+    Assume(pos < Size());
+    m_levels[0][pos] = leaf;
+    UpdatePath(0, pos);
+}
+
+uint256 MerkleTree::Root() const
+{
+    if (m_levels.empty()) return uint256();
+    return m_levels.back()[0];
+}
+
+std::vector<uint256> MerkleTree::Path(size_t pos) const
+{
+    std::vector<uint256> path;
+    for (size_t level = 0; level < m_levels.size() && m_levels[level].size() > 1; ++level, pos /= 2) {
+        const auto& nodes{m_levels[level]};
+        path.push_back((pos ^ 1) < nodes.size() ? nodes[pos ^ 1] : nodes[pos]);
+    }
+    return path;
+}
@@ -34,4 +34,35 @@ uint256 BlockWitnessMerkleRoot(const CBlock& block, bool* mutated = nullptr);
  */
 std::vector<uint256> TransactionMerklePath(const CBlock& block, uint32_t position);
 
+/**
+ * A merkle tree that keeps all of its levels, so that it can be modified
+ * without rehashing everything.
+ *
+ * Replacing a leaf (e.g. the coinbase of a block template) or appending one
+ * only rehashes the O(log n) nodes above it. Root() and Path() give the same
+ * results as ComputeMerkleRoot() and TransactionMerklePath() on its leaves.
+ */
+class MerkleTree
+{
+    //! m_levels[0] are the leaves, each next level holds the hashes of pairs of the previous one.
+    std::vector<std::vector<uint256>> m_levels;
+
+    //! Recompute the parents of node pos at every level above level.
+    void UpdatePath(size_t level, size_t pos);
+
+public:
+    MerkleTree() = default;
+    explicit MerkleTree(std::vector<uint256> leaves);
+
+    /** Build a tree over the txids of a block's transactions. */
+    static MerkleTree FromBlock(const CBlock& block);
+
+    size_t Size() const { return m_levels.empty() ? 0 : m_levels[0].size(); }
+    void Append(const uint256& leaf);
+    void Update(size_t pos, const uint256& leaf);
+    uint256 Root() const;
+    /** Merkle path to the leaf at pos, ordered from the deepest. */
+    std::vector<uint256> Path(size_t pos) const;
+};
+
 #endif // BITCOIN_CONSENSUS_MERKLE_H
@@ -0,0 +1,20 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_CRYPTO_AVX512_H
+#define BITCOIN_CRYPTO_AVX512_H
+
+// The AVX-512 intrinsics use _mm512_undefined_epi32(), which GCC reports as uninitialized once they are inlined.
+// Only silence that for the intrinsics themselves, so that it is still reported for the code using them.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // BITCOIN_CRYPTO_AVX512_H
@@ -7,6 +7,7 @@
 
 #include <crypto/common.h>
 #include <crypto/chacha20.h>
+#include <compat/cpuid.h>
 #include <support/cleanse.h>
 #include <span.h>
 
@@ -14,6 +15,27 @@
 #include <bit>
 #include <string.h>
 
+#if defined(ENABLE_SSE2)
+namespace chacha20_sse2
+{
+void Crypt_4way(const uint32_t* input, const std::byte* in, std::byte* out);
+}
+#endif
+
+#if defined(ENABLE_AVX2)
+namespace chacha20_avx2
+{
+void Crypt_8way(const uint32_t* input, const std::byte* in, std::byte* out);
+}
+#endif
+
+#if defined(ENABLE_AVX512)
+namespace chacha20_avx512
+{
+void Crypt_16way(const uint32_t* input, const std::byte* in, std::byte* out);
+}
+#endif
+
 #define QUARTERROUND(a,b,c,d) \
   a += b; d = std::rotl(d ^ a, 16); \
   c += d; b = std::rotl(b ^ c, 12); \
@@ -22,6 +44,72 @@
 
 #define REPEAT10(a) do { {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; } while(0)
 
+namespace {
+/** Compute the blocks at the position of input, XOR them with in (unless nullptr), and write them to out. */
+typedef void (*CryptBlocksFn)(const uint32_t* input, const std::byte* in, std::byte* out);
+
+CryptBlocksFn Crypt_4way = nullptr;
+CryptBlocksFn Crypt_8way = nullptr;
+CryptBlocksFn Crypt_16way = nullptr;
+
+/** Process as many of the blocks as possible with the multi-block implementations, advancing the block counter in
+ *  input. Returns the number of blocks processed. */
+size_t CryptMultiBlock(uint32_t* input, const std::byte* in, std::byte* out, size_t blocks) noexcept
+{
+    size_t done{0};
+    const auto run{[&](CryptBlocksFn fn, size_t lanes) {
+        if (!fn) return;
+        for (; blocks - done >= lanes; done += lanes) {
+            fn(input, in ? in + done * ChaCha20Aligned::BLOCKLEN : nullptr, out + done * ChaCha20Aligned::BLOCKLEN);
+            input[8] += lanes;
+            if (input[8] < lanes) ++input[9];
+        }
+    }};
+    run(Crypt_16way, 16);
+    run(Crypt_8way, 8);
+    run(Crypt_4way, 4);
+    return done;
+}
+} // namespace
+
+std::string ChaCha20AutoDetect(chacha20_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    Crypt_4way = nullptr;
+    Crypt_8way = nullptr;
+    Crypt_16way = nullptr;
+
+#if defined(HAVE_GETCPUID)
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    [[maybe_unused]] const bool have_sse2{((edx >> 26) & 1) && (use_implementation & chacha20_implementation::USE_SSE2)};
+    const X86VectorSupport vector_support{GetX86VectorSupport()};
+    [[maybe_unused]] const bool have_avx2{vector_support.avx2 && (use_implementation & chacha20_implementation::USE_AVX2)};
+    [[maybe_unused]] const bool have_avx512{vector_support.avx512f && (use_implementation & chacha20_implementation::USE_AVX512)};
+
+#if defined(ENABLE_SSE2)
+    if (have_sse2) {
+        Crypt_4way = chacha20_sse2::Crypt_4way;
+        ret += ",sse2(4way)";
+    }
+#endif
+#if defined(ENABLE_AVX2)
+    if (have_avx2) {
+        Crypt_8way = chacha20_avx2::Crypt_8way;
+        ret += ",avx2(8way)";
+    }
+#endif
+#if defined(ENABLE_AVX512)
+    if (have_avx512) {
+        Crypt_16way = chacha20_avx512::Crypt_16way;
+        ret += ",avx512(16way)";
+    }
+#endif
+#endif // defined(HAVE_GETCPUID)
+
+    return ret;
+}
+
 void ChaCha20Aligned::SetKey(std::span<const std::byte> key) noexcept
 {
     assert(key.size() == KEYLEN);
@@ -63,6 +151,10 @@ inline void ChaCha20Aligned::Keystream(std::span<std::byte> output) noexcept
     size_t blocks = output.size() / BLOCKLEN;
     assert(blocks * BLOCKLEN == output.size());
 
+    const size_t done = CryptMultiBlock(input, nullptr, c, blocks);
+    c += done * BLOCKLEN;
+    blocks -= done;
+
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
     uint32_t j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
 
@@ -166,6 +258,11 @@ inline void ChaCha20Aligned::Crypt(std::span<const std::byte> in_bytes, std::spa
     size_t blocks = out_bytes.size() / BLOCKLEN;
     assert(blocks * BLOCKLEN == out_bytes.size());
 
+    const size_t done = CryptMultiBlock(input, m, c, blocks);
+    m += done * BLOCKLEN;
+    c += done * BLOCKLEN;
+    blocks -= done;
+
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
     uint32_t j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
 
@@ -0,0 +1,98 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include <attributes.h>
+
+#include <cstddef>
+
+namespace chacha20_avx2 {
+namespace {
+
+__m256i inline K(uint32_t x) { return _mm256_set1_epi32(x); }
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+template<int n> __m256i inline Rotl(__m256i x) { return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n)); }
+// Rotations by whole bytes are a single shuffle.
+__m256i inline Rotl16(__m256i x) { return _mm256_shuffle_epi8(x, _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2, 13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2)); }
+__m256i inline Rotl8(__m256i x) { return _mm256_shuffle_epi8(x, _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3, 14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3)); }
+
+void ALWAYS_INLINE QuarterRound(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    a = Add(a, b); d = Rotl16(Xor(d, a));
+    c = Add(c, d); b = Rotl<12>(Xor(b, c));
+    a = Add(a, b); d = Rotl8(Xor(d, a));
+    c = Add(c, d); b = Rotl<7>(Xor(b, c));
+}
+
+/** Turn 4 vectors holding the same word of 8 blocks into 4 vectors holding 4 consecutive words of one block in
+ *  each 128-bit half: blocks 0 and 4 in the first vector, 1 and 5 in the second, and so on. */
+void ALWAYS_INLINE Transpose(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    const __m256i t0{_mm256_unpacklo_epi32(a, b)};
+    const __m256i t1{_mm256_unpacklo_epi32(c, d)};
+    const __m256i t2{_mm256_unpackhi_epi32(a, b)};
+    const __m256i t3{_mm256_unpackhi_epi32(c, d)};
+    a = _mm256_unpacklo_epi64(t0, t1);
+    b = _mm256_unpackhi_epi64(t0, t1);
+    c = _mm256_unpacklo_epi64(t2, t3);
+    d = _mm256_unpackhi_epi64(t2, t3);
+}
+
+void ALWAYS_INLINE Write(const std::byte* in, std::byte* out, __m256i v)
+{
+    if (in) v = Xor(v, _mm256_loadu_si256((const __m256i*)in));
+    _mm256_storeu_si256((__m256i*)out, v);
+}
+
+}
+
+void Crypt_8way(const uint32_t* input, const std::byte* in, std::byte* out)
+{
+    // Lane i computes block counter + i. Like in the scalar code, the counter overflows into the first nonce word.
+    const __m256i counter{Add(K(input[8]), _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0))};
+    // Signed comparison of the counters with their sign bits flipped: -1 in the lanes that overflowed.
+    const __m256i sign{K(0x80000000)};
+    const __m256i overflow{_mm256_cmpgt_epi32(Xor(K(input[8]), sign), Xor(counter, sign))};
+    const __m256i j[16] = {
+        K(0x61707865), K(0x3320646e), K(0x79622d32), K(0x6b206574),
+        K(input[0]), K(input[1]), K(input[2]), K(input[3]),
+        K(input[4]), K(input[5]), K(input[6]), K(input[7]),
+        counter, _mm256_sub_epi32(K(input[9]), overflow), K(input[10]), K(input[11]),
+    };
+    __m256i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = j[i];
+
+    for (int i = 0; i < 10; ++i) {
+        QuarterRound(x[0], x[4], x[8], x[12]);
+        QuarterRound(x[1], x[5], x[9], x[13]);
+        QuarterRound(x[2], x[6], x[10], x[14]);
+        QuarterRound(x[3], x[7], x[11], x[15]);
+        QuarterRound(x[0], x[5], x[10], x[15]);
+        QuarterRound(x[1], x[6], x[11], x[12]);
+        QuarterRound(x[2], x[7], x[8], x[13]);
+        QuarterRound(x[3], x[4], x[9], x[14]);
+    }
+
+    for (int i = 0; i < 16; ++i) x[i] = Add(x[i], j[i]);
+    for (int g = 0; g < 4; ++g) Transpose(x[4 * g], x[4 * g + 1], x[4 * g + 2], x[4 * g + 3]);
+
+    // Combine the halves of words 0-7 and 8-15 of each block.
+    for (int h = 0; h < 2; ++h) {
+        for (int b = 0; b < 4; ++b) {
+            const __m256i lo{x[8 * h + b]}, hi{x[8 * h + 4 + b]};
+            const size_t pos{size_t(64 * b + 32 * h)};
+            Write(in ? in + pos : nullptr, out + pos, _mm256_permute2x128_si256(lo, hi, 0x20));
+            Write(in ? in + pos + 256 : nullptr, out + pos + 256, _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+    }
+}
+
+}
+
+#endif
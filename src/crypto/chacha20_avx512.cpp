@@ -0,0 +1,105 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX512
+
+#include <stdint.h>
+
+#include <attributes.h>
+#include <crypto/avx512.h>
+
+#include <cstddef>
+
+namespace chacha20_avx512 {
+namespace {
+
+__m512i inline K(uint32_t x) { return _mm512_set1_epi32(x); }
+__m512i inline Add(__m512i x, __m512i y) { return _mm512_add_epi32(x, y); }
+__m512i inline Xor(__m512i x, __m512i y) { return _mm512_xor_si512(x, y); }
+template<int n> __m512i inline Rotl(__m512i x) { return _mm512_rol_epi32(x, n); }
+
+void ALWAYS_INLINE QuarterRound(__m512i& a, __m512i& b, __m512i& c, __m512i& d)
+{
+    a = Add(a, b); d = Rotl<16>(Xor(d, a));
+    c = Add(c, d); b = Rotl<12>(Xor(b, c));
+    a = Add(a, b); d = Rotl<8>(Xor(d, a));
+    c = Add(c, d); b = Rotl<7>(Xor(b, c));
+}
+
+/** Turn 4 vectors holding the same word of 16 blocks into 4 vectors holding 4 consecutive words of one block in
+ *  each 128-bit lane: blocks 0, 4, 8 and 12 in the first vector, 1, 5, 9 and 13 in the second, and so on. */
+void ALWAYS_INLINE Transpose(__m512i& a, __m512i& b, __m512i& c, __m512i& d)
+{
+    const __m512i t0{_mm512_unpacklo_epi32(a, b)};
+    const __m512i t1{_mm512_unpacklo_epi32(c, d)};
+    const __m512i t2{_mm512_unpackhi_epi32(a, b)};
+    const __m512i t3{_mm512_unpackhi_epi32(c, d)};
+    a = _mm512_unpacklo_epi64(t0, t1);
+    b = _mm512_unpackhi_epi64(t0, t1);
+    c = _mm512_unpacklo_epi64(t2, t3);
+    d = _mm512_unpackhi_epi64(t2, t3);
+}
+
+/** Transpose 4 vectors of 4 128-bit lanes each. */
+void ALWAYS_INLINE TransposeLanes(__m512i& a, __m512i& b, __m512i& c, __m512i& d)
+{
+    const __m512i t0{_mm512_shuffle_i32x4(a, b, 0x44)};
+    const __m512i t1{_mm512_shuffle_i32x4(a, b, 0xee)};
+    const __m512i t2{_mm512_shuffle_i32x4(c, d, 0x44)};
+    const __m512i t3{_mm512_shuffle_i32x4(c, d, 0xee)};
+    a = _mm512_shuffle_i32x4(t0, t2, 0x88);
+    b = _mm512_shuffle_i32x4(t0, t2, 0xdd);
+    c = _mm512_shuffle_i32x4(t1, t3, 0x88);
+    d = _mm512_shuffle_i32x4(t1, t3, 0xdd);
+}
+
+void ALWAYS_INLINE Write(const std::byte* in, std::byte* out, __m512i v)
+{
+    if (in) v = Xor(v, _mm512_loadu_si512(in));
+    _mm512_storeu_si512(out, v);
+}
+
+}
+
+void Crypt_16way(const uint32_t* input, const std::byte* in, std::byte* out)
+{
+    // Lane i computes block counter + i. Like in the scalar code, the counter overflows into the first nonce word.
+    const __m512i counter{Add(K(input[8]), _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0))};
+    const __mmask16 overflow{_mm512_cmplt_epu32_mask(counter, K(input[8]))};
+    const __m512i j[16] = {
+        K(0x61707865), K(0x3320646e), K(0x79622d32), K(0x6b206574),
+        K(input[0]), K(input[1]), K(input[2]), K(input[3]),
+        K(input[4]), K(input[5]), K(input[6]), K(input[7]),
+        counter, _mm512_mask_add_epi32(K(input[9]), overflow, K(input[9]), K(1)), K(input[10]), K(input[11]),
+    };
+    __m512i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = j[i];
+
+    for (int i = 0; i < 10; ++i) {
+        QuarterRound(x[0], x[4], x[8], x[12]);
+        QuarterRound(x[1], x[5], x[9], x[13]);
+        QuarterRound(x[2], x[6], x[10], x[14]);
+        QuarterRound(x[3], x[7], x[11], x[15]);
+        QuarterRound(x[0], x[5], x[10], x[15]);
+        QuarterRound(x[1], x[6], x[11], x[12]);
+        QuarterRound(x[2], x[7], x[8], x[13]);
+        QuarterRound(x[3], x[4], x[9], x[14]);
+    }
+
+    for (int i = 0; i < 16; ++i) x[i] = Add(x[i], j[i]);
+    for (int g = 0; g < 4; ++g) Transpose(x[4 * g], x[4 * g + 1], x[4 * g + 2], x[4 * g + 3]);
+
+    // Gather the 4 groups of words of each block.
+    for (int b = 0; b < 4; ++b) {
+        TransposeLanes(x[b], x[4 + b], x[8 + b], x[12 + b]);
+        for (int l = 0; l < 4; ++l) {
+            const size_t pos{size_t(64 * (b + 4 * l))};
+            Write(in ? in + pos : nullptr, out + pos, x[4 * l + b]);
+        }
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,86 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_SSE2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include <attributes.h>
+
+#include <cstddef>
+
+namespace chacha20_sse2 {
+namespace {
+
+__m128i inline K(uint32_t x) { return _mm_set1_epi32(x); }
+__m128i inline Add(__m128i x, __m128i y) { return _mm_add_epi32(x, y); }
+__m128i inline Xor(__m128i x, __m128i y) { return _mm_xor_si128(x, y); }
+template<int n> __m128i inline Rotl(__m128i x) { return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n)); }
+
+void ALWAYS_INLINE QuarterRound(__m128i& a, __m128i& b, __m128i& c, __m128i& d)
+{
+    a = Add(a, b); d = Rotl<16>(Xor(d, a));
+    c = Add(c, d); b = Rotl<12>(Xor(b, c));
+    a = Add(a, b); d = Rotl<8>(Xor(d, a));
+    c = Add(c, d); b = Rotl<7>(Xor(b, c));
+}
+
+/** Turn 4 vectors holding the same word of 4 blocks into 4 vectors holding 4 consecutive words of one block. */
+void ALWAYS_INLINE Transpose(__m128i& a, __m128i& b, __m128i& c, __m128i& d)
+{
+    const __m128i t0{_mm_unpacklo_epi32(a, b)};
+    const __m128i t1{_mm_unpacklo_epi32(c, d)};
+    const __m128i t2{_mm_unpackhi_epi32(a, b)};
+    const __m128i t3{_mm_unpackhi_epi32(c, d)};
+    a = _mm_unpacklo_epi64(t0, t1);
+    b = _mm_unpackhi_epi64(t0, t1);
+    c = _mm_unpacklo_epi64(t2, t3);
+    d = _mm_unpackhi_epi64(t2, t3);
+}
+
+}
+
+void Crypt_4way(const uint32_t* input, const std::byte* in, std::byte* out)
+{
+    // Lane i computes block counter + i. Like in the scalar code, the counter overflows into the first nonce word.
+    const __m128i counter{Add(K(input[8]), _mm_set_epi32(3, 2, 1, 0))};
+    // Signed comparison of the counters with their sign bits flipped: -1 in the lanes that overflowed.
+    const __m128i sign{K(0x80000000)};
+    const __m128i overflow{_mm_cmpgt_epi32(Xor(K(input[8]), sign), Xor(counter, sign))};
+    const __m128i j[16] = {
+        K(0x61707865), K(0x3320646e), K(0x79622d32), K(0x6b206574),
+        K(input[0]), K(input[1]), K(input[2]), K(input[3]),
+        K(input[4]), K(input[5]), K(input[6]), K(input[7]),
+        counter, _mm_sub_epi32(K(input[9]), overflow), K(input[10]), K(input[11]),
+    };
+    __m128i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = j[i];
+
+    for (int i = 0; i < 10; ++i) {
+        QuarterRound(x[0], x[4], x[8], x[12]);
+        QuarterRound(x[1], x[5], x[9], x[13]);
+        QuarterRound(x[2], x[6], x[10], x[14]);
+        QuarterRound(x[3], x[7], x[11], x[15]);
+        QuarterRound(x[0], x[5], x[10], x[15]);
+        QuarterRound(x[1], x[6], x[11], x[12]);
+        QuarterRound(x[2], x[7], x[8], x[13]);
+        QuarterRound(x[3], x[4], x[9], x[14]);
+    }
+
+    for (int i = 0; i < 16; ++i) x[i] = Add(x[i], j[i]);
+
+    for (int g = 0; g < 4; ++g) {
+        Transpose(x[4 * g], x[4 * g + 1], x[4 * g + 2], x[4 * g + 3]);
+        for (int b = 0; b < 4; ++b) {
+            __m128i v{x[4 * g + b]};
+            if (in) v = Xor(v, _mm_loadu_si128((const __m128i*)(in + 64 * b + 16 * g)));
+            _mm_storeu_si128((__m128i*)(out + 64 * b + 16 * g), v);
+        }
+    }
+}
+
+}
+
+#endif
@@ -4,9 +4,60 @@
 
 #include <crypto/common.h>
 #include <crypto/poly1305.h>
+#include <compat/cpuid.h>
 
 #include <string.h>
 
+#if defined(ENABLE_AVX2)
+namespace poly1305_avx2
+{
+void Blocks_4way(uint32_t* h, const uint32_t (*rpow)[5], const unsigned char* m, size_t groups);
+}
+#endif
+
+#if defined(ENABLE_AVX512)
+namespace poly1305_avx512
+{
+void Blocks_8way(uint32_t* h, const uint32_t (*rpow)[5], const unsigned char* m, size_t groups);
+}
+#endif
+
+namespace {
+/** Process groups * lanes full (non-final) blocks, given r^1 .. r^lanes. */
+typedef void (*BlocksFn)(uint32_t* h, const uint32_t (*rpow)[5], const unsigned char* m, size_t groups);
+
+BlocksFn Blocks_4way = nullptr;
+BlocksFn Blocks_8way = nullptr;
+} // namespace
+
+std::string Poly1305AutoDetect(poly1305_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    Blocks_4way = nullptr;
+    Blocks_8way = nullptr;
+
+#if defined(HAVE_GETCPUID)
+    const X86VectorSupport vector_support{GetX86VectorSupport()};
+    [[maybe_unused]] const bool have_avx2{vector_support.avx2 && (use_implementation & poly1305_implementation::USE_AVX2)};
+    [[maybe_unused]] const bool have_avx512{vector_support.avx512f && (use_implementation & poly1305_implementation::USE_AVX512)};
+
+#if defined(ENABLE_AVX2)
+    if (have_avx2) {
+        Blocks_4way = poly1305_avx2::Blocks_4way;
+        ret += ",avx2(4way)";
+    }
+#endif
+#if defined(ENABLE_AVX512)
+    if (have_avx512) {
+        Blocks_8way = poly1305_avx512::Blocks_8way;
+        ret += ",avx512(8way)";
+    }
+#endif
+#endif // defined(HAVE_GETCPUID)
+
+    return ret;
+}
+
 namespace poly1305_donna {
 
 // Based on the public domain implementation by Andrew Moon
@@ -35,6 +86,46 @@ void poly1305_init(poly1305_context *st, const unsigned char key[32]) noexcept {
 
     st->leftover = 0;
     st->final = 0;
+    st->rpow_count = 0;
+}
+
+/* h = h * r (partially reduced), for computing powers of r */
+static void poly1305_mul(uint32_t h[5], const uint32_t r[5]) noexcept {
+    const uint32_t s1 = r[1] * 5, s2 = r[2] * 5, s3 = r[3] * 5, s4 = r[4] * 5;
+    uint64_t d0,d1,d2,d3,d4;
+    uint32_t c;
+
+    d0 = ((uint64_t)h[0] * r[0]) + ((uint64_t)h[1] * s4) + ((uint64_t)h[2] * s3) + ((uint64_t)h[3] * s2) + ((uint64_t)h[4] * s1);
+    d1 = ((uint64_t)h[0] * r[1]) + ((uint64_t)h[1] * r[0]) + ((uint64_t)h[2] * s4) + ((uint64_t)h[3] * s3) + ((uint64_t)h[4] * s2);
+    d2 = ((uint64_t)h[0] * r[2]) + ((uint64_t)h[1] * r[1]) + ((uint64_t)h[2] * r[0]) + ((uint64_t)h[3] * s4) + ((uint64_t)h[4] * s3);
+    d3 = ((uint64_t)h[0] * r[3]) + ((uint64_t)h[1] * r[2]) + ((uint64_t)h[2] * r[1]) + ((uint64_t)h[3] * r[0]) + ((uint64_t)h[4] * s4);
+    d4 = ((uint64_t)h[0] * r[4]) + ((uint64_t)h[1] * r[3]) + ((uint64_t)h[2] * r[2]) + ((uint64_t)h[3] * r[1]) + ((uint64_t)h[4] * r[0]);
+
+                   c = (uint32_t)(d0 >> 26); h[0] = (uint32_t)d0 & 0x3ffffff;
+    d1 += c;       c = (uint32_t)(d1 >> 26); h[1] = (uint32_t)d1 & 0x3ffffff;
+    d2 += c;       c = (uint32_t)(d2 >> 26); h[2] = (uint32_t)d2 & 0x3ffffff;
+    d3 += c;       c = (uint32_t)(d3 >> 26); h[3] = (uint32_t)d3 & 0x3ffffff;
+    d4 += c;       c = (uint32_t)(d4 >> 26); h[4] = (uint32_t)d4 & 0x3ffffff;
+    h[0] += c * 5; c =           (h[0] >> 26); h[0] =         h[0] & 0x3ffffff;
+    h[1] += c;
+}
+
+/* process as many full blocks as possible with a multi-block implementation, returns the number of bytes processed */
+static size_t poly1305_blocks_multi(poly1305_context *st, const unsigned char *m, size_t bytes) noexcept {
+    size_t done = 0;
+    const auto run = [&](BlocksFn fn, size_t lanes) {
+        const size_t groups = (bytes - done) / (lanes * POLY1305_BLOCK_SIZE);
+        if (!fn || groups == 0) return;
+        for (; st->rpow_count < lanes; st->rpow_count++) {
+            memcpy(st->rpow[st->rpow_count], st->rpow_count ? st->rpow[st->rpow_count - 1] : st->r, sizeof(st->r));
+            if (st->rpow_count) poly1305_mul(st->rpow[st->rpow_count], st->r);
+        }
+        fn(st->h, st->rpow, m + done, groups);
+        done += groups * lanes * POLY1305_BLOCK_SIZE;
+    };
+    run(Blocks_8way, 8);
+    run(Blocks_4way, 4);
+    return done;
 }
 
 static void poly1305_blocks(poly1305_context *st, const unsigned char *m, size_t bytes) noexcept {
@@ -45,6 +136,12 @@ static void poly1305_blocks(poly1305_context *st, const unsigned char *m, size_t
     uint64_t d0,d1,d2,d3,d4;
     uint32_t c;
 
+    if (!st->final) {
+        size_t done = poly1305_blocks_multi(st, m, bytes);
+        m += done;
+        bytes -= done;
+    }
+
     r0 = st->r[0];
     r1 = st->r[1];
     r2 = st->r[2];
@@ -181,6 +278,12 @@ void poly1305_finish(poly1305_context *st, unsigned char mac[16]) noexcept {
     st->pad[1] = 0;
     st->pad[2] = 0;
     st->pad[3] = 0;
+    for (size_t i = 0; i < st->rpow_count; i++) {
+        for (size_t j = 0; j < 5; j++) {
+            st->rpow[i][j] = 0;
+        }
+    }
+    st->rpow_count = 0;
 }
 
 void poly1305_update(poly1305_context *st, const unsigned char *m, size_t bytes) noexcept {
@@ -10,9 +10,29 @@
 #include <cassert>
 #include <cstdlib>
 #include <stdint.h>
+#include <string>
 
 #define POLY1305_BLOCK_SIZE 16
 
+/** Maximum number of blocks processed in parallel by the multi-block implementations. */
+#define POLY1305_MAX_LANES 8
+
+namespace poly1305_implementation {
+enum UseImplementation : uint8_t {
+    STANDARD = 0,
+    USE_AVX2 = 1 << 0,
+    USE_AVX512 = 1 << 1,
+    USE_ALL = USE_AVX2 | USE_AVX512,
+};
+}
+
+/** Autodetect the best available multi-block Poly1305 implementations, which process 4 or 8 blocks at once for
+ *  long messages. Returns the name of the implementation.
+ *
+ *  This is not thread-safe: it must not be called while Poly1305 is in use.
+ */
+std::string Poly1305AutoDetect(poly1305_implementation::UseImplementation use_implementation = poly1305_implementation::USE_ALL);
+
 namespace poly1305_donna {
 
 // Based on the public domain implementation by Andrew Moon
@@ -25,6 +45,9 @@ typedef struct {
     size_t leftover;
     unsigned char buffer[POLY1305_BLOCK_SIZE];
     unsigned char final;
+    /* r^1 .. r^rpow_count, computed when first needed by a multi-block implementation */
+    uint32_t rpow[POLY1305_MAX_LANES][5];
+    size_t rpow_count;
 } poly1305_context;
 
 void poly1305_init(poly1305_context *st, const unsigned char key[32]) noexcept;
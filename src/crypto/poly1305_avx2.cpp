@@ -0,0 +1,101 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include <attributes.h>
+
+#include <cstddef>
+
+namespace poly1305_avx2 {
+namespace {
+
+// Each 64-bit lane holds one 26-bit limb of the accumulator of one of 4 interleaved blocks.
+__m256i inline K(uint64_t x) { return _mm256_set1_epi64x(x); }
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+__m256i inline Mul(__m256i x, __m256i y) { return _mm256_mul_epu32(x, y); }
+__m256i inline And(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+__m256i inline Or(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+
+/** Add 4 consecutive message blocks, one to each lane of h. */
+void ALWAYS_INLINE AddBlocks(__m256i (&h)[5], const unsigned char* m)
+{
+    const __m256i mask{K(0x3ffffff)};
+    const __m256i a{_mm256_loadu_si256((const __m256i*)m)};
+    const __m256i b{_mm256_loadu_si256((const __m256i*)(m + 32))};
+    // The low and high 8 bytes of each block.
+    const __m256i lo{_mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a, b), 0xd8)};
+    const __m256i hi{_mm256_permute4x64_epi64(_mm256_unpackhi_epi64(a, b), 0xd8)};
+    h[0] = Add(h[0], And(lo, mask));
+    h[1] = Add(h[1], And(_mm256_srli_epi64(lo, 26), mask));
+    h[2] = Add(h[2], And(Or(_mm256_srli_epi64(lo, 52), _mm256_slli_epi64(hi, 12)), mask));
+    h[3] = Add(h[3], And(_mm256_srli_epi64(hi, 14), mask));
+    h[4] = Add(h[4], Or(_mm256_srli_epi64(hi, 40), K(1 << 24)));
+}
+
+/** h *= r (partially reduced), with s = 5 * r. */
+void ALWAYS_INLINE MulReduce(__m256i (&h)[5], const __m256i (&r)[5], const __m256i (&s)[5])
+{
+    const __m256i mask{K(0x3ffffff)};
+    __m256i d0{Add(Add(Add(Add(Mul(h[0], r[0]), Mul(h[1], s[4])), Mul(h[2], s[3])), Mul(h[3], s[2])), Mul(h[4], s[1]))};
+    __m256i d1{Add(Add(Add(Add(Mul(h[0], r[1]), Mul(h[1], r[0])), Mul(h[2], s[4])), Mul(h[3], s[3])), Mul(h[4], s[2]))};
+    __m256i d2{Add(Add(Add(Add(Mul(h[0], r[2]), Mul(h[1], r[1])), Mul(h[2], r[0])), Mul(h[3], s[4])), Mul(h[4], s[3]))};
+    __m256i d3{Add(Add(Add(Add(Mul(h[0], r[3]), Mul(h[1], r[2])), Mul(h[2], r[1])), Mul(h[3], r[0])), Mul(h[4], s[4]))};
+    __m256i d4{Add(Add(Add(Add(Mul(h[0], r[4]), Mul(h[1], r[3])), Mul(h[2], r[2])), Mul(h[3], r[1])), Mul(h[4], r[0]))};
+
+    d1 = Add(d1, _mm256_srli_epi64(d0, 26)); h[0] = And(d0, mask);
+    d2 = Add(d2, _mm256_srli_epi64(d1, 26)); h[1] = And(d1, mask);
+    d3 = Add(d3, _mm256_srli_epi64(d2, 26)); h[2] = And(d2, mask);
+    d4 = Add(d4, _mm256_srli_epi64(d3, 26)); h[3] = And(d3, mask);
+    const __m256i c{_mm256_srli_epi64(d4, 26)}; h[4] = And(d4, mask);
+    h[0] = Add(h[0], Add(c, _mm256_slli_epi64(c, 2)));
+    h[1] = Add(h[1], _mm256_srli_epi64(h[0], 26)); h[0] = And(h[0], mask);
+}
+
+}
+
+void Blocks_4way(uint32_t* h, const uint32_t (*rpow)[5], const unsigned char* m, size_t groups)
+{
+    // Every lane is multiplied by r^4 per group, except in the last group, where lane i is multiplied by r^(4-i).
+    // Summing the lanes then gives the same result as processing the blocks one by one.
+    __m256i r[5], s[5], r_last[5], s_last[5], acc[5];
+    for (int i = 0; i < 5; ++i) {
+        r[i] = K(rpow[3][i]);
+        s[i] = K(rpow[3][i] * 5);
+        r_last[i] = _mm256_set_epi64x(rpow[0][i], rpow[1][i], rpow[2][i], rpow[3][i]);
+        s_last[i] = _mm256_set_epi64x(rpow[0][i] * 5, rpow[1][i] * 5, rpow[2][i] * 5, rpow[3][i] * 5);
+        acc[i] = _mm256_set_epi64x(0, 0, 0, h[i]);
+    }
+
+    for (size_t g = 0; g < groups; ++g, m += 64) {
+        AddBlocks(acc, m);
+        if (g + 1 < groups) {
+            MulReduce(acc, r, s);
+        } else {
+            MulReduce(acc, r_last, s_last);
+        }
+    }
+
+    uint64_t d[5];
+    for (int i = 0; i < 5; ++i) {
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256((__m256i*)lanes, acc[i]);
+        d[i] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    d[1] += d[0] >> 26; h[0] = d[0] & 0x3ffffff;
+    d[2] += d[1] >> 26; h[1] = d[1] & 0x3ffffff;
+    d[3] += d[2] >> 26; h[2] = d[2] & 0x3ffffff;
+    d[4] += d[3] >> 26; h[3] = d[3] & 0x3ffffff;
+    const uint64_t c{d[4] >> 26}; h[4] = d[4] & 0x3ffffff;
+    const uint64_t h0{h[0] + c * 5};
+    h[0] = h0 & 0x3ffffff;
+    h[1] += h0 >> 26;
+}
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX512
+
+#include <stdint.h>
+
+#include <attributes.h>
+#include <crypto/avx512.h>
+
+#include <cstddef>
+
+namespace poly1305_avx512 {
+namespace {
+
+// Each 64-bit lane holds one 26-bit limb of the accumulator of one of 8 interleaved blocks.
+__m512i inline K(uint64_t x) { return _mm512_set1_epi64(x); }
+__m512i inline Add(__m512i x, __m512i y) { return _mm512_add_epi64(x, y); }
+__m512i inline Mul(__m512i x, __m512i y) { return _mm512_mul_epu32(x, y); }
+__m512i inline And(__m512i x, __m512i y) { return _mm512_and_si512(x, y); }
+__m512i inline Or(__m512i x, __m512i y) { return _mm512_or_si512(x, y); }
+
+/** Add 8 consecutive message blocks, one to each lane of h. */
+void ALWAYS_INLINE AddBlocks(__m512i (&h)[5], const unsigned char* m)
+{
+    const __m512i mask{K(0x3ffffff)};
+    const __m512i a{_mm512_loadu_si512(m)};
+    const __m512i b{_mm512_loadu_si512(m + 64)};
+    // The low and high 8 bytes of each block.
+    const __m512i order{_mm512_set_epi64(7, 5, 3, 1, 6, 4, 2, 0)};
+    const __m512i lo{_mm512_permutexvar_epi64(order, _mm512_unpacklo_epi64(a, b))};
+    const __m512i hi{_mm512_permutexvar_epi64(order, _mm512_unpackhi_epi64(a, b))};
+    h[0] = Add(h[0], And(lo, mask));
+    h[1] = Add(h[1], And(_mm512_srli_epi64(lo, 26), mask));
+    h[2] = Add(h[2], And(Or(_mm512_srli_epi64(lo, 52), _mm512_slli_epi64(hi, 12)), mask));
+    h[3] = Add(h[3], And(_mm512_srli_epi64(hi, 14), mask));
+    h[4] = Add(h[4], Or(_mm512_srli_epi64(hi, 40), K(1 << 24)));
+}
+
+/** h *= r (partially reduced), with s = 5 * r. */
+void ALWAYS_INLINE MulReduce(__m512i (&h)[5], const __m512i (&r)[5], const __m512i (&s)[5])
+{
+    const __m512i mask{K(0x3ffffff)};
+    __m512i d0{Add(Add(Add(Add(Mul(h[0], r[0]), Mul(h[1], s[4])), Mul(h[2], s[3])), Mul(h[3], s[2])), Mul(h[4], s[1]))};
+    __m512i d1{Add(Add(Add(Add(Mul(h[0], r[1]), Mul(h[1], r[0])), Mul(h[2], s[4])), Mul(h[3], s[3])), Mul(h[4], s[2]))};
+    __m512i d2{Add(Add(Add(Add(Mul(h[0], r[2]), Mul(h[1], r[1])), Mul(h[2], r[0])), Mul(h[3], s[4])), Mul(h[4], s[3]))};
+    __m512i d3{Add(Add(Add(Add(Mul(h[0], r[3]), Mul(h[1], r[2])), Mul(h[2], r[1])), Mul(h[3], r[0])), Mul(h[4], s[4]))};
+    __m512i d4{Add(Add(Add(Add(Mul(h[0], r[4]), Mul(h[1], r[3])), Mul(h[2], r[2])), Mul(h[3], r[1])), Mul(h[4], r[0]))};
+
+    d1 = Add(d1, _mm512_srli_epi64(d0, 26)); h[0] = And(d0, mask);
+    d2 = Add(d2, _mm512_srli_epi64(d1, 26)); h[1] = And(d1, mask);
+    d3 = Add(d3, _mm512_srli_epi64(d2, 26)); h[2] = And(d2, mask);
+    d4 = Add(d4, _mm512_srli_epi64(d3, 26)); h[3] = And(d3, mask);
+    const __m512i c{_mm512_srli_epi64(d4, 26)}; h[4] = And(d4, mask);
+    h[0] = Add(h[0], Add(c, _mm512_slli_epi64(c, 2)));
+    h[1] = Add(h[1], _mm512_srli_epi64(h[0], 26)); h[0] = And(h[0], mask);
+}
+
+}
+
+void Blocks_8way(uint32_t* h, const uint32_t (*rpow)[5], const unsigned char* m, size_t groups)
+{
+    // Every lane is multiplied by r^8 per group, except in the last group, where lane i is multiplied by r^(8-i).
+    // Summing the lanes then gives the same result as processing the blocks one by one.
+    __m512i r[5], s[5], r_last[5], s_last[5], acc[5];
+    for (int i = 0; i < 5; ++i) {
+        r[i] = K(rpow[7][i]);
+        s[i] = K(rpow[7][i] * 5);
+        r_last[i] = _mm512_set_epi64(rpow[0][i], rpow[1][i], rpow[2][i], rpow[3][i], rpow[4][i], rpow[5][i], rpow[6][i], rpow[7][i]);
+        s_last[i] = _mm512_set_epi64(rpow[0][i] * 5, rpow[1][i] * 5, rpow[2][i] * 5, rpow[3][i] * 5,
+                                     rpow[4][i] * 5, rpow[5][i] * 5, rpow[6][i] * 5, rpow[7][i] * 5);
+        acc[i] = _mm512_set_epi64(0, 0, 0, 0, 0, 0, 0, h[i]);
+    }
+
+    for (size_t g = 0; g < groups; ++g, m += 128) {
+        AddBlocks(acc, m);
+        if (g + 1 < groups) {
+            MulReduce(acc, r, s);
+        } else {
+            MulReduce(acc, r_last, s_last);
+        }
+    }
+
+    uint64_t d[5];
+    for (int i = 0; i < 5; ++i) d[i] = _mm512_reduce_add_epi64(acc[i]);
+    d[1] += d[0] >> 26; h[0] = d[0] & 0x3ffffff;
+    d[2] += d[1] >> 26; h[1] = d[1] & 0x3ffffff;
+    d[3] += d[2] >> 26; h[2] = d[2] & 0x3ffffff;
+    d[4] += d[3] >> 26; h[3] = d[3] & 0x3ffffff;
+    const uint64_t c{d[4] >> 26}; h[4] = d[4] & 0x3ffffff;
+    const uint64_t h0{h[0] + c * 5};
+    h[0] = h0 & 0x3ffffff;
+    h[1] += h0 >> 26;
+}
+
+}
+
+#endif
@@ -4,10 +4,18 @@
 
 #include <crypto/ripemd160.h>
 
+#include <compat/cpuid.h>
 #include <crypto/common.h>
 
 #include <string.h>
 
+#if defined(ENABLE_AVX2)
+namespace ripemd160_avx2
+{
+void Hash_32_8way(unsigned char* out, const unsigned char* in);
+}
+#endif
+
 // Internal implementation code.
 namespace
 {
@@ -290,3 +298,37 @@ CRIPEMD160& CRIPEMD160::Reset()
     ripemd160::Initialize(s);
     return *this;
 }
+
+#if defined(ENABLE_AVX2)
+namespace {
+bool DetectRIPEMD160AVX2()
+{
+#if defined(HAVE_GETCPUID)
+    return GetX86VectorSupport().avx2;
+#else
+    return false;
+#endif
+}
+} // namespace
+#endif
+
+void RIPEMD160_32(unsigned char* out, const unsigned char* in, size_t blocks)
+{
+#if defined(ENABLE_AVX2)
+    static const bool use_avx2{DetectRIPEMD160AVX2()};
+    if (use_avx2) {
+        while (blocks >= 8) {
+            ripemd160_avx2::Hash_32_8way(out, in);
+            out += 20 * 8;
+            in += 32 * 8;
+            blocks -= 8;
+        }
+    }
+#endif
+    while (blocks) {
+        CRIPEMD160().Write(in, 32).Finalize(out);
+        out += 20;
+        in += 32;
+        --blocks;
+    }
+}
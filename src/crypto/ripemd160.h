@@ -25,4 +25,12 @@ public:
     CRIPEMD160& Reset();
 };
 
+/** Compute the RIPEMD-160 hashes of `blocks` consecutive 32-byte inputs.
+ *
+ *  Writes `blocks` consecutive 20-byte hashes to out. Uses an 8-way AVX2
+ *  implementation where supported, which is how the RIPEMD-160 half of
+ *  many HASH160 computations is done at once.
+ */
+void RIPEMD160_32(unsigned char* out, const unsigned char* in, size_t blocks);
+
 #endif // BITCOIN_CRYPTO_RIPEMD160_H
@@ -39,6 +39,11 @@ namespace sha256d64_avx2
 void Transform_8way(unsigned char* out, const unsigned char* in);
 }
 
+namespace sha256d64_avx512
+{
+void Transform_16way(unsigned char* out, const unsigned char* in);
+}
+
 namespace sha256d64_x86_shani
 {
 void Transform_2way(unsigned char* out, const unsigned char* in);
@@ -482,6 +487,7 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformD64Type TransformD64_16way = nullptr;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -489,7 +495,7 @@ bool SelfTest() {
         0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul, 0xa54ff53aul, 0x510e527ful, 0x9b05688cul, 0x1f83d9abul, 0x5be0cd19ul
     };
     // Some random input data to test with
-    static const unsigned char data[641] = "-" // Intentionally not aligned
+    static const unsigned char data[1026] = "-" // Intentionally not aligned
         "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
         "eiusmod tempor incididunt ut labore et dolore magna aliqua. Et m"
         "olestie ac feugiat sed lectus vestibulum mattis ullamcorper. Mor"
@@ -497,7 +503,15 @@ bool SelfTest() {
         "unc congue nisi vita suscipit tellus mauris. Imperdiet proin fer"
         "mentum leo vel orci. Massa tempor nec feugiat nisl pretium fusce"
         " id velit. Telus in metus vulputate eu scelerisque felis. Mi tem"
-        "pus imperdiet nulla malesuada pellentesque. Tristique magna sit.";
+        "pus imperdiet nulla malesuada pellentesque. Tristique magna sit."
+        "Viverra nam libero justo laoreet sit amet cursus sit amet. Amet "
+        "dictum sit amet justo donec enim diam vulputate ut. Pharetra mas"
+        "sa massa ultricies mi quis hendrerit dolor magna eget. Ut portti"
+        "tor leo a diam sollicitudin tempor id eu. Faucibus nisl tincidun"
+        "t eget nullam non nisi est sit. Lacus vel facilisis volutpat est"
+        " velit egestas dui id ornare. Arcu non sodales neque sodales ut "
+        "etiam sit amet. Nibh tellus molestie nunc non blandit massa enim"
+        " nec dui. Elementum nisi quis eleifend quam adipiscing vitae pr.";
     // Expected output state for hashing the i*64 first input bytes above (excluding SHA256 padding).
     static const uint32_t result[9][8] = {
         {0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul, 0xa54ff53aul, 0x510e527ful, 0x9b05688cul, 0x1f83d9abul, 0x5be0cd19ul},
@@ -510,8 +524,8 @@ bool SelfTest() {
         {0x3e4c4039ul, 0xbb6fca8cul, 0x6f27d2f7ul, 0x301e44a4ul, 0x8352ba14ul, 0x5769ce37ul, 0x48a1155ful, 0xc0e1c4c6ul},
         {0xfe2fa9ddul, 0x69d0862bul, 0x1ae0db23ul, 0x471f9244ul, 0xf55c0145ul, 0xc30f9c3bul, 0x40a84ea0ul, 0x5b8a266cul},
     };
-    // Expected output for each of the individual 8 64-byte messages under full double SHA256 (including padding).
-    static const unsigned char result_d64[256] = {
+    // Expected output for each of the individual 16 64-byte messages under full double SHA256 (including padding).
+    static const unsigned char result_d64[512] = {
         0x09, 0x3a, 0xc4, 0xd0, 0x0f, 0xf7, 0x57, 0xe1, 0x72, 0x85, 0x79, 0x42, 0xfe, 0xe7, 0xe0, 0xa0,
         0xfc, 0x52, 0xd7, 0xdb, 0x07, 0x63, 0x45, 0xfb, 0x53, 0x14, 0x7d, 0x17, 0x22, 0x86, 0xf0, 0x52,
         0x48, 0xb6, 0x11, 0x9e, 0x6e, 0x48, 0x81, 0x6d, 0xcc, 0x57, 0x1f, 0xb2, 0x97, 0xa8, 0xd5, 0x25,
@@ -527,7 +541,23 @@ bool SelfTest() {
         0xb6, 0x53, 0x9e, 0x1c, 0x95, 0xb7, 0xca, 0xdc, 0x7f, 0x7d, 0x74, 0x27, 0x5c, 0x8e, 0xa6, 0x84,
         0xb5, 0xac, 0x87, 0xa9, 0xf3, 0xff, 0x75, 0xf2, 0x34, 0xcd, 0x1a, 0x3b, 0x82, 0x2c, 0x2b, 0x4e,
         0x6a, 0x46, 0x30, 0xa6, 0x89, 0x86, 0x23, 0xac, 0xf8, 0xa5, 0x15, 0xe9, 0x0a, 0xaa, 0x1e, 0x9a,
-        0xd7, 0x93, 0x6b, 0x28, 0xe4, 0x3b, 0xfd, 0x59, 0xc6, 0xed, 0x7c, 0x5f, 0xa5, 0x41, 0xcb, 0x51
+        0xd7, 0x93, 0x6b, 0x28, 0xe4, 0x3b, 0xfd, 0x59, 0xc6, 0xed, 0x7c, 0x5f, 0xa5, 0x41, 0xcb, 0x51,
+        0x3a, 0x01, 0x83, 0x10, 0xbf, 0x55, 0x01, 0xbc, 0xca, 0x3a, 0x10, 0x5f, 0xe5, 0x01, 0x85, 0x0f,
+        0x95, 0x40, 0x1e, 0x35, 0x02, 0x0f, 0xfd, 0x92, 0xfb, 0x1a, 0x92, 0xc7, 0x97, 0xaf, 0x48, 0x3b,
+        0xbe, 0x82, 0xa2, 0x32, 0xc1, 0xe5, 0xbc, 0xfb, 0xf1, 0xab, 0xba, 0xe1, 0x6f, 0x95, 0xca, 0x19,
+        0x80, 0xe2, 0x24, 0x0f, 0x94, 0xef, 0x03, 0x82, 0xd2, 0x49, 0x6c, 0x8f, 0xc8, 0x8b, 0x56, 0xae,
+        0x93, 0xdc, 0x87, 0x52, 0xdc, 0x6c, 0x48, 0x0a, 0xd6, 0xae, 0x45, 0x85, 0xf1, 0x19, 0x3a, 0x5f,
+        0x83, 0x57, 0xf5, 0x3a, 0xf4, 0xc1, 0x3a, 0xf7, 0xcf, 0x40, 0xa7, 0x2a, 0x0f, 0xc6, 0x30, 0xb6,
+        0x64, 0x6e, 0xaf, 0x5e, 0x5b, 0x82, 0x13, 0xb5, 0xda, 0x24, 0x94, 0xb5, 0xc8, 0x44, 0xe3, 0x92,
+        0x95, 0x97, 0xa6, 0x2b, 0xfc, 0xcc, 0x44, 0x82, 0x7c, 0x11, 0x47, 0xb3, 0x13, 0x00, 0xe8, 0xfd,
+        0x5f, 0x6e, 0x27, 0x45, 0x33, 0xa8, 0xb9, 0xeb, 0x9a, 0x86, 0x90, 0xdc, 0x44, 0x20, 0xad, 0xd7,
+        0x42, 0x97, 0x31, 0xe1, 0xf6, 0xbe, 0x86, 0xa6, 0x42, 0xb3, 0xcb, 0x65, 0xa2, 0x03, 0xd9, 0x5c,
+        0x52, 0xa5, 0x69, 0xdd, 0xee, 0x13, 0xf3, 0x95, 0xda, 0x06, 0x3b, 0x50, 0x8c, 0x15, 0x41, 0x0a,
+        0x4a, 0xcf, 0x4e, 0x06, 0xe6, 0x9b, 0x7c, 0x07, 0x70, 0x8f, 0xe0, 0xc1, 0xb4, 0x2b, 0x44, 0xe8,
+        0xda, 0xd3, 0x70, 0x80, 0x14, 0xfa, 0x0f, 0x47, 0xbe, 0xb8, 0x58, 0x39, 0xa5, 0x27, 0x02, 0xf3,
+        0xb7, 0x94, 0x38, 0x03, 0x43, 0xa5, 0x79, 0x89, 0xa6, 0xd2, 0xea, 0xa6, 0x08, 0x82, 0x50, 0xb8,
+        0x7b, 0x79, 0xf1, 0xc4, 0xc4, 0xc3, 0xb8, 0xd3, 0x76, 0x10, 0x00, 0x46, 0x44, 0x51, 0xc4, 0x3d,
+        0x70, 0xc4, 0x28, 0x83, 0x96, 0xbb, 0x02, 0x1e, 0xb1, 0x57, 0x07, 0x2f, 0x8a, 0xb6, 0x6a, 0xdf
     };
 
 
@@ -565,20 +595,15 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
-    return true;
-}
+    // Test TransformD64_16way, if available.
+    if (TransformD64_16way) {
+        unsigned char out[512];
+        TransformD64_16way(out, data + 1);
+        if (!std::equal(out, out + 512, result_d64)) return false;
+    }
 
-#if !defined(DISABLE_OPTIMIZED_SHA256)
-#if (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
-/** Check whether the OS has enabled AVX registers. */
-bool AVXEnabled()
-{
-    uint32_t a, d;
-    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
-    return (a & 6) == 6;
+    return true;
 }
-#endif
-#endif // DISABLE_OPTIMIZED_SHA256
 } // namespace
 
 
@@ -590,6 +615,7 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     TransformD64_2way = nullptr;
     TransformD64_4way = nullptr;
     TransformD64_8way = nullptr;
+    TransformD64_16way = nullptr;
 
 #if !defined(DISABLE_OPTIMIZED_SHA256)
 #if defined(HAVE_GETCPUID)
@@ -597,8 +623,10 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     bool have_xsave = false;
     bool have_avx = false;
     [[maybe_unused]] bool have_avx2 = false;
+    [[maybe_unused]] bool have_avx512 = false;
     [[maybe_unused]] bool have_x86_shani = false;
     [[maybe_unused]] bool enabled_avx = false;
+    [[maybe_unused]] bool enabled_avx512 = false;
 
     uint32_t eax, ebx, ecx, edx;
     GetCPUID(1, 0, eax, ebx, ecx, edx);
@@ -609,12 +637,16 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     have_avx = (ecx >> 28) & 1;
     if (have_xsave && have_avx) {
         enabled_avx = AVXEnabled();
+        enabled_avx512 = AVX512Enabled();
     }
     if (have_sse4) {
         GetCPUID(7, 0, eax, ebx, ecx, edx);
         if (use_implementation & sha256_implementation::USE_AVX2) {
             have_avx2 = (ebx >> 5) & 1;
         }
+        if (use_implementation & sha256_implementation::USE_AVX512) {
+            have_avx512 = (ebx >> 16) & 1;
+        }
         if (use_implementation & sha256_implementation::USE_SHANI) {
             have_x86_shani = (ebx >> 29) & 1;
         }
@@ -649,6 +681,15 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
         ret += ",avx2(8way)";
     }
 #endif
+
+#if defined(ENABLE_AVX512)
+    // Unlike AVX2, this is also used alongside SHA-NI, which only offers 2 lanes:
+    // for batches of at least 16 messages, 16 lanes are faster.
+    if (have_avx512 && enabled_avx512) {
+        TransformD64_16way = sha256d64_avx512::Transform_16way;
+        ret += ",avx512(16way)";
+    }
+#endif
 #endif // defined(HAVE_GETCPUID)
 
 #if defined(ENABLE_ARM_SHANI)
@@ -748,6 +789,14 @@ CSHA256& CSHA256::Reset()
 
 void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
 {
+    if (TransformD64_16way) {
+        while (blocks >= 16) {
+            TransformD64_16way(out, in);
+            out += 512;
+            in += 1024;
+            blocks -= 16;
+        }
+    }
     if (TransformD64_8way) {
         while (blocks >= 8) {
             TransformD64_8way(out, in);
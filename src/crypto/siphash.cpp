@@ -4,7 +4,25 @@
 
 #include <crypto/siphash.h>
 
+#include <compat/cpuid.h>
+
 #include <bit>
+#include <cassert>
+#include <cstddef>
+
+#if defined(ENABLE_AVX2)
+namespace siphash_avx2
+{
+void SipHashUint256_4way(uint64_t k0, uint64_t k1, const uint256* const* vals, uint64_t* out);
+}
+#endif
+
+#if defined(ENABLE_AVX512)
+namespace siphash_avx512
+{
+void SipHashUint256_8way(uint64_t k0, uint64_t k1, const uint256* const* vals, uint64_t* out);
+}
+#endif
 
 #define SIPROUND do { \
     v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; \
@@ -172,3 +190,40 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+namespace {
+/** Multi-lane SipHashUint256 implementation, hashing `lanes` values per call. */
+struct SipHashUint256Lanes {
+    size_t lanes{0};
+    void (*hash)(uint64_t k0, uint64_t k1, const uint256* const* vals, uint64_t* out){nullptr};
+};
+
+SipHashUint256Lanes DetectSipHashUint256Lanes()
+{
+#if defined(HAVE_GETCPUID) && (defined(ENABLE_AVX2) || defined(ENABLE_AVX512))
+    [[maybe_unused]] const X86VectorSupport vector_support{GetX86VectorSupport()};
+#if defined(ENABLE_AVX512)
+    if (vector_support.avx512f) return {8, siphash_avx512::SipHashUint256_8way};
+#endif
+#if defined(ENABLE_AVX2)
+    if (vector_support.avx2) return {4, siphash_avx2::SipHashUint256_4way};
+#endif
+#endif
+    return {};
+}
+} // namespace
+
+void SipHashUint256Batch(uint64_t k0, uint64_t k1, std::span<const uint256* const> vals, std::span<uint64_t> out)
+{
+    static const SipHashUint256Lanes impl{DetectSipHashUint256Lanes()};
+    assert(vals.size() == out.size());
+    size_t i{0};
+    if (impl.hash) {
+        for (; i + impl.lanes <= vals.size(); i += impl.lanes) {
+            impl.hash(k0, k1, &vals[i], &out[i]);
+        }
+    }
+    for (; i < vals.size(); ++i) {
+        out[i] = SipHashUint256(k0, k1, *vals[i]);
+    }
+}
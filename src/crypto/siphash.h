@@ -45,4 +45,12 @@ public:
 uint64_t SipHashUint256(uint64_t k0, uint64_t k1, const uint256& val);
 uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint32_t extra);
 
+/** Compute out[i] = SipHashUint256(k0, k1, *vals[i]) for all i.
+ *
+ *  Hashes 4 (AVX2) or 8 (AVX-512) values at once where supported, which is
+ *  considerably faster than hashing them one by one.
+ *  vals and out must have the same size.
+ */
+void SipHashUint256Batch(uint64_t k0, uint64_t k1, std::span<const uint256* const> vals, std::span<uint64_t> out);
+
 #endif // BITCOIN_CRYPTO_SIPHASH_H
@@ -0,0 +1,69 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX512
+
+#include <stdint.h>
+
+#include <attributes.h>
+#include <crypto/avx512.h>
+#include <uint256.h>
+
+namespace siphash_avx512 {
+namespace {
+
+__m512i inline K(uint64_t x) { return _mm512_set1_epi64(x); }
+__m512i inline Add(__m512i x, __m512i y) { return _mm512_add_epi64(x, y); }
+__m512i inline Xor(__m512i x, __m512i y) { return _mm512_xor_si512(x, y); }
+__m512i inline Rotl(__m512i x, int n) { return _mm512_rol_epi64(x, n); }
+
+void ALWAYS_INLINE SipRound(__m512i& v0, __m512i& v1, __m512i& v2, __m512i& v3)
+{
+    v0 = Add(v0, v1); v1 = Rotl(v1, 13); v1 = Xor(v1, v0);
+    v0 = Rotl(v0, 32);
+    v2 = Add(v2, v3); v3 = Rotl(v3, 16); v3 = Xor(v3, v2);
+    v0 = Add(v0, v3); v3 = Rotl(v3, 21); v3 = Xor(v3, v0);
+    v2 = Add(v2, v1); v1 = Rotl(v1, 17); v1 = Xor(v1, v2);
+    v2 = Rotl(v2, 32);
+}
+
+void ALWAYS_INLINE Compress(__m512i& v0, __m512i& v1, __m512i& v2, __m512i& v3, __m512i d)
+{
+    v3 = Xor(v3, d);
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    v0 = Xor(v0, d);
+}
+
+__m512i inline Read8(const uint256* const* vals, int pos)
+{
+    return _mm512_set_epi64(vals[7]->GetUint64(pos), vals[6]->GetUint64(pos), vals[5]->GetUint64(pos), vals[4]->GetUint64(pos),
+                            vals[3]->GetUint64(pos), vals[2]->GetUint64(pos), vals[1]->GetUint64(pos), vals[0]->GetUint64(pos));
+}
+
+}
+
+void SipHashUint256_8way(uint64_t k0, uint64_t k1, const uint256* const* vals, uint64_t* out)
+{
+    __m512i v0 = K(0x736f6d6570736575ULL ^ k0);
+    __m512i v1 = K(0x646f72616e646f6dULL ^ k1);
+    __m512i v2 = K(0x6c7967656e657261ULL ^ k0);
+    __m512i v3 = K(0x7465646279746573ULL ^ k1);
+
+    Compress(v0, v1, v2, v3, Read8(vals, 0));
+    Compress(v0, v1, v2, v3, Read8(vals, 1));
+    Compress(v0, v1, v2, v3, Read8(vals, 2));
+    Compress(v0, v1, v2, v3, Read8(vals, 3));
+    Compress(v0, v1, v2, v3, K(uint64_t{4} << 59));
+    v2 = Xor(v2, K(0xFF));
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    _mm512_storeu_si512(out, Xor(Xor(v0, v1), Xor(v2, v3)));
+}
+
+}
+
+#endif
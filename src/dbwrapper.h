@@ -28,6 +28,9 @@ static const size_t DBWRAPPER_MAX_FILE_SIZE = 32 << 20; // 32 MiB
 struct DBOptions {
     //! Compact database on startup.
     bool force_compact = false;
+    //! Maximum number of threads a single large compaction is split across
+    //! (leveldb::Options::max_subcompactions). 1 disables splitting.
+    int compaction_threads = 1;
 };
 
 //! Application-specific storage settings.
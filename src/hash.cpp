@@ -7,7 +7,10 @@
 #include <crypto/common.h>
 #include <crypto/hmac_sha512.h>
 
+#include <algorithm>
 #include <bit>
+#include <cassert>
+#include <cstring>
 #include <string>
 
 unsigned int MurmurHash3(unsigned int nHashSeed, std::span<const unsigned char> vDataToHash)
@@ -75,6 +78,24 @@ void BIP32Hash(const ChainCode &chainCode, unsigned int nChild, unsigned char he
     CHMAC_SHA512(chainCode.begin(), chainCode.size()).Write(&header, 1).Write(data, 32).Write(num, 4).Finalize(output);
 }
 
+void Hash160Batch(std::span<const std::span<const unsigned char>> in, std::span<uint160> out)
+{
+    assert(in.size() == out.size());
+    static constexpr size_t BATCH_SIZE{64};
+    unsigned char sha256[BATCH_SIZE * CSHA256::OUTPUT_SIZE];
+    unsigned char ripemd160[BATCH_SIZE * CRIPEMD160::OUTPUT_SIZE];
+    for (size_t i = 0; i < in.size(); i += BATCH_SIZE) {
+        const size_t count{std::min(BATCH_SIZE, in.size() - i)};
+        for (size_t j = 0; j < count; ++j) {
+            CSHA256().Write(in[i + j].data(), in[i + j].size()).Finalize(sha256 + j * CSHA256::OUTPUT_SIZE);
+        }
+        RIPEMD160_32(ripemd160, sha256, count);
+        for (size_t j = 0; j < count; ++j) {
+            std::memcpy(out[i + j].begin(), ripemd160 + j * CRIPEMD160::OUTPUT_SIZE, CRIPEMD160::OUTPUT_SIZE);
+        }
+    }
+}
+
 uint256 SHA256Uint256(const uint256& input)
 {
     uint256 result;
@@ -96,6 +96,14 @@ inline uint160 Hash160(const T1& in1)
     return result;
 }
 
+/** Compute out[i] = Hash160(in[i]) for all i.
+ *
+ *  The RIPEMD-160 step of all inputs is done in multi-buffer fashion, which
+ *  is considerably faster than hashing them one by one when deriving many
+ *  key or script identifiers at once. in and out must have the same size.
+ */
+void Hash160Batch(std::span<const std::span<const unsigned char>> in, std::span<uint160> out);
+
 /** A writer stream (for serialization) that computes a 256-bit hash. */
 class HashWriter
 {
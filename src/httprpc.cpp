@@ -9,6 +9,7 @@
 #include <httpserver.h>
 #include <logging.h>
 #include <netaddress.h>
+#include <rpc/jsonstream.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
 #include <util/fs.h>
@@ -97,6 +98,64 @@ static void JSONErrorReply(HTTPRequest* req, UniValue objError, const JSONRPCReq
     req->WriteReply(nStatus, strReply);
 }
 
+/**
+ * Execute a single request like JSONRPCExec, but let the method stream its result (see
+ * JSONRPCRequest::m_result_writer), in which case the reply is sent to the client piecewise, using
+ * chunked transfer encoding once it exceeds a single flush.
+ *
+ * @returns the reply to send as usual, or std::nullopt if it was already sent.
+ */
+static std::optional<UniValue> JSONRPCExecStreaming(HTTPRequest* req, JSONRPCRequest& jreq, bool catch_errors)
+{
+    bool finished{false};
+    JSONStreamWriter writer{[&](std::string&& chunk) {
+        if (finished) chunk += '\n';
+        if (!writer.Flushed()) {
+            req->WriteHeader("Content-Type", "application/json");
+            if (finished) {
+                req->WriteReply(HTTP_OK, chunk);
+                return;
+            }
+            req->StartChunkedReply(HTTP_OK);
+        }
+        req->WriteReplyChunk(chunk);
+        if (finished) req->EndChunkedReply();
+    }};
+    // Field order as in JSONRPCReplyObj.
+    writer.BeginObject();
+    if (jreq.m_json_version == JSONRPCVersion::V2) writer.KeyValue("jsonrpc", "2.0");
+    writer.Key("result");
+
+    UniValue reply;
+    jreq.m_result_writer = &writer;
+    try {
+        reply = JSONRPCExec(jreq, catch_errors);
+    } catch (...) {
+        jreq.m_result_writer = nullptr;
+        if (!writer.Flushed()) throw;
+        LogPrintf("RPC %s failed after part of its result was sent\n", jreq.strMethod);
+        req->EndChunkedReply();
+        return std::nullopt;
+    }
+    jreq.m_result_writer = nullptr;
+
+    // The method returned its result instead of streaming it.
+    if (writer.ExpectingValue()) return reply;
+    if (!reply.find_value("error").isNull() || writer.Depth() != 1) {
+        // Unless part of the result is on its way already, the error can be reported normally.
+        if (!writer.Flushed()) return reply;
+        LogPrintf("RPC %s failed after part of its result was sent\n", jreq.strMethod);
+        req->EndChunkedReply();
+        return std::nullopt;
+    }
+    if (jreq.m_json_version == JSONRPCVersion::V1_LEGACY) writer.KeyValue("error", NullUniValue);
+    if (jreq.id.has_value()) writer.KeyValue("id", jreq.id.value());
+    writer.EndObject();
+    finished = true;
+    writer.Flush();
+    return std::nullopt;
+}
+
 //This function checks username and password against -rpcauth
 //entries from config file.
 static bool CheckUserAuthorized(std::string_view user, std::string_view pass)
@@ -201,14 +260,18 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             // 2.0 behavior is to catch exceptions and return HTTP success with
             // RPC errors, as long as there is not an actual HTTP server error.
             const bool catch_errors{jreq.m_json_version == JSONRPCVersion::V2};
-            reply = JSONRPCExec(jreq, catch_errors);
 
             if (jreq.IsNotification()) {
+                JSONRPCExec(jreq, catch_errors);
                 // Even though we do execute notifications, we do not respond to them
                 req->WriteReply(HTTP_NO_CONTENT);
                 return true;
             }
 
+            std::optional<UniValue> unsent_reply{JSONRPCExecStreaming(req, jreq, catch_errors)};
+            if (!unsent_reply) return true;
+            reply = std::move(*unsent_reply);
+
         // array of requests
         } else if (valRequest.isArray()) {
             // Check authorization for each request's method
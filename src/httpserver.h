@@ -73,6 +73,8 @@ private:
     struct evhttp_request* req;
     const util::SignalInterrupt& m_interrupt;
     bool replySent;
+    //! Whether a chunked reply was started, but not ended yet.
+    bool m_chunked{false};
 
 public:
     explicit HTTPRequest(struct evhttp_request* req, const util::SignalInterrupt& interrupt, bool replySent = false);
@@ -143,6 +145,28 @@ public:
         WriteReply(nStatus, std::as_bytes(std::span{reply}));
     }
     void WriteReply(int nStatus, std::span<const std::byte> reply);
+
+    /**
+     * Start an HTTP reply whose body is sent in pieces, using chunked transfer encoding.
+     * nStatus is the HTTP status code to send.
+     *
+     * @note Use instead of WriteReply, followed by any number of calls to WriteReplyChunk
+     * and a single call to EndChunkedReply.
+     */
+    void StartChunkedReply(int nStatus);
+    /** Send a piece of the body of a reply started with StartChunkedReply. */
+    void WriteReplyChunk(std::span<const std::byte> chunk);
+    void WriteReplyChunk(std::string_view chunk)
+    {
+        WriteReplyChunk(std::as_bytes(std::span{chunk}));
+    }
+    /**
+     * Finish a reply started with StartChunkedReply.
+     *
+     * @note As this will give the request back to the main thread, do not call any other
+     * HTTPRequest methods after calling this.
+     */
+    void EndChunkedReply();
 };
 
 /** Get the query parameter value from request uri for a specified key, or std::nullopt if the key
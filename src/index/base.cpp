@@ -14,12 +14,15 @@
 #include <node/database_args.h>
 #include <node/interface_ui.h>
 #include <tinyformat.h>
+#include <undo.h>
 #include <util/string.h>
 #include <util/thread.h>
 #include <util/translation.h>
 #include <validation.h>
 
 #include <chrono>
+#include <deque>
+#include <future>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -31,6 +34,8 @@ constexpr uint8_t DB_BEST_BLOCK{'B'};
 
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
+//! Number of blocks read ahead of the block being indexed during sync
+constexpr size_t SYNC_READ_AHEAD_BLOCKS{8};
 
 template <typename... Args>
 void BaseIndex::FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args)
@@ -152,6 +157,20 @@ void BaseIndex::Sync()
     if (!m_synced) {
         std::chrono::steady_clock::time_point last_log_time{0s};
         std::chrono::steady_clock::time_point last_locator_write_time{0s};
+        // Blocks (and their undo data, if used) already being read from disk,
+        // starting with the next one to index
+        struct PendingRead {
+            const CBlockIndex* index;
+            std::future<std::optional<CBlock>> block;
+            std::future<std::optional<CBlockUndo>> undo;
+        };
+        std::deque<PendingRead> read_ahead;
+        const auto read_async{[&](const CBlockIndex& index) {
+            PendingRead read{&index, m_chainstate->m_blockman.ReadBlockAsync(index, /*use_arena=*/true), {}};
+            // The genesis block has no undo data
+            if (UsesUndoData() && index.nHeight > 0) read.undo = m_chainstate->m_blockman.ReadBlockUndoAsync(index);
+            return read;
+        }};
         while (true) {
             if (m_interrupt) {
                 LogPrintf("%s: m_interrupt set; exiting ThreadSync\n", GetName());
@@ -190,15 +209,40 @@ void BaseIndex::Sync()
             }
             pindex = pindex_next;
 
+            // Discard reads past a block that is no longer in the active chain
+            if (!read_ahead.empty() && read_ahead.front().index != pindex) read_ahead.clear();
+            if (read_ahead.empty()) {
+                read_ahead.push_back(read_async(*pindex));
+            }
+            {
+                LOCK(::cs_main);
+                while (read_ahead.size() < SYNC_READ_AHEAD_BLOCKS) {
+                    const CBlockIndex* next{m_chainstate->m_chain.Next(read_ahead.back().index)};
+                    if (!next) break;
+                    read_ahead.push_back(read_async(*next));
+                }
+            }
+            PendingRead read{std::move(read_ahead.front())};
+            read_ahead.pop_front();
+            const std::optional<CBlock> block{read.block.get()};
 
-            CBlock block;
             interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex);
-            if (!m_chainstate->m_blockman.ReadBlock(block, *pindex)) {
+            if (!block) {
                 FatalErrorf("%s: Failed to read block %s from disk",
                            __func__, pindex->GetBlockHash().ToString());
                 return;
             } else {
-                block_info.data = &block;
+                block_info.data = &*block;
+            }
+            std::optional<CBlockUndo> block_undo;
+            if (read.undo.valid()) {
+                block_undo = read.undo.get();
+                if (!block_undo) {
+                    FatalErrorf("%s: Failed to read undo data of block %s from disk",
+                               __func__, pindex->GetBlockHash().ToString());
+                    return;
+                }
+                block_info.undo_data = &*block_undo;
             }
             if (!CustomAppend(block_info)) {
                 FatalErrorf("%s: Failed to write block %s to index database",
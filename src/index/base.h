@@ -113,6 +113,11 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Whether CustomAppend() uses the undo data of blocks. If so, Sync() reads
+    /// it ahead along with the blocks and passes it in BlockInfo::undo_data.
+    /// Blocks connected after the index is synced are passed without it.
+    virtual bool UsesUndoData() const { return false; }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
@@ -79,16 +79,38 @@ bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRe
         return false;
     }
 
-    AutoFile file{m_chainstate->m_blockman.OpenBlockFile(postx, true)};
+    if (postx.nPos < node::STORAGE_HEADER_BYTES) {
+        LogError("%s: Invalid transaction position\n", __func__);
+        return false;
+    }
+    AutoFile file{m_chainstate->m_blockman.OpenBlockFile({postx.nFile, postx.nPos - node::STORAGE_HEADER_BYTES}, true)};
     if (file.IsNull()) {
         LogError("%s: OpenBlockFile failed\n", __func__);
         return false;
     }
     CBlockHeader header;
     try {
-        file >> header;
-        file.seek(postx.nTxOffset, SEEK_CUR);
-        file >> TX_WITH_WITNESS(tx);
+        MessageStartChars blk_start;
+        uint32_t blk_size;
+        file >> blk_start >> blk_size;
+        if (blk_size & node::BLOCK_COMPRESSED_FLAG) {
+            // The transaction offset refers to the uncompressed block, so read it as a whole.
+            std::vector<uint8_t> block_data;
+            if (!m_chainstate->m_blockman.ReadRawBlock(block_data, postx)) {
+                return false;
+            }
+            SpanReader reader{block_data};
+            reader >> header;
+            if (postx.nTxOffset > reader.size()) {
+                throw std::ios_base::failure("transaction offset beyond end of block");
+            }
+            reader.ignore(postx.nTxOffset);
+            reader >> TX_WITH_WITNESS(tx);
+        } else {
+            file >> header;
+            file.seek(postx.nTxOffset, SEEK_CUR);
+            file >> TX_WITH_WITNESS(tx);
+        }
     } catch (const std::exception& e) {
         LogError("%s: Deserialize or I/O error - %s\n", __func__, e.what());
         return false;
@@ -13,6 +13,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <optional>
@@ -166,6 +167,12 @@ public:
     //! or contents.
     virtual bool findBlock(const uint256& hash, const FoundBlock& block={}) = 0;
 
+    //! Start reading the contents of a block on the node's block read
+    //! threads, so that callers walking the chain can keep several reads in
+    //! flight. The result is std::nullopt if the block is unknown or could
+    //! not be read.
+    virtual std::future<std::optional<CBlock>> readBlockAsync(const uint256& hash) = 0;
+
     //! Find first block in the chain with timestamp >= the given time
     //! and height >= than the given height, return false if there is no block
     //! with a high enough timestamp and height. Optionally return block
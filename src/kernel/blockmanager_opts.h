@@ -16,6 +16,7 @@ class CChainParams;
 namespace kernel {
 
 static constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
+static constexpr bool DEFAULT_BLOCK_COMPRESSION{false};
 
 /**
  * An options struct for `BlockManager`, more ergonomically referred to as
@@ -24,6 +25,7 @@ static constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
 struct BlockManagerOpts {
     const CChainParams& chainparams;
     bool use_xor{DEFAULT_XOR_BLOCKSDIR};
+    bool compress_blocks{DEFAULT_BLOCK_COMPRESSION};
     uint64_t prune_target{0};
     bool fast_prune{false};
     const fs::path blocks_dir;
@@ -40,7 +40,7 @@ struct ChainstateManagerOpts {
     std::optional<uint256> assumed_valid_block{};
     //! If the tip is older than this, the node is considered to be in initial block download.
     std::chrono::seconds max_tip_age{DEFAULT_MAX_TIP_AGE};
-    DBOptions coins_db{};
+    DBOptions coins_db{.compaction_threads = DEFAULT_COINS_DB_COMPACTION_THREADS};
     CoinsViewOptions coins_view{};
     Notifications& notifications;
     ValidationSignals* signals{nullptr};
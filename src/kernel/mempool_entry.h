@@ -13,11 +13,11 @@
 #include <primitives/transaction.h>
 #include <util/epochguard.h>
 #include <util/overflow.h>
+#include <util/sortedvectorset.h>
 
 #include <chrono>
 #include <functional>
 #include <memory>
-#include <set>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -66,9 +66,10 @@ class CTxMemPoolEntry
 {
 public:
     typedef std::reference_wrapper<const CTxMemPoolEntry> CTxMemPoolEntryRef;
-    // two aliases, should the types ever diverge
-    typedef std::set<CTxMemPoolEntryRef, CompareIteratorByHash> Parents;
-    typedef std::set<CTxMemPoolEntryRef, CompareIteratorByHash> Children;
+    // two aliases, should the types ever diverge. Most transactions have few
+    // in-mempool parents and children, so these are kept as sorted vectors.
+    typedef SortedVectorSet<CTxMemPoolEntryRef, CompareIteratorByHash> Parents;
+    typedef SortedVectorSet<CTxMemPoolEntryRef, CompareIteratorByHash> Children;
 
 private:
     CTxMemPoolEntry(const CTxMemPoolEntry&) = default;
@@ -81,12 +82,12 @@ private:
     mutable Children m_children;
     const CAmount nFee;             //!< Cached to avoid expensive parent-transaction lookups
     const int32_t nTxWeight;         //!< ... and avoid recomputing tx weight (also used for GetTxSize())
+    const unsigned int entryHeight; //!< Chain height when entering the mempool
     const size_t nUsageSize;        //!< ... and total memory usage
     const int64_t nTime;            //!< Local time when entering the mempool
     const uint64_t entry_sequence;  //!< Sequence number used to determine whether this transaction is too recent for relay
-    const unsigned int entryHeight; //!< Chain height when entering the mempool
-    const bool spendsCoinbase;      //!< keep track of transactions that spend a coinbase
     const int64_t sigOpCost;        //!< Total sigop cost
+    const bool spendsCoinbase;      //!< keep track of transactions that spend a coinbase
     CAmount m_modified_fee;         //!< Used for determining the priority of the transaction for mining in a block
     mutable LockPoints lockPoints;  //!< Track the height and time at which tx was final
 
@@ -113,12 +114,12 @@ public:
         : tx{tx},
           nFee{fee},
           nTxWeight{GetTransactionWeight(*tx)},
+          entryHeight{entry_height},
           nUsageSize{RecursiveDynamicUsage(tx)},
           nTime{time},
           entry_sequence{entry_sequence},
-          entryHeight{entry_height},
-          spendsCoinbase{spends_coinbase},
           sigOpCost{sigops_cost},
+          spendsCoinbase{spends_coinbase},
           m_modified_fee{nFee},
           lockPoints{lp},
           nSizeWithDescendants{GetTxSize()},
@@ -23,6 +23,7 @@
 #include "db/table_cache.h"
 #include "db/version_set.h"
 #include "db/write_batch_internal.h"
+#include "leveldb/comparator.h"
 #include "leveldb/db.h"
 #include "leveldb/env.h"
 #include "leveldb/status.h"
@@ -84,6 +85,19 @@ struct DBImpl::CompactionState {
   TableBuilder* builder;
 
   uint64_t total_bytes;
+
+  // Position in the key range of the compaction processed so far
+  Compaction::Cursor cursor;
+};
+
+// A subcompaction running on a thread of its own, see DoCompactionWork()
+struct DBImpl::Subcompaction {
+  DBImpl* db;
+  CompactionState* compact;
+  const Slice* begin;
+  const Slice* end;
+  Iterator* input;
+  Status status;
 };
 
 // Fix user-supplied options to be reasonable
@@ -103,6 +117,7 @@ Options SanitizeOptions(const std::string& dbname,
   ClipToRange(&result.write_buffer_size, 64 << 10, 1 << 30);
   ClipToRange(&result.max_file_size, 1 << 20, 1 << 30);
   ClipToRange(&result.block_size, 1 << 10, 4 << 20);
+  ClipToRange(&result.max_subcompactions, 1, 64);
   if (result.info_log == nullptr) {
     // Open a log file in the same directory as the db
     src.env->CreateDir(dbname);  // In case it does not exist
@@ -137,6 +152,8 @@ DBImpl::DBImpl(const Options& raw_options, const std::string& dbname)
       db_lock_(nullptr),
       shutting_down_(false),
       background_work_finished_signal_(&mutex_),
+      subcompaction_signal_(&mutex_),
+      subcompactions_running_(0),
       mem_(nullptr),
       imm_(nullptr),
       has_imm_(false),
@@ -676,6 +693,18 @@ void DBImpl::BGWork(void* db) {
   reinterpret_cast<DBImpl*>(db)->BackgroundCall();
 }
 
+void DBImpl::RunSubcompaction(void* arg) {
+  Subcompaction* sub = reinterpret_cast<Subcompaction*>(arg);
+  DBImpl* db = sub->db;
+  sub->status = db->DoSubcompactionWork(sub->compact, sub->begin, sub->end,
+                                        sub->input, nullptr);
+  // *sub may be destroyed as soon as the mutex is released
+  db->mutex_.Lock();
+  db->subcompactions_running_--;
+  db->subcompaction_signal_.Signal();
+  db->mutex_.Unlock();
+}
+
 void DBImpl::BackgroundCall() {
   MutexLock l(&mutex_);
   assert(background_compaction_scheduled_);
@@ -885,6 +914,21 @@ Status DBImpl::InstallCompactionResults(CompactionState* compact) {
   return versions_->LogAndApply(compact->compaction->edit(), &mutex_);
 }
 
+void DBImpl::CompactMemTableDuringCompaction(int64_t* imm_micros) {
+  // Prioritize immutable compaction work
+  if (has_imm_.load(std::memory_order_relaxed)) {
+    const uint64_t imm_start = env_->NowMicros();
+    mutex_.Lock();
+    if (imm_ != nullptr) {
+      CompactMemTable();
+      // Wake up MakeRoomForWrite() if necessary.
+      background_work_finished_signal_.SignalAll();
+    }
+    mutex_.Unlock();
+    *imm_micros += (env_->NowMicros() - imm_start);
+  }
+}
+
 Status DBImpl::DoCompactionWork(CompactionState* compact) {
   const uint64_t start_micros = env_->NowMicros();
   int64_t imm_micros = 0;  // Micros spent doing imm_ compactions
@@ -903,33 +947,234 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
     compact->smallest_snapshot = snapshots_.oldest()->sequence_number();
   }
 
-  Iterator* input = versions_->MakeInputIterator(compact->compaction);
+  // Split a large compaction into subcompactions over disjoint user key
+  // ranges, bounded by boundaries[i - 1] and boundaries[i].  Subcompaction 0
+  // runs on this thread and writes to *compact, the others run on threads
+  // of their own.
+  std::vector<std::string> boundaries;
+  ComputeSubcompactionBoundaries(compact->compaction, &boundaries);
+  std::vector<CompactionState*> subcompacts;
+  std::vector<Iterator*> inputs;
+  inputs.push_back(versions_->MakeInputIterator(compact->compaction));
+  for (size_t i = 0; i < boundaries.size(); i++) {
+    CompactionState* sub = new CompactionState(compact->compaction);
+    sub->smallest_snapshot = compact->smallest_snapshot;
+    subcompacts.push_back(sub);
+    inputs.push_back(versions_->MakeInputIterator(compact->compaction));
+  }
+  if (!subcompacts.empty()) {
+    Log(options_.info_log, "Compacting in %d subcompactions",
+        static_cast<int>(subcompacts.size() + 1));
+  }
+
+  std::vector<Subcompaction> subs(subcompacts.size());
+  std::vector<Slice> bounds(boundaries.begin(), boundaries.end());
+  for (size_t i = 0; i < subcompacts.size(); i++) {
+    subs[i].db = this;
+    subs[i].compact = subcompacts[i];
+    subs[i].begin = &bounds[i];
+    subs[i].end = i + 1 < bounds.size() ? &bounds[i + 1] : nullptr;
+    subs[i].input = inputs[i + 1];
+  }
+  subcompactions_running_ = static_cast<int>(subs.size());
 
   // Release mutex while we're actually doing the compaction work
   mutex_.Unlock();
 
-  input->SeekToFirst();
+  for (size_t i = 0; i < subs.size(); i++) {
+    env_->StartThread(&DBImpl::RunSubcompaction, &subs[i]);
+  }
+  Status status = DoSubcompactionWork(
+      compact, nullptr, bounds.empty() ? nullptr : &bounds[0], inputs[0],
+      &imm_micros);
+
+  // Keep flushing the memtable while the other subcompactions finish.  If
+  // flushing failed, imm_ is left in place, so only wait for them then.
+  mutex_.Lock();
+  while (subcompactions_running_ > 0) {
+    if (imm_ != nullptr && bg_error_.ok() &&
+        !shutting_down_.load(std::memory_order_acquire)) {
+      const uint64_t imm_start = env_->NowMicros();
+      CompactMemTable();
+      // Wake up MakeRoomForWrite() if necessary.
+      background_work_finished_signal_.SignalAll();
+      imm_micros += (env_->NowMicros() - imm_start);
+    } else {
+      subcompaction_signal_.Wait();
+    }
+  }
+  mutex_.Unlock();
+  for (size_t i = 0; i < inputs.size(); i++) {
+    delete inputs[i];
+  }
+
+  // Collect the output files of all subcompactions, in key order.  Files of
+  // failed subcompactions are still needed by CleanupCompaction().
+  for (size_t i = 0; i < subcompacts.size(); i++) {
+    CompactionState* sub = subcompacts[i];
+    if (status.ok()) {
+      status = subs[i].status;
+    }
+    if (sub->builder != nullptr) {
+      sub->builder->Abandon();
+      delete sub->builder;
+    }
+    delete sub->outfile;
+    compact->outputs.insert(compact->outputs.end(), sub->outputs.begin(),
+                            sub->outputs.end());
+    compact->total_bytes += sub->total_bytes;
+    delete sub;
+  }
+
+  CompactionStats stats;
+  stats.micros = env_->NowMicros() - start_micros - imm_micros;
+  for (int which = 0; which < 2; which++) {
+    for (int i = 0; i < compact->compaction->num_input_files(which); i++) {
+      stats.bytes_read += compact->compaction->input(which, i)->file_size;
+    }
+  }
+  for (size_t i = 0; i < compact->outputs.size(); i++) {
+    stats.bytes_written += compact->outputs[i].file_size;
+  }
+
+  mutex_.Lock();
+  stats_[compact->compaction->level() + 1].Add(stats);
+
+  if (status.ok()) {
+    status = InstallCompactionResults(compact);
+  }
+  if (!status.ok()) {
+    RecordBackgroundError(status);
+  }
+  VersionSet::LevelSummaryStorage tmp;
+  Log(options_.info_log, "compacted to: %s", versions_->LevelSummary(&tmp));
+  return status;
+}
+
+void DBImpl::ComputeSubcompactionBoundaries(
+    Compaction* c, std::vector<std::string>* boundaries) {
+  if (options_.max_subcompactions <= 1) return;
+
+  // Don't bother splitting small compactions
+  static const uint64_t kMinSubcompactionBytes = 4 << 20;
+  uint64_t input_bytes = 0;
+  std::vector<const FileMetaData*> files;
+  for (int which = 0; which < 2; which++) {
+    for (int i = 0; i < c->num_input_files(which); i++) {
+      files.push_back(c->input(which, i));
+      input_bytes += files.back()->file_size;
+    }
+  }
+  const uint64_t n = std::min<uint64_t>(options_.max_subcompactions,
+                                        input_bytes / kMinSubcompactionBytes);
+  if (n <= 1) return;
+
+  // Keys are not spread evenly over the key space (e.g. several kinds of
+  // keys told apart by their first byte), so balance the subcompactions by
+  // input bytes.  Candidate split points are the boundary keys of the input
+  // files and keys sampled from their indexes, a few per subcompaction in
+  // proportion to the size of each file.  The input bytes before each
+  // candidate are estimated from the indexes too.
+  const Comparator* ucmp = user_comparator();
+  std::vector<Table*> tables(files.size(), nullptr);
+  std::vector<Iterator*> table_iters(files.size(), nullptr);
+  std::vector<std::string> candidates;
+  for (size_t i = 0; i < files.size(); i++) {
+    const FileMetaData* f = files[i];
+    candidates.push_back(f->smallest.user_key().ToString());
+    candidates.push_back(f->largest.user_key().ToString());
+    table_iters[i] = table_cache_->NewIterator(ReadOptions(), f->number,
+                                               f->file_size, &tables[i]);
+    if (tables[i] != nullptr) {
+      std::vector<std::string> index_keys;
+      tables[i]->SampleIndexKeys(
+          static_cast<int>(4 * n * f->file_size / input_bytes), &index_keys);
+      for (const std::string& index_key : index_keys) {
+        candidates.push_back(ExtractUserKey(index_key).ToString());
+      }
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [ucmp](const std::string& a, const std::string& b) {
+              return ucmp->Compare(a, b) < 0;
+            });
+  candidates.erase(std::unique(candidates.begin(), candidates.end(),
+                               [ucmp](const std::string& a,
+                                      const std::string& b) {
+                                 return ucmp->Compare(a, b) == 0;
+                               }),
+                   candidates.end());
+
+  std::vector<uint64_t> bytes_before(candidates.size(), 0);
+  for (size_t j = 1; j < candidates.size(); j++) {
+    const Slice key(candidates[j]);
+    const InternalKey ikey(key, kMaxSequenceNumber, kValueTypeForSeek);
+    for (size_t i = 0; i < files.size(); i++) {
+      const FileMetaData* f = files[i];
+      if (ucmp->Compare(f->largest.user_key(), key) < 0) {
+        bytes_before[j] += f->file_size;
+      } else if (ucmp->Compare(f->smallest.user_key(), key) < 0 &&
+                 tables[i] != nullptr) {
+        bytes_before[j] += tables[i]->ApproximateOffsetOf(ikey.Encode());
+      }
+    }
+  }
+
+  // Split at the candidates closest to multiples of input_bytes / n.  All
+  // entries of one user key end up in the same subcompaction, as the ranges
+  // are delimited by user keys.  The smallest and largest keys of the
+  // compaction are not used, and neither are candidates that would leave a
+  // subcompaction without input, so that none of them is empty.
+  size_t last = 0;
+  for (uint64_t k = 1; k < n; k++) {
+    const uint64_t target = input_bytes / n * k;
+    size_t best = 0;
+    for (size_t j = last + 1; j + 1 < candidates.size(); j++) {
+      if (bytes_before[j] <= bytes_before[last]) continue;
+      const uint64_t distance = bytes_before[j] > target
+                                    ? bytes_before[j] - target
+                                    : target - bytes_before[j];
+      const uint64_t best_distance =
+          bytes_before[best] > target ? bytes_before[best] - target
+                                      : target - bytes_before[best];
+      if (best == 0 || distance < best_distance) best = j;
+      if (bytes_before[j] >= target) break;
+    }
+    if (best == 0) break;
+    boundaries->push_back(candidates[best]);
+    last = best;
+  }
+  for (Iterator* iter : table_iters) {
+    delete iter;
+  }
+}
+
+Status DBImpl::DoSubcompactionWork(CompactionState* compact,
+                                   const Slice* begin, const Slice* end,
+                                   Iterator* input, int64_t* imm_micros) {
+  if (begin != nullptr) {
+    InternalKey start(*begin, kMaxSequenceNumber, kValueTypeForSeek);
+    input->Seek(start.Encode());
+  } else {
+    input->SeekToFirst();
+  }
   Status status;
   ParsedInternalKey ikey;
   std::string current_user_key;
   bool has_current_user_key = false;
   SequenceNumber last_sequence_for_key = kMaxSequenceNumber;
   while (input->Valid() && !shutting_down_.load(std::memory_order_acquire)) {
-    // Prioritize immutable compaction work
-    if (has_imm_.load(std::memory_order_relaxed)) {
-      const uint64_t imm_start = env_->NowMicros();
-      mutex_.Lock();
-      if (imm_ != nullptr) {
-        CompactMemTable();
-        // Wake up MakeRoomForWrite() if necessary.
-        background_work_finished_signal_.SignalAll();
-      }
-      mutex_.Unlock();
-      imm_micros += (env_->NowMicros() - imm_start);
+    if (imm_micros != nullptr) {
+      CompactMemTableDuringCompaction(imm_micros);
     }
 
     Slice key = input->key();
-    if (compact->compaction->ShouldStopBefore(key) &&
+    if (end != nullptr && key.size() >= 8 &&
+        user_comparator()->Compare(ExtractUserKey(key), *end) >= 0) {
+      // Reached the range of the next subcompaction
+      break;
+    }
+    if (compact->compaction->ShouldStopBefore(key, &compact->cursor) &&
         compact->builder != nullptr) {
       status = FinishCompactionOutputFile(compact, input);
       if (!status.ok()) {
@@ -959,7 +1204,8 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
         drop = true;  // (A)
       } else if (ikey.type == kTypeDeletion &&
                  ikey.sequence <= compact->smallest_snapshot &&
-                 compact->compaction->IsBaseLevelForKey(ikey.user_key)) {
+                 compact->compaction->IsBaseLevelForKey(ikey.user_key,
+                                                        &compact->cursor)) {
         // For this user key:
         // (1) there is no data in higher levels
         // (2) data in lower levels will have larger sequence numbers
@@ -978,7 +1224,7 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
         "%d smallest_snapshot: %d",
         ikey.user_key.ToString().c_str(),
         (int)ikey.sequence, ikey.type, kTypeValue, drop,
-        compact->compaction->IsBaseLevelForKey(ikey.user_key),
+        compact->compaction->IsBaseLevelForKey(ikey.user_key, &compact->cursor),
         (int)last_sequence_for_key, (int)compact->smallest_snapshot);
 #endif
 
@@ -1018,31 +1264,6 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
   if (status.ok()) {
     status = input->status();
   }
-  delete input;
-  input = nullptr;
-
-  CompactionStats stats;
-  stats.micros = env_->NowMicros() - start_micros - imm_micros;
-  for (int which = 0; which < 2; which++) {
-    for (int i = 0; i < compact->compaction->num_input_files(which); i++) {
-      stats.bytes_read += compact->compaction->input(which, i)->file_size;
-    }
-  }
-  for (size_t i = 0; i < compact->outputs.size(); i++) {
-    stats.bytes_written += compact->outputs[i].file_size;
-  }
-
-  mutex_.Lock();
-  stats_[compact->compaction->level() + 1].Add(stats);
-
-  if (status.ok()) {
-    status = InstallCompactionResults(compact);
-  }
-  if (!status.ok()) {
-    RecordBackgroundError(status);
-  }
-  VersionSet::LevelSummaryStorage tmp;
-  Log(options_.info_log, "compacted to: %s", versions_->LevelSummary(&tmp));
   return status;
 }
 
@@ -1371,6 +1592,10 @@ Status DBImpl::MakeRoomForWrite(bool force) {
       log_ = new log::Writer(lfile);
       imm_ = mem_;
       has_imm_.store(true, std::memory_order_release);
+      if (subcompactions_running_ > 0) {
+        // Have the compaction flush it
+        subcompaction_signal_.Signal();
+      }
       mem_ = new MemTable(internal_comparator_);
       mem_->Ref();
       force = false;  // Do not force another compaction if have room
@@ -9,6 +9,7 @@
 #include <deque>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "db/dbformat.h"
 #include "db/log_writer.h"
@@ -20,6 +21,7 @@
 
 namespace leveldb {
 
+class Compaction;
 class MemTable;
 class TableCache;
 class Version;
@@ -74,6 +76,7 @@ class DBImpl : public DB {
  private:
   friend class DB;
   struct CompactionState;
+  struct Subcompaction;
   struct Writer;
 
   // Information for a manual compaction
@@ -139,12 +142,32 @@ class DBImpl : public DB {
 
   void MaybeScheduleCompaction() EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   static void BGWork(void* db);
+  // Body of the threads running subcompactions, arg is a Subcompaction*.
+  static void RunSubcompaction(void* arg);
   void BackgroundCall();
   void BackgroundCompaction() EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   void CleanupCompaction(CompactionState* compact)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   Status DoCompactionWork(CompactionState* compact)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Compact the immutable memtable, if any, from within a running
+  // compaction, adding the time spent to *imm_micros.
+  void CompactMemTableDuringCompaction(int64_t* imm_micros)
+      LOCKS_EXCLUDED(mutex_);
+  // Choose the user keys at which to split the compaction into
+  // subcompactions, see Options::max_subcompactions.  Leaves *boundaries
+  // empty if the compaction should not be split.
+  void ComputeSubcompactionBoundaries(Compaction* c,
+                                      std::vector<std::string>* boundaries)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Merge the inputs of a compaction with user keys in [*begin,*end) into
+  // the output files of *compact.  begin == nullptr means before all keys,
+  // end == nullptr means after all keys.  Only the subcompaction running on
+  // the background thread passes imm_micros, and compacts the memtable when
+  // needed.
+  Status DoSubcompactionWork(CompactionState* compact, const Slice* begin,
+                             const Slice* end, Iterator* input,
+                             int64_t* imm_micros) LOCKS_EXCLUDED(mutex_);
 
   Status OpenCompactionOutputFile(CompactionState* compact);
   Status FinishCompactionOutputFile(CompactionState* compact, Iterator* input);
@@ -174,6 +197,10 @@ class DBImpl : public DB {
   port::Mutex mutex_;
   std::atomic<bool> shutting_down_;
   port::CondVar background_work_finished_signal_ GUARDED_BY(mutex_);
+  // Signalled when a subcompaction finishes or the memtable becomes immutable
+  // while subcompactions are running.
+  port::CondVar subcompaction_signal_ GUARDED_BY(mutex_);
+  int subcompactions_running_ GUARDED_BY(mutex_);
   MemTable* mem_;
   MemTable* imm_ GUARDED_BY(mutex_);  // Memtable being compacted
   std::atomic<bool> has_imm_;         // So bg thread can detect non-null imm_
@@ -114,6 +114,14 @@ struct LEVELDB_EXPORT Options {
   // initially populating a large database.
   size_t max_file_size = 2 * 1024 * 1024;
 
+  // Maximum number of threads a single compaction is split across.  A
+  // large compaction (such as one merging level-0 files spanning the whole
+  // key space into level 1) is divided into subcompactions covering
+  // disjoint key ranges, which write their output files in parallel.
+  // This shortens the time writes are slowed down or stopped while
+  // level-0 files pile up.  A value of 1 disables subcompactions.
+  int max_subcompactions = 1;
+
   // Compress blocks using the specified compression algorithm.  This
   // parameter can be changed dynamically.
   //
@@ -7,6 +7,9 @@
 
 #include <stdint.h>
 
+#include <string>
+#include <vector>
+
 #include "leveldb/export.h"
 #include "leveldb/iterator.h"
 
@@ -58,6 +61,11 @@ class LEVELDB_EXPORT Table {
   // be close to the file length.
   uint64_t ApproximateOffsetOf(const Slice& key) const;
 
+  // Append to *keys the keys of at most max_keys entries of the table's
+  // index, spread evenly over it.  Each index key separates two data
+  // blocks, so these split the table into parts of about the same size.
+  void SampleIndexKeys(int max_keys, std::vector<std::string>* keys) const;
+
  private:
   friend class TableCache;
   struct Rep;
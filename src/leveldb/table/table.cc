@@ -4,6 +4,8 @@
 
 #include "leveldb/table.h"
 
+#include <algorithm>
+
 #include "leveldb/cache.h"
 #include "leveldb/comparator.h"
 #include "leveldb/env.h"
@@ -270,4 +272,24 @@ uint64_t Table::ApproximateOffsetOf(const Slice& key) const {
   return result;
 }
 
+void Table::SampleIndexKeys(int max_keys,
+                            std::vector<std::string>* keys) const {
+  if (max_keys <= 0) return;
+  Iterator* index_iter =
+      rep_->index_block->NewIterator(rep_->options.comparator);
+  int num_entries = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    num_entries++;
+  }
+  // The last entry follows the last data block, so it splits nothing.
+  const int stride = std::max(1, num_entries / (max_keys + 1));
+  int i = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    if (++i % stride == 0 && i < num_entries && max_keys-- > 0) {
+      keys->push_back(index_iter->key().ToString());
+    }
+  }
+  delete index_iter;
+}
+
 }  // namespace leveldb
@@ -8,6 +8,7 @@
 #include <indirectmap.h>
 #include <prevector.h>
 #include <support/allocators/pool.h>
+#include <util/sortedvectorset.h>
 
 #include <cassert>
 #include <cstdlib>
@@ -121,6 +122,12 @@ static inline size_t IncrementalDynamicUsage(const std::set<X, Y>& s)
     return MallocUsage(sizeof(stl_tree_node<X>));
 }
 
+template<typename X, typename Y>
+static inline size_t DynamicUsage(const SortedVectorSet<X, Y>& s)
+{
+    return MallocUsage(s.capacity() * sizeof(X));
+}
+
 template<typename X, typename Y, typename Z>
 static inline size_t DynamicUsage(const std::map<X, Y, Z>& m)
 {
@@ -833,13 +833,8 @@ CNetMessage V1Transport::GetReceivedMessage(const std::chrono::microseconds time
     return msg;
 }
 
-bool V1Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
+std::vector<uint8_t> V1Transport::MakeHeader(const CSerializedNetMsg& msg) const noexcept
 {
-    AssertLockNotHeld(m_send_mutex);
-    // Determine whether a new message can be set.
-    LOCK(m_send_mutex);
-    if (m_sending_header || m_bytes_sent < m_message_to_send.data.size()) return false;
-
     // create dbl-sha256 checksum
     uint256 hash = Hash(msg.data);
 
@@ -848,16 +843,49 @@ bool V1Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
     memcpy(hdr.pchChecksum, hash.begin(), CMessageHeader::CHECKSUM_SIZE);
 
     // serialize header
-    m_header_to_send.clear();
-    VectorWriter{m_header_to_send, 0, hdr};
+    std::vector<uint8_t> header;
+    VectorWriter{header, 0, hdr};
+    return header;
+}
+
+bool V1Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
+{
+    AssertLockNotHeld(m_send_mutex);
+    // Determine whether a new message can be set.
+    LOCK(m_send_mutex);
+    if (!SendIdle()) return false;
 
     // update state
+    m_header_to_send = MakeHeader(msg);
     m_message_to_send = std::move(msg);
     m_sending_header = true;
     m_bytes_sent = 0;
     return true;
 }
 
+bool V1Transport::QueueMessageToSend(CSerializedNetMsg& msg, size_t max_queued_bytes) noexcept
+{
+    AssertLockNotHeld(m_send_mutex);
+    LOCK(m_send_mutex);
+    if (SendIdle()) {
+        m_header_to_send = MakeHeader(msg);
+        m_message_to_send = std::move(msg);
+        m_sending_header = true;
+        m_bytes_sent = 0;
+        return true;
+    }
+
+    // Bytes still to be sent for the current message, and the ones queued behind it.
+    const size_t queued_bytes{(m_sending_header ? m_header_to_send.size() : 0) + m_message_to_send.data.size() - m_bytes_sent + m_send_queue_bytes};
+    if (queued_bytes >= max_queued_bytes) return false;
+
+    auto header{MakeHeader(msg)};
+    m_send_queue_bytes += header.size() + msg.data.size();
+    m_send_queue_memusage += msg.GetMemoryUsage();
+    m_send_queue.emplace_back(std::move(header), std::move(msg));
+    return true;
+}
+
 Transport::BytesToSend V1Transport::GetBytesToSend(bool have_next_message) const noexcept
 {
     AssertLockNotHeld(m_send_mutex);
@@ -866,41 +894,80 @@ Transport::BytesToSend V1Transport::GetBytesToSend(bool have_next_message) const
         return {std::span{m_header_to_send}.subspan(m_bytes_sent),
                 // We have more to send after the header if the message has payload, or if there
                 // is a next message after that.
-                have_next_message || !m_message_to_send.data.empty(),
+                have_next_message || !m_message_to_send.data.empty() || !m_send_queue.empty(),
                 m_message_to_send.m_type
                };
     } else {
         return {std::span{m_message_to_send.data}.subspan(m_bytes_sent),
                 // We only have more to send after this message's payload if there is another
                 // message.
-                have_next_message,
+                have_next_message || !m_send_queue.empty(),
                 m_message_to_send.m_type
                };
     }
 }
 
+bool V1Transport::GetBytesToSendBuffers(std::vector<SendBuffer>& buffers, bool have_next_message, size_t max_buffers) const noexcept
+{
+    AssertLockNotHeld(m_send_mutex);
+    LOCK(m_send_mutex);
+    const size_t max_size{buffers.size() + max_buffers};
+    // Add a buffer if non-empty, and return false if it didn't fit.
+    const auto add{[&](std::span<const uint8_t> data, const std::string& msg_type) {
+        if (data.empty()) return true;
+        if (buffers.size() == max_size) return false;
+        buffers.push_back({data, &msg_type});
+        return true;
+    }};
+
+    if (m_sending_header && !add(std::span{m_header_to_send}.subspan(m_bytes_sent), m_message_to_send.m_type)) return true;
+    if (!add(std::span{m_message_to_send.data}.subspan(m_sending_header ? 0 : m_bytes_sent), m_message_to_send.m_type)) return true;
+    for (const auto& [header, msg] : m_send_queue) {
+        if (!add(header, msg.m_type) || !add(msg.data, msg.m_type)) return true;
+    }
+    return have_next_message;
+}
+
 void V1Transport::MarkBytesSent(size_t bytes_sent) noexcept
 {
     AssertLockNotHeld(m_send_mutex);
     LOCK(m_send_mutex);
-    m_bytes_sent += bytes_sent;
-    if (m_sending_header && m_bytes_sent == m_header_to_send.size()) {
-        // We're done sending a message's header. Switch to sending its data bytes.
-        m_sending_header = false;
-        m_bytes_sent = 0;
-    } else if (!m_sending_header && m_bytes_sent == m_message_to_send.data.size()) {
-        // We're done sending a message's data. Wipe the data vector to reduce memory consumption.
-        ClearShrink(m_message_to_send.data);
-        m_bytes_sent = 0;
+    // The bytes may span several messages if they were returned by GetBytesToSendBuffers().
+    while (true) {
+        const size_t part_size{m_sending_header ? m_header_to_send.size() : m_message_to_send.data.size()};
+        const size_t part_sent{std::min(bytes_sent, part_size - m_bytes_sent)};
+        m_bytes_sent += part_sent;
+        bytes_sent -= part_sent;
+        if (m_sending_header && m_bytes_sent == m_header_to_send.size()) {
+            // We're done sending a message's header. Switch to sending its data bytes.
+            m_sending_header = false;
+            m_bytes_sent = 0;
+        } else if (!m_sending_header && m_bytes_sent == m_message_to_send.data.size()) {
+            // We're done sending a message's data. Wipe the data vector to reduce memory consumption.
+            ClearShrink(m_message_to_send.data);
+            m_bytes_sent = 0;
+            if (m_send_queue.empty()) break;
+            // Continue with the next queued message.
+            auto& [header, msg] = m_send_queue.front();
+            m_send_queue_bytes -= header.size() + msg.data.size();
+            m_send_queue_memusage -= msg.GetMemoryUsage();
+            m_header_to_send = std::move(header);
+            m_message_to_send = std::move(msg);
+            m_sending_header = true;
+            m_send_queue.pop_front();
+        } else {
+            break;
+        }
     }
+    Assume(bytes_sent == 0);
 }
 
 size_t V1Transport::GetSendMemoryUsage() const noexcept
 {
     AssertLockNotHeld(m_send_mutex);
     LOCK(m_send_mutex);
-    // Don't count sending-side fields besides m_message_to_send, as they're all small and bounded.
-    return m_message_to_send.GetMemoryUsage();
+    // Don't count sending-side fields besides the messages, as they're all small and bounded.
+    return m_message_to_send.GetMemoryUsage() + m_send_queue_memusage;
 }
 
 namespace {
@@ -1473,6 +1540,33 @@ CNetMessage V2Transport::GetReceivedMessage(std::chrono::microseconds time, bool
     return msg;
 }
 
+void V2Transport::AppendMessagePacket(CSerializedNetMsg& msg) noexcept
+{
+    AssertLockHeld(m_send_mutex);
+    Assume(m_send_state == SendState::READY);
+    // Construct the message type encoding, which precedes the payload in the contents.
+    std::array<uint8_t, 1 + CMessageHeader::MESSAGE_TYPE_SIZE> msg_type_enc{};
+    static_assert(1 + CMessageHeader::MESSAGE_TYPE_SIZE <= BIP324Cipher::MAX_PREFIX_LEN);
+    size_t msg_type_enc_len;
+    auto short_message_id = V2_MESSAGE_MAP(msg.m_type);
+    if (short_message_id) {
+        msg_type_enc[0] = *short_message_id;
+        msg_type_enc_len = 1;
+    } else {
+        // Write the message type string starting at offset 1. This means msg_type_enc[0] and
+        // the unused positions in msg_type_enc[1..13] remain 0x00.
+        std::copy_n(msg.m_type.begin(), std::min(msg.m_type.size(), CMessageHeader::MESSAGE_TYPE_SIZE), msg_type_enc.data() + 1);
+        msg_type_enc_len = msg_type_enc.size();
+    }
+    // Construct ciphertext at the end of the send buffer, encrypting the payload directly from
+    // the message rather than first concatenating it with the message type into a contents buffer.
+    const size_t start{m_send_buffer.size()};
+    m_send_buffer.resize(start + msg_type_enc_len + msg.data.size() + BIP324Cipher::EXPANSION);
+    m_cipher.Encrypt(MakeByteSpan(std::span{msg_type_enc}.first(msg_type_enc_len)), MakeByteSpan(msg.data), {}, false, MakeWritableByteSpan(m_send_buffer).subspan(start));
+    // Release memory
+    ClearShrink(msg.data);
+}
+
 bool V2Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
 {
     AssertLockNotHeld(m_send_mutex);
@@ -1482,26 +1576,35 @@ bool V2Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
     // is available) and the send buffer is empty. This limits the number of messages in the send
     // buffer to just one, and leaves the responsibility for queueing them up to the caller.
     if (!(m_send_state == SendState::READY && m_send_buffer.empty())) return false;
-    // Construct contents (encoding message type + payload).
-    std::vector<uint8_t> contents;
-    auto short_message_id = V2_MESSAGE_MAP(msg.m_type);
-    if (short_message_id) {
-        contents.resize(1 + msg.data.size());
-        contents[0] = *short_message_id;
-        std::copy(msg.data.begin(), msg.data.end(), contents.begin() + 1);
-    } else {
-        // Initialize with zeroes, and then write the message type string starting at offset 1.
-        // This means contents[0] and the unused positions in contents[1..13] remain 0x00.
-        contents.resize(1 + CMessageHeader::MESSAGE_TYPE_SIZE + msg.data.size(), 0);
-        std::copy(msg.m_type.begin(), msg.m_type.end(), contents.data() + 1);
-        std::copy(msg.data.begin(), msg.data.end(), contents.begin() + 1 + CMessageHeader::MESSAGE_TYPE_SIZE);
-    }
-    // Construct ciphertext in send buffer.
-    m_send_buffer.resize(contents.size() + BIP324Cipher::EXPANSION);
-    m_cipher.Encrypt(MakeByteSpan(contents), {}, false, MakeWritableByteSpan(m_send_buffer));
     m_send_type = msg.m_type;
-    // Release memory
-    ClearShrink(msg.data);
+    AppendMessagePacket(msg);
+    return true;
+}
+
+bool V2Transport::QueueMessageToSend(CSerializedNetMsg& msg, size_t max_queued_bytes) noexcept
+{
+    AssertLockNotHeld(m_send_mutex);
+    LOCK(m_send_mutex);
+    if (m_send_state == SendState::V1) return m_v1_fallback.QueueMessageToSend(msg, max_queued_bytes);
+    // Messages can only be encrypted in the READY state.
+    if (m_send_state != SendState::READY) return false;
+    if (m_send_buffer.empty()) {
+        m_send_type = msg.m_type;
+        AppendMessagePacket(msg);
+        return true;
+    }
+    if (m_send_buffer.size() - m_send_pos >= max_queued_bytes) return false;
+
+    // Drop the bytes already sent, so the buffer does not keep growing while it never runs empty.
+    // This is not done before 24 bytes have been sent, as m_sent_v1_header_worth is derived from
+    // m_send_pos.
+    if (m_sent_v1_header_worth && m_send_pos > 0) {
+        m_send_buffer.erase(m_send_buffer.begin(), m_send_buffer.begin() + m_send_pos);
+        for (auto& [start, type] : m_send_queue) start -= m_send_pos;
+        m_send_pos = 0;
+    }
+    m_send_queue.emplace_back(m_send_buffer.size(), msg.m_type);
+    AppendMessagePacket(msg);
     return true;
 }
 
@@ -1513,15 +1616,40 @@ Transport::BytesToSend V2Transport::GetBytesToSend(bool have_next_message) const
 
     if (m_send_state == SendState::MAYBE_V1) Assume(m_send_buffer.empty());
     Assume(m_send_pos <= m_send_buffer.size());
+    // Only return the bytes up to the first queued message, as they are sent on behalf of a
+    // different message type.
+    const size_t end{m_send_queue.empty() ? m_send_buffer.size() : m_send_queue.front().first};
     return {
-        std::span{m_send_buffer}.subspan(m_send_pos),
+        std::span{m_send_buffer}.first(end).subspan(m_send_pos),
         // We only have more to send after the current m_send_buffer if there is a (next)
         // message to be sent, and we're capable of sending packets. */
-        have_next_message && m_send_state == SendState::READY,
+        !m_send_queue.empty() || (have_next_message && m_send_state == SendState::READY),
         m_send_type
     };
 }
 
+bool V2Transport::GetBytesToSendBuffers(std::vector<SendBuffer>& buffers, bool have_next_message, size_t max_buffers) const noexcept
+{
+    AssertLockNotHeld(m_send_mutex);
+    LOCK(m_send_mutex);
+    if (m_send_state == SendState::V1) return m_v1_fallback.GetBytesToSendBuffers(buffers, have_next_message, max_buffers);
+
+    // Return one buffer per message, so that the bytes can be accounted to their message types.
+    const std::string* type{&m_send_type};
+    size_t pos{m_send_pos};
+    for (size_t i{0}; i <= m_send_queue.size(); ++i) {
+        const size_t end{i < m_send_queue.size() ? m_send_queue[i].first : m_send_buffer.size()};
+        if (pos < end) {
+            if (max_buffers == 0) return true;
+            buffers.push_back({std::span{m_send_buffer}.first(end).subspan(pos), type});
+            --max_buffers;
+            pos = end;
+        }
+        if (i < m_send_queue.size()) type = &m_send_queue[i].second;
+    }
+    return have_next_message && m_send_state == SendState::READY;
+}
+
 void V2Transport::MarkBytesSent(size_t bytes_sent) noexcept
 {
     AssertLockNotHeld(m_send_mutex);
@@ -1537,6 +1665,11 @@ void V2Transport::MarkBytesSent(size_t bytes_sent) noexcept
     if (m_send_pos >= CMessageHeader::HEADER_SIZE) {
         m_sent_v1_header_worth = true;
     }
+    // Move on to the queued messages which have started being sent.
+    while (!m_send_queue.empty() && m_send_queue.front().first <= m_send_pos) {
+        m_send_type = std::move(m_send_queue.front().second);
+        m_send_queue.pop_front();
+    }
     // Wipe the buffer when everything is sent.
     if (m_send_pos == m_send_buffer.size()) {
         m_send_pos = 0;
@@ -1597,28 +1730,36 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
     size_t nSentSize = 0;
     bool data_left{false}; //!< second return value (whether unsent data remains)
     std::optional<bool> expected_more;
+    std::vector<Transport::SendBuffer> buffers;
+    std::vector<std::span<const uint8_t>> spans;
 
     while (true) {
-        if (it != node.vSendMsg.end()) {
-            // If possible, move one message from the send queue to the transport. This fails when
-            // there is an existing message still being sent, or (for v2 transports) when the
-            // handshake has not yet completed.
+        while (it != node.vSendMsg.end()) {
+            // If possible, move messages from the send queue to the transport, so that several of
+            // them can be sent with one system call. This fails when too much is already waiting
+            // to be sent, or (for v2 transports) when the handshake has not yet completed.
             size_t memusage = it->GetMemoryUsage();
-            if (node.m_transport->SetMessageToSend(*it)) {
-                // Update memory usage of send buffer (as *it will be deleted).
-                node.m_send_memusage -= memusage;
-                ++it;
-            }
+            if (!node.m_transport->QueueMessageToSend(*it, MAX_SEND_BATCH_BYTES)) break;
+            // Update memory usage of send buffer (as *it will be deleted).
+            node.m_send_memusage -= memusage;
+            ++it;
         }
-        const auto& [data, more, msg_type] = node.m_transport->GetBytesToSend(it != node.vSendMsg.end());
-        // We rely on the 'more' value returned by GetBytesToSend to correctly predict whether more
-        // bytes are still to be sent, to correctly set the MSG_MORE flag. As a sanity check,
-        // verify that the previously returned 'more' was correct.
-        if (expected_more.has_value()) Assume(!data.empty() == *expected_more);
+        buffers.clear();
+        const bool more{node.m_transport->GetBytesToSendBuffers(buffers, it != node.vSendMsg.end(), Sock::SENDMSG_MAX_BUFFERS)};
+        // We rely on the 'more' value returned by GetBytesToSendBuffers to correctly predict
+        // whether more bytes are still to be sent, to correctly set the MSG_MORE flag. As a sanity
+        // check, verify that the previously returned 'more' was correct.
+        if (expected_more.has_value()) Assume(!buffers.empty() == *expected_more);
         expected_more = more;
-        data_left = !data.empty(); // will be overwritten on next loop if all of data gets sent
-        int nBytes = 0;
-        if (!data.empty()) {
+        data_left = !buffers.empty(); // will be overwritten on next loop if all of data gets sent
+        size_t data_size{0};
+        spans.clear();
+        for (const auto& buffer : buffers) {
+            data_size += buffer.data.size();
+            spans.push_back(buffer.data);
+        }
+        ssize_t nBytes = 0;
+        if (!buffers.empty()) {
             LOCK(node.m_sock_mutex);
             // There is no socket in case we've already disconnected, or in test cases without
             // real connections. In these cases, we bail out immediately and just leave things
@@ -1632,26 +1773,35 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
                 flags |= MSG_MORE;
             }
 #endif
-            nBytes = node.m_sock->Send(reinterpret_cast<const char*>(data.data()), data.size(), flags);
+            nBytes = node.m_sock->SendMsg(spans, flags);
         }
         if (nBytes > 0) {
             node.m_last_send = GetTime<std::chrono::seconds>();
             node.nSendBytes += nBytes;
+            // Update statistics per message type. This must happen before MarkBytesSent, which
+            // invalidates the buffers.
+            size_t to_account{size_t(nBytes)};
+            for (const auto& buffer : buffers) {
+                if (to_account == 0) break;
+                const size_t buffer_sent{std::min(to_account, buffer.data.size())};
+                if (!buffer.m_type->empty()) { // don't report v2 handshake bytes for now
+                    node.AccountForSentBytes(*buffer.m_type, buffer_sent);
+                }
+                to_account -= buffer_sent;
+            }
             // Notify transport that bytes have been processed.
             node.m_transport->MarkBytesSent(nBytes);
-            // Update statistics per message type.
-            if (!msg_type.empty()) { // don't report v2 handshake bytes for now
-                node.AccountForSentBytes(msg_type, nBytes);
-            }
             nSentSize += nBytes;
-            if ((size_t)nBytes != data.size()) {
+            if ((size_t)nBytes != data_size) {
                 // could not send full message; stop sending more
+                node.m_sock_writable = false;
                 break;
             }
         } else {
             if (nBytes < 0) {
                 // error
                 int nErr = WSAGetLastError();
+                if (nErr == WSAEWOULDBLOCK || nErr == WSAEAGAIN) node.m_sock_writable = false;
                 if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS) {
                     LogDebug(BCLog::NET, "socket send error, %s: %s\n", node.DisconnectMsg(fLogIPs), NetworkErrorString(nErr));
                     node.CloseSocketDisconnect();
@@ -1843,6 +1993,7 @@ void CConnman::CreateNodeFromAcceptedSocket(std::unique_ptr<Sock>&& sock,
     {
         LOCK(m_nodes_mutex);
         m_nodes.push_back(pnode);
+        EpollAddNode(*pnode);
     }
     LogDebug(BCLog::NET, "connection from %s accepted\n", addr.ToStringAddrPort());
     TRACEPOINT(net, inbound_connection,
@@ -1942,6 +2093,7 @@ void CConnman::DisconnectNodes()
                 pnode->grantOutbound.Release();
 
                 // close socket and cleanup
+                EpollRemoveNode(*pnode);
                 pnode->CloseSocketDisconnect();
 
                 // update connection count by network
@@ -2046,6 +2198,14 @@ bool CConnman::InactivityCheck(const CNode& node) const
     return false;
 }
 
+/** Whether sending is possible: either there are bytes to send right now, or there will be once a
+ *  potential message from vSendMsg is handed to the transport. */
+static bool HasBytesToSend(const CNode& node) EXCLUSIVE_LOCKS_REQUIRED(node.cs_vSend)
+{
+    const auto& [to_send, more, _msg_type] = node.m_transport->GetBytesToSend(!node.vSendMsg.empty());
+    return !to_send.empty() || more;
+}
+
 Sock::EventsPerSock CConnman::GenerateWaitSockets(std::span<CNode* const> nodes)
 {
     Sock::EventsPerSock events_per_sock;
@@ -2056,15 +2216,7 @@ Sock::EventsPerSock CConnman::GenerateWaitSockets(std::span<CNode* const> nodes)
 
     for (CNode* pnode : nodes) {
         bool select_recv = !pnode->fPauseRecv;
-        bool select_send;
-        {
-            LOCK(pnode->cs_vSend);
-            // Sending is possible if either there are bytes to send right now, or if there will be
-            // once a potential message from vSendMsg is handed to the transport. GetBytesToSend
-            // determines both of these in a single call.
-            const auto& [to_send, more, _msg_type] = pnode->m_transport->GetBytesToSend(!pnode->vSendMsg.empty());
-            select_send = !to_send.empty() || more;
-        }
+        bool select_send = WITH_LOCK(pnode->cs_vSend, return HasBytesToSend(*pnode));
         if (!select_recv && !select_send) continue;
 
         LOCK(pnode->m_sock_mutex);
@@ -2081,6 +2233,11 @@ void CConnman::SocketHandler()
 {
     AssertLockNotHeld(m_total_bytes_sent_mutex);
 
+    if (m_sock_epoll) {
+        SocketHandlerEpoll();
+        return;
+    }
+
     Sock::EventsPerSock events_per_sock;
 
     {
@@ -2114,12 +2271,7 @@ void CConnman::SocketHandlerConnected(const std::vector<CNode*>& nodes,
         if (interruptNet)
             return;
 
-        //
-        // Receive
-        //
-        bool recvSet = false;
-        bool sendSet = false;
-        bool errorSet = false;
+        Sock::Event occurred{0};
         {
             LOCK(pnode->m_sock_mutex);
             if (!pnode->m_sock) {
@@ -2127,81 +2279,98 @@ void CConnman::SocketHandlerConnected(const std::vector<CNode*>& nodes,
             }
             const auto it = events_per_sock.find(pnode->m_sock);
             if (it != events_per_sock.end()) {
-                recvSet = it->second.occurred & Sock::RECV;
-                sendSet = it->second.occurred & Sock::SEND;
-                errorSet = it->second.occurred & Sock::ERR;
+                occurred = it->second.occurred;
             }
         }
 
-        if (sendSet) {
-            // Send data
-            auto [bytes_sent, data_left] = WITH_LOCK(pnode->cs_vSend, return SocketSendData(*pnode));
-            if (bytes_sent) {
-                RecordBytesSent(bytes_sent);
-
-                // If both receiving and (non-optimistic) sending were possible, we first attempt
-                // sending. If that succeeds, but does not fully drain the send queue, do not
-                // attempt to receive. This avoids needlessly queueing data if the remote peer
-                // is slow at receiving data, by means of TCP flow control. We only do this when
-                // sending actually succeeded to make sure progress is always made; otherwise a
-                // deadlock would be possible when both sides have data to send, but neither is
-                // receiving.
-                if (data_left) recvSet = false;
-            }
+        SocketHandlerNode(*pnode, occurred);
+
+        if (InactivityCheck(*pnode)) pnode->fDisconnect = true;
+    }
+}
+
+bool CConnman::SocketHandlerNode(CNode& node, Sock::Event occurred)
+{
+    AssertLockNotHeld(m_total_bytes_sent_mutex);
+
+    //
+    // Receive
+    //
+    bool recvSet = occurred & Sock::RECV;
+    const bool sendSet = occurred & Sock::SEND;
+    const bool errorSet = occurred & Sock::ERR;
+
+    if (sendSet) {
+        // Send data
+        auto [bytes_sent, data_left] = WITH_LOCK(node.cs_vSend, return SocketSendData(node));
+        if (bytes_sent) {
+            RecordBytesSent(bytes_sent);
+
+            // If both receiving and (non-optimistic) sending were possible, we first attempt
+            // sending. If that succeeds, but does not fully drain the send queue, do not
+            // attempt to receive. This avoids needlessly queueing data if the remote peer
+            // is slow at receiving data, by means of TCP flow control. We only do this when
+            // sending actually succeeded to make sure progress is always made; otherwise a
+            // deadlock would be possible when both sides have data to send, but neither is
+            // receiving.
+            if (data_left) recvSet = false;
         }
+    }
 
-        if (recvSet || errorSet)
+    if (!recvSet && !errorSet) {
+        return occurred & Sock::RECV;
+    }
+
+    // typical socket buffer is 8K-64K
+    uint8_t pchBuf[0x10000];
+    int nBytes = 0;
+    {
+        LOCK(node.m_sock_mutex);
+        if (!node.m_sock) {
+            return false;
+        }
+        nBytes = node.m_sock->Recv(pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
+    }
+    if (nBytes > 0)
+    {
+        bool notify = false;
+        if (!node.ReceiveMsgBytes({pchBuf, (size_t)nBytes}, notify)) {
+            LogDebug(BCLog::NET,
+                "receiving message bytes failed, %s\n",
+                node.DisconnectMsg(fLogIPs)
+            );
+            node.CloseSocketDisconnect();
+        }
+        RecordBytesRecv(nBytes);
+        if (notify) {
+            node.MarkReceivedMsgsForProcessing();
+            WakeMessageHandler(node);
+        }
+        return (size_t)nBytes == sizeof(pchBuf);
+    }
+    else if (nBytes == 0)
+    {
+        // socket closed gracefully
+        if (!node.fDisconnect) {
+            LogDebug(BCLog::NET, "socket closed, %s\n", node.DisconnectMsg(fLogIPs));
+        }
+        node.CloseSocketDisconnect();
+    }
+    else if (nBytes < 0)
+    {
+        // error
+        int nErr = WSAGetLastError();
+        if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
         {
-            // typical socket buffer is 8K-64K
-            uint8_t pchBuf[0x10000];
-            int nBytes = 0;
-            {
-                LOCK(pnode->m_sock_mutex);
-                if (!pnode->m_sock) {
-                    continue;
-                }
-                nBytes = pnode->m_sock->Recv(pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
-            }
-            if (nBytes > 0)
-            {
-                bool notify = false;
-                if (!pnode->ReceiveMsgBytes({pchBuf, (size_t)nBytes}, notify)) {
-                    LogDebug(BCLog::NET,
-                        "receiving message bytes failed, %s\n",
-                        pnode->DisconnectMsg(fLogIPs)
-                    );
-                    pnode->CloseSocketDisconnect();
-                }
-                RecordBytesRecv(nBytes);
-                if (notify) {
-                    pnode->MarkReceivedMsgsForProcessing();
-                    WakeMessageHandler();
-                }
-            }
-            else if (nBytes == 0)
-            {
-                // socket closed gracefully
-                if (!pnode->fDisconnect) {
-                    LogDebug(BCLog::NET, "socket closed, %s\n", pnode->DisconnectMsg(fLogIPs));
-                }
-                pnode->CloseSocketDisconnect();
-            }
-            else if (nBytes < 0)
-            {
-                // error
-                int nErr = WSAGetLastError();
-                if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
-                {
-                    if (!pnode->fDisconnect) {
-                        LogDebug(BCLog::NET, "socket recv error, %s: %s\n", pnode->DisconnectMsg(fLogIPs), NetworkErrorString(nErr));
-                    }
-                    pnode->CloseSocketDisconnect();
-                }
+            if (!node.fDisconnect) {
+                LogDebug(BCLog::NET, "socket recv error, %s: %s\n", node.DisconnectMsg(fLogIPs), NetworkErrorString(nErr));
             }
+            node.CloseSocketDisconnect();
+        } else if (nErr == WSAEINTR) {
+            return true;
         }
-
-        if (InactivityCheck(*pnode)) pnode->fDisconnect = true;
     }
+    return false;
 }
 
 void CConnman::SocketHandlerListening(const Sock::EventsPerSock& events_per_sock)
@@ -2217,6 +2386,121 @@ void CConnman::SocketHandlerListening(const Sock::EventsPerSock& events_per_sock
     }
 }
 
+/** Added to the index into vhListenSocket to form the SockEpoll token of a listening socket. NodeIds are never this large. */
+static constexpr SockEpoll::Token EPOLL_LISTEN_TOKEN{SockEpoll::Token{1} << 63};
+/** How often SocketHandlerEpoll() runs InactivityCheck() on all nodes. */
+static constexpr auto EPOLL_SWEEP_INTERVAL{1s};
+
+void CConnman::SocketHandlerEpoll()
+{
+    AssertLockNotHeld(m_total_bytes_sent_mutex);
+
+    // Don't wait if a node left over from the previous round can make progress already.
+    const auto timeout{m_epoll_pending_ready ? 0ms : std::chrono::milliseconds{SELECT_TIMEOUT_MILLISECONDS}};
+    std::vector<SockEpoll::Ready> ready;
+    if (!m_sock_epoll->Wait(timeout, ready)) {
+        interruptNet.sleep_for(timeout);
+    }
+
+    // Collect the nodes with events, and the ones that were left over, merging their events.
+    std::vector<std::pair<NodeId, Sock::Event>> node_events;
+    node_events.reserve(ready.size() + m_epoll_pending.size());
+    std::vector<size_t> listen_ready;
+    for (const auto& [token, occurred] : ready) {
+        if (token & EPOLL_LISTEN_TOKEN) {
+            if (occurred & Sock::RECV) listen_ready.push_back(token & ~EPOLL_LISTEN_TOKEN);
+        } else {
+            node_events.emplace_back(NodeId(token), occurred);
+        }
+    }
+    for (const NodeId id : m_epoll_pending) {
+        node_events.emplace_back(id, 0);
+    }
+    m_epoll_pending.clear();
+    m_epoll_pending_ready = false;
+
+    const bool sweep{SteadyClock::now() >= m_epoll_next_sweep};
+    std::vector<std::pair<CNode*, Sock::Event>> nodes;
+    {
+        LOCK(m_nodes_mutex);
+        if (sweep) {
+            // Look at every node once in a while, to catch inactive ones.
+            for (CNode* pnode : m_nodes) {
+                if (InactivityCheck(*pnode)) pnode->fDisconnect = true;
+                node_events.emplace_back(pnode->GetId(), 0);
+            }
+            m_epoll_next_sweep = SteadyClock::now() + EPOLL_SWEEP_INTERVAL;
+        }
+        std::sort(node_events.begin(), node_events.end());
+        for (size_t i{0}; i < node_events.size();) {
+            const NodeId id{node_events[i].first};
+            Sock::Event occurred{0};
+            for (; i < node_events.size() && node_events[i].first == id; ++i) {
+                occurred |= node_events[i].second;
+            }
+            // Nodes disconnected in the meantime are not found. The reference keeps them alive until we are done.
+            const auto it{m_epoll_nodes.find(id)};
+            if (it == m_epoll_nodes.end()) continue;
+            it->second->AddRef();
+            nodes.emplace_back(it->second, occurred);
+        }
+    }
+
+    for (const auto& [pnode, occurred] : nodes) {
+        if (interruptNet) break;
+
+        // Edge-triggered events only report changes, so remember them until they are used up.
+        if (occurred & (Sock::RECV | Sock::ERR)) pnode->m_sock_readable = true;
+        bool send;
+        {
+            LOCK(pnode->cs_vSend);
+            if (occurred & Sock::SEND) pnode->m_sock_writable = true;
+            send = pnode->m_sock_writable && HasBytesToSend(*pnode);
+        }
+        const bool recv{pnode->m_sock_readable && !pnode->fPauseRecv};
+        const bool more_to_recv{SocketHandlerNode(*pnode, (send ? Sock::SEND : 0) | (recv ? Sock::RECV : 0))};
+        if (recv) pnode->m_sock_readable = more_to_recv;
+
+        // Whatever was received may have made data available for sending (e.g. during the v2
+        // handshake), without the socket reporting an event.
+        const bool can_send{WITH_LOCK(pnode->cs_vSend, return pnode->m_sock_writable && HasBytesToSend(*pnode))};
+        const bool can_recv{pnode->m_sock_readable && !pnode->fPauseRecv};
+        // A node with unread data is kept around while its receiving is paused, to resume it once unpaused.
+        if (can_send || pnode->m_sock_readable) m_epoll_pending.push_back(pnode->GetId());
+        if (can_send || can_recv) m_epoll_pending_ready = true;
+    }
+
+    for (const auto& [pnode, _] : nodes) {
+        pnode->Release();
+    }
+
+    // Accept new connections from listening sockets.
+    for (const size_t i : listen_ready) {
+        if (interruptNet) return;
+        AcceptConnection(vhListenSocket[i]);
+    }
+}
+
+void CConnman::EpollAddNode(CNode& node)
+{
+    if (!m_sock_epoll) return;
+    LOCK(node.m_sock_mutex);
+    if (node.m_sock && m_sock_epoll->Add(*node.m_sock, node.GetId(), Sock::RECV | Sock::SEND, /*edge_triggered=*/true)) {
+        m_epoll_nodes.emplace(node.GetId(), &node);
+    } else {
+        LogDebug(BCLog::NET, "cannot wait for socket events, %s\n", node.DisconnectMsg(fLogIPs));
+        node.fDisconnect = true;
+    }
+}
+
+void CConnman::EpollRemoveNode(CNode& node)
+{
+    if (!m_sock_epoll) return;
+    m_epoll_nodes.erase(node.GetId());
+    LOCK(node.m_sock_mutex);
+    if (node.m_sock) m_sock_epoll->Remove(*node.m_sock);
+}
+
 void CConnman::ThreadSocketHandler()
 {
     AssertLockNotHeld(m_total_bytes_sent_mutex);
@@ -2233,9 +2517,20 @@ void CConnman::WakeMessageHandler()
 {
     {
         LOCK(mutexMsgProc);
-        fMsgProcWake = true;
+        m_msgproc_wake.assign(m_msgproc_wake.size(), true);
+    }
+    condMsgProc.notify_all();
+}
+
+void CConnman::WakeMessageHandler(const CNode& node)
+{
+    {
+        LOCK(mutexMsgProc);
+        if (m_msgproc_wake.empty()) return;
+        m_msgproc_wake[MessageHandlerFor(node)] = true;
     }
-    condMsgProc.notify_one();
+    // All threads wait on the same condition variable; the ones whose flag is not set go back to sleep.
+    condMsgProc.notify_all();
 }
 
 void CConnman::ThreadDNSAddressSeed()
@@ -3010,6 +3305,7 @@ void CConnman::OpenNetworkConnection(const CAddress& addrConnect, bool fCountFai
     {
         LOCK(m_nodes_mutex);
         m_nodes.push_back(pnode);
+        EpollAddNode(*pnode);
 
         // update connection count by network
         if (pnode->IsManualOrFullOutboundConn()) ++m_network_conn_counts[pnode->addr.GetNetwork()];
@@ -3025,10 +3321,8 @@ void CConnman::OpenNetworkConnection(const CAddress& addrConnect, bool fCountFai
 
 Mutex NetEventsInterface::g_msgproc_mutex;
 
-void CConnman::ThreadMessageHandler()
+void CConnman::ThreadMessageHandler(size_t worker)
 {
-    LOCK(NetEventsInterface::g_msgproc_mutex);
-
     while (!flagInterruptMsgProc)
     {
         bool fMoreWork = false;
@@ -3043,13 +3337,22 @@ void CConnman::ThreadMessageHandler()
                 if (pnode->fDisconnect)
                     continue;
 
+                // Every node is handled by a single thread, so that its messages are processed in order.
+                if (MessageHandlerFor(*pnode) != worker)
+                    continue;
+
                 // Receive messages
-                bool fMoreNodeWork = m_msgproc->ProcessMessages(pnode, flagInterruptMsgProc);
+                bool fMoreNodeWork = WITH_LOCK(NetEventsInterface::g_msgproc_mutex,
+                                               return m_msgproc->ProcessMessages(pnode, flagInterruptMsgProc));
+                if (flagInterruptMsgProc)
+                    return;
+                // Serve requests that don't need g_msgproc_mutex, concurrently with the other threads
+                fMoreNodeWork |= m_msgproc->ServeRequests(pnode, flagInterruptMsgProc);
                 fMoreWork |= (fMoreNodeWork && !pnode->fPauseSend);
                 if (flagInterruptMsgProc)
                     return;
                 // Send messages
-                m_msgproc->SendMessages(pnode);
+                WITH_LOCK(NetEventsInterface::g_msgproc_mutex, m_msgproc->SendMessages(pnode));
 
                 if (flagInterruptMsgProc)
                     return;
@@ -3058,9 +3361,9 @@ void CConnman::ThreadMessageHandler()
 
         WAIT_LOCK(mutexMsgProc, lock);
         if (!fMoreWork) {
-            condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [this]() EXCLUSIVE_LOCKS_REQUIRED(mutexMsgProc) { return fMsgProcWake; });
+            condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [&]() EXCLUSIVE_LOCKS_REQUIRED(mutexMsgProc) { return m_msgproc_wake[worker]; });
         }
-        fMsgProcWake = false;
+        m_msgproc_wake[worker] = false;
     }
 }
 
@@ -3345,7 +3648,16 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
 
     {
         LOCK(mutexMsgProc);
-        fMsgProcWake = false;
+        m_msgproc_wake.assign(m_num_msghand_threads, false);
+    }
+
+    // Wait for socket events with epoll if possible, see SocketHandlerEpoll().
+    m_sock_epoll = SockEpoll::Create();
+    for (size_t i{0}; m_sock_epoll && i < vhListenSocket.size(); ++i) {
+        if (!m_sock_epoll->Add(*vhListenSocket[i].sock, EPOLL_LISTEN_TOKEN | i, Sock::RECV, /*edge_triggered=*/false)) {
+            LogPrintf("Failed to wait for events on listening socket with epoll, falling back to poll\n");
+            m_sock_epoll.reset();
+        }
     }
 
     // Send and receive from sockets, accept connections
@@ -3374,7 +3686,10 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
     }
 
     // Process messages
-    threadMessageHandler = std::thread(&util::TraceThread, "msghand", [this] { ThreadMessageHandler(); });
+    for (int i{0}; i < m_num_msghand_threads; ++i) {
+        const std::string thread_name{m_num_msghand_threads == 1 ? "msghand" : strprintf("msghand.%i", i)};
+        m_msghand_threads.emplace_back(&util::TraceThread, thread_name, [this, i] { ThreadMessageHandler(i); });
+    }
 
     if (m_i2p_sam_session) {
         threadI2PAcceptIncoming =
@@ -3437,8 +3752,10 @@ void CConnman::StopThreads()
     if (threadI2PAcceptIncoming.joinable()) {
         threadI2PAcceptIncoming.join();
     }
-    if (threadMessageHandler.joinable())
-        threadMessageHandler.join();
+    for (std::thread& thread : m_msghand_threads) {
+        if (thread.joinable()) thread.join();
+    }
+    m_msghand_threads.clear();
     if (threadOpenConnections.joinable())
         threadOpenConnections.join();
     if (threadOpenAddedConnections.joinable())
@@ -3478,6 +3795,10 @@ void CConnman::StopNodes()
         DeleteNode(pnode);
     }
     m_nodes_disconnected.clear();
+    WITH_LOCK(m_nodes_mutex, m_epoll_nodes.clear());
+    m_epoll_pending.clear();
+    m_epoll_pending_ready = false;
+    m_sock_epoll.reset();
     vhListenSocket.clear();
     semOutbound.reset();
     semAddnode.reset();
@@ -31,8 +31,10 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/sock.h>
+#include <util/sockepoll.h>
 #include <util/threadinterrupt.h>
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
@@ -44,6 +46,7 @@
 #include <optional>
 #include <queue>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -62,6 +65,9 @@ static constexpr auto FEELER_INTERVAL = 2min;
 static constexpr auto EXTRA_BLOCK_RELAY_ONLY_PEER_INTERVAL = 5min;
 /** Maximum length of incoming protocol messages (no message over 4 MB is currently acceptable). */
 static const unsigned int MAX_PROTOCOL_MESSAGE_LENGTH = 4 * 1000 * 1000;
+/** Maximum number of bytes to hand to a transport ahead of the ones being sent, so that several
+ *  messages can be sent to a peer with a single system call. */
+static constexpr size_t MAX_SEND_BATCH_BYTES{256 * 1024};
 /** Maximum length of the user agent string in `version` message */
 static const unsigned int MAX_SUBVERSION_LENGTH = 256;
 /** Maximum number of automatic outgoing nodes over which we'll relay everything (blocks, tx, addrs, etc) */
@@ -82,6 +88,11 @@ static const std::string DEFAULT_MAX_UPLOAD_TARGET{"0M"};
 static const bool DEFAULT_BLOCKSONLY = false;
 /** -peertimeout default */
 static const int64_t DEFAULT_PEER_CONNECT_TIMEOUT = 60;
+/** -blockservethreads default */
+static constexpr int DEFAULT_BLOCK_SERVE_THREADS{1};
+/** Maximum of -blockservethreads. Message handler threads beyond the first only add concurrency for serving blocks,
+ *  all other message processing is serialized by NetEventsInterface::g_msgproc_mutex. */
+static constexpr int MAX_BLOCK_SERVE_THREADS{16};
 /** Number of file descriptors required for message capture **/
 static const int NUM_FDS_MESSAGE_CAPTURE = 1;
 /** Interval for ASMap Health Check **/
@@ -298,6 +309,18 @@ public:
      */
     virtual bool SetMessageToSend(CSerializedNetMsg& msg) noexcept = 0;
 
+    /** Like SetMessageToSend(), but also accept a message while earlier ones are not done being
+     *  sent yet, as long as fewer than max_queued_bytes bytes are waiting to be sent.
+     *
+     * This lets the caller hand over several messages at once, so that their bytes can be sent
+     * with a single system call (see GetBytesToSendBuffers()). The default implementation only
+     * calls SetMessageToSend().
+     */
+    virtual bool QueueMessageToSend(CSerializedNetMsg& msg, size_t max_queued_bytes) noexcept
+    {
+        return SetMessageToSend(msg);
+    }
+
     /** Return type for GetBytesToSend, consisting of:
      *  - std::span<const uint8_t> to_send: span of bytes to be sent over the wire (possibly empty).
      *  - bool more: whether there will be more bytes to be sent after the ones in to_send are
@@ -348,9 +371,40 @@ public:
      */
     virtual BytesToSend GetBytesToSend(bool have_next_message) const noexcept = 0;
 
-    /** Report how many bytes returned by the last GetBytesToSend() have been sent.
+    /** A part of the bytes to send, with the message type on behalf of which it is sent ("" for
+     *  bytes that are not on behalf of any message). */
+    struct SendBuffer {
+        std::span<const uint8_t> data;
+        const std::string* m_type;
+    };
+
+    /** Get all bytes that are ready to be sent on the wire, as consecutive non-empty buffers.
+     *
+     * Unlike GetBytesToSend(), this covers all messages handed over with QueueMessageToSend(). The
+     * first buffer is the to_send of GetBytesToSend(). Like there, the buffers refer to data
+     * internal to the transport, and calling any non-const function may invalidate them.
+     *
+     * @param[out] buffers          Appended to, with at most max_buffers buffers.
+     * @param[in] have_next_message See GetBytesToSend().
+     * @param[in] max_buffers       Maximum number of buffers to return.
+     * @return whether there will be more bytes to send after all returned buffers are sent, like
+     *         the 'more' of GetBytesToSend().
+     */
+    virtual bool GetBytesToSendBuffers(std::vector<SendBuffer>& buffers, bool have_next_message, size_t max_buffers) const noexcept
+    {
+        const auto& [to_send, more, m_type] = GetBytesToSend(have_next_message);
+        if (!to_send.empty()) {
+            if (max_buffers == 0) return true;
+            buffers.push_back({to_send, &m_type});
+        }
+        return more;
+    }
+
+    /** Report how many bytes returned by the last GetBytesToSend() or GetBytesToSendBuffers()
+     *  have been sent.
      *
-     * bytes_sent cannot exceed to_send.size() of the last GetBytesToSend() result.
+     * bytes_sent cannot exceed to_send.size() of the last GetBytesToSend() result, or the total
+     * size of the buffers of the last GetBytesToSendBuffers() result.
      *
      * If bytes_sent=0, this call has no effect.
      */
@@ -413,6 +467,20 @@ private:
     bool m_sending_header GUARDED_BY(m_send_mutex) {false};
     /** How many bytes have been sent so far (from m_header_to_send, or from m_message_to_send.data). */
     size_t m_bytes_sent GUARDED_BY(m_send_mutex) {0};
+    /** Messages queued by QueueMessageToSend() behind m_message_to_send, with their headers. */
+    std::deque<std::pair<std::vector<uint8_t>, CSerializedNetMsg>> m_send_queue GUARDED_BY(m_send_mutex);
+    /** Number of bytes to send for the messages in m_send_queue. */
+    size_t m_send_queue_bytes GUARDED_BY(m_send_mutex) {0};
+    /** Memory usage of the messages in m_send_queue. */
+    size_t m_send_queue_memusage GUARDED_BY(m_send_mutex) {0};
+
+    /** Serialize the header for a message to send. */
+    std::vector<uint8_t> MakeHeader(const CSerializedNetMsg& msg) const noexcept;
+    /** Whether the current message is done being sent, so that a new one can be set. */
+    bool SendIdle() const noexcept EXCLUSIVE_LOCKS_REQUIRED(m_send_mutex)
+    {
+        return !m_sending_header && m_bytes_sent >= m_message_to_send.data.size();
+    }
 
 public:
     explicit V1Transport(const NodeId node_id) noexcept;
@@ -441,7 +509,9 @@ public:
     CNetMessage GetReceivedMessage(std::chrono::microseconds time, bool& reject_message) override EXCLUSIVE_LOCKS_REQUIRED(!m_recv_mutex);
 
     bool SetMessageToSend(CSerializedNetMsg& msg) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
+    bool QueueMessageToSend(CSerializedNetMsg& msg, size_t max_queued_bytes) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     BytesToSend GetBytesToSend(bool have_next_message) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
+    bool GetBytesToSendBuffers(std::vector<SendBuffer>& buffers, bool have_next_message, size_t max_buffers) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     void MarkBytesSent(size_t bytes_sent) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     size_t GetSendMemoryUsage() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     bool ShouldReconnectV1() const noexcept override { return false; }
@@ -607,6 +677,9 @@ private:
     std::vector<uint8_t> m_send_garbage GUARDED_BY(m_send_mutex);
     /** Type of the message being sent. */
     std::string m_send_type GUARDED_BY(m_send_mutex);
+    /** Start positions in m_send_buffer and types of the messages queued by QueueMessageToSend()
+     *  behind the one being sent (READY state only). */
+    std::deque<std::pair<size_t, std::string>> m_send_queue GUARDED_BY(m_send_mutex);
     /** Current sender state. */
     SendState m_send_state GUARDED_BY(m_send_mutex);
     /** Whether we've sent at least 24 bytes (which would trigger disconnect for V1 peers). */
@@ -622,6 +695,8 @@ private:
     size_t GetMaxBytesToProcess() noexcept EXCLUSIVE_LOCKS_REQUIRED(m_recv_mutex);
     /** Put our public key + garbage in the send buffer. */
     void StartSendingHandshake() noexcept EXCLUSIVE_LOCKS_REQUIRED(m_send_mutex);
+    /** Append an encrypted packet for msg to the send buffer (READY state only). */
+    void AppendMessagePacket(CSerializedNetMsg& msg) noexcept EXCLUSIVE_LOCKS_REQUIRED(m_send_mutex);
     /** Process bytes in m_recv_buffer, while in KEY_MAYBE_V1 state. */
     void ProcessReceivedMaybeV1Bytes() noexcept EXCLUSIVE_LOCKS_REQUIRED(m_recv_mutex, !m_send_mutex);
     /** Process bytes in m_recv_buffer, while in KEY state. */
@@ -651,7 +726,9 @@ public:
 
     // Send side functions.
     bool SetMessageToSend(CSerializedNetMsg& msg) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
+    bool QueueMessageToSend(CSerializedNetMsg& msg, size_t max_queued_bytes) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     BytesToSend GetBytesToSend(bool have_next_message) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
+    bool GetBytesToSendBuffers(std::vector<SendBuffer>& buffers, bool have_next_message, size_t max_buffers) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     void MarkBytesSent(size_t bytes_sent) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     size_t GetSendMemoryUsage() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
 
@@ -695,6 +772,12 @@ public:
     uint64_t nSendBytes GUARDED_BY(cs_vSend){0};
     /** Messages still to be fed to m_transport->SetMessageToSend. */
     std::deque<CSerializedNetMsg> vSendMsg GUARDED_BY(cs_vSend);
+    /** Whether the socket can accept more data, as far as known: cleared when a send could not
+     *  complete, set again by an epoll event. Only maintained when CConnman uses epoll. */
+    bool m_sock_writable GUARDED_BY(cs_vSend){false};
+    /** Whether the socket may have data that was not received yet: set by an epoll event, cleared
+     *  when receiving drained it. Only maintained when CConnman uses epoll, by the socket handler thread. */
+    bool m_sock_readable{false};
     Mutex cs_vSend;
     Mutex m_sock_mutex;
     Mutex cs_vRecv;
@@ -1008,7 +1091,10 @@ private:
 class NetEventsInterface
 {
 public:
-    /** Mutex for anything that is only accessed via the msg processing thread */
+    /**
+     * Mutex for anything that is only accessed via ProcessMessages() and SendMessages(). With several message
+     * handler threads, these calls are serialized by it, while ServeRequests() may run concurrently.
+     */
     static Mutex g_msgproc_mutex;
 
     /** Initialize a peer (setup state) */
@@ -1040,6 +1126,17 @@ public:
     */
     virtual bool SendMessages(CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex) = 0;
 
+    /**
+    * Serve requests of a given node that do not depend on the message processing state (such as blocks asked for
+    * with getdata), without holding g_msgproc_mutex. Called after ProcessMessages() by the message handler thread
+    * the node is assigned to.
+    *
+    * @param[in]   pnode           The node whose requests to serve.
+    * @param[in]   interrupt       Interrupt condition for processing threads
+    * @return                      True if there is more work to be done
+    */
+    virtual bool ServeRequests(CNode* pnode, std::atomic<bool>& interrupt) EXCLUSIVE_LOCKS_REQUIRED(!g_msgproc_mutex) = 0;
+
 
 protected:
     /**
@@ -1064,6 +1161,7 @@ public:
         unsigned int nReceiveFloodSize = 0;
         uint64_t nMaxOutboundLimit = 0;
         int64_t m_peer_connect_timeout = DEFAULT_PEER_CONNECT_TIMEOUT;
+        int m_num_msghand_threads = DEFAULT_BLOCK_SERVE_THREADS;
         std::vector<std::string> vSeedNodes;
         std::vector<NetWhitelistPermissions> vWhitelistedRangeIncoming;
         std::vector<NetWhitelistPermissions> vWhitelistedRangeOutgoing;
@@ -1098,6 +1196,7 @@ public:
         nSendBufferMaxSize = connOptions.nSendBufferMaxSize;
         nReceiveFloodSize = connOptions.nReceiveFloodSize;
         m_peer_connect_timeout = std::chrono::seconds{connOptions.m_peer_connect_timeout};
+        m_num_msghand_threads = std::clamp(connOptions.m_num_msghand_threads, 1, MAX_BLOCK_SERVE_THREADS);
         {
             LOCK(m_total_bytes_sent_mutex);
             nMaxOutboundLimit = connOptions.nMaxOutboundLimit;
@@ -1266,7 +1365,10 @@ public:
     /** Get a unique deterministic randomizer. */
     CSipHasher GetDeterministicRandomizer(uint64_t id) const;
 
+    /** Wake up all message handler threads. */
     void WakeMessageHandler() EXCLUSIVE_LOCKS_REQUIRED(!mutexMsgProc);
+    /** Wake up the message handler thread that the given node is assigned to. */
+    void WakeMessageHandler(const CNode& node) EXCLUSIVE_LOCKS_REQUIRED(!mutexMsgProc);
 
     /** Return true if we should disconnect the peer for failing an inactivity check. */
     bool ShouldRunInactivityChecks(const CNode& node, std::chrono::seconds now) const;
@@ -1299,7 +1401,9 @@ private:
     void AddAddrFetch(const std::string& strDest) EXCLUSIVE_LOCKS_REQUIRED(!m_addr_fetches_mutex);
     void ProcessAddrFetch() EXCLUSIVE_LOCKS_REQUIRED(!m_addr_fetches_mutex, !m_unused_i2p_sessions_mutex);
     void ThreadOpenConnections(std::vector<std::string> connect, std::span<const std::string> seed_nodes) EXCLUSIVE_LOCKS_REQUIRED(!m_addr_fetches_mutex, !m_added_nodes_mutex, !m_nodes_mutex, !m_unused_i2p_sessions_mutex, !m_reconnections_mutex);
-    void ThreadMessageHandler() EXCLUSIVE_LOCKS_REQUIRED(!mutexMsgProc);
+    /** Index of the message handler thread that processes all messages from and to the given node. */
+    size_t MessageHandlerFor(const CNode& node) const { return size_t(node.GetId()) % m_num_msghand_threads; }
+    void ThreadMessageHandler(size_t worker) EXCLUSIVE_LOCKS_REQUIRED(!mutexMsgProc, !NetEventsInterface::g_msgproc_mutex);
     void ThreadI2PAcceptIncoming();
     void AcceptConnection(const ListenSocket& hListenSocket);
 
@@ -1342,6 +1446,27 @@ private:
                                 const Sock::EventsPerSock& events_per_sock)
         EXCLUSIVE_LOCKS_REQUIRED(!m_total_bytes_sent_mutex, !mutexMsgProc);
 
+    /**
+     * Do the read/write for a single connected socket.
+     * @param[in] node The node to process.
+     * @param[in] occurred The events the node's socket is ready for.
+     * @return Whether data may remain to be received: receiving was requested but skipped, or
+     * filled the whole receive buffer.
+     */
+    bool SocketHandlerNode(CNode& node, Sock::Event occurred)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_total_bytes_sent_mutex, !mutexMsgProc);
+
+    /**
+     * Same as SocketHandler(), but using m_sock_epoll: only the nodes whose sockets reported
+     * events, or that are known to have more work pending, are processed.
+     */
+    void SocketHandlerEpoll() EXCLUSIVE_LOCKS_REQUIRED(!m_total_bytes_sent_mutex, !mutexMsgProc);
+
+    /** Register a new node's socket with m_sock_epoll (if in use), or disconnect it if that fails. */
+    void EpollAddNode(CNode& node) EXCLUSIVE_LOCKS_REQUIRED(m_nodes_mutex);
+    /** Unregister a node from m_sock_epoll (if in use). */
+    void EpollRemoveNode(CNode& node) EXCLUSIVE_LOCKS_REQUIRED(m_nodes_mutex);
+
     /**
      * Accept incoming connections, one from each read-ready listening socket.
      * @param[in] events_per_sock Sockets that are ready for IO.
@@ -1446,6 +1571,22 @@ private:
     std::vector<CNode*> m_nodes GUARDED_BY(m_nodes_mutex);
     std::list<CNode*> m_nodes_disconnected;
     mutable RecursiveMutex m_nodes_mutex;
+
+    /**
+     * Persistent set of the sockets of all nodes in m_nodes and the listening sockets, used by
+     * the socket handler thread instead of Sock::WaitMany() if available. Set up by Start()
+     * before any threads are started. Node sockets are registered edge-triggered, with their
+     * NodeId as token, so CNode::m_sock_readable and CNode::m_sock_writable keep the state.
+     */
+    std::unique_ptr<SockEpoll> m_sock_epoll;
+    /** Nodes registered with m_sock_epoll, for mapping its tokens back to nodes. */
+    std::unordered_map<NodeId, CNode*> m_epoll_nodes GUARDED_BY(m_nodes_mutex);
+    /** Nodes to process in the next SocketHandlerEpoll() round even without an event. Only used by the socket handler thread. */
+    std::vector<NodeId> m_epoll_pending;
+    /** Whether some node in m_epoll_pending can make progress right away. Only used by the socket handler thread. */
+    bool m_epoll_pending_ready{false};
+    /** When SocketHandlerEpoll() next runs InactivityCheck() on all nodes. Only used by the socket handler thread. */
+    SteadyClock::time_point m_epoll_next_sweep{};
     std::atomic<NodeId> nLastNodeId{0};
     unsigned int nPrevNodeCount{0};
 
@@ -1534,8 +1675,11 @@ private:
     /** SipHasher seeds for deterministic randomness */
     const uint64_t nSeed0, nSeed1;
 
-    /** flag for waking the message processor. */
-    bool fMsgProcWake GUARDED_BY(mutexMsgProc);
+    /** Number of message handler threads, see ThreadMessageHandler(). */
+    int m_num_msghand_threads{DEFAULT_BLOCK_SERVE_THREADS};
+
+    /** flags for waking the message processor, one per message handler thread. */
+    std::vector<bool> m_msgproc_wake GUARDED_BY(mutexMsgProc);
 
     std::condition_variable condMsgProc;
     Mutex mutexMsgProc;
@@ -1560,7 +1704,7 @@ private:
     std::thread threadSocketHandler;
     std::thread threadOpenAddedConnections;
     std::thread threadOpenConnections;
-    std::thread threadMessageHandler;
+    std::vector<std::thread> m_msghand_threads;
     std::thread threadI2PAcceptIncoming;
 
     /** flag for deciding to connect to an extra outbound peer,
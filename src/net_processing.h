@@ -91,6 +91,10 @@ public:
         //! Number of headers sent in one getheaders message result (this is
         //! a test-only option).
         uint32_t max_headers_result{MAX_HEADERS_RESULTS};
+        //! Whether blocks requested with getdata are served by ServeRequests()
+        //! instead of ProcessMessages(), so that this can happen on several
+        //! message handler threads concurrently.
+        bool serve_blocks_concurrently{false};
     };
 
     static std::unique_ptr<PeerManager> make(CConnman& connman, AddrMan& addrman,
@@ -8,6 +8,7 @@
 #include <chain.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
+#include <crypto/common.h>
 #include <dbwrapper.h>
 #include <flatfile.h>
 #include <hash.h>
@@ -31,6 +32,7 @@
 #include <util/batchpriority.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/lz.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/translation.h>
@@ -43,7 +45,10 @@
 #include <node/interface_ui.h>
 #include <node/validation_interface_args.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <deque>
+#include <future>
 #include <map>
 #include <unordered_map>
 
@@ -899,7 +904,7 @@ FlatFilePos BlockManager::FindNextBlockPos(unsigned int nAddSize, unsigned int n
     return pos;
 }
 
-void BlockManager::UpdateBlockInfo(const CBlock& block, unsigned int nHeight, const FlatFilePos& pos)
+void BlockManager::UpdateBlockInfo(const CBlock& block, unsigned int nHeight, const FlatFilePos& pos, unsigned int stored_size)
 {
     LOCK(cs_LastBlockFile);
 
@@ -911,13 +916,12 @@ void BlockManager::UpdateBlockInfo(const CBlock& block, unsigned int nHeight, co
     }
 
     // Update the file information with the current block.
-    const unsigned int added_size = ::GetSerializeSize(TX_WITH_WITNESS(block));
     const int nFile = pos.nFile;
     if (static_cast<int>(m_blockfile_info.size()) <= nFile) {
         m_blockfile_info.resize(nFile + 1);
     }
     m_blockfile_info[nFile].AddBlock(nHeight, block.GetBlockTime());
-    m_blockfile_info[nFile].nSize = std::max(pos.nPos + added_size, m_blockfile_info[nFile].nSize);
+    m_blockfile_info[nFile].nSize = std::max(pos.nPos + stored_size, m_blockfile_info[nFile].nSize);
     m_dirty_fileinfo.insert(nFile);
 }
 
@@ -1007,7 +1011,7 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
     return true;
 }
 
-bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos) const
+bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos, bool use_arena) const
 {
     block.SetNull();
 
@@ -1019,7 +1023,11 @@ bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos) const
 
     try {
         // Read block
-        SpanReader{block_data} >> TX_WITH_WITNESS(block);
+        if (use_arena) {
+            SpanReader{block_data} >> TX_WITH_WITNESS(Using<BlockArenaFormatter>(block));
+        } else {
+            SpanReader{block_data} >> TX_WITH_WITNESS(block);
+        }
     } catch (const std::exception& e) {
         LogError("Deserialize or I/O error - %s at %s while reading block", e.what(), pos.ToString());
         return false;
@@ -1040,11 +1048,11 @@ bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos) const
     return true;
 }
 
-bool BlockManager::ReadBlock(CBlock& block, const CBlockIndex& index) const
+bool BlockManager::ReadBlock(CBlock& block, const CBlockIndex& index, bool use_arena) const
 {
     const FlatFilePos block_pos{WITH_LOCK(cs_main, return index.GetBlockPos())};
 
-    if (!ReadBlock(block, block_pos)) {
+    if (!ReadBlock(block, block_pos, use_arena)) {
         return false;
     }
     if (block.GetHash() != index.GetBlockHash()) {
@@ -1054,6 +1062,31 @@ bool BlockManager::ReadBlock(CBlock& block, const CBlockIndex& index) const
     return true;
 }
 
+ThreadPool& BlockManager::GetReadPool() const
+{
+    LOCK(m_read_pool_mutex);
+    if (!m_read_pool) m_read_pool = std::make_unique<ThreadPool>("blkread", BLOCK_READ_THREADS);
+    return *m_read_pool;
+}
+
+std::future<std::optional<CBlock>> BlockManager::ReadBlockAsync(const CBlockIndex& index, bool use_arena) const
+{
+    return GetReadPool().Submit([this, &index, use_arena]() -> std::optional<CBlock> {
+        CBlock block;
+        if (!ReadBlock(block, index, use_arena)) return std::nullopt;
+        return block;
+    });
+}
+
+std::future<std::optional<CBlockUndo>> BlockManager::ReadBlockUndoAsync(const CBlockIndex& index) const
+{
+    return GetReadPool().Submit([this, &index]() -> std::optional<CBlockUndo> {
+        CBlockUndo blockundo;
+        if (!ReadBlockUndo(blockundo, index)) return std::nullopt;
+        return blockundo;
+    });
+}
+
 bool BlockManager::ReadRawBlock(std::vector<uint8_t>& block, const FlatFilePos& pos) const
 {
     if (pos.nPos < STORAGE_HEADER_BYTES) {
@@ -1081,14 +1114,26 @@ bool BlockManager::ReadRawBlock(std::vector<uint8_t>& block, const FlatFilePos&
             return false;
         }
 
+        const bool compressed{(blk_size & BLOCK_COMPRESSED_FLAG) != 0};
+        blk_size &= ~BLOCK_COMPRESSED_FLAG;
+
         if (blk_size > MAX_SIZE) {
             LogError("Block data is larger than maximum deserialization size for %s: %s versus %s while reading raw block",
                 pos.ToString(), blk_size, MAX_SIZE);
             return false;
         }
 
-        block.resize(blk_size); // Zeroing of memory is intentional here
-        filein.read(MakeWritableByteSpan(block));
+        if (compressed) {
+            std::vector<uint8_t> compressed_data(blk_size);
+            filein.read(MakeWritableByteSpan(compressed_data));
+            if (!DecompressBlockData(compressed_data, block)) {
+                LogError("Failed to decompress block data for %s while reading raw block", pos.ToString());
+                return false;
+            }
+        } else {
+            block.resize(blk_size); // Zeroing of memory is intentional here
+            filein.read(MakeWritableByteSpan(block));
+        }
     } catch (const std::exception& e) {
         LogError("Read from block file failed: %s for %s while reading raw block", e.what(), pos.ToString());
         return false;
@@ -1097,10 +1142,39 @@ bool BlockManager::ReadRawBlock(std::vector<uint8_t>& block, const FlatFilePos&
     return true;
 }
 
+std::vector<uint8_t> CompressBlockData(std::span<const uint8_t> block_data)
+{
+    std::vector<uint8_t> compressed(sizeof(uint32_t));
+    WriteLE32(compressed.data(), block_data.size());
+    const std::vector<uint8_t> lz_data{util::LZCompress(block_data)};
+    compressed.insert(compressed.end(), lz_data.begin(), lz_data.end());
+    return compressed;
+}
+
+bool DecompressBlockData(std::span<const uint8_t> compressed, std::vector<uint8_t>& block_data)
+{
+    if (compressed.size() < sizeof(uint32_t)) return false;
+    const uint32_t raw_size{ReadLE32(compressed.data())};
+    if (raw_size > MAX_SIZE) return false;
+    return util::LZDecompress(compressed.subspan(sizeof(uint32_t)), raw_size, block_data);
+}
+
 FlatFilePos BlockManager::WriteBlock(const CBlock& block, int nHeight)
 {
     const unsigned int block_size{static_cast<unsigned int>(GetSerializeSize(TX_WITH_WITNESS(block)))};
-    FlatFilePos pos{FindNextBlockPos(block_size + STORAGE_HEADER_BYTES, nHeight, block.GetBlockTime())};
+
+    // With -blockcompression, store the block compressed unless that does not save space.
+    std::vector<uint8_t> compressed_data;
+    if (m_opts.compress_blocks) {
+        std::vector<uint8_t> block_data;
+        block_data.reserve(block_size);
+        VectorWriter{block_data, 0, TX_WITH_WITNESS(block)};
+        compressed_data = CompressBlockData(block_data);
+        if (compressed_data.size() >= block_size) compressed_data.clear();
+    }
+    const unsigned int stored_size{compressed_data.empty() ? block_size : static_cast<unsigned int>(compressed_data.size())};
+
+    FlatFilePos pos{FindNextBlockPos(stored_size + STORAGE_HEADER_BYTES, nHeight, block.GetBlockTime())};
     if (pos.IsNull()) {
         LogError("FindNextBlockPos failed for %s while writing block", pos.ToString());
         return FlatFilePos();
@@ -1119,11 +1193,15 @@ FlatFilePos BlockManager::WriteBlock(const CBlock& block, int nHeight)
     
     // Write block header
     BufferedWriter fileout{file};
-    fileout << GetParams().MessageStart() << block_size;
+    fileout << GetParams().MessageStart() << (compressed_data.empty() ? block_size : stored_size | BLOCK_COMPRESSED_FLAG);
     pos.nPos += STORAGE_HEADER_BYTES;
     
     // Write block data
-    fileout << TX_WITH_WITNESS(block);
+    if (compressed_data.empty()) {
+        fileout << TX_WITH_WITNESS(block);
+    } else {
+        fileout << std::span{compressed_data};
+    }
     
     // Ensure the block is written to disk
     fileout.flush();
@@ -1230,26 +1308,58 @@ void ImportBlocks(ChainstateManager& chainman, std::span<const fs::path> import_
 
     // -reindex
     if (!chainman.m_blockman.m_blockfiles_indexed) {
-        int nFile = 0;
         // Map of disk positions for blocks with unknown parent (only used for reindex);
         // parent hash -> child disk position, multiple children can have the same parent.
-        std::multimap<uint256, FlatFilePos> blocks_with_unknown_parent;
+        std::multimap<uint256, StoredBlockPos> blocks_with_unknown_parent;
+        // Block files are read and deserialized on worker threads, a few files
+        // ahead of the one whose blocks are added to the block index here. The
+        // read-ahead is limited by the size of the files, as all blocks of a
+        // scanned file stay in memory until they are processed.
+        const int scan_threads{std::clamp(GetNumCores() - 1, 1, MAX_REINDEX_SCAN_THREADS)};
+        ThreadPool scan_pool{"reindex", scan_threads};
+        // Result of ChainstateManager::ScanBlockFile(), or std::nullopt if the file could not be opened
+        using ScannedFile = std::optional<std::vector<ScannedBlock>>;
+        struct Scan {
+            int file;
+            uint64_t bytes;
+            std::future<ScannedFile> result;
+        };
+        std::deque<Scan> scans;
+        uint64_t scan_bytes{0};
+        int next_file{0};
         while (true) {
-            FlatFilePos pos(nFile, 0);
-            if (!fs::exists(chainman.m_blockman.GetBlockPosFilename(pos))) {
-                break; // No block files left to reindex
-            }
-            AutoFile file{chainman.m_blockman.OpenBlockFile(pos, /*fReadOnly=*/true)};
-            if (file.IsNull()) {
-                break; // This error is logged in OpenBlockFile
+            while (scans.size() <= size_t(scan_threads)) {
+                const FlatFilePos pos(next_file, 0);
+                const fs::path path{chainman.m_blockman.GetBlockPosFilename(pos)};
+                std::error_code ec;
+                const uint64_t bytes{fs::file_size(path, ec)};
+                if (ec) {
+                    break; // No block files left to reindex
+                }
+                // Always scan at least one file
+                if (!scans.empty() && scan_bytes + bytes > MAX_REINDEX_SCAN_BYTES) break;
+                scan_bytes += bytes;
+                scans.push_back({next_file, bytes, scan_pool.Submit([&chainman, pos]() -> ScannedFile {
+                    AutoFile file{chainman.m_blockman.OpenBlockFile(pos, /*fReadOnly=*/true)};
+                    if (file.IsNull()) {
+                        return std::nullopt; // This error is logged in OpenBlockFile
+                    }
+                    return chainman.ScanBlockFile(file, pos.nFile);
+                })});
+                ++next_file;
             }
+            if (scans.empty()) break;
+            const int nFile{scans.front().file};
+            auto blocks{scans.front().result.get()};
+            if (!blocks) break;
             LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
-            chainman.LoadExternalBlockFile(file, &pos, &blocks_with_unknown_parent);
+            chainman.LoadScannedBlockFile(*blocks, blocks_with_unknown_parent);
+            scan_bytes -= scans.front().bytes;
+            scans.pop_front();
             if (chainman.m_interrupt) {
                 LogPrintf("Interrupt requested. Exit %s\n", __func__);
                 return;
             }
-            nFile++;
         }
         WITH_LOCK(::cs_main, chainman.m_blockman.m_block_tree_db->WriteReindexing(false));
         chainman.m_blockman.m_blockfiles_indexed = true;
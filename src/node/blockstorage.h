@@ -19,11 +19,13 @@
 #include <uint256.h>
 #include <util/fs.h>
 #include <util/hasher.h>
+#include <util/threadpool.h>
 
 #include <array>
 #include <atomic>
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <limits>
 #include <map>
 #include <memory>
@@ -71,12 +73,35 @@ using kernel::BlockTreeDB;
 static const unsigned int BLOCKFILE_CHUNK_SIZE = 0x1000000; // 16 MiB
 /** The pre-allocation chunk size for rev?????.dat files (since 0.8) */
 static const unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
+/** Number of threads serving ReadBlockAsync() and ReadBlockUndoAsync() */
+static constexpr int BLOCK_READ_THREADS{4};
+/** Maximum number of threads scanning block files ahead during -reindex */
+static constexpr int MAX_REINDEX_SCAN_THREADS{4};
+/** Maximum total size of the block files scanned ahead during -reindex. Their
+ *  deserialized blocks are held in memory until they are processed. */
+static constexpr uint64_t MAX_REINDEX_SCAN_BYTES{256 << 20};
 /** The maximum size of a blk?????.dat file (since 0.8) */
 static const unsigned int MAX_BLOCKFILE_SIZE = 0x8000000; // 128 MiB
 
 /** Size of header written by WriteBlock before a serialized CBlock (8 bytes) */
 static constexpr uint32_t STORAGE_HEADER_BYTES{std::tuple_size_v<MessageStartChars> + sizeof(unsigned int)};
 
+/**
+ * Flag set in the size field of the storage header when the block that follows is
+ * stored compressed (-blockcompression). The size field then holds the size of the
+ * compressed data, as produced by CompressBlockData().
+ */
+static constexpr uint32_t BLOCK_COMPRESSED_FLAG{0x80000000};
+
+/**
+ * Compress a serialized block for storage in a block file. The result consists of the
+ * uncompressed size (4 bytes) followed by the data compressed with util::LZCompress().
+ */
+std::vector<uint8_t> CompressBlockData(std::span<const uint8_t> block_data);
+
+/** Inverse of CompressBlockData(). Returns false if the compressed data is malformed. */
+bool DecompressBlockData(std::span<const uint8_t> compressed, std::vector<uint8_t>& block_data);
+
 /** Total overhead when writing undo data: header (8 bytes) plus checksum (32 bytes) */
 static constexpr uint32_t UNDO_DATA_DISK_OVERHEAD{STORAGE_HEADER_BYTES + uint256::size()};
 
@@ -342,8 +367,10 @@ public:
      * @param[in]  block        the block being processed
      * @param[in]  nHeight      the height of the block
      * @param[in]  pos          the position of the serialized CBlock on disk
+     * @param[in]  stored_size  the size of the block data on disk, as in its storage header. This is less
+     *                          than its serialized size if the block is stored compressed.
      */
-    void UpdateBlockInfo(const CBlock& block, unsigned int nHeight, const FlatFilePos& pos);
+    void UpdateBlockInfo(const CBlock& block, unsigned int nHeight, const FlatFilePos& pos, unsigned int stored_size);
 
     /** Whether running in -prune mode. */
     [[nodiscard]] bool IsPruneMode() const { return m_prune_mode; }
@@ -410,14 +437,40 @@ public:
      */
     void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const;
 
-    /** Functions for disk access for blocks */
-    bool ReadBlock(CBlock& block, const FlatFilePos& pos) const;
-    bool ReadBlock(CBlock& block, const CBlockIndex& index) const;
+    /**
+     * Functions for disk access for blocks.
+     *
+     * With use_arena, all transactions of the block are allocated from one
+     * per-block arena (see BlockArenaFormatter). This does not cover their
+     * inputs, outputs, scripts and witnesses. Only use this when the
+     * transactions are not retained beyond the lifetime of the block.
+     */
+    bool ReadBlock(CBlock& block, const FlatFilePos& pos, bool use_arena = false) const;
+    bool ReadBlock(CBlock& block, const CBlockIndex& index, bool use_arena = false) const;
     bool ReadRawBlock(std::vector<uint8_t>& block, const FlatFilePos& pos) const;
 
     bool ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index) const;
 
+    /**
+     * Asynchronous variants of ReadBlock and ReadBlockUndo, for callers walking
+     * the chain that want to keep several reads in flight (index sync, wallet
+     * rescans). The reads are performed on a pool of BLOCK_READ_THREADS
+     * threads shared by all callers, which is started on first use. The
+     * future holds std::nullopt if the read failed.
+     */
+    std::future<std::optional<CBlock>> ReadBlockAsync(const CBlockIndex& index, bool use_arena = false) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_read_pool_mutex);
+    std::future<std::optional<CBlockUndo>> ReadBlockUndoAsync(const CBlockIndex& index) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_read_pool_mutex);
+
     void CleanupBlockRevFiles() const;
+
+private:
+    ThreadPool& GetReadPool() const EXCLUSIVE_LOCKS_REQUIRED(!m_read_pool_mutex);
+
+    mutable Mutex m_read_pool_mutex;
+    //! Declared last, so that pending reads are done before any member they access is destroyed.
+    mutable std::unique_ptr<ThreadPool> m_read_pool GUARDED_BY(m_read_pool_mutex);
 };
 
 // Calls ActivateBestChain() even if no blocks are imported.
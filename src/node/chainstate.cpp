@@ -91,6 +91,12 @@ static ChainstateLoadResult CompleteChainstateInitialization(
                 /*cache_size_bytes=*/chainman.m_total_coinsdb_cache * init_cache_fraction,
                 /*in_memory=*/options.coins_db_in_memory,
                 /*should_wipe=*/options.wipe_chainstate_db);
+        } catch (const coinsdb_version_error& err) {
+            LogError("%s\n", err.what());
+            return {ChainstateLoadStatus::FAILURE_INCOMPATIBLE_DB, _("The chainstate database was created by a newer version "
+                                                                     "of the software, for example with a different number of "
+                                                                     "shards, and can not be opened. Please use that version, "
+                                                                     "or restart with -reindex-chainstate to rebuild it.")};
         } catch (dbwrapper_error& err) {
             LogError("%s\n", err.what());
             return {ChainstateLoadStatus::FAILURE, _("Error opening coins database")};
@@ -48,6 +48,7 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, ChainstateManage
     if (auto value{args.GetIntArg("-maxtipage")}) opts.max_tip_age = std::chrono::seconds{*value};
 
     ReadDatabaseArgs(args, opts.coins_db);
+    if (auto value{args.GetIntArg("-dbcompactionthreads")}) opts.coins_db.compaction_threads = *value;
     ReadCoinsViewArgs(args, opts.coins_view);
 
     int script_threads = args.GetIntArg("-par", DEFAULT_SCRIPTCHECK_THREADS);
@@ -65,6 +65,7 @@
 #include <ziacoin-build-config.h> // IWYU pragma: keep
 
 #include <any>
+#include <future>
 #include <memory>
 #include <optional>
 #include <utility>
@@ -599,6 +600,16 @@ public:
         WAIT_LOCK(cs_main, lock);
         return FillBlock(chainman().m_blockman.LookupBlockIndex(hash), block, lock, chainman().ActiveChain(), chainman().m_blockman);
     }
+    std::future<std::optional<CBlock>> readBlockAsync(const uint256& hash) override
+    {
+        const CBlockIndex* index{WITH_LOCK(cs_main, return chainman().m_blockman.LookupBlockIndex(hash))};
+        if (!index) {
+            std::promise<std::optional<CBlock>> unknown;
+            unknown.set_value(std::nullopt);
+            return unknown.get_future();
+        }
+        return chainman().m_blockman.ReadBlockAsync(*index);
+    }
     bool findFirstBlockWithTimeAndHeight(int64_t min_time, int min_height, const FoundBlock& block) override
     {
         WAIT_LOCK(cs_main, lock);
@@ -924,12 +935,12 @@ public:
 
     std::vector<uint256> getCoinbaseMerklePath() override
     {
-        return TransactionMerklePath(m_block_template->block, 0);
+        return merkleTree().Path(0);
     }
 
     bool submitSolution(uint32_t version, uint32_t timestamp, uint32_t nonce, CTransactionRef coinbase) override
     {
-        AddMerkleRootAndCoinbase(m_block_template->block, std::move(coinbase), version, timestamp, nonce);
+        AddMerkleRootAndCoinbase(m_block_template->block, merkleTree(), std::move(coinbase), version, timestamp, nonce);
         return chainman().ProcessNewBlock(std::make_shared<const CBlock>(m_block_template->block), /*force_processing=*/true, /*min_pow_checked=*/true, /*new_block=*/nullptr);
     }
 
@@ -944,6 +955,16 @@ public:
 
     const std::unique_ptr<CBlockTemplate> m_block_template;
 
+    //! Merkle tree of the template's transactions. Built on first use and kept,
+    //! so that each coinbase path request or submitted solution costs O(log n) hashing.
+    std::optional<MerkleTree> m_merkle_tree;
+
+    MerkleTree& merkleTree()
+    {
+        if (!m_merkle_tree) m_merkle_tree = MerkleTree::FromBlock(m_block_template->block);
+        return *m_merkle_tree;
+    }
+
     ChainstateManager& chainman() { return *Assert(m_node.chainman); }
     KernelNotifications& notifications() { return *Assert(m_node.notifications); }
     NodeContext& m_node;
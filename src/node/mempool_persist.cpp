@@ -20,6 +20,7 @@
 #include <util/time.h>
 #include <validation.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <exception>
@@ -37,6 +38,10 @@ namespace node {
 
 static const uint64_t MEMPOOL_DUMP_VERSION_NO_XOR_KEY{1};
 static const uint64_t MEMPOOL_DUMP_VERSION{2};
+/** Number of consecutive transactions from the file that are validated together.
+ *  cs_main is held for the whole batch, and shutdown is only checked in between
+ *  batches, so keep this small. */
+static constexpr size_t MEMPOOL_LOAD_BATCH_SIZE{100};
 
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active_chainstate, ImportMempoolOptions&& opts)
 {
@@ -71,53 +76,74 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
         file >> total_txns_to_load;
         uint64_t txns_tried = 0;
         LogInfo("Loading %u mempool transactions from file...\n", total_txns_to_load);
+        const auto load_start{SteadyClock::now()};
         int next_tenth_to_report = 0;
+        std::vector<CTransactionRef> batch_txs;
+        std::vector<int64_t> batch_times;
         while (txns_tried < total_txns_to_load) {
             const int percentage_done(100.0 * txns_tried / total_txns_to_load);
             if (next_tenth_to_report < percentage_done / 10) {
-                LogInfo("Progress loading mempool transactions from file: %d%% (tried %u, %u remaining)\n",
-                        percentage_done, txns_tried, total_txns_to_load - txns_tried);
+                const auto elapsed{Ticks<SecondsDouble>(SteadyClock::now() - load_start)};
+                LogInfo("Progress loading mempool transactions from file: %d%% (tried %u, %u remaining, %.0f tx/s)\n",
+                        percentage_done, txns_tried, total_txns_to_load - txns_tried, elapsed > 0 ? txns_tried / elapsed : 0.0);
                 next_tenth_to_report = percentage_done / 10;
             }
-            ++txns_tried;
 
-            CTransactionRef tx;
-            int64_t nTime;
-            int64_t nFeeDelta;
-            file >> TX_WITH_WITNESS(tx);
-            file >> nTime;
-            file >> nFeeDelta;
+            // Transactions are dumped in topological order, so consecutive
+            // transactions can be validated as a batch: their signatures are
+            // checked in parallel on the script check threads, and cs_main is
+            // taken once per batch rather than once per transaction.
+            batch_txs.clear();
+            batch_times.clear();
+            while (txns_tried < total_txns_to_load && batch_txs.size() < MEMPOOL_LOAD_BATCH_SIZE) {
+                ++txns_tried;
+
+                CTransactionRef tx;
+                int64_t nTime;
+                int64_t nFeeDelta;
+                file >> TX_WITH_WITNESS(tx);
+                file >> nTime;
+                file >> nFeeDelta;
+
+                if (opts.use_current_time) {
+                    nTime = TicksSinceEpoch<std::chrono::seconds>(now);
+                }
 
-            if (opts.use_current_time) {
-                nTime = TicksSinceEpoch<std::chrono::seconds>(now);
+                CAmount amountdelta = nFeeDelta;
+                if (amountdelta && opts.apply_fee_delta_priority) {
+                    pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
+                }
+                if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
+                    batch_txs.push_back(std::move(tx));
+                    batch_times.push_back(nTime);
+                } else {
+                    ++expired;
+                }
             }
+            if (batch_txs.empty()) continue;
 
-            CAmount amountdelta = nFeeDelta;
-            if (amountdelta && opts.apply_fee_delta_priority) {
-                pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
-            }
-            if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
-                LOCK(cs_main);
-                const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false);
-                if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
+            const auto results{WITH_LOCK(cs_main, return AcceptToMemoryPoolBatch(active_chainstate, batch_txs, batch_times, /*bypass_limits=*/false, /*test_accept=*/false))};
+            for (size_t i{0}; i < batch_txs.size(); ++i) {
+                if (results[i].m_result_type == MempoolAcceptResult::ResultType::VALID) {
                     ++count;
                 } else {
                     // mempool may contain the transaction already, e.g. from
                     // wallet(s) having loaded it while we were processing
                     // mempool transactions; consider these as valid, instead of
                     // failed, but mark them as 'already there'
-                    if (pool.exists(GenTxid::Txid(tx->GetHash()))) {
+                    if (pool.exists(GenTxid::Txid(batch_txs[i]->GetHash()))) {
                         ++already_there;
                     } else {
                         ++failed;
                     }
                 }
-            } else {
-                ++expired;
             }
             if (active_chainstate.m_chainman.m_interrupt)
                 return false;
         }
+        const auto elapsed{Ticks<SecondsDouble>(SteadyClock::now() - load_start)};
+        LogInfo("Validated %u mempool transactions from file in %.2fs (%.0f tx/s)\n",
+                txns_tried, elapsed, elapsed > 0 ? txns_tried / elapsed : 0.0);
         std::map<uint256, CAmount> mapDeltas;
         file >> mapDeltas;
 
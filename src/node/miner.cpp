@@ -303,6 +303,7 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
 {
     const auto& mempool{*Assert(m_mempool)};
     LOCK(mempool.cs);
+    pblocktemplate->m_mempool_updated = mempool.GetTransactionsUpdated();
 
     // mapModifiedTx will store sorted packages after they are modified
     // because some of their txs are already in the block
@@ -441,17 +442,20 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
     }
 }
 
-void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, uint32_t nonce)
+void AddMerkleRootAndCoinbase(CBlock& block, MerkleTree& merkle_tree, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, uint32_t nonce)
 {
+    Assume(merkle_tree.Size() == block.vtx.size());
     if (block.vtx.size() == 0) {
+        merkle_tree.Append(coinbase->GetHash());
         block.vtx.emplace_back(coinbase);
     } else {
+        merkle_tree.Update(0, coinbase->GetHash());
         block.vtx[0] = coinbase;
     }
     block.nVersion = version;
     block.nTime = timestamp;
     block.nNonce = nonce;
-    block.hashMerkleRoot = BlockMerkleRoot(block);
+    block.hashMerkleRoot = merkle_tree.Root();
 }
 
 std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainman,
@@ -465,8 +469,14 @@ std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainma
     // comes in before the next tick.
     CAmount current_fees = -1;
 
+    // The mempool state the most recently assembled template was assembled
+    // from. For a given tip, transaction selection is deterministic, so there
+    // is no need to assemble again until the mempool changes.
+    unsigned int last_mempool_updated{block_template->m_mempool_updated};
+
     // Alternate waiting for a new tip and checking if fees have risen.
-    // The latter check is expensive so we only run it once per second.
+    // The latter check is expensive so we only run it once per second, and
+    // only if the mempool changed in the meantime.
     auto now{NodeClock::now()};
     const auto deadline = now + options.timeout;
     const MillisecondsDouble tick{1000};
@@ -509,9 +519,23 @@ std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainma
          * (approximate) fees for the next block increased, perhaps more so after
          * Cluster Mempool.
          *
+         * A fresh template is only generated if the mempool changed since the
+         * last one, otherwise it would select the same transactions again.
+         * The exception is a fee_threshold of zero or less, which any fresh
+         * template meets.
+         *
          * We'll also create a new template if the tip changed during this iteration.
          */
-        if (options.fee_threshold < MAX_MONEY || tip_changed) {
+        const bool check_fees{options.fee_threshold < MAX_MONEY};
+        if (check_fees && current_fees == -1) {
+            // Calculate the original template total fees if we haven't already
+            current_fees = 0;
+            for (CAmount fee : block_template->vTxFees) {
+                current_fees += fee;
+            }
+        }
+        const bool mempool_changed{mempool && mempool->GetTransactionsUpdated() != last_mempool_updated};
+        if (tip_changed || (check_fees && (mempool_changed || options.fee_threshold <= 0))) {
             auto new_tmpl{BlockAssembler{
                 chainman.ActiveChainstate(),
                 mempool,
@@ -521,20 +545,13 @@ std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainma
             // If the tip changed, return the new template regardless of its fees.
             if (tip_changed) return new_tmpl;
 
-            // Calculate the original template total fees if we haven't already
-            if (current_fees == -1) {
-                current_fees = 0;
-                for (CAmount fee : block_template->vTxFees) {
-                    current_fees += fee;
-                }
-            }
-
             CAmount new_fees = 0;
             for (CAmount fee : new_tmpl->vTxFees) {
                 new_fees += fee;
                 Assume(options.fee_threshold != MAX_MONEY);
                 if (new_fees >= current_fees + options.fee_threshold) return new_tmpl;
             }
+            last_mempool_updated = new_tmpl->m_mempool_updated;
         }
 
         now = NodeClock::now();
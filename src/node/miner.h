@@ -29,6 +29,7 @@ class CChainParams;
 class CScript;
 class Chainstate;
 class ChainstateManager;
+class MerkleTree;
 
 namespace Consensus { struct Params; };
 
@@ -50,6 +51,9 @@ struct CBlockTemplate
     /* A vector of package fee rates, ordered by the sequence in which
      * packages are selected for inclusion in the block template.*/
     std::vector<FeeFrac> m_package_feerates;
+    /* Value of CTxMemPool::GetTransactionsUpdated() when transactions were
+     * selected. Selection for the same tip only changes once it does. */
+    unsigned int m_mempool_updated{0};
 };
 
 // Container for tracking updates to ancestor feerate as we include (parent)
@@ -235,8 +239,10 @@ void RegenerateCommitments(CBlock& block, ChainstateManager& chainman);
 /** Apply -blockmintxfee and -blockmaxweight options from ArgsManager to BlockAssembler options. */
 void ApplyArgsManOptions(const ArgsManager& gArgs, BlockAssembler::Options& options);
 
-/* Compute the block's merkle root, insert or replace the coinbase transaction and the merkle root into the block */
-void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, uint32_t nonce);
+/* Insert or replace the coinbase transaction and the merkle root into the block.
+ * merkle_tree must hold the txids of the block's transactions. It is updated
+ * for the new coinbase, which only rehashes the coinbase's merkle path. */
+void AddMerkleRootAndCoinbase(CBlock& block, MerkleTree& merkle_tree, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, uint32_t nonce);
 
 /**
  * Return a new block template when fees rise to a certain threshold or after a
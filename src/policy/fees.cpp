@@ -28,6 +28,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <optional>
 #include <stdexcept>
 #include <utility>
 
@@ -113,8 +114,19 @@ private:
     // transactions still unconfirmed after GetMaxConfirms for each bucket
     std::vector<int> oldUnconfTxs;
 
+    // Suffix sums of unconfTxs, computed on demand by UnconfirmedSince():
+    // m_unconf_since[Y][X] is the number of transactions in bucket X that have
+    // been in the mempool for at least Y (and less than GetMaxConfirms) blocks,
+    // as of block height m_unconf_since_height.
+    mutable std::vector<std::vector<int>> m_unconf_since;
+    mutable std::optional<unsigned int> m_unconf_since_height;
+
     void resizeInMemoryCounters(size_t newbuckets);
 
+    /** Return for each bucket the number of transactions that have been in the
+     *  mempool for at least confTarget blocks, excluding oldUnconfTxs. */
+    const std::vector<int>& UnconfirmedSince(unsigned int confTarget, unsigned int nBlockHeight) const;
+
 public:
     /**
      * Create new TxConfirmStats. This is called by BlockPolicyEstimator's
@@ -201,6 +213,24 @@ void TxConfirmStats::resizeInMemoryCounters(size_t newbuckets) {
         unconfTxs[i].resize(newbuckets);
     }
     oldUnconfTxs.resize(newbuckets);
+    m_unconf_since_height.reset();
+}
+
+const std::vector<int>& TxConfirmStats::UnconfirmedSince(unsigned int confTarget, unsigned int nBlockHeight) const
+{
+    const unsigned int bins = unconfTxs.size();
+    if (m_unconf_since_height != nBlockHeight) {
+        // Row bins stays all zeroes, for targets beyond what is tracked.
+        m_unconf_since.assign(bins + 1, std::vector<int>(oldUnconfTxs.size()));
+        for (unsigned int confct = bins; confct-- > 0;) {
+            const auto& unconf = unconfTxs[(nBlockHeight - confct) % bins];
+            for (unsigned int j = 0; j < oldUnconfTxs.size(); j++) {
+                m_unconf_since[confct][j] = m_unconf_since[confct + 1][j] + unconf[j];
+            }
+        }
+        m_unconf_since_height = nBlockHeight;
+    }
+    return m_unconf_since[std::min(confTarget, bins)];
 }
 
 // Roll the unconfirmed txs circular buffer
@@ -210,6 +240,7 @@ void TxConfirmStats::ClearCurrent(unsigned int nBlockHeight)
         oldUnconfTxs[j] += unconfTxs[nBlockHeight % unconfTxs.size()][j];
         unconfTxs[nBlockHeight%unconfTxs.size()][j] = 0;
     }
+    m_unconf_since_height.reset();
 }
 
 
@@ -252,6 +283,7 @@ double TxConfirmStats::EstimateMedianVal(int confTarget, double sufficientTxVal,
     double failNum = 0; // Number of tx's that were never confirmed but removed from the mempool after confTarget
     const int periodTarget = (confTarget + scale - 1) / scale;
     const int maxbucketindex = buckets.size() - 1;
+    const std::vector<int>& unconfSince = UnconfirmedSince(confTarget, nBlockHeight);
 
     // We'll combine buckets until we have enough samples.
     // The near and far variables will define the range we've combined
@@ -269,7 +301,6 @@ double TxConfirmStats::EstimateMedianVal(int confTarget, double sufficientTxVal,
     double partialNum = 0;
 
     bool foundAnswer = false;
-    unsigned int bins = unconfTxs.size();
     bool newBucketRange = true;
     bool passing = true;
     EstimatorBucket passBucket;
@@ -286,8 +317,7 @@ double TxConfirmStats::EstimateMedianVal(int confTarget, double sufficientTxVal,
         partialNum += txCtAvg[bucket];
         totalNum += txCtAvg[bucket];
         failNum += failAvg[periodTarget - 1][bucket];
-        for (unsigned int confct = confTarget; confct < GetMaxConfirms(); confct++)
-            extraNum += unconfTxs[(nBlockHeight - confct) % bins][bucket];
+        extraNum += unconfSince[bucket];
         extraNum += oldUnconfTxs[bucket];
         // If we have enough transaction data points in this range of buckets,
         // we can test for success
@@ -478,6 +508,7 @@ unsigned int TxConfirmStats::NewTx(unsigned int nBlockHeight, double val)
     unsigned int bucketindex = bucketMap.lower_bound(val)->second;
     unsigned int blockIndex = nBlockHeight % unconfTxs.size();
     unconfTxs[blockIndex][bucketindex]++;
+    m_unconf_since_height.reset();
     return bucketindex;
 }
 
@@ -509,6 +540,7 @@ void TxConfirmStats::removeTx(unsigned int entryHeight, unsigned int nBestSeenHe
                      blockIndex, bucketindex);
         }
     }
+    m_unconf_since_height.reset();
     if (!inBlock && (unsigned int)blocksAgo >= scale) { // Only counts as a failure if not confirmed for entire period
         assert(scale != 0);
         unsigned int periodsAgo = blocksAgo / scale;
@@ -529,6 +561,7 @@ bool CBlockPolicyEstimator::_removeTx(const uint256& hash, bool inBlock)
     AssertLockHeld(m_cs_fee_estimator);
     std::map<uint256, TxStatsInfo>::iterator pos = mapMemPoolTxs.find(hash);
     if (pos != mapMemPoolTxs.end()) {
+        if (UnconfirmedTxAffectsEstimates(pos->second.blockHeight)) ClearSmartFeeCache();
         feeStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         shortStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         longStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
@@ -628,6 +661,7 @@ void CBlockPolicyEstimator::processTransaction(const NewMempoolTransactionInfo&
     // Feerates are stored and reported as ZIA-per-kb:
     const CFeeRate feeRate(tx.info.m_fee, tx.info.m_virtual_transaction_size);
 
+    if (UnconfirmedTxAffectsEstimates(txHeight)) ClearSmartFeeCache();
     mapMemPoolTxs[hash].blockHeight = txHeight;
     unsigned int bucketIndex = feeStats->NewTx(txHeight, static_cast<double>(feeRate.GetFeePerK()));
     mapMemPoolTxs[hash].bucketIndex = bucketIndex;
@@ -712,6 +746,8 @@ void CBlockPolicyEstimator::processBlock(const std::vector<RemovedMempoolTransac
 
     trackedTxs = 0;
     untrackedTxs = 0;
+
+    ClearSmartFeeCache();
 }
 
 CFeeRate CBlockPolicyEstimator::estimateFee(int confTarget) const
@@ -869,7 +905,48 @@ double CBlockPolicyEstimator::estimateConservativeFee(unsigned int doubleTarget,
  */
 CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
 {
+    {
+        LOCK(m_cs_smart_fee_cache);
+        const auto& cache = m_smart_fee_cache[conservative];
+        if (confTarget > 0 && (unsigned int)confTarget <= cache.size() && cache[confTarget - 1]) {
+            if (feeCalc) *feeCalc = cache[confTarget - 1]->calc;
+            return cache[confTarget - 1]->feerate;
+        }
+    }
+
     LOCK(m_cs_fee_estimator);
+    CachedSmartFee result;
+    result.feerate = _estimateSmartFee(confTarget, &result.calc, conservative);
+    if (confTarget > 0 && (unsigned int)confTarget <= longStats->GetMaxConfirms()) {
+        LOCK(m_cs_smart_fee_cache);
+        auto& cache = m_smart_fee_cache[conservative];
+        cache.resize(longStats->GetMaxConfirms());
+        cache[confTarget - 1] = result;
+    }
+    if (feeCalc) *feeCalc = result.calc;
+    return result.feerate;
+}
+
+bool CBlockPolicyEstimator::UnconfirmedTxAffectsEstimates(unsigned int txHeight) const
+{
+    AssertLockHeld(m_cs_fee_estimator);
+    // Estimates only count transactions that have been unconfirmed for at least
+    // one block. The circular buffers index entries by height modulo their size
+    // though, so at low heights the index of the current block wraps around
+    // onto that of older ones.
+    return txHeight != nBestSeenHeight || nBestSeenHeight < longStats->GetMaxConfirms();
+}
+
+void CBlockPolicyEstimator::ClearSmartFeeCache()
+{
+    AssertLockHeld(m_cs_fee_estimator);
+    LOCK(m_cs_smart_fee_cache);
+    for (auto& cache : m_smart_fee_cache) cache.clear();
+}
+
+CFeeRate CBlockPolicyEstimator::_estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
+{
+    AssertLockHeld(m_cs_fee_estimator);
 
     if (feeCalc) {
         feeCalc->desiredTarget = confTarget;
@@ -1046,6 +1123,7 @@ bool CBlockPolicyEstimator::Read(AutoFile& filein)
             nBestSeenHeight = nFileBestSeenHeight;
             historicalFirst = nFileHistoricalFirst;
             historicalBest = nFileHistoricalBest;
+            ClearSmartFeeCache();
         }
     }
     catch (const std::exception& e) {
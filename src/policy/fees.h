@@ -18,6 +18,7 @@
 #include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -205,15 +206,15 @@ public:
     /** Process all the transactions that have been included in a block */
     void processBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block,
                       unsigned int nBlockHeight)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Process a transaction accepted to the mempool*/
     void processTransaction(const NewMempoolTransactionInfo& tx)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Remove a transaction from the mempool tracking stats for non BLOCK removal reasons*/
     bool removeTx(uint256 hash)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** DEPRECATED. Return a feerate estimate */
     CFeeRate estimateFee(int confTarget) const
@@ -225,7 +226,7 @@ public:
      *  valid over longer time horizons also.
      */
     CFeeRate estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Return a specific fee estimate calculation with a given success
      * threshold and time horizon, and optionally return detailed data about
@@ -241,11 +242,11 @@ public:
 
     /** Read estimation data from a file */
     bool Read(AutoFile& filein)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Empty mempool transactions on shutdown to record failure to confirm for txs still in mempool */
     void FlushUnconfirmed()
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Calculation of highest target that estimates are tracked for */
     unsigned int HighestTargetTracked(FeeEstimateHorizon horizon) const
@@ -253,7 +254,7 @@ public:
 
     /** Drop still unconfirmed transactions and record current estimations, if the fee estimation file is present. */
     void Flush()
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Record current fee estimations. */
     void FlushFeeEstimates()
@@ -265,11 +266,11 @@ public:
 protected:
     /** Overridden from CValidationInterface. */
     void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t /*unused*/) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
     void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason /*unused*/, uint64_t /*unused*/) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
     void MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
 private:
     mutable Mutex m_cs_fee_estimator;
@@ -301,7 +302,7 @@ private:
     std::map<double, unsigned int> bucketMap GUARDED_BY(m_cs_fee_estimator); // Map of bucket upper-bound to index into all vectors by bucket
 
     /** Process a transaction confirmed in a block*/
-    bool processBlockTx(unsigned int nBlockHeight, const RemovedMempoolTransactionInfo& tx) EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+    bool processBlockTx(unsigned int nBlockHeight, const RemovedMempoolTransactionInfo& tx) EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Helper for estimateSmartFee */
     double estimateCombinedFee(unsigned int confTarget, double successThreshold, bool checkShorterHorizon, EstimationResult *result) const EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
@@ -316,7 +317,30 @@ private:
 
     /** A non-thread-safe helper for the removeTx function */
     bool _removeTx(const uint256& hash, bool inBlock)
+        EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator, !m_cs_smart_fee_cache);
+
+    /** A non-thread-safe helper for the estimateSmartFee function */
+    CFeeRate _estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
         EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+
+    struct CachedSmartFee
+    {
+        CFeeRate feerate;
+        FeeCalculation calc;
+    };
+
+    /** Results of estimateSmartFee, indexed by [conservative][confTarget - 1], and looked
+     *  up without taking m_cs_fee_estimator. Each entry is computed the first time it is
+     *  requested after the estimates changed (e.g. a block was processed), which empties
+     *  the cache. */
+    mutable Mutex m_cs_smart_fee_cache;
+    mutable std::array<std::vector<std::optional<CachedSmartFee>>, 2> m_smart_fee_cache GUARDED_BY(m_cs_smart_fee_cache);
+
+    /** Whether adding or removing an unconfirmed transaction that entered the mempool at
+     *  txHeight can change estimateSmartFee results */
+    bool UnconfirmedTxAffectsEstimates(unsigned int txHeight) const EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+    /** Mark all cached estimateSmartFee results as out of date */
+    void ClearSmartFeeCache() EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator, !m_cs_smart_fee_cache);
 };
 
 class FeeFilterRounder
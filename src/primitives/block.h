@@ -8,9 +8,14 @@
 
 #include <primitives/transaction.h>
 #include <serialize.h>
+#include <support/allocators/arena.h>
 #include <uint256.h>
 #include <util/time.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -116,6 +121,52 @@ public:
     std::string ToString() const;
 };
 
+/**
+ * Formatter that deserializes a CBlock with all of its transactions carved out
+ * of one per-block arena, instead of one heap allocation per transaction.
+ *
+ * The resulting CTransactionRefs are ordinary shared pointers and can be used
+ * anywhere. However, each of them keeps the whole arena alive, so this should
+ * only be used for blocks whose transactions are short-lived (e.g. blocks read
+ * from disk for serving, indexing or RPC), not for transactions that may end up
+ * in long-lived structures like the wallet or the mempool.
+ *
+ * Only the transactions themselves (CTransaction and the shared_ptr control
+ * block) are taken from the arena. Their vin, vout and witness stack vectors,
+ * and scripts too long to be stored inline in CScript, are still allocated
+ * individually, as their types are fixed by CTransaction. For block 413567
+ * this saves one out of three allocations (4672 -> 3117).
+ *
+ * Usage: s >> TX_WITH_WITNESS(Using<BlockArenaFormatter>(block));
+ */
+struct BlockArenaFormatter
+{
+    /** Upper bound of the arena bytes needed per transaction (shared_ptr control block and CTransaction). */
+    static constexpr size_t ARENA_BYTES_PER_TX{sizeof(CTransaction) + 64};
+
+    template <typename Stream>
+    void Ser(Stream& s, const CBlock& block)
+    {
+        s << block;
+    }
+
+    template <typename Stream>
+    void Unser(Stream& s, CBlock& block)
+    {
+        block.SetNull();
+        s >> AsBase<CBlockHeader>(block);
+        const size_t num_tx{ReadCompactSize(s)};
+        // For DoS prevention, do not blindly allocate as much as the stream claims
+        // to contain. The arena grows by itself should the estimate be too small.
+        auto arena{std::make_shared<ArenaResource>(std::min<size_t>(num_tx * ARENA_BYTES_PER_TX, MAX_VECTOR_ALLOCATE))};
+        const ArenaAllocator<CTransaction> alloc{std::move(arena)};
+        block.vtx.reserve(std::min<size_t>(num_tx, MAX_VECTOR_ALLOCATE / sizeof(CTransactionRef)));
+        for (size_t i{0}; i < num_tx; ++i) {
+            block.vtx.push_back(std::allocate_shared<const CTransaction>(alloc, deserialize, s));
+        }
+    }
+};
+
 /** Describes a place in the block chain to another node such that if the
  * other node doesn't have the same branch, it can find a recent common trunk.
  * The further back it is, the further before the fork it may be.
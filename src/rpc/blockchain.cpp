@@ -33,6 +33,7 @@
 #include <node/utxo_snapshot.h>
 #include <node/warnings.h>
 #include <primitives/transaction.h>
+#include <rpc/jsonstream.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
@@ -55,6 +56,7 @@
 #include <stdint.h>
 
 #include <condition_variable>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -177,19 +179,24 @@ UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex
     return result;
 }
 
-UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+/** The fields of blockToJSON's result that precede "tx". */
+static UniValue BlockSummaryToJSON(const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256& pow_limit)
 {
     UniValue result = blockheaderToJSON(tip, blockindex, pow_limit);
 
     result.pushKV("strippedsize", (int)::GetSerializeSize(TX_NO_WITNESS(block)));
     result.pushKV("size", (int)::GetSerializeSize(TX_WITH_WITNESS(block)));
     result.pushKV("weight", (int)::GetBlockWeight(block));
-    UniValue txs(UniValue::VARR);
+    return result;
+}
 
+/** Call fn with the JSON representation of each transaction in block, as included in blockToJSON's result. */
+static void ForEachTxToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& blockindex, TxVerbosity verbosity, const std::function<void(UniValue&&)>& fn)
+{
     switch (verbosity) {
         case TxVerbosity::SHOW_TXID:
             for (const CTransactionRef& tx : block.vtx) {
-                txs.push_back(tx->GetHash().GetHex());
+                fn(tx->GetHash().GetHex());
             }
             break;
 
@@ -207,16 +214,33 @@ UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIn
                 const CTxUndo* txundo = (have_undo && i > 0) ? &blockUndo.vtxundo.at(i - 1) : nullptr;
                 UniValue objTx(UniValue::VOBJ);
                 TxToUniv(*tx, /*block_hash=*/uint256(), /*entry=*/objTx, /*include_hex=*/true, txundo, verbosity);
-                txs.push_back(std::move(objTx));
+                fn(std::move(objTx));
             }
             break;
     }
+}
 
+UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+{
+    UniValue result = BlockSummaryToJSON(block, tip, blockindex, pow_limit);
+    UniValue txs(UniValue::VARR);
+    ForEachTxToJSON(blockman, block, blockindex, verbosity, [&](UniValue&& tx) { txs.push_back(std::move(tx)); });
     result.pushKV("tx", std::move(txs));
 
     return result;
 }
 
+void blockToJSON(JSONStreamWriter& writer, BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+{
+    writer.BeginObject();
+    writer.KeyValues(BlockSummaryToJSON(block, tip, blockindex, pow_limit));
+    writer.Key("tx");
+    writer.BeginArray();
+    ForEachTxToJSON(blockman, block, blockindex, verbosity, [&](UniValue&& tx) { writer.Value(tx); });
+    writer.EndArray();
+    writer.EndObject();
+}
+
 static RPCHelpMan getblockcount()
 {
     return RPCHelpMan{
@@ -651,7 +675,7 @@ static CBlock GetBlockChecked(BlockManager& blockman, const CBlockIndex& blockin
         CheckBlockDataAvailability(blockman, blockindex, /*check_for_undo=*/false);
     }
 
-    if (!blockman.ReadBlock(block, blockindex)) {
+    if (!blockman.ReadBlock(block, blockindex, /*use_arena=*/true)) {
         // Block not found on disk. This shouldn't normally happen unless the block was
         // pruned right after we released the lock above.
         throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
@@ -831,6 +855,11 @@ static RPCHelpMan getblock()
         tx_verbosity = TxVerbosity::SHOW_DETAILS_AND_PREVOUT;
     }
 
+    if (tx_verbosity != TxVerbosity::SHOW_TXID && request.m_result_writer) {
+        // Send the transactions to the client as they are produced, rather than building the whole result first.
+        blockToJSON(*request.m_result_writer, chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+        return UniValue::VNULL;
+    }
     return blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
 },
     };
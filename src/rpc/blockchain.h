@@ -19,6 +19,7 @@
 class CBlock;
 class CBlockIndex;
 class Chainstate;
+class JSONStreamWriter;
 class UniValue;
 namespace node {
 class BlockManager;
@@ -37,6 +38,8 @@ double GetDifficulty(const CBlockIndex& blockindex);
 
 /** Block description to JSON */
 UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
+/** Write the same description as blockToJSON to writer, one transaction at a time */
+void blockToJSON(JSONStreamWriter& writer, node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
 
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
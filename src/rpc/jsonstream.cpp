@@ -0,0 +1,91 @@
+// Copyright (c) The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/jsonstream.h>
+
+#include <util/check.h>
+
+#include <utility>
+
+void JSONStreamWriter::BeginValue()
+{
+    if (m_stack.empty()) {
+        Assume(!m_done);
+    } else if (m_stack.back().m_is_object) {
+        Assume(m_after_key);
+        m_after_key = false;
+    } else {
+        if (!m_stack.back().m_empty) m_buffer += ',';
+        m_stack.back().m_empty = false;
+    }
+}
+
+void JSONStreamWriter::EndValue()
+{
+    if (m_stack.empty()) m_done = true;
+    if (m_buffer.size() >= m_flush_threshold) Flush();
+}
+
+void JSONStreamWriter::BeginObject()
+{
+    BeginValue();
+    m_buffer += '{';
+    m_stack.push_back({.m_is_object = true});
+}
+
+void JSONStreamWriter::EndObject()
+{
+    Assume(!m_stack.empty() && m_stack.back().m_is_object && !m_after_key);
+    m_buffer += '}';
+    m_stack.pop_back();
+    EndValue();
+}
+
+void JSONStreamWriter::BeginArray()
+{
+    BeginValue();
+    m_buffer += '[';
+    m_stack.push_back({.m_is_object = false});
+}
+
+void JSONStreamWriter::EndArray()
+{
+    Assume(!m_stack.empty() && !m_stack.back().m_is_object);
+    m_buffer += ']';
+    m_stack.pop_back();
+    EndValue();
+}
+
+void JSONStreamWriter::Key(std::string_view key)
+{
+    Assume(!m_stack.empty() && m_stack.back().m_is_object && !m_after_key);
+    if (!m_stack.back().m_empty) m_buffer += ',';
+    m_stack.back().m_empty = false;
+    m_buffer += UniValue{std::string{key}}.write();
+    m_buffer += ':';
+    m_after_key = true;
+}
+
+void JSONStreamWriter::Value(const UniValue& value)
+{
+    BeginValue();
+    m_buffer += value.write();
+    EndValue();
+}
+
+void JSONStreamWriter::KeyValues(const UniValue& obj)
+{
+    const auto& keys{obj.getKeys()};
+    const auto& values{obj.getValues()};
+    for (size_t i{0}; i < keys.size(); ++i) {
+        KeyValue(keys[i], values[i]);
+    }
+}
+
+void JSONStreamWriter::Flush()
+{
+    if (m_buffer.empty()) return;
+    m_sink(std::exchange(m_buffer, {}));
+    m_flushed = true;
+}
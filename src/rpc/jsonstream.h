@@ -0,0 +1,85 @@
+// Copyright (c) The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_RPC_JSONSTREAM_H
+#define BITCOIN_RPC_JSONSTREAM_H
+
+#include <univalue.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Writes a JSON document piecewise to a sink, so that large results never need to be held in memory as a whole,
+ * neither as a UniValue tree nor as a single string.
+ *
+ * Containers are opened and closed explicitly, while their elements (e.g. a single transaction) are passed as
+ * UniValue. Commas are inserted automatically. The output is collected in a buffer, which is passed to the sink
+ * whenever it reaches the flush threshold, and by Flush(). The output is identical to UniValue::write() without
+ * indentation.
+ */
+class JSONStreamWriter
+{
+public:
+    using Sink = std::function<void(std::string&& chunk)>;
+
+    static constexpr size_t DEFAULT_FLUSH_THRESHOLD{64 * 1024};
+
+    explicit JSONStreamWriter(Sink sink, size_t flush_threshold = DEFAULT_FLUSH_THRESHOLD)
+        : m_sink{std::move(sink)}, m_flush_threshold{flush_threshold} {}
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    /** Write a key inside an object. Must be followed by a value (or container). */
+    void Key(std::string_view key);
+    /** Write a value inside an array, after a key, or as the top-level value. */
+    void Value(const UniValue& value);
+    void KeyValue(std::string_view key, const UniValue& value)
+    {
+        Key(key);
+        Value(value);
+    }
+    /** Write all key/value pairs of obj into the current object. */
+    void KeyValues(const UniValue& obj);
+
+    /** Pass all buffered output to the sink. */
+    void Flush();
+
+    /** Whether a value is expected next: at the start of the document, or right after Key(). */
+    bool ExpectingValue() const { return m_after_key || (m_stack.empty() && !m_done); }
+    /** Number of currently open containers. */
+    size_t Depth() const { return m_stack.size(); }
+    /** Whether any output has been passed to the sink. */
+    bool Flushed() const { return m_flushed; }
+
+private:
+    struct Container {
+        bool m_is_object;
+        //! Whether no element has been written to this container yet.
+        bool m_empty{true};
+    };
+
+    Sink m_sink;
+    const size_t m_flush_threshold;
+    std::string m_buffer;
+    std::vector<Container> m_stack;
+    //! Whether a key was written, but not its value yet.
+    bool m_after_key{false};
+    //! Whether the top-level value is complete.
+    bool m_done{false};
+    bool m_flushed{false};
+
+    //! Check that a value may be written here, and write the separator needed before it.
+    void BeginValue();
+    //! Bookkeeping after a value (or container) has been completed.
+    void EndValue();
+};
+
+#endif // BITCOIN_RPC_JSONSTREAM_H
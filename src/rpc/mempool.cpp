@@ -17,6 +17,8 @@
 #include <policy/rbf.h>
 #include <policy/settings.h>
 #include <primitives/transaction.h>
+#include <rpc/jsonstream.h>
+#include <rpc/mempool.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
@@ -286,33 +288,99 @@ static std::vector<RPCResult> MempoolEntryDescription()
     };
 }
 
-static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
+/** Copy of the fields of a mempool entry that entryToJSON reports, so that they can be serialized without holding pool.cs. */
+struct MempoolEntrySnapshot {
+    Txid txid;
+    Wtxid wtxid;
+    int32_t vsize;
+    int32_t weight;
+    std::chrono::seconds time;
+    unsigned int height;
+    uint64_t descendant_count;
+    int64_t descendant_size;
+    uint64_t ancestor_count;
+    int64_t ancestor_size;
+    CAmount fee;
+    CAmount modified_fee;
+    CAmount ancestor_fees;
+    CAmount descendant_fees;
+    //! Inputs' txids that are in the mempool, in input order (possibly repeated).
+    std::vector<Txid> depends;
+    std::vector<Txid> spent_by;
+    bool bip125_replaceable;
+    bool unbroadcast;
+};
+
+static MempoolEntrySnapshot SnapshotEntry(const CTxMemPool& pool, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
 {
     AssertLockHeld(pool.cs);
 
-    info.pushKV("vsize", (int)e.GetTxSize());
-    info.pushKV("weight", (int)e.GetTxWeight());
-    info.pushKV("time", count_seconds(e.GetTime()));
-    info.pushKV("height", (int)e.GetHeight());
-    info.pushKV("descendantcount", e.GetCountWithDescendants());
-    info.pushKV("descendantsize", e.GetSizeWithDescendants());
-    info.pushKV("ancestorcount", e.GetCountWithAncestors());
-    info.pushKV("ancestorsize", e.GetSizeWithAncestors());
-    info.pushKV("wtxid", e.GetTx().GetWitnessHash().ToString());
+    const CTransaction& tx = e.GetTx();
+    MempoolEntrySnapshot snapshot{
+        .txid = tx.GetHash(),
+        .wtxid = tx.GetWitnessHash(),
+        .vsize = e.GetTxSize(),
+        .weight = e.GetTxWeight(),
+        .time = e.GetTime(),
+        .height = e.GetHeight(),
+        .descendant_count = e.GetCountWithDescendants(),
+        .descendant_size = e.GetSizeWithDescendants(),
+        .ancestor_count = e.GetCountWithAncestors(),
+        .ancestor_size = e.GetSizeWithAncestors(),
+        .fee = e.GetFee(),
+        .modified_fee = e.GetModifiedFee(),
+        .ancestor_fees = e.GetModFeesWithAncestors(),
+        .descendant_fees = e.GetModFeesWithDescendants(),
+        .depends = {},
+        .spent_by = {},
+        .bip125_replaceable = false,
+        .unbroadcast = pool.IsUnbroadcastTx(tx.GetHash()),
+    };
+
+    for (const CTxIn& txin : tx.vin)
+    {
+        if (pool.exists(GenTxid::Txid(txin.prevout.hash)))
+            snapshot.depends.push_back(txin.prevout.hash);
+    }
+
+    snapshot.spent_by.reserve(e.GetMemPoolChildrenConst().size());
+    for (const CTxMemPoolEntry& child : e.GetMemPoolChildrenConst()) {
+        snapshot.spent_by.push_back(child.GetTx().GetHash());
+    }
+
+    // Add opt-in RBF status
+    RBFTransactionState rbfState = IsRBFOptIn(tx, pool);
+    if (rbfState == RBFTransactionState::UNKNOWN) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
+    } else if (rbfState == RBFTransactionState::REPLACEABLE_BIP125) {
+        snapshot.bip125_replaceable = true;
+    }
+
+    return snapshot;
+}
+
+static void entryToJSON(UniValue& info, const MempoolEntrySnapshot& e)
+{
+    info.pushKV("vsize", (int)e.vsize);
+    info.pushKV("weight", (int)e.weight);
+    info.pushKV("time", count_seconds(e.time));
+    info.pushKV("height", (int)e.height);
+    info.pushKV("descendantcount", e.descendant_count);
+    info.pushKV("descendantsize", e.descendant_size);
+    info.pushKV("ancestorcount", e.ancestor_count);
+    info.pushKV("ancestorsize", e.ancestor_size);
+    info.pushKV("wtxid", e.wtxid.ToString());
 
     UniValue fees(UniValue::VOBJ);
-    fees.pushKV("base", ValueFromAmount(e.GetFee()));
-    fees.pushKV("modified", ValueFromAmount(e.GetModifiedFee()));
-    fees.pushKV("ancestor", ValueFromAmount(e.GetModFeesWithAncestors()));
-    fees.pushKV("descendant", ValueFromAmount(e.GetModFeesWithDescendants()));
+    fees.pushKV("base", ValueFromAmount(e.fee));
+    fees.pushKV("modified", ValueFromAmount(e.modified_fee));
+    fees.pushKV("ancestor", ValueFromAmount(e.ancestor_fees));
+    fees.pushKV("descendant", ValueFromAmount(e.descendant_fees));
     info.pushKV("fees", std::move(fees));
 
-    const CTransaction& tx = e.GetTx();
     std::set<std::string> setDepends;
-    for (const CTxIn& txin : tx.vin)
-    {
-        if (pool.exists(GenTxid::Txid(txin.prevout.hash)))
-            setDepends.insert(txin.prevout.hash.ToString());
+    for (const Txid& dep : e.depends) {
+        setDepends.insert(dep.ToString());
     }
 
     UniValue depends(UniValue::VARR);
@@ -324,23 +392,19 @@ static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPool
     info.pushKV("depends", std::move(depends));
 
     UniValue spent(UniValue::VARR);
-    for (const CTxMemPoolEntry& child : e.GetMemPoolChildrenConst()) {
-        spent.push_back(child.GetTx().GetHash().ToString());
+    for (const Txid& child : e.spent_by) {
+        spent.push_back(child.ToString());
     }
 
     info.pushKV("spentby", std::move(spent));
 
-    // Add opt-in RBF status
-    bool rbfStatus = false;
-    RBFTransactionState rbfState = IsRBFOptIn(tx, pool);
-    if (rbfState == RBFTransactionState::UNKNOWN) {
-        throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
-    } else if (rbfState == RBFTransactionState::REPLACEABLE_BIP125) {
-        rbfStatus = true;
-    }
+    info.pushKV("bip125-replaceable", e.bip125_replaceable);
+    info.pushKV("unbroadcast", e.unbroadcast);
+}
 
-    info.pushKV("bip125-replaceable", rbfStatus);
-    info.pushKV("unbroadcast", pool.IsUnbroadcastTx(tx.GetHash()));
+static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
+{
+    entryToJSON(info, SnapshotEntry(pool, e));
 }
 
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempool_sequence)
@@ -381,6 +445,27 @@ UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempoo
     }
 }
 
+void MempoolToJSON(const CTxMemPool& pool, JSONStreamWriter& writer)
+{
+    // Only copy the entries' fields while holding the lock, as serializing them and sending the result to the
+    // client takes much longer.
+    std::vector<MempoolEntrySnapshot> snapshots;
+    {
+        LOCK(pool.cs);
+        snapshots.reserve(pool.size());
+        for (const CTxMemPoolEntry& e : pool.entryAll()) {
+            snapshots.push_back(SnapshotEntry(pool, e));
+        }
+    }
+    writer.BeginObject();
+    for (const MempoolEntrySnapshot& e : snapshots) {
+        UniValue info(UniValue::VOBJ);
+        entryToJSON(info, e);
+        writer.KeyValue(e.txid.ToString(), info);
+    }
+    writer.EndObject();
+}
+
 static RPCHelpMan getrawmempool()
 {
     return RPCHelpMan{
@@ -427,7 +512,13 @@ static RPCHelpMan getrawmempool()
         include_mempool_sequence = request.params[1].get_bool();
     }
 
-    return MempoolToJSON(EnsureAnyMemPool(request.context), fVerbose, include_mempool_sequence);
+    const CTxMemPool& mempool{EnsureAnyMemPool(request.context)};
+    if (fVerbose && !include_mempool_sequence && request.m_result_writer) {
+        // Send the entries to the client as they are produced, rather than building the whole result first.
+        MempoolToJSON(mempool, *request.m_result_writer);
+        return UniValue::VNULL;
+    }
+    return MempoolToJSON(mempool, fVerbose, include_mempool_sequence);
 },
     };
 }
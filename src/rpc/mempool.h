@@ -6,6 +6,7 @@
 #define BITCOIN_RPC_MEMPOOL_H
 
 class CTxMemPool;
+class JSONStreamWriter;
 class UniValue;
 
 /** Mempool information to JSON */
@@ -14,4 +15,7 @@ UniValue MempoolInfoToJSON(const CTxMemPool& pool);
 /** Mempool to JSON */
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose = false, bool include_mempool_sequence = false);
 
+/** Write the verbose mempool JSON (as returned by MempoolToJSON with verbose=true) to writer, one entry at a time */
+void MempoolToJSON(const CTxMemPool& pool, JSONStreamWriter& writer);
+
 #endif // BITCOIN_RPC_MEMPOOL_H
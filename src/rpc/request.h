@@ -13,6 +13,8 @@
 #include <univalue.h>
 #include <util/fs.h>
 
+class JSONStreamWriter;
+
 enum class JSONRPCVersion {
     V1_LEGACY,
     V2
@@ -61,6 +63,11 @@ public:
     std::string peerAddr;
     std::any context;
     JSONRPCVersion m_json_version = JSONRPCVersion::V1_LEGACY;
+    /**
+     * If set, the method may write its whole result to this writer as a single JSON value, instead of
+     * returning it (in which case it returns null). Used for results too large to build in memory first.
+     */
+    JSONStreamWriter* m_result_writer{nullptr};
 
     void parse(const UniValue& valRequest);
     [[nodiscard]] bool IsNotification() const { return !id.has_value() && m_json_version == JSONRPCVersion::V2; };
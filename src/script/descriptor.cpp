@@ -22,6 +22,7 @@
 #include <util/vector.h>
 
 #include <algorithm>
+#include <iterator>
 #include <memory>
 #include <numeric>
 #include <optional>
@@ -175,19 +176,21 @@ public:
      */
     bool operator<(PubkeyProvider& other) const {
         FlatSigningProvider dummy;
+        KeyOriginInfo dummy_info;
 
-        std::optional<CPubKey> a = GetPubKey(0, dummy, dummy);
-        std::optional<CPubKey> b = other.GetPubKey(0, dummy, dummy);
+        std::optional<CPubKey> a = GetPubKey(0, dummy, dummy_info);
+        std::optional<CPubKey> b = other.GetPubKey(0, dummy, dummy_info);
 
         return a < b;
     }
 
-    /** Derive a public key and put it into out.
+    /** Derive a public key and put its origin into info.
+     *  The key ID is left to the caller, so that those of many keys can be computed in one batch.
      *  read_cache is the cache to read keys from (if not nullptr)
      *  write_cache is the cache to write keys to (if not nullptr)
      *  Caches are not exclusive but this is not tested. Currently we use them exclusively
      */
-    virtual std::optional<CPubKey> GetPubKey(int pos, const SigningProvider& arg, FlatSigningProvider& out, const DescriptorCache* read_cache = nullptr, DescriptorCache* write_cache = nullptr) const = 0;
+    virtual std::optional<CPubKey> GetPubKey(int pos, const SigningProvider& arg, KeyOriginInfo& info, const DescriptorCache* read_cache = nullptr, DescriptorCache* write_cache = nullptr) const = 0;
 
     /** Whether this represent multiple public keys at different positions. */
     virtual bool IsRange() const = 0;
@@ -238,15 +241,12 @@ class OriginPubkeyProvider final : public PubkeyProvider
 
 public:
     OriginPubkeyProvider(uint32_t exp_index, KeyOriginInfo info, std::unique_ptr<PubkeyProvider> provider, bool apostrophe) : PubkeyProvider(exp_index), m_origin(std::move(info)), m_provider(std::move(provider)), m_apostrophe(apostrophe) {}
-    std::optional<CPubKey> GetPubKey(int pos, const SigningProvider& arg, FlatSigningProvider& out, const DescriptorCache* read_cache = nullptr, DescriptorCache* write_cache = nullptr) const override
+    std::optional<CPubKey> GetPubKey(int pos, const SigningProvider& arg, KeyOriginInfo& info, const DescriptorCache* read_cache = nullptr, DescriptorCache* write_cache = nullptr) const override
     {
-        std::optional<CPubKey> pub = m_provider->GetPubKey(pos, arg, out, read_cache, write_cache);
+        std::optional<CPubKey> pub = m_provider->GetPubKey(pos, arg, info, read_cache, write_cache);
         if (!pub) return std::nullopt;
-        Assert(out.pubkeys.contains(pub->GetID()));
-        auto& [pubkey, suborigin] = out.origins[pub->GetID()];
-        Assert(pubkey == *pub); // m_provider must have a valid origin by this point.
-        std::copy(std::begin(m_origin.fingerprint), std::end(m_origin.fingerprint), suborigin.fingerprint);
-        suborigin.path.insert(suborigin.path.begin(), m_origin.path.begin(), m_origin.path.end());
+        std::copy(std::begin(m_origin.fingerprint), std::end(m_origin.fingerprint), info.fingerprint);
+        info.path.insert(info.path.begin(), m_origin.path.begin(), m_origin.path.end());
         return pub;
     }
     bool IsRange() const override { return m_provider->IsRange(); }
@@ -296,25 +296,23 @@ public:
 class ConstPubkeyProvider final : public PubkeyProvider
 {
     CPubKey m_pubkey;
+    CKeyID m_keyid;
     bool m_xonly;
 
     std::optional<CKey> GetPrivKey(const SigningProvider& arg) const
     {
         CKey key;
         if (!(m_xonly ? arg.GetKeyByXOnly(XOnlyPubKey(m_pubkey), key) :
-                        arg.GetKey(m_pubkey.GetID(), key))) return std::nullopt;
+                        arg.GetKey(m_keyid, key))) return std::nullopt;
         return key;
     }
 
 public:
-    ConstPubkeyProvider(uint32_t exp_index, const CPubKey& pubkey, bool xonly) : PubkeyProvider(exp_index), m_pubkey(pubkey), m_xonly(xonly) {}
-    std::optional<CPubKey> GetPubKey(int pos, const SigningProvider&, FlatSigningProvider& out, const DescriptorCache* read_cache = nullptr, DescriptorCache* write_cache = nullptr) const override
-    {
-        KeyOriginInfo info;
-        CKeyID keyid = m_pubkey.GetID();
-        std::copy(keyid.begin(), keyid.begin() + sizeof(info.fingerprint), info.fingerprint);
-        out.origins.emplace(keyid, std::make_pair(m_pubkey, info));
-        out.pubkeys.emplace(keyid, m_pubkey);
+    ConstPubkeyProvider(uint32_t exp_index, const CPubKey& pubkey, bool xonly) : PubkeyProvider(exp_index), m_pubkey(pubkey), m_keyid(pubkey.GetID()), m_xonly(xonly) {}
+    std::optional<CPubKey> GetPubKey(int pos, const SigningProvider&, KeyOriginInfo& info, const DescriptorCache* read_cache = nullptr, DescriptorCache* write_cache = nullptr) const override
+    {
+        info = KeyOriginInfo{};
+        std::copy(m_keyid.begin(), m_keyid.begin() + sizeof(info.fingerprint), info.fingerprint);
         return m_pubkey;
     }
     bool IsRange() const override { return false; }
@@ -363,6 +361,7 @@ class BIP32PubkeyProvider final : public PubkeyProvider
 {
     // Root xpub, path, and final derivation step type being used, if any
     CExtPubKey m_root_extkey;
+    CKeyID m_root_keyid;
     KeyPath m_path;
     DeriveType m_derive;
     // Whether ' or h is used in harded derivation
@@ -371,7 +370,7 @@ class BIP32PubkeyProvider final : public PubkeyProvider
     bool GetExtKey(const SigningProvider& arg, CExtKey& ret) const
     {
         CKey key;
-        if (!arg.GetKey(m_root_extkey.pubkey.GetID(), key)) return false;
+        if (!arg.GetKey(m_root_keyid, key)) return false;
         ret.nDepth = m_root_extkey.nDepth;
         std::copy(m_root_extkey.vchFingerprint, m_root_extkey.vchFingerprint + sizeof(ret.vchFingerprint), ret.vchFingerprint);
         ret.nChild = m_root_extkey.nChild;
@@ -403,14 +402,12 @@ class BIP32PubkeyProvider final : public PubkeyProvider
     }
 
 public:
-    BIP32PubkeyProvider(uint32_t exp_index, const CExtPubKey& extkey, KeyPath path, DeriveType derive, bool apostrophe) : PubkeyProvider(exp_index), m_root_extkey(extkey), m_path(std::move(path)), m_derive(derive), m_apostrophe(apostrophe) {}
+    BIP32PubkeyProvider(uint32_t exp_index, const CExtPubKey& extkey, KeyPath path, DeriveType derive, bool apostrophe) : PubkeyProvider(exp_index), m_root_extkey(extkey), m_root_keyid(extkey.pubkey.GetID()), m_path(std::move(path)), m_derive(derive), m_apostrophe(apostrophe) {}
     bool IsRange() const override { return m_derive != DeriveType::NO; }
     size_t GetSize() const override { return 33; }
-    std::optional<CPubKey> GetPubKey(int pos, const SigningProvider& arg, FlatSigningProvider& out, const DescriptorCache* read_cache = nullptr, DescriptorCache* write_cache = nullptr) const override
+    std::optional<CPubKey> GetPubKey(int pos, const SigningProvider& arg, KeyOriginInfo& info, const DescriptorCache* read_cache = nullptr, DescriptorCache* write_cache = nullptr) const override
     {
-        KeyOriginInfo info;
-        CKeyID keyid = m_root_extkey.pubkey.GetID();
-        std::copy(keyid.begin(), keyid.begin() + sizeof(info.fingerprint), info.fingerprint);
+        std::copy(m_root_keyid.begin(), m_root_keyid.begin() + sizeof(info.fingerprint), info.fingerprint);
         info.path = m_path;
         if (m_derive == DeriveType::UNHARDENED) info.path.push_back((uint32_t)pos);
         if (m_derive == DeriveType::HARDENED) info.path.push_back(((uint32_t)pos) | 0x80000000L);
@@ -449,9 +446,6 @@ public:
         }
         if (!der) return std::nullopt;
 
-        out.origins.emplace(final_extkey.pubkey.GetID(), std::make_pair(final_extkey.pubkey, info));
-        out.pubkeys.emplace(final_extkey.pubkey.GetID(), final_extkey.pubkey);
-
         if (write_cache) {
             // Only cache parent if there is any unhardened derivation
             if (m_derive != DeriveType::HARDENED) {
@@ -525,8 +519,7 @@ public:
             end_path.push_back(m_path.at(k));
         }
         // Get the fingerprint
-        CKeyID id = m_root_extkey.pubkey.GetID();
-        std::copy(id.begin(), id.begin() + 4, origin.fingerprint);
+        std::copy(m_root_keyid.begin(), m_root_keyid.begin() + 4, origin.fingerprint);
 
         CExtPubKey xpub;
         CExtKey lh_xprv;
@@ -574,6 +567,33 @@ public:
     }
 };
 
+/** A public key derived while expanding a descriptor, along with its origin and key ID. */
+struct ExpandedKey {
+    CPubKey pubkey;
+    KeyOriginInfo info;
+    //! Set by HashExpandedKeys.
+    CKeyID id;
+};
+
+/** Compute the key IDs of the keys derived by each expansion.
+ *
+ *  They are computed in one batch, which is a lot faster than hashing them one by one
+ *  when expanding a range of positions.
+ */
+void HashExpandedKeys(std::span<std::vector<ExpandedKey>> keys)
+{
+    std::vector<std::span<const unsigned char>> serialized;
+    for (const auto& pos_keys : keys) {
+        for (const ExpandedKey& key : pos_keys) serialized.emplace_back(key.pubkey.data(), key.pubkey.size());
+    }
+    std::vector<uint160> ids(serialized.size());
+    Hash160Batch(serialized, ids);
+    size_t i{0};
+    for (auto& pos_keys : keys) {
+        for (ExpandedKey& key : pos_keys) key.id = CKeyID{ids[i++]};
+    }
+}
+
 /** Base class for all Descriptor implementations. */
 class DescriptorImpl : public Descriptor
 {
@@ -597,12 +617,13 @@ protected:
      *  This function is invoked once by ExpandHelper.
      *
      *  @param pubkeys The evaluations of the m_pubkey_args field.
+     *  @param keyids The key IDs of pubkeys, computed in one batch with those of the other keys being expanded.
      *  @param scripts The evaluations of m_subdescriptor_args (one for each m_subdescriptor_args element).
      *  @param out A FlatSigningProvider to put scripts or public keys in that are necessary to the solver.
      *             The origin info of the provided pubkeys is automatically added.
      *  @return A vector with scriptPubKeys for this descriptor.
      */
-    virtual std::vector<CScript> MakeScripts(const std::vector<CPubKey>& pubkeys, std::span<const CScript> scripts, FlatSigningProvider& out) const = 0;
+    virtual std::vector<CScript> MakeScripts(const std::vector<CPubKey>& pubkeys, std::span<const CKeyID> keyids, std::span<const CScript> scripts, FlatSigningProvider& out) const = 0;
 
 public:
     DescriptorImpl(std::vector<std::unique_ptr<PubkeyProvider>> pubkeys, const std::string& name) : m_pubkey_args(std::move(pubkeys)), m_name(name), m_subdescriptor_args() {}
@@ -704,40 +725,98 @@ public:
         return ret;
     }
 
+    /** Derive the public keys of this descriptor and its subdescriptors at pos, depth first, and
+     *  append them to out_keys. Nothing is appended in case of failure. */
+    // NOLINTNEXTLINE(misc-no-recursion)
+    bool DeriveKeys(int pos, const SigningProvider& arg, const DescriptorCache* read_cache, std::vector<ExpandedKey>& out_keys, DescriptorCache* write_cache) const
+    {
+        const size_t old_size{out_keys.size()};
+        for (const auto& p : m_pubkey_args) {
+            KeyOriginInfo info;
+            std::optional<CPubKey> pubkey = p->GetPubKey(pos, arg, info, read_cache, write_cache);
+            if (!pubkey) {
+                out_keys.resize(old_size);
+                return false;
+            }
+            out_keys.push_back({*pubkey, std::move(info), {}});
+        }
+        for (const auto& subarg : m_subdescriptor_args) {
+            if (!subarg->DeriveKeys(pos, arg, read_cache, out_keys, write_cache)) {
+                out_keys.resize(old_size);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** Construct the scripts of this descriptor from the front of keys, as derived by DeriveKeys
+     *  and hashed by HashExpandedKeys, and drop the keys used. */
     // NOLINTNEXTLINE(misc-no-recursion)
-    bool ExpandHelper(int pos, const SigningProvider& arg, const DescriptorCache* read_cache, std::vector<CScript>& output_scripts, FlatSigningProvider& out, DescriptorCache* write_cache) const
+    void ExpandHelper(std::span<const ExpandedKey>& keys, std::vector<CScript>& output_scripts, FlatSigningProvider& out) const
     {
-        FlatSigningProvider subprovider;
         std::vector<CPubKey> pubkeys;
+        std::vector<CKeyID> keyids;
         pubkeys.reserve(m_pubkey_args.size());
-
-        // Construct temporary data in `pubkeys`, `subscripts`, and `subprovider` to avoid producing output in case of failure.
-        for (const auto& p : m_pubkey_args) {
-            std::optional<CPubKey> pubkey = p->GetPubKey(pos, arg, subprovider, read_cache, write_cache);
-            if (!pubkey) return false;
-            pubkeys.push_back(pubkey.value());
+        keyids.reserve(m_pubkey_args.size());
+        for (const ExpandedKey& key : keys.first(m_pubkey_args.size())) {
+            pubkeys.push_back(key.pubkey);
+            keyids.push_back(key.id);
         }
+        keys = keys.subspan(m_pubkey_args.size());
         std::vector<CScript> subscripts;
         for (const auto& subarg : m_subdescriptor_args) {
             std::vector<CScript> outscripts;
-            if (!subarg->ExpandHelper(pos, arg, read_cache, outscripts, subprovider, write_cache)) return false;
+            subarg->ExpandHelper(keys, outscripts, out);
             assert(outscripts.size() == 1);
             subscripts.emplace_back(std::move(outscripts[0]));
         }
-        out.Merge(std::move(subprovider));
+        output_scripts = MakeScripts(pubkeys, keyids, std::span{subscripts}, out);
+    }
 
-        output_scripts = MakeScripts(pubkeys, std::span{subscripts}, out);
-        return true;
+    /** Construct the scripts from all keys derived at one position, and add the keys and their origins to out. */
+    void ExpandKeys(std::span<ExpandedKey> keys, std::vector<CScript>& output_scripts, FlatSigningProvider& out) const
+    {
+        std::span<const ExpandedKey> remaining{keys};
+        ExpandHelper(remaining, output_scripts, out);
+        assert(remaining.empty());
+        for (ExpandedKey& key : keys) {
+            out.origins.emplace(key.id, std::make_pair(key.pubkey, std::move(key.info)));
+            out.pubkeys.emplace(key.id, key.pubkey);
+        }
     }
 
     bool Expand(int pos, const SigningProvider& provider, std::vector<CScript>& output_scripts, FlatSigningProvider& out, DescriptorCache* write_cache = nullptr) const final
     {
-        return ExpandHelper(pos, provider, nullptr, output_scripts, out, write_cache);
+        std::vector<ExpandedKey> keys;
+        if (!DeriveKeys(pos, provider, nullptr, keys, write_cache)) return false;
+        HashExpandedKeys(std::span{&keys, 1});
+        ExpandKeys(keys, output_scripts, out);
+        return true;
     }
 
     bool ExpandFromCache(int pos, const DescriptorCache& read_cache, std::vector<CScript>& output_scripts, FlatSigningProvider& out) const final
     {
-        return ExpandHelper(pos, DUMMY_SIGNING_PROVIDER, &read_cache, output_scripts, out, nullptr);
+        std::vector<ExpandedKey> keys;
+        if (!DeriveKeys(pos, DUMMY_SIGNING_PROVIDER, &read_cache, keys, nullptr)) return false;
+        HashExpandedKeys(std::span{&keys, 1});
+        ExpandKeys(keys, output_scripts, out);
+        return true;
+    }
+
+    bool ExpandFromCacheRange(int begin, int end, const DescriptorCache& read_cache, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out) const final
+    {
+        assert(begin <= end);
+        std::vector<std::vector<ExpandedKey>> keys(end - begin);
+        for (int pos = begin; pos < end; ++pos) {
+            if (!DeriveKeys(pos, DUMMY_SIGNING_PROVIDER, &read_cache, keys[pos - begin], nullptr)) return false;
+        }
+        HashExpandedKeys(keys);
+        output_scripts.assign(end - begin, {});
+        out.assign(end - begin, {});
+        for (size_t i = 0; i < keys.size(); ++i) {
+            ExpandKeys(keys[i], output_scripts[i], out[i]);
+        }
+        return true;
     }
 
     // NOLINTNEXTLINE(misc-no-recursion)
@@ -789,7 +868,7 @@ class AddressDescriptor final : public DescriptorImpl
     const CTxDestination m_destination;
 protected:
     std::string ToStringExtra() const override { return EncodeDestination(m_destination); }
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, std::span<const CScript>, FlatSigningProvider&) const override { return Vector(GetScriptForDestination(m_destination)); }
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, std::span<const CKeyID>, std::span<const CScript>, FlatSigningProvider&) const override { return Vector(GetScriptForDestination(m_destination)); }
 public:
     AddressDescriptor(CTxDestination destination) : DescriptorImpl({}, "addr"), m_destination(std::move(destination)) {}
     bool IsSolvable() const final { return false; }
@@ -814,7 +893,7 @@ class RawDescriptor final : public DescriptorImpl
     const CScript m_script;
 protected:
     std::string ToStringExtra() const override { return HexStr(m_script); }
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, std::span<const CScript>, FlatSigningProvider&) const override { return Vector(m_script); }
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, std::span<const CKeyID>, std::span<const CScript>, FlatSigningProvider&) const override { return Vector(m_script); }
 public:
     RawDescriptor(CScript script) : DescriptorImpl({}, "raw"), m_script(std::move(script)) {}
     bool IsSolvable() const final { return false; }
@@ -842,7 +921,7 @@ class PKDescriptor final : public DescriptorImpl
 private:
     const bool m_xonly;
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CScript>, FlatSigningProvider&) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CKeyID>, std::span<const CScript>, FlatSigningProvider&) const override
     {
         if (m_xonly) {
             CScript script = CScript() << ToByteVector(XOnlyPubKey(keys[0])) << OP_CHECKSIG;
@@ -880,10 +959,9 @@ public:
 class PKHDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CScript>, FlatSigningProvider&) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, std::span<const CKeyID> keyids, std::span<const CScript>, FlatSigningProvider&) const override
     {
-        CKeyID id = keys[0].GetID();
-        return Vector(GetScriptForDestination(PKHash(id)));
+        return Vector(GetScriptForDestination(PKHash(keyids[0])));
     }
 public:
     PKHDescriptor(std::unique_ptr<PubkeyProvider> prov) : DescriptorImpl(Vector(std::move(prov)), "pkh") {}
@@ -913,10 +991,9 @@ public:
 class WPKHDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CScript>, FlatSigningProvider&) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, std::span<const CKeyID> keyids, std::span<const CScript>, FlatSigningProvider&) const override
     {
-        CKeyID id = keys[0].GetID();
-        return Vector(GetScriptForDestination(WitnessV0KeyHash(id)));
+        return Vector(GetScriptForDestination(WitnessV0KeyHash(keyids[0])));
     }
 public:
     WPKHDescriptor(std::unique_ptr<PubkeyProvider> prov) : DescriptorImpl(Vector(std::move(prov)), "wpkh") {}
@@ -946,10 +1023,10 @@ public:
 class ComboDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CScript>, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CKeyID> keyids, std::span<const CScript>, FlatSigningProvider& out) const override
     {
         std::vector<CScript> ret;
-        CKeyID id = keys[0].GetID();
+        const CKeyID& id = keyids[0];
         ret.emplace_back(GetScriptForRawPubKey(keys[0])); // P2PK
         ret.emplace_back(GetScriptForDestination(PKHash(id))); // P2PKH
         if (keys[0].IsCompressed()) {
@@ -976,7 +1053,7 @@ class MultisigDescriptor final : public DescriptorImpl
     const bool m_sorted;
 protected:
     std::string ToStringExtra() const override { return strprintf("%i", m_threshold); }
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CScript>, FlatSigningProvider&) const override {
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CKeyID>, std::span<const CScript>, FlatSigningProvider&) const override {
         if (m_sorted) {
             std::vector<CPubKey> sorted_keys(keys);
             std::sort(sorted_keys.begin(), sorted_keys.end());
@@ -1022,7 +1099,7 @@ class MultiADescriptor final : public DescriptorImpl
     const bool m_sorted;
 protected:
     std::string ToStringExtra() const override { return strprintf("%i", m_threshold); }
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CScript>, FlatSigningProvider&) const override {
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CKeyID>, std::span<const CScript>, FlatSigningProvider&) const override {
         CScript ret;
         std::vector<XOnlyPubKey> xkeys;
         xkeys.reserve(keys.size());
@@ -1065,7 +1142,7 @@ public:
 class SHDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, std::span<const CScript> scripts, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, std::span<const CKeyID>, std::span<const CScript> scripts, FlatSigningProvider& out) const override
     {
         auto ret = Vector(GetScriptForDestination(ScriptHash(scripts[0])));
         if (ret.size()) out.scripts.emplace(CScriptID(scripts[0]), scripts[0]);
@@ -1115,7 +1192,7 @@ public:
 class WSHDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, std::span<const CScript> scripts, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, std::span<const CKeyID>, std::span<const CScript> scripts, FlatSigningProvider& out) const override
     {
         auto ret = Vector(GetScriptForDestination(WitnessV0ScriptHash(scripts[0])));
         if (ret.size()) out.scripts.emplace(CScriptID(scripts[0]), scripts[0]);
@@ -1157,7 +1234,7 @@ class TRDescriptor final : public DescriptorImpl
 {
     std::vector<int> m_depths;
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CScript> scripts, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CKeyID>, std::span<const CScript> scripts, FlatSigningProvider& out) const override
     {
         TaprootBuilder builder;
         assert(m_depths.size() == scripts.size());
@@ -1235,6 +1312,8 @@ public:
 class ScriptMaker {
     //! Keys contained in the Miniscript (the evaluation of DescriptorImpl::m_pubkey_args).
     const std::vector<CPubKey>& m_keys;
+    //! The key IDs of m_keys.
+    const std::span<const CKeyID> m_keyids;
     //! The script context we're operating within (Tapscript or P2WSH).
     const miniscript::MiniscriptContext m_script_ctx;
 
@@ -1245,11 +1324,11 @@ class ScriptMaker {
         if (miniscript::IsTapscript(m_script_ctx)) {
             return Hash160(XOnlyPubKey{m_keys[key]});
         }
-        return m_keys[key].GetID();
+        return m_keyids[key];
     }
 
 public:
-    ScriptMaker(const std::vector<CPubKey>& keys LIFETIMEBOUND, const miniscript::MiniscriptContext script_ctx) : m_keys(keys), m_script_ctx{script_ctx} {}
+    ScriptMaker(const std::vector<CPubKey>& keys LIFETIMEBOUND, std::span<const CKeyID> keyids LIFETIMEBOUND, const miniscript::MiniscriptContext script_ctx) : m_keys(keys), m_keyids(keyids), m_script_ctx{script_ctx} {}
 
     std::vector<unsigned char> ToPKBytes(uint32_t key) const {
         // In Tapscript keys always serialize as x-only, whether an x-only key was used in the descriptor or not.
@@ -1299,18 +1378,18 @@ private:
     miniscript::NodeRef<uint32_t> m_node;
 
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CScript> scripts,
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CKeyID> keyids, std::span<const CScript> scripts,
                                      FlatSigningProvider& provider) const override
     {
         const auto script_ctx{m_node->GetMsCtx()};
-        for (const auto& key : keys) {
+        for (size_t i = 0; i < keys.size(); ++i) {
             if (miniscript::IsTapscript(script_ctx)) {
-                provider.pubkeys.emplace(Hash160(XOnlyPubKey{key}), key);
+                provider.pubkeys.emplace(Hash160(XOnlyPubKey{keys[i]}), keys[i]);
             } else {
-                provider.pubkeys.emplace(key.GetID(), key);
+                provider.pubkeys.emplace(keyids[i], keys[i]);
             }
         }
-        return Vector(m_node->ToScript(ScriptMaker(keys, script_ctx)));
+        return Vector(m_node->ToScript(ScriptMaker(keys, keyids, script_ctx)));
     }
 
 public:
@@ -1356,7 +1435,7 @@ public:
 class RawTRDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CScript> scripts, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, std::span<const CKeyID>, std::span<const CScript> scripts, FlatSigningProvider& out) const override
     {
         assert(keys.size() == 1);
         XOnlyPubKey xpk(keys[0]);
@@ -2390,6 +2469,17 @@ std::unique_ptr<Descriptor> InferDescriptor(const CScript& script, const Signing
     return InferScript(script, ParseScriptContext::TOP, provider);
 }
 
+bool Descriptor::ExpandFromCacheRange(int begin, int end, const DescriptorCache& read_cache, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out) const
+{
+    assert(begin <= end);
+    output_scripts.assign(end - begin, {});
+    out.assign(end - begin, {});
+    for (int pos = begin; pos < end; ++pos) {
+        if (!ExpandFromCache(pos, read_cache, output_scripts[pos - begin], out[pos - begin])) return false;
+    }
+    return true;
+}
+
 uint256 DescriptorID(const Descriptor& desc)
 {
     std::string desc_str = desc.ToString(/*compat_format=*/true);
@@ -136,6 +136,20 @@ struct Descriptor {
      */
     virtual bool ExpandFromCache(int pos, const DescriptorCache& read_cache, std::vector<CScript>& output_scripts, FlatSigningProvider& out) const = 0;
 
+    /** Expand a descriptor at every position in [begin, end) using cached expansion data.
+     *
+     * Equivalent to calling ExpandFromCache for each position, but lets the
+     * implementation hash the public keys of all positions in one batch.
+     *
+     * @param[in] begin The first position to expand.
+     * @param[in] end One past the last position to expand.
+     * @param[in] read_cache Cached expansion data.
+     * @param[out] output_scripts The expanded scriptPubKeys, one entry per position.
+     * @param[out] out Scripts and public keys necessary for solving the expanded scriptPubKeys, one entry per position.
+     * @return false if any position could not be expanded from the cache. The outputs are then unspecified.
+     */
+    virtual bool ExpandFromCacheRange(int begin, int end, const DescriptorCache& read_cache, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out) const;
+
     /** Expand the private key for a descriptor at a specified position, if possible.
      *
      * @param[in] pos The position at which to expand the descriptor. If IsRange() is false, this is ignored.
@@ -0,0 +1,223 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
+#define BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * A monotonic memory resource, similar to std::pmr::monotonic_buffer_resource.
+ *
+ * * Allocations are carved out of a contiguous chunk by bumping a pointer.
+ *   Deallocation is a no-op; all memory is released at once when the
+ *   resource is destroyed.
+ *
+ * * The first chunk is sized by the caller, so that objects whose total size
+ *   is known up front (e.g. all transactions of one block) end up in a single
+ *   buffer. Should the estimate be too small, further chunks are allocated,
+ *   each twice the size of the previous one.
+ *
+ * ArenaResource is not thread-safe for allocation. Since deallocation does not
+ * touch the resource, objects allocated from it may be released concurrently.
+ * It is intended to be used by ArenaAllocator, which shares ownership of the
+ * resource so that it lives as long as any object allocated from it.
+ */
+class ArenaResource final
+{
+    /**
+     * Alignment of each chunk. Allocations with a larger alignment are padded.
+     */
+    static constexpr std::size_t CHUNK_ALIGN_BYTES{alignof(std::max_align_t)};
+
+    /**
+     * Contains all allocated chunks together with their size, used to free the data in the destructor.
+     */
+    std::vector<std::pair<std::byte*, std::size_t>> m_allocated_chunks{};
+
+    /**
+     * Points to the beginning of available memory for carving out allocations.
+     */
+    std::byte* m_available_memory_it{nullptr};
+
+    /**
+     * Points to the end of available memory for carving out allocations.
+     */
+    std::byte* m_available_memory_end{nullptr};
+
+    /**
+     * Sum of the bytes handed out by Allocate(), including alignment padding.
+     */
+    std::size_t m_used_bytes{0};
+
+    /**
+     * Allocate a new chunk of at least min_bytes, and at least twice the size of the previous chunk.
+     */
+    void AllocateChunk(std::size_t min_bytes)
+    {
+        std::size_t chunk_bytes{std::max(min_bytes, CHUNK_ALIGN_BYTES)};
+        if (!m_allocated_chunks.empty()) {
+            chunk_bytes = std::max(chunk_bytes, 2 * m_allocated_chunks.back().second);
+        }
+        void* storage = ::operator new (chunk_bytes, std::align_val_t{CHUNK_ALIGN_BYTES});
+        m_available_memory_it = new (storage) std::byte[chunk_bytes];
+        m_available_memory_end = m_available_memory_it + chunk_bytes;
+        m_allocated_chunks.emplace_back(m_available_memory_it, chunk_bytes);
+    }
+
+public:
+    /**
+     * Construct a new ArenaResource object which allocates the first chunk of initial_bytes.
+     */
+    explicit ArenaResource(std::size_t initial_bytes)
+    {
+        AllocateChunk(initial_bytes);
+    }
+
+    /**
+     * Disable copy & move semantics, these are not supported for the resource.
+     */
+    ArenaResource(const ArenaResource&) = delete;
+    ArenaResource& operator=(const ArenaResource&) = delete;
+    ArenaResource(ArenaResource&&) = delete;
+    ArenaResource& operator=(ArenaResource&&) = delete;
+
+    /**
+     * Deallocates all memory associated with the memory resource.
+     */
+    ~ArenaResource()
+    {
+        for (const auto& [chunk, chunk_bytes] : m_allocated_chunks) {
+            std::destroy(chunk, chunk + chunk_bytes);
+            ::operator delete ((void*)chunk, std::align_val_t{CHUNK_ALIGN_BYTES});
+        }
+    }
+
+    /**
+     * Allocates a block of bytes from the current chunk, allocating a new chunk if it is exhausted.
+     */
+    void* Allocate(std::size_t bytes, std::size_t alignment)
+    {
+        assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+        void* p = m_available_memory_it;
+        std::size_t space = m_available_memory_end - m_available_memory_it;
+        if (!std::align(alignment, bytes, p, space)) {
+            // slow path, only happens when the size estimate was too small
+            AllocateChunk(bytes + alignment);
+            p = m_available_memory_it;
+            space = m_available_memory_end - m_available_memory_it;
+            p = std::align(alignment, bytes, p, space);
+            assert(p);
+        }
+        std::byte* const end = static_cast<std::byte*>(p) + bytes;
+        m_used_bytes += end - m_available_memory_it;
+        m_available_memory_it = end;
+        return p;
+    }
+
+    /**
+     * Memory is only released when the resource is destroyed.
+     */
+    void Deallocate(void*, std::size_t, std::size_t) noexcept {}
+
+    /**
+     * Number of allocated chunks
+     */
+    [[nodiscard]] std::size_t NumAllocatedChunks() const
+    {
+        return m_allocated_chunks.size();
+    }
+
+    /**
+     * Total size in bytes of all allocated chunks
+     */
+    [[nodiscard]] std::size_t AllocatedBytes() const
+    {
+        std::size_t bytes{0};
+        for (const auto& chunk : m_allocated_chunks) bytes += chunk.second;
+        return bytes;
+    }
+
+    /**
+     * Number of bytes handed out so far, including alignment padding
+     */
+    [[nodiscard]] std::size_t UsedBytes() const
+    {
+        return m_used_bytes;
+    }
+};
+
+/**
+ * Forwards all allocations to an ArenaResource, and keeps it alive.
+ *
+ * Every copy of the allocator shares ownership of the resource. Containers and
+ * std::allocate_shared store a copy, so the arena is freed only once the last
+ * object carved out of it has been destroyed.
+ */
+template <class T>
+class ArenaAllocator
+{
+    std::shared_ptr<ArenaResource> m_resource;
+
+    template <typename U>
+    friend class ArenaAllocator;
+
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(std::shared_ptr<ArenaResource> resource) noexcept
+        : m_resource(std::move(resource))
+    {
+    }
+
+    ArenaAllocator(const ArenaAllocator& other) noexcept = default;
+    ArenaAllocator& operator=(const ArenaAllocator& other) noexcept = default;
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : m_resource(other.m_resource)
+    {
+    }
+
+    /**
+     * Forwards each call to the resource.
+     */
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(m_resource->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * Forwards each call to the resource.
+     */
+    void deallocate(T* p, size_t n) noexcept
+    {
+        m_resource->Deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    ArenaResource* resource() const noexcept
+    {
+        return m_resource.get();
+    }
+};
+
+template <class T1, class T2>
+bool operator==(const ArenaAllocator<T1>& a, const ArenaAllocator<T2>& b) noexcept
+{
+    return a.resource() == b.resource();
+}
+
+template <class T1, class T2>
+bool operator!=(const ArenaAllocator<T1>& a, const ArenaAllocator<T2>& b) noexcept
+{
+    return !(a == b);
+}
+
+#endif // BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
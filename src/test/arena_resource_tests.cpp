@@ -0,0 +1,126 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <streams.h>
+#include <support/allocators/arena.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(arena_resource_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(basic_allocating)
+{
+    ArenaResource resource{256};
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+    BOOST_CHECK_EQUAL(resource.AllocatedBytes(), 256U);
+    BOOST_CHECK_EQUAL(resource.UsedBytes(), 0U);
+
+    // allocations are carved out of the chunk back to back
+    auto* a = static_cast<std::byte*>(resource.Allocate(8, 8));
+    auto* b = static_cast<std::byte*>(resource.Allocate(8, 8));
+    BOOST_CHECK_EQUAL(b - a, 8);
+    BOOST_CHECK_EQUAL(resource.UsedBytes(), 16U);
+
+    // alignment is honored by padding
+    auto* c = static_cast<std::byte*>(resource.Allocate(1, 1));
+    auto* d = static_cast<std::byte*>(resource.Allocate(8, 16));
+    BOOST_CHECK_EQUAL(c - a, 16);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(d) % 16, 0U);
+    BOOST_CHECK_EQUAL(resource.UsedBytes(), 40U);
+
+    // deallocation does not give memory back
+    resource.Deallocate(d, 8, 16);
+    BOOST_CHECK_EQUAL(resource.UsedBytes(), 40U);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+
+    // exhausting the chunk allocates a new one of at least twice the size
+    resource.Allocate(256, 8);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+    BOOST_CHECK_GE(resource.AllocatedBytes(), 256U * 3);
+
+    // an allocation larger than twice the previous chunk gets a chunk of its own
+    resource.Allocate(10000, 8);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 3U);
+    BOOST_CHECK_GE(resource.AllocatedBytes(), 256U * 3 + 10000);
+}
+
+BOOST_AUTO_TEST_CASE(shared_ownership)
+{
+    std::weak_ptr<ArenaResource> weak_resource;
+    std::shared_ptr<const std::vector<int>> survivor;
+    {
+        auto resource{std::make_shared<ArenaResource>(1024)};
+        weak_resource = resource;
+        const ArenaAllocator<std::vector<int>> alloc{std::move(resource)};
+        auto first{std::allocate_shared<const std::vector<int>>(alloc, 3, 1)};
+        survivor = std::allocate_shared<const std::vector<int>>(alloc, 5, 2);
+        BOOST_CHECK(!weak_resource.expired());
+        BOOST_CHECK_EQUAL(alloc.resource()->NumAllocatedChunks(), 1U);
+    }
+    // the remaining object keeps the arena alive
+    BOOST_CHECK(!weak_resource.expired());
+    BOOST_CHECK_EQUAL(survivor->size(), 5U);
+    BOOST_CHECK_EQUAL(survivor->at(4), 2);
+    survivor.reset();
+    BOOST_CHECK(weak_resource.expired());
+}
+
+BOOST_AUTO_TEST_CASE(block_arena_formatter)
+{
+    CBlock block;
+    block.nVersion = 4;
+    block.nTime = 1234;
+    for (int i{0}; i < 20; ++i) {
+        CMutableTransaction mtx;
+        mtx.vin.resize(i % 3 + 1);
+        mtx.vin[0].prevout = COutPoint{Txid::FromUint256(m_rng.rand256()), uint32_t(i)};
+        mtx.vin[0].scriptSig = CScript() << std::vector<unsigned char>(i * 10, 0x42);
+        if (i % 2) mtx.vin[0].scriptWitness.stack.emplace_back(i + 1, 0x01);
+        mtx.vout.resize(i % 4 + 1);
+        mtx.vout[0].nValue = i;
+        mtx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+        block.vtx.push_back(MakeTransactionRef(std::move(mtx)));
+    }
+
+    DataStream stream{};
+    stream << TX_WITH_WITNESS(block);
+    const size_t serialized_size{stream.size()};
+
+    CBlock arena_block;
+    stream >> TX_WITH_WITNESS(Using<BlockArenaFormatter>(arena_block));
+    BOOST_CHECK(stream.empty());
+    BOOST_CHECK_EQUAL(arena_block.GetHash(), block.GetHash());
+    BOOST_REQUIRE_EQUAL(arena_block.vtx.size(), block.vtx.size());
+    for (size_t i{0}; i < block.vtx.size(); ++i) {
+        BOOST_CHECK_EQUAL(arena_block.vtx[i]->GetWitnessHash(), block.vtx[i]->GetWitnessHash());
+    }
+
+    // the arena-backed block serializes identically
+    DataStream restream{};
+    restream << TX_WITH_WITNESS(arena_block);
+    BOOST_CHECK_EQUAL(restream.size(), serialized_size);
+
+    // transactions outlive the block they were deserialized with
+    CTransactionRef tx{arena_block.vtx.back()};
+    arena_block.SetNull();
+    BOOST_CHECK_EQUAL(tx->GetWitnessHash(), block.vtx.back()->GetWitnessHash());
+
+    // truncated data throws without leaking
+    DataStream truncated{};
+    truncated << TX_WITH_WITNESS(block);
+    truncated.resize(serialized_size / 2);
+    CBlock bad_block;
+    BOOST_CHECK_THROW(truncated >> TX_WITH_WITNESS(Using<BlockArenaFormatter>(bad_block)), std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -85,6 +85,20 @@ void TestBIP324PacketVector(
     std::vector<std::byte> ciphertext(contents.size() + cipher.EXPANSION);
     cipher.Encrypt(contents, in_aad, in_ignore, ciphertext);
 
+    // Encrypting the same contents split into a prefix and the rest gives the same ciphertext.
+    {
+        BIP324Cipher split_cipher(key, ellswift_ours);
+        split_cipher.Initialize(ellswift_theirs, in_initiating);
+        for (uint32_t i = 0; i < in_idx; ++i) {
+            std::vector<std::byte> dummy(split_cipher.EXPANSION);
+            split_cipher.Encrypt({}, {}, {}, true, dummy);
+        }
+        const size_t prefix_len = m_rng.randrange(std::min<size_t>(contents.size(), BIP324Cipher::MAX_PREFIX_LEN) + 1);
+        std::vector<std::byte> split_ciphertext(contents.size() + split_cipher.EXPANSION);
+        split_cipher.Encrypt(std::span{contents}.first(prefix_len), std::span{contents}.subspan(prefix_len), in_aad, in_ignore, split_ciphertext);
+        BOOST_CHECK(split_ciphertext == ciphertext);
+    }
+
     // Verify ciphertext. Note that the test vectors specify either out_ciphertext (for short
     // messages) or out_ciphertext_endswith (for long messages), so only check the relevant one.
     if (!out_ciphertext.empty()) {
@@ -5,11 +5,15 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <clientversion.h>
+#include <interfaces/chain.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <node/kernel_notifications.h>
 #include <script/solver.h>
 #include <primitives/block.h>
+#include <script/script.h>
+#include <streams.h>
+#include <undo.h>
 #include <util/chaintype.h>
 #include <validation.h>
 
@@ -19,6 +23,8 @@
 
 using node::STORAGE_HEADER_BYTES;
 using node::BlockManager;
+using node::CompressBlockData;
+using node::DecompressBlockData;
 using node::KernelNotifications;
 using node::MAX_BLOCKFILE_SIZE;
 
@@ -46,7 +52,7 @@ BOOST_AUTO_TEST_CASE(blockmanager_find_block_pos)
     // the block is found at offset 8 because there is an 8 byte serialization header
     // consisting of 4 magic bytes + 4 length bytes before each block in a well-formed blk file.
     const FlatFilePos pos{0, STORAGE_HEADER_BYTES};
-    blockman.UpdateBlockInfo(params->GenesisBlock(), 0, pos);
+    blockman.UpdateBlockInfo(params->GenesisBlock(), 0, pos, ::GetSerializeSize(TX_WITH_WITNESS(params->GenesisBlock())));
     // now simulate what happens after reindex for the first new block processed
     // the actual block contents don't matter, just that it's a block.
     // verify that the write position is at offset 0x12d.
@@ -137,6 +143,42 @@ BOOST_FIXTURE_TEST_CASE(blockmanager_block_data_availability, TestChain100Setup)
     BOOST_CHECK(!blockman.CheckBlockDataAvailability(tip, *last_pruned_block));
 }
 
+BOOST_FIXTURE_TEST_CASE(blockmanager_read_async, TestChain100Setup)
+{
+    auto& chainman = m_node.chainman;
+    auto& blockman = chainman->m_blockman;
+    std::vector<const CBlockIndex*> indexes;
+    for (int height{1}; height <= 100; ++height) {
+        indexes.push_back(WITH_LOCK(::cs_main, return chainman->ActiveChain()[height]));
+    }
+
+    // Keep all reads in flight at once, then collect them in order
+    std::vector<std::future<std::optional<CBlock>>> blocks;
+    std::vector<std::future<std::optional<CBlockUndo>>> undos;
+    for (const CBlockIndex* index : indexes) {
+        blocks.push_back(blockman.ReadBlockAsync(*index));
+        undos.push_back(blockman.ReadBlockUndoAsync(*index));
+    }
+    for (size_t i{0}; i < indexes.size(); ++i) {
+        const std::optional<CBlock> block{blocks[i].get()};
+        BOOST_REQUIRE(block);
+        BOOST_CHECK_EQUAL(block->GetHash(), indexes[i]->GetBlockHash());
+        const std::optional<CBlockUndo> undo{undos[i].get()};
+        BOOST_REQUIRE(undo);
+        BOOST_CHECK_EQUAL(undo->vtxundo.size(), block->vtx.size() - 1);
+    }
+
+    // A failed read is reported as std::nullopt
+    CBlockIndex missing;
+    BOOST_CHECK(!blockman.ReadBlockAsync(missing).get());
+
+    // The same reads are available to the wallet through the chain interface
+    const std::optional<CBlock> tip_block{m_node.chain->readBlockAsync(indexes.back()->GetBlockHash()).get()};
+    BOOST_REQUIRE(tip_block);
+    BOOST_CHECK_EQUAL(tip_block->GetHash(), indexes.back()->GetBlockHash());
+    BOOST_CHECK(!m_node.chain->readBlockAsync(uint256::ONE).get());
+}
+
 BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
 {
     KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
@@ -195,7 +237,7 @@ BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
     // to block 2 location.
     CBlockFileInfo* block_data = blockman.GetBlockFileInfo(0);
     BOOST_CHECK_EQUAL(block_data->nBlocks, 2);
-    blockman.UpdateBlockInfo(block3, /*nHeight=*/3, /*pos=*/pos2);
+    blockman.UpdateBlockInfo(block3, /*nHeight=*/3, /*pos=*/pos2, /*stored_size=*/TEST_BLOCK_SIZE);
     // Metadata is updated...
     BOOST_CHECK_EQUAL(block_data->nBlocks, 3);
     // ...but there are still only two blocks in the file
@@ -206,4 +248,83 @@ BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
     BOOST_CHECK_EQUAL(read_block.nVersion, 2);
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_compressed_blocks)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .compress_blocks = true,
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+
+    // A block with repetitive transactions, which compresses well
+    CBlock big_block;
+    big_block.nVersion = 1;
+    for (int i = 0; i < 100; ++i) {
+        CMutableTransaction mtx;
+        mtx.vin.resize(1);
+        mtx.vin[0].prevout = COutPoint{Txid::FromUint256(uint256::ONE), uint32_t(i)};
+        mtx.vout.resize(2);
+        mtx.vout[0].scriptPubKey = CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 0x42) << OP_EQUALVERIFY << OP_CHECKSIG;
+        mtx.vout[1].scriptPubKey = mtx.vout[0].scriptPubKey;
+        big_block.vtx.push_back(MakeTransactionRef(std::move(mtx)));
+    }
+    // A block without transactions, which does not compress and is stored as is
+    CBlock small_block;
+    small_block.nVersion = 2;
+
+    DataStream big_stream{};
+    big_stream << TX_WITH_WITNESS(big_block);
+    DataStream small_stream{};
+    small_stream << TX_WITH_WITNESS(small_block);
+
+    const FlatFilePos big_pos{blockman.WriteBlock(big_block, /*nHeight=*/1)};
+    const FlatFilePos small_pos{blockman.WriteBlock(small_block, /*nHeight=*/2)};
+    BOOST_CHECK_LT(blockman.CalculateCurrentUsage(), big_stream.size() + small_stream.size() + 2 * STORAGE_HEADER_BYTES);
+    BOOST_CHECK_EQUAL(small_pos.nPos - big_pos.nPos - STORAGE_HEADER_BYTES, CompressBlockData(MakeUCharSpan(big_stream)).size());
+
+    // Both blocks are read back transparently
+    std::vector<uint8_t> raw_block;
+    BOOST_CHECK(blockman.ReadRawBlock(raw_block, big_pos));
+    BOOST_CHECK(std::ranges::equal(MakeByteSpan(raw_block), big_stream));
+    BOOST_CHECK(blockman.ReadRawBlock(raw_block, small_pos));
+    BOOST_CHECK(std::ranges::equal(MakeByteSpan(raw_block), small_stream));
+
+    CBlock read_block;
+    {
+        ASSERT_DEBUG_LOG("Errors in block header");
+        BOOST_CHECK(!blockman.ReadBlock(read_block, big_pos));
+        BOOST_CHECK_EQUAL(read_block.vtx.size(), big_block.vtx.size());
+        BOOST_CHECK_EQUAL(read_block.hashMerkleRoot, big_block.hashMerkleRoot);
+        BOOST_CHECK_EQUAL(read_block.vtx.back()->GetHash(), big_block.vtx.back()->GetHash());
+    }
+
+    // Malformed compressed data is rejected
+    auto compressed{CompressBlockData(MakeUCharSpan(big_stream))};
+    std::vector<uint8_t> decompressed;
+    BOOST_CHECK(DecompressBlockData(compressed, decompressed));
+    BOOST_CHECK(std::ranges::equal(MakeByteSpan(decompressed), big_stream));
+    compressed.pop_back();
+    BOOST_CHECK(!DecompressBlockData(compressed, decompressed));
+    BOOST_CHECK(!DecompressBlockData(std::span{compressed}.first(3), decompressed));
+
+    // During reindex, a compressed block takes the space of its compressed record, so a
+    // file with compressed and uncompressed blocks ends up with the same size as written.
+    const unsigned int written_size{blockman.GetBlockFileInfo(0)->nSize};
+    BOOST_CHECK_EQUAL(written_size, small_pos.nPos + small_stream.size());
+    blockman_opts.block_tree_db_params.path = m_args.GetDataDirNet() / "blocks" / "reindex";
+    BlockManager reindex_blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+    reindex_blockman.UpdateBlockInfo(big_block, /*nHeight=*/1, big_pos, /*stored_size=*/small_pos.nPos - big_pos.nPos - STORAGE_HEADER_BYTES);
+    BOOST_CHECK_LT(reindex_blockman.GetBlockFileInfo(0)->nSize, big_pos.nPos + big_stream.size());
+    reindex_blockman.UpdateBlockInfo(small_block, /*nHeight=*/2, small_pos, /*stored_size=*/small_stream.size());
+    BOOST_CHECK_EQUAL(reindex_blockman.GetBlockFileInfo(0)->nSize, written_size);
+    BOOST_CHECK_EQUAL(reindex_blockman.GetBlockFileInfo(0)->nBlocks, 2U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1049,6 +1049,78 @@ BOOST_FIXTURE_TEST_CASE(ccoins_flush_behavior, FlushTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_sharded_db)
+{
+    const fs::path path{m_args.GetDataDirBase() / "sharded_chainstate"};
+    std::map<COutPoint, Coin> expected;
+    {
+        // Small batches, so that every shard is written to in several parts.
+        CCoinsViewDB db{{.path = path, .cache_bytes = 1 << 23}, {.batch_write_bytes = 1 << 12, .shards = 4}};
+        BOOST_CHECK_EQUAL(db.ShardCount(), 4U);
+        CCoinsViewCache cache{&db};
+        for (int i{0}; i < 1000; ++i) {
+            const COutPoint outpoint{Txid::FromUint256(m_rng.rand256()), uint32_t(i % 3)};
+            const Coin coin{CTxOut{i, CScript() << i}, i, false};
+            expected.emplace(outpoint, coin);
+            cache.AddCoin(outpoint, Coin{coin}, /*possible_overwrite=*/false);
+        }
+        cache.SetBestBlock(m_rng.rand256());
+        BOOST_CHECK(cache.Flush());
+    }
+    BOOST_CHECK_EQUAL(CoinsDBShardPaths(path).size(), 3U);
+    {
+        // A version without sharding opens the first shard as a plain database.
+        // Its head blocks are not a state that version can replay, so it refuses
+        // to load the chainstate instead of using a partial UTXO set.
+        CDBWrapper root{{.path = path, .cache_bytes = 1 << 20}};
+        std::vector<uint256> heads;
+        BOOST_CHECK(root.Read(uint8_t{'H'}, heads));
+        BOOST_CHECK(!heads.empty() && heads.size() != 2);
+        // Versions that know the format version check it instead.
+        int version{0};
+        BOOST_CHECK(root.Read(uint8_t{'V'}, version));
+        BOOST_CHECK_EQUAL(version, COINS_DB_VERSION);
+    }
+    {
+        // The number of shards of an existing database does not change.
+        CCoinsViewDB db{{.path = path, .cache_bytes = 1 << 23}, {}};
+        BOOST_CHECK_EQUAL(db.ShardCount(), 4U);
+        BOOST_CHECK(db.GetHeadBlocks().empty());
+        for (const auto& [outpoint, coin] : expected) {
+            BOOST_CHECK(db.HaveCoin(outpoint));
+            const auto db_coin{db.GetCoin(outpoint)};
+            BOOST_CHECK(db_coin && *db_coin == coin);
+        }
+        // The cursor merges the shards into the order of a single database.
+        auto cursor{db.Cursor()};
+        for (const auto& [outpoint, coin] : expected) {
+            BOOST_REQUIRE(cursor->Valid());
+            COutPoint key;
+            Coin value;
+            BOOST_CHECK(cursor->GetKey(key) && key == outpoint);
+            BOOST_CHECK(cursor->GetValue(value) && value == coin);
+            cursor->Next();
+        }
+        BOOST_CHECK(!cursor->Valid());
+    }
+    {
+        // A database written by a newer version is refused with a clear error.
+        {
+            CDBWrapper root{{.path = path, .cache_bytes = 1 << 20}};
+            root.Write(uint8_t{'V'}, COINS_DB_VERSION + 1, /*fSync=*/true);
+        }
+        BOOST_CHECK_EXCEPTION(CCoinsViewDB(DBParams{.path = path, .cache_bytes = 1 << 23}, CoinsViewOptions{}), coinsdb_version_error,
+                              HasReason{"created by a newer version"});
+    }
+    {
+        // Wiping the database removes all shards.
+        CCoinsViewDB db{{.path = path, .cache_bytes = 1 << 23, .wipe_data = true}, {.shards = 2}};
+        BOOST_CHECK_EQUAL(db.ShardCount(), 2U);
+        BOOST_CHECK_EQUAL(CoinsDBShardPaths(path).size(), 1U);
+        BOOST_CHECK(!db.HaveCoin(expected.begin()->first));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(coins_resource_is_used)
 {
     CCoinsMapMemoryResource resource;
@@ -969,6 +969,63 @@ BOOST_AUTO_TEST_CASE(poly1305_testvector)
                  "0e410fa9d7a40ac582e77546be9a72bb");
 }
 
+BOOST_AUTO_TEST_CASE(chacha20_implementations)
+{
+    using namespace chacha20_implementation;
+    // Compare every multi-block implementation with the scalar code, including around the block counter overflow.
+    for (int i = 0; i < 100; ++i) {
+        const auto key{m_rng.randbytes<std::byte>(ChaCha20::KEYLEN)};
+        const ChaCha20::Nonce96 nonce{m_rng.rand32(), m_rng.rand64()};
+        const uint32_t seek{i % 2 ? m_rng.rand32() : uint32_t(-1 - m_rng.randrange(20))};
+        const auto in{m_rng.randbytes<std::byte>(m_rng.randrange(2048))};
+        const size_t split{m_rng.randrange(in.size() + 1)};
+
+        ChaCha20AutoDetect(STANDARD);
+        std::vector<std::byte> expected(in.size());
+        ChaCha20 c20{key};
+        c20.Seek(nonce, seek);
+        c20.Crypt(in, expected);
+
+        for (auto use_implementation : {USE_SSE2, USE_SSE2_AND_AVX2, USE_ALL}) {
+            ChaCha20AutoDetect(use_implementation);
+            std::vector<std::byte> out(in.size()), keystream(in.size());
+            c20.Seek(nonce, seek);
+            c20.Crypt(std::span{in}.first(split), std::span{out}.first(split));
+            c20.Crypt(std::span{in}.subspan(split), std::span{out}.subspan(split));
+            BOOST_CHECK(out == expected);
+            c20.Seek(nonce, seek);
+            c20.Keystream(keystream);
+            for (size_t j = 0; j < in.size(); ++j) keystream[j] ^= in[j];
+            BOOST_CHECK(keystream == expected);
+        }
+    }
+    ChaCha20AutoDetect();
+}
+
+BOOST_AUTO_TEST_CASE(poly1305_implementations)
+{
+    using namespace poly1305_implementation;
+    // Compare every multi-block implementation with the scalar code, for random and all-ones keys and messages.
+    for (int i = 0; i < 100; ++i) {
+        auto key{m_rng.randbytes<std::byte>(Poly1305::KEYLEN)};
+        auto msg{m_rng.randbytes<std::byte>(m_rng.randrange(2048))};
+        if (i % 4 == 0) std::fill(key.begin(), key.begin() + 16, std::byte{0xff});
+        if (i % 8 == 0) std::fill(msg.begin(), msg.end(), std::byte{0xff});
+        const size_t split{m_rng.randrange(msg.size() + 1)};
+
+        Poly1305AutoDetect(STANDARD);
+        std::array<std::byte, Poly1305::TAGLEN> expected, tag;
+        Poly1305{key}.Update(msg).Finalize(expected);
+
+        for (auto use_implementation : {USE_AVX2, USE_ALL}) {
+            Poly1305AutoDetect(use_implementation);
+            Poly1305{key}.Update(std::span{msg}.first(split)).Update(std::span{msg}.subspan(split)).Finalize(tag);
+            BOOST_CHECK(tag == expected);
+        }
+    }
+    Poly1305AutoDetect();
+}
+
 BOOST_AUTO_TEST_CASE(chacha20poly1305_testvectors)
 {
     // Note that in our implementation, the authentication is suffixed to the ciphertext.
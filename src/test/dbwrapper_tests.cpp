@@ -3,12 +3,16 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <dbwrapper.h>
+#include <logging.h>
+#include <test/util/logging.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
 #include <uint256.h>
 #include <util/string.h>
 
+#include <map>
 #include <memory>
+#include <optional>
 
 #include <boost/test/unit_test.hpp>
 
@@ -280,6 +284,77 @@ BOOST_AUTO_TEST_CASE(existing_data_reindex)
     BOOST_CHECK_EQUAL(res3.ToString(), in2.ToString());
 }
 
+// Check that splitting a large compaction across threads leaves the same
+// contents as compacting it on one thread.
+BOOST_AUTO_TEST_CASE(dbwrapper_subcompactions)
+{
+    // Random writes, overwrites and erases (std::nullopt) of 1 KB values.
+    std::vector<std::pair<uint256, std::optional<std::vector<uint8_t>>>> ops;
+    std::map<uint256, std::vector<uint8_t>> expected;
+    std::vector<uint256> keys;
+    for (int i{0}; i < 24'000; ++i) {
+        if (!keys.empty() && m_rng.randrange(5) == 0) {
+            ops.emplace_back(keys[m_rng.randrange(keys.size())], std::nullopt);
+        }
+        if (!keys.empty() && m_rng.randrange(7) == 0) {
+            ops.emplace_back(keys[m_rng.randrange(keys.size())], m_rng.randbytes<uint8_t>(1000));
+        }
+        keys.push_back(m_rng.rand256());
+        ops.emplace_back(keys.back(), m_rng.randbytes<uint8_t>(1000));
+    }
+    for (const auto& [key, value] : ops) {
+        if (value) {
+            expected[key] = *value;
+        } else {
+            expected.erase(key);
+        }
+    }
+
+    std::vector<std::map<uint256, std::vector<uint8_t>>> results;
+    LogInstance().EnableCategory(BCLog::LEVELDB);
+    for (const int threads : {1, 4}) {
+        const fs::path ph{m_args.GetDataDirBase() / fs::u8path(strprintf("dbwrapper_subcompactions_%d", threads))};
+        const DBParams params{.path = ph, .cache_bytes = 16 << 20, .wipe_data = true, .options = {.compaction_threads = threads}};
+        {
+            CDBWrapper dbw{params};
+            CDBBatch batch{dbw};
+            for (const auto& [key, value] : ops) {
+                if (value) {
+                    batch.Write(key, *value);
+                } else {
+                    batch.Erase(key);
+                }
+                if (batch.ApproximateSize() > (1 << 20)) {
+                    BOOST_CHECK(dbw.WriteBatch(batch));
+                    batch.Clear();
+                }
+            }
+            BOOST_CHECK(dbw.WriteBatch(batch));
+        }
+
+        auto reopen_params{params};
+        reopen_params.wipe_data = false;
+        reopen_params.options.force_compact = true;
+        std::optional<DebugLogHelper> split_log;
+        if (threads > 1) split_log.emplace("subcompactions");
+        CDBWrapper dbw{reopen_params};
+        split_log.reset();
+
+        auto& contents{results.emplace_back()};
+        std::unique_ptr<CDBIterator> it{dbw.NewIterator()};
+        for (it->SeekToFirst(); it->Valid(); it->Next()) {
+            uint256 key;
+            std::vector<uint8_t> value;
+            BOOST_REQUIRE(it->GetKey(key));
+            BOOST_REQUIRE(it->GetValue(value));
+            contents.emplace(key, std::move(value));
+        }
+        BOOST_CHECK(contents == expected);
+    }
+    LogInstance().DisableCategory(BCLog::LEVELDB);
+    BOOST_CHECK(results[0] == results[1]);
+}
+
 BOOST_AUTO_TEST_CASE(iterator_ordering)
 {
     fs::path ph = m_args.GetDataDirBase() / "iterator_ordering";
@@ -281,6 +281,16 @@ void DoCheck(std::string prv, std::string pub, const std::string& norm_pub, int
             BOOST_CHECK(script_provider.scripts == script_provider_cached.scripts);
             BOOST_CHECK(GetKeyOriginData(script_provider, flags) == GetKeyOriginData(script_provider_cached, flags));
 
+            // Expanding a range from the cache must give the same result.
+            std::vector<std::vector<CScript>> spks_range;
+            std::vector<FlatSigningProvider> script_provider_range;
+            BOOST_CHECK(parse_pub->ExpandFromCacheRange(i, i + 1, desc_cache, spks_range, script_provider_range));
+            BOOST_REQUIRE_EQUAL(spks_range.size(), 1U);
+            BOOST_REQUIRE_EQUAL(script_provider_range.size(), 1U);
+            BOOST_CHECK(spks_range[0] == spks_cached);
+            BOOST_CHECK(GetKeyData(script_provider_range[0], flags) == GetKeyData(script_provider_cached, flags));
+            BOOST_CHECK(GetKeyOriginData(script_provider_range[0], flags) == GetKeyOriginData(script_provider_cached, flags));
+
             // Check whether keys are in the cache
             const auto& der_xpub_cache = desc_cache.GetCachedDerivedExtPubKeys();
             const auto& parent_xpub_cache = desc_cache.GetCachedParentExtPubKeys();
@@ -405,6 +415,33 @@ void DoCheck(std::string prv, std::string pub, const std::string& norm_pub, int
         }
     }
 
+    // Expand a range spanning many positions from a cache filled by expanding each of them, and compare
+    // it with expanding the positions from the cache one at a time.
+    {
+        constexpr int range_end{20};
+        const FlatSigningProvider& key_provider = (flags & HARDENED) ? keys_priv : keys_pub;
+        DescriptorCache desc_cache;
+        for (int i = 0; i < range_end; ++i) {
+            FlatSigningProvider script_provider;
+            std::vector<CScript> spks;
+            BOOST_CHECK(parse_pub->Expand(i, key_provider, spks, script_provider, &desc_cache));
+        }
+        std::vector<std::vector<CScript>> spks_range;
+        std::vector<FlatSigningProvider> script_provider_range;
+        BOOST_CHECK(parse_pub->ExpandFromCacheRange(0, range_end, desc_cache, spks_range, script_provider_range));
+        BOOST_REQUIRE_EQUAL(spks_range.size(), size_t{range_end});
+        BOOST_REQUIRE_EQUAL(script_provider_range.size(), size_t{range_end});
+        for (int i = 0; i < range_end; ++i) {
+            FlatSigningProvider script_provider_cached;
+            std::vector<CScript> spks_cached;
+            BOOST_CHECK(parse_pub->ExpandFromCache(i, desc_cache, spks_cached, script_provider_cached));
+            BOOST_CHECK(spks_range[i] == spks_cached);
+            BOOST_CHECK(GetKeyData(script_provider_range[i], flags) == GetKeyData(script_provider_cached, flags));
+            BOOST_CHECK(script_provider_range[i].scripts == script_provider_cached.scripts);
+            BOOST_CHECK(GetKeyOriginData(script_provider_range[i], flags) == GetKeyOriginData(script_provider_cached, flags));
+        }
+    }
+
     // Verify no expected paths remain that were not observed.
     BOOST_CHECK_MESSAGE(left_paths.empty(), "Not all expected key paths found: " + prv);
 }
@@ -281,7 +281,7 @@ void TestType(FuzzBufferType buffer)
 
 FUZZ_TARGET(bitset)
 {
-    unsigned typdat = ReadByte(buffer) % 8;
+    unsigned typdat = ReadByte(buffer) % 9;
     if (typdat == 0) {
         /* 16 bits */
         TestType<bitset_detail::IntBitSet<uint16_t>>(buffer);
@@ -312,5 +312,9 @@ FUZZ_TARGET(bitset)
     } else if (typdat == 7) {
         /* 256 bits */
         TestType<bitset_detail::MultiIntBitSet<uint64_t, 4>>(buffer);
+        TestType<bitset_detail::MultiIntBitSet<uint32_t, 8>>(buffer);
+    } else if (typdat == 8) {
+        /* 512 bits */
+        TestType<bitset_detail::MultiIntBitSet<uint64_t, 8>>(buffer);
     }
 }
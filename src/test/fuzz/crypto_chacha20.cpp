@@ -71,6 +71,8 @@ void ChaCha20SplitFuzz(FuzzedDataProvider& provider)
     ChaCha20 crypt2(key_bytes);
     crypt1.Seek({iv_prefix, iv}, seek);
     crypt2.Seek({iv_prefix, iv}, seek);
+    // The whole array is encrypted with the scalar code, the chunks with a fuzzer-selected implementation.
+    const auto use_implementation{chacha20_implementation::UseImplementation(provider.ConsumeIntegral<uint8_t>() & chacha20_implementation::USE_ALL)};
 
     // Construct vectors with data.
     std::vector<std::byte> data1, data2;
@@ -88,6 +90,7 @@ void ChaCha20SplitFuzz(FuzzedDataProvider& provider)
     assert(data1 == data2);
 
     // Encrypt data1, the whole array at once.
+    ChaCha20AutoDetect(chacha20_implementation::STANDARD);
     if constexpr (UseCrypt) {
         crypt1.Crypt(data1, data1);
     } else {
@@ -95,6 +98,7 @@ void ChaCha20SplitFuzz(FuzzedDataProvider& provider)
     }
 
     // Encrypt data2, in at most 256 chunks.
+    ChaCha20AutoDetect(use_implementation);
     uint64_t bytes2 = 0;
     int iter = 0;
     while (true) {
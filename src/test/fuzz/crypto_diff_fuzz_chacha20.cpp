@@ -269,6 +269,9 @@ FUZZ_TARGET(crypto_diff_fuzz_chacha20)
 {
     FuzzedDataProvider fuzzed_data_provider{buffer.data(), buffer.size()};
 
+    // Compare a fuzzer-selected multi-block implementation against DJB's reference code.
+    ChaCha20AutoDetect(chacha20_implementation::UseImplementation(fuzzed_data_provider.ConsumeIntegral<uint8_t>() & chacha20_implementation::USE_ALL));
+
     ECRYPT_ctx ctx;
 
     const std::vector<unsigned char> key = ConsumeFixedLengthByteVector(fuzzed_data_provider, 32);
@@ -30,6 +30,10 @@ FUZZ_TARGET(crypto_poly1305_split)
     key.resize(Poly1305::KEYLEN);
     Poly1305 poly_full{key}, poly_split{key};
 
+    // The pieces are processed with a fuzzer-selected implementation, the entire input with the scalar code.
+    const auto use_implementation{poly1305_implementation::UseImplementation(provider.ConsumeIntegral<uint8_t>() & poly1305_implementation::USE_ALL)};
+    Poly1305AutoDetect(use_implementation);
+
     // Vector that holds all bytes processed so far.
     std::vector<std::byte> total_input;
 
@@ -42,6 +46,7 @@ FUZZ_TARGET(crypto_poly1305_split)
     }
 
     // Process entire input at once.
+    Poly1305AutoDetect(poly1305_implementation::STANDARD);
     poly_full.Update(total_input);
 
     // Verify both agree.
@@ -37,8 +37,14 @@ FUZZ_TARGET(load_external_block_file, .init = initialize_load_external_block_fil
     if (fuzzed_data_provider.ConsumeBool()) {
         // Corresponds to the -reindex case (track orphan blocks across files).
         FlatFilePos flat_file_pos;
-        std::multimap<uint256, FlatFilePos> blocks_with_unknown_parent;
-        g_setup->m_node.chainman->LoadExternalBlockFile(fuzzed_block_file, &flat_file_pos, &blocks_with_unknown_parent);
+        std::multimap<uint256, StoredBlockPos> blocks_with_unknown_parent;
+        if (fuzzed_data_provider.ConsumeBool()) {
+            g_setup->m_node.chainman->LoadExternalBlockFile(fuzzed_block_file, &flat_file_pos, &blocks_with_unknown_parent);
+        } else {
+            // As done by ImportBlocks(), with the scan normally running on another thread.
+            auto blocks{g_setup->m_node.chainman->ScanBlockFile(fuzzed_block_file, flat_file_pos.nFile)};
+            g_setup->m_node.chainman->LoadScannedBlockFile(blocks, blocks_with_unknown_parent);
+        }
     } else {
         // Corresponds to the -loadblock= case (orphan blocks aren't tracked across files).
         g_setup->m_node.chainman->LoadExternalBlockFile(fuzzed_block_file);
@@ -221,6 +221,58 @@ void SimulationTest(Transport& initiator, Transport& responder, R& rng, FuzzedDa
         }
     };
 
+    // Function to make side queue a new message behind the ones it is sending.
+    auto queue_msg_fn = [&](int side) {
+        // Don't do anything if there are too many unreceived messages already.
+        if (expected[side].size() >= 16) return;
+        // Queueing a message does not change the bytes currently being sent, if any.
+        const bool sending{!to_send[side].empty()};
+        CSerializedNetMsg msg = next_msg[side].Copy();
+        bool queued = transports[side]->QueueMessageToSend(msg, provider.ConsumeIntegralInRange<size_t>(0, 200000));
+        // Update expected more data.
+        if (!sending) expect_more[side] = expect_more_next[side];
+        expect_more_next[side] = std::nullopt;
+        // Verify consistency of GetBytesToSend after QueueMessageToSend
+        bytes_to_send_fn(/*side=*/side);
+        if (queued) {
+            // Remember that this message is now expected by the receiver.
+            expected[side].emplace_back(std::move(next_msg[side]));
+            // Construct a new next message to send.
+            next_msg[side] = make_msg_fn(/*first=*/false);
+        }
+    };
+
+    // Function to make side send out bytes from several buffers at once (if any).
+    auto send_buffers_fn = [&](int side) {
+        const auto& [bytes, _more, _msg_type] = bytes_to_send_fn(/*side=*/side);
+        std::vector<Transport::SendBuffer> buffers;
+        const bool more = transports[side]->GetBytesToSendBuffers(buffers, false, provider.ConsumeIntegralInRange<size_t>(1, 8));
+        // The first buffer must be what GetBytesToSend returns, and no buffer may be empty.
+        assert(buffers.empty() == bytes.empty());
+        if (buffers.empty()) return false;
+        assert(std::ranges::equal(buffers[0].data, bytes));
+        const size_t first_size{bytes.size()};
+        std::vector<uint8_t> all_bytes;
+        for (const auto& buffer : buffers) {
+            assert(!buffer.data.empty());
+            all_bytes.insert(all_bytes.end(), buffer.data.begin(), buffer.data.end());
+        }
+        size_t send_now = provider.ConsumeIntegralInRange<size_t>(0, all_bytes.size());
+        if (send_now == 0) return false;
+        // Add bytes to the in-flight queue, and mark those bytes as consumed.
+        in_flight[side].insert(in_flight[side].end(), all_bytes.begin(), all_bytes.begin() + send_now);
+        transports[side]->MarkBytesSent(send_now);
+        // Only if everything was sent, it is known whether more bytes follow.
+        expect_more[side] = send_now == all_bytes.size() ? std::optional{more} : std::nullopt;
+        expect_more_next[side] = std::nullopt;
+        // Remove the bytes from the last reported to-be-sent vector.
+        assert(to_send[side].size() == first_size);
+        to_send[side].erase(to_send[side].begin(), to_send[side].begin() + std::min(send_now, first_size));
+        // Verify that GetBytesToSend gives a result consistent with earlier.
+        bytes_to_send_fn(/*side=*/side);
+        return true;
+    };
+
     // Function to make side send out bytes (if any).
     auto send_fn = [&](int side, bool everything = false) {
         const auto& [bytes, more, msg_type] = bytes_to_send_fn(/*side=*/side);
@@ -299,9 +351,13 @@ void SimulationTest(Transport& initiator, Transport& responder, R& rng, FuzzedDa
             // (Try to) give the next message to the transport.
             [&] { new_msg_fn(/*side=*/0); },
             [&] { new_msg_fn(/*side=*/1); },
+            [&] { queue_msg_fn(/*side=*/0); },
+            [&] { queue_msg_fn(/*side=*/1); },
             // (Try to) send some bytes from the transport to the network.
             [&] { send_fn(/*side=*/0); },
             [&] { send_fn(/*side=*/1); },
+            [&] { send_buffers_fn(/*side=*/0); },
+            [&] { send_buffers_fn(/*side=*/1); },
             // (Try to) receive bytes from the network, converting to messages.
             [&] { recv_fn(/*side=*/0); },
             [&] { recv_fn(/*side=*/1); }
@@ -670,6 +670,18 @@ FUZZ_TARGET(txgraph)
                 // DoWork.
                 real->DoWork();
                 break;
+            } else if (command-- == 0) {
+                // ImproveLinearizations.
+                auto max_iters = provider.ConsumeIntegralInRange<uint64_t>(0, alt ? 10000 : 100);
+                auto all_optimal = real->ImproveLinearizations(max_iters);
+                auto [num_optimal, num_other] = real->GetMainClusterQualityCounts();
+                if (all_optimal) {
+                    assert(!main_sim.IsOversized());
+                    assert(block_builders.empty());
+                    assert(num_other == 0);
+                }
+                if (num_optimal + num_other == 0) assert(main_sim.GetTransactionCount() == 0);
+                break;
             } else if (sims.size() == 2 && !sims[0].IsOversized() && !sims[1].IsOversized() && command-- == 0) {
                 // GetMainStagingDiagrams()
                 auto [real_main_diagram, real_staged_diagram] = real->GetMainStagingDiagrams();
@@ -9,6 +9,8 @@
 #include <test/util/setup_common.h>
 #include <util/strencodings.h>
 
+#include <vector>
+
 #include <boost/test/unit_test.hpp>
 
 BOOST_FIXTURE_TEST_SUITE(hash_tests, BasicTestingSetup)
@@ -148,4 +150,43 @@ BOOST_AUTO_TEST_CASE(siphash)
     }
 }
 
+BOOST_AUTO_TEST_CASE(siphash_batch)
+{
+    // Cover every remainder after the 4- and 8-lane implementations.
+    for (size_t count = 0; count <= 35; ++count) {
+        const uint64_t k0 = m_rng.rand64();
+        const uint64_t k1 = m_rng.rand64();
+        std::vector<uint256> vals(count);
+        std::vector<const uint256*> ptrs;
+        for (auto& val : vals) {
+            val = m_rng.rand256();
+            ptrs.push_back(&val);
+        }
+        std::vector<uint64_t> out(count);
+        SipHashUint256Batch(k0, k1, ptrs, out);
+        for (size_t i = 0; i < count; ++i) {
+            BOOST_CHECK_EQUAL(out[i], SipHashUint256(k0, k1, vals[i]));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hash160_batch)
+{
+    // Mix compressed and uncompressed public key sizes, and cover every
+    // remainder after the 8-lane RIPEMD-160 implementation.
+    for (size_t count = 0; count <= 20; ++count) {
+        std::vector<std::vector<unsigned char>> data;
+        std::vector<std::span<const unsigned char>> in;
+        for (size_t i = 0; i < count; ++i) {
+            data.push_back(m_rng.randbytes(m_rng.randbool() ? 33 : 65));
+        }
+        for (const auto& d : data) in.emplace_back(d);
+        std::vector<uint160> out(count);
+        Hash160Batch(in, out);
+        for (size_t i = 0; i < count; ++i) {
+            BOOST_CHECK_EQUAL(out[i], Hash160(data[i]));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
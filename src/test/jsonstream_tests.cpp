@@ -0,0 +1,103 @@
+// Copyright (c) The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/jsonstream.h>
+#include <test/util/setup_common.h>
+#include <univalue.h>
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(jsonstream_tests, BasicTestingSetup)
+
+/** Stream value the way a streaming RPC would: containers explicitly, their elements as UniValue. */
+static void StreamValue(JSONStreamWriter& writer, const UniValue& value)
+{
+    if (value.isObject()) {
+        writer.BeginObject();
+        for (size_t i{0}; i < value.size(); ++i) {
+            writer.Key(value.getKeys()[i]);
+            StreamValue(writer, value.getValues()[i]);
+        }
+        writer.EndObject();
+    } else if (value.isArray()) {
+        writer.BeginArray();
+        for (const UniValue& element : value.getValues()) StreamValue(writer, element);
+        writer.EndArray();
+    } else {
+        writer.Value(value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(jsonstream_matches_univalue)
+{
+    UniValue inner{UniValue::VOBJ};
+    inner.pushKV("a", 1);
+    inner.pushKV("quote\"and\\backslash", "line\nbreak");
+    inner.pushKV("empty_obj", UniValue{UniValue::VOBJ});
+    inner.pushKV("empty_arr", UniValue{UniValue::VARR});
+    UniValue arr{UniValue::VARR};
+    arr.push_back(inner);
+    arr.push_back(UniValue{});
+    arr.push_back(true);
+    arr.push_back(inner);
+    UniValue doc{UniValue::VOBJ};
+    doc.pushKV("x", arr);
+    doc.pushKV("y", inner);
+    doc.pushKV("z", -2.5);
+
+    for (const size_t threshold : {size_t{0}, size_t{1}, size_t{7}, JSONStreamWriter::DEFAULT_FLUSH_THRESHOLD}) {
+        std::vector<std::string> chunks;
+        JSONStreamWriter writer{[&](std::string&& chunk) { chunks.push_back(std::move(chunk)); }, threshold};
+        BOOST_CHECK(writer.ExpectingValue());
+        StreamValue(writer, doc);
+        BOOST_CHECK(!writer.ExpectingValue());
+        BOOST_CHECK_EQUAL(writer.Depth(), 0U);
+        writer.Flush();
+        BOOST_CHECK(writer.Flushed());
+
+        std::string out;
+        for (const std::string& chunk : chunks) {
+            BOOST_CHECK(!chunk.empty());
+            out += chunk;
+        }
+        BOOST_CHECK_EQUAL(out, doc.write());
+        // Small thresholds split the output, but only after complete values.
+        if (threshold == 1) BOOST_CHECK(chunks.size() > 1);
+        if (threshold == JSONStreamWriter::DEFAULT_FLUSH_THRESHOLD) BOOST_CHECK_EQUAL(chunks.size(), 1U);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(jsonstream_state)
+{
+    std::string out;
+    JSONStreamWriter writer{[&](std::string&& chunk) { out += chunk; }};
+    writer.BeginObject();
+    BOOST_CHECK(!writer.ExpectingValue());
+    BOOST_CHECK_EQUAL(writer.Depth(), 1U);
+    writer.KeyValue("jsonrpc", "2.0");
+    writer.Key("result");
+    BOOST_CHECK(writer.ExpectingValue());
+    writer.BeginArray();
+    BOOST_CHECK(!writer.ExpectingValue());
+    BOOST_CHECK_EQUAL(writer.Depth(), 2U);
+    writer.Value(1);
+    writer.Value("two");
+    writer.EndArray();
+    BOOST_CHECK_EQUAL(writer.Depth(), 1U);
+    UniValue rest{UniValue::VOBJ};
+    rest.pushKV("error", UniValue{});
+    rest.pushKV("id", 3);
+    writer.KeyValues(rest);
+    writer.EndObject();
+    BOOST_CHECK(!writer.Flushed());
+    BOOST_CHECK(out.empty());
+    writer.Flush();
+    BOOST_CHECK(writer.Flushed());
+    BOOST_CHECK_EQUAL(out, R"({"jsonrpc":"2.0","result":[1,"two"],"error":null,"id":3})");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <common/system.h>
+#include <memusage.h>
 #include <policy/policy.h>
 #include <test/util/txmempool.h>
 #include <txmempool.h>
@@ -126,6 +127,47 @@ static void CheckSort(CTxMemPool& pool, std::vector<std::string>& sortedOrder) E
     }
 }
 
+BOOST_AUTO_TEST_CASE(MempoolParentChildUsageTest)
+{
+    // Linking a child to its in-mempool parent costs one small allocation for
+    // each of the parent's children set and the child's parents set.
+    TestMemPoolEntryHelper entry;
+    CMutableTransaction tx_parent;
+    tx_parent.vin.resize(1);
+    tx_parent.vin[0].scriptSig = CScript() << OP_11;
+    tx_parent.vout.resize(1);
+    tx_parent.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    tx_parent.vout[0].nValue = 33000LL;
+
+    // Two transactions of the same shape, only one of which spends tx_parent
+    CMutableTransaction tx_unrelated;
+    tx_unrelated.vin.resize(1);
+    tx_unrelated.vin[0].scriptSig = CScript() << OP_11;
+    tx_unrelated.vin[0].prevout = COutPoint{Txid::FromUint256(uint256::ONE), 0};
+    tx_unrelated.vout.resize(1);
+    tx_unrelated.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    tx_unrelated.vout[0].nValue = 11000LL;
+    CMutableTransaction tx_child{tx_unrelated};
+    tx_child.vin[0].prevout = COutPoint{tx_parent.GetHash(), 0};
+
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(::cs_main, pool.cs);
+    AddToMempool(pool, entry.FromTx(tx_parent));
+    AddToMempool(pool, entry.FromTx(tx_unrelated));
+    const size_t usage_unrelated{pool.DynamicMemoryUsage()};
+    pool.removeRecursive(CTransaction(tx_unrelated), REMOVAL_REASON_DUMMY);
+    AddToMempool(pool, entry.FromTx(tx_child));
+    const size_t usage_child{pool.DynamicMemoryUsage()};
+    BOOST_CHECK_EQUAL(usage_child - usage_unrelated, 2 * memusage::MallocUsage(sizeof(CTxMemPoolEntryRef)));
+
+    // Memory for the sets is released again when the child leaves the mempool
+    pool.removeRecursive(CTransaction(tx_child), REMOVAL_REASON_DUMMY);
+    AddToMempool(pool, entry.FromTx(tx_unrelated));
+    BOOST_CHECK_EQUAL(pool.DynamicMemoryUsage(), usage_unrelated);
+    pool.removeRecursive(CTransaction(tx_parent), REMOVAL_REASON_DUMMY);
+    pool.removeRecursive(CTransaction(tx_unrelated), REMOVAL_REASON_DUMMY);
+}
+
 BOOST_AUTO_TEST_CASE(MempoolIndexingTest)
 {
     CTxMemPool& pool = *Assert(m_node.mempool);
@@ -245,4 +245,42 @@ BOOST_AUTO_TEST_CASE(merkle_test_BlockWitness)
 
     BOOST_CHECK_EQUAL(merkleRootofHashes, blockWitness);
 }
+
+BOOST_AUTO_TEST_CASE(merkle_tree_incremental)
+{
+    for (size_t size = 0; size <= 40; ++size) {
+        std::vector<uint256> leaves(size);
+        for (auto& leaf : leaves) leaf = m_rng.rand256();
+
+        // Building at once and appending one by one give the same tree.
+        MerkleTree tree{leaves};
+        MerkleTree appended;
+        for (const auto& leaf : leaves) appended.Append(leaf);
+        BOOST_CHECK_EQUAL(tree.Size(), size);
+        BOOST_CHECK_EQUAL(appended.Size(), size);
+        BOOST_CHECK_EQUAL(tree.Root(), ComputeMerkleRoot(leaves));
+        BOOST_CHECK_EQUAL(appended.Root(), ComputeMerkleRoot(leaves));
+        if (size == 0) continue;
+
+        // Replace a random leaf, e.g. the coinbase of a block template.
+        const size_t pos = m_rng.randrange(size);
+        leaves[pos] = m_rng.rand256();
+        tree.Update(pos, leaves[pos]);
+        BOOST_CHECK_EQUAL(tree.Root(), ComputeMerkleRoot(leaves));
+
+        // Paths match the ones computed from scratch, and lead to the root.
+        CBlock block;
+        for (const auto& leaf : leaves) {
+            CMutableTransaction mtx;
+            mtx.nLockTime = leaf.GetUint64(0);
+            block.vtx.push_back(MakeTransactionRef(std::move(mtx)));
+        }
+        const MerkleTree block_tree{MerkleTree::FromBlock(block)};
+        BOOST_CHECK_EQUAL(block_tree.Root(), BlockMerkleRoot(block));
+        for (uint32_t i = 0; i < size; ++i) {
+            BOOST_CHECK(block_tree.Path(i) == TransactionMerklePath(block, i));
+            BOOST_CHECK_EQUAL(ComputeMerkleRootFromBranch(leaves[i], tree.Path(i), i), tree.Root());
+        }
+    }
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -11,6 +11,7 @@
 #include <interfaces/mining.h>
 #include <node/miner.h>
 #include <policy/policy.h>
+#include <test/util/logging.h>
 #include <test/util/random.h>
 #include <test/util/txmempool.h>
 #include <txmempool.h>
@@ -26,6 +27,7 @@
 #include <test/util/setup_common.h>
 
 #include <memory>
+#include <numeric>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
@@ -150,6 +152,36 @@ void MinerTestingSetup::TestPackageSelection(const CScript& scriptPubKey, const
     BOOST_CHECK(block.vtx[2]->GetHash() == hashHighFeeTx);
     BOOST_CHECK(block.vtx[3]->GetHash() == hashMediumFeeTx);
 
+    {
+        int assembled{0};
+        DebugLogHelper log{"CreateNewBlock(): block weight", [&](const std::string* line) {
+            if (line) ++assembled;
+            return false;
+        }};
+        // waitNext() doesn't assemble a new template while the mempool is unchanged...
+        BOOST_CHECK(!block_template->waitNext({.timeout = MillisecondsDouble{0}, .fee_threshold = 1}));
+        BOOST_CHECK_EQUAL(assembled, 0);
+        // ...unless any new template is good enough
+        BOOST_CHECK(block_template->waitNext({.timeout = MillisecondsDouble{0}, .fee_threshold = 0}));
+        BOOST_CHECK_EQUAL(assembled, 1);
+        // A new transaction changes the mempool, and raises the fees of the new template
+        CMutableTransaction bump_tx;
+        bump_tx.vin.resize(1);
+        bump_tx.vin[0].scriptSig = CScript() << OP_1;
+        bump_tx.vin[0].prevout = COutPoint{txFirst[3]->GetHash(), 0};
+        bump_tx.vout.resize(1);
+        bump_tx.vout[0].nValue = 5000000000LL - 1000;
+        AddToMempool(tx_mempool, entry.Fee(1000).Time(Now<NodeSeconds>()).SpendsCoinbase(true).FromTx(bump_tx));
+        const auto bumped_template{block_template->waitNext({.timeout = MillisecondsDouble{0}, .fee_threshold = 1000})};
+        BOOST_CHECK_EQUAL(assembled, 2);
+        BOOST_REQUIRE(bumped_template);
+        const auto old_fees{block_template->getTxFees()};
+        const auto new_fees{bumped_template->getTxFees()};
+        BOOST_CHECK_EQUAL(std::accumulate(new_fees.begin(), new_fees.end(), CAmount{0}),
+                          std::accumulate(old_fees.begin(), old_fees.end(), CAmount{0}) + 1000);
+        tx_mempool.removeRecursive(CTransaction{bump_tx}, MemPoolRemovalReason::REPLACED);
+    }
+
     // Test the inclusion of package feerates in the block template and ensure they are sequential.
     const auto block_package_feerates = BlockAssembler{m_node.chainman->ActiveChainstate(), &tx_mempool, options}.CreateNewBlock()->m_package_feerates;
     BOOST_CHECK(block_package_feerates.size() == 2);
@@ -711,6 +743,7 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
         if (current_height % 2 == 0) {
             BOOST_REQUIRE(Assert(m_node.chainman)->ProcessNewBlock(shared_pblock, /*force_processing=*/true, /*min_pow_checked=*/true, nullptr));
         } else {
+            BOOST_CHECK(block_template->getCoinbaseMerklePath() == TransactionMerklePath(block, 0));
             BOOST_REQUIRE(block_template->submitSolution(block.nVersion, block.nTime, block.nNonce, MakeTransactionRef(txCoinbase)));
         }
         {
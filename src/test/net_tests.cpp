@@ -1546,4 +1546,74 @@ BOOST_AUTO_TEST_CASE(v2transport_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(transport_queue_test)
+{
+    for (const bool use_v2transport : {false, true}) {
+        std::unique_ptr<Transport> sender, receiver;
+        if (use_v2transport) {
+            sender = std::make_unique<V2Transport>(NodeId{0}, /*initiating=*/true);
+            receiver = std::make_unique<V2Transport>(NodeId{1}, /*initiating=*/false);
+        } else {
+            sender = std::make_unique<V1Transport>(NodeId{0});
+            receiver = std::make_unique<V1Transport>(NodeId{1});
+        }
+
+        // Move up to max_bytes bytes from the first three buffers of one transport to the other.
+        std::vector<CNetMessage> received;
+        const auto transfer{[&](Transport& from, Transport& to, size_t max_bytes) {
+            std::vector<Transport::SendBuffer> buffers;
+            (void)from.GetBytesToSendBuffers(buffers, /*have_next_message=*/false, /*max_buffers=*/3);
+            std::vector<uint8_t> bytes;
+            for (const auto& buffer : buffers) bytes.insert(bytes.end(), buffer.data.begin(), buffer.data.end());
+            bytes.resize(std::min(bytes.size(), max_bytes));
+            from.MarkBytesSent(bytes.size());
+            std::span<const uint8_t> to_recv{bytes};
+            while (!to_recv.empty()) {
+                BOOST_REQUIRE(to.ReceivedBytes(to_recv));
+                if (to.ReceivedMessageComplete()) {
+                    bool reject{false};
+                    received.push_back(to.GetReceivedMessage({}, reject));
+                    BOOST_CHECK(!reject);
+                }
+            }
+            return bytes.size();
+        }};
+        const auto exchange{[&] {
+            while (transfer(*sender, *receiver, 777) + transfer(*receiver, *sender, 777) > 0) {}
+        }};
+        // Complete the v2 handshake.
+        exchange();
+
+        std::vector<CSerializedNetMsg> msgs;
+        for (const auto& [type, size] : {std::pair{"ping", 0}, {"inv", 1000}, {"tx", 5}, {"block", 100000}}) {
+            CSerializedNetMsg msg;
+            msg.m_type = type;
+            msg.data = m_rng.randbytes<uint8_t>(size);
+            msgs.push_back(std::move(msg));
+        }
+        for (size_t i{0}; i < msgs.size(); ++i) {
+            CSerializedNetMsg msg{msgs[i].Copy()};
+            // While messages are pending, only QueueMessageToSend() accepts more, up to the given limit.
+            if (i > 0) BOOST_CHECK(!sender->SetMessageToSend(msg));
+            if (i == 2) BOOST_CHECK(!sender->QueueMessageToSend(msg, /*max_queued_bytes=*/1000));
+            BOOST_CHECK(sender->QueueMessageToSend(msg, MAX_SEND_BATCH_BYTES));
+        }
+        std::vector<Transport::SendBuffer> buffers;
+        BOOST_CHECK(sender->GetBytesToSendBuffers(buffers, /*have_next_message=*/false, /*max_buffers=*/2));
+        BOOST_CHECK_EQUAL(buffers.size(), 2U);
+        BOOST_CHECK_EQUAL(*buffers[0].m_type, "ping");
+
+        exchange();
+        BOOST_REQUIRE_EQUAL(received.size(), msgs.size());
+        for (size_t i{0}; i < msgs.size(); ++i) {
+            BOOST_CHECK_EQUAL(received[i].m_type, msgs[i].m_type);
+            BOOST_CHECK(std::ranges::equal(received[i].m_recv, MakeByteSpan(msgs[i].data)));
+        }
+        buffers.clear();
+        BOOST_CHECK(!sender->GetBytesToSendBuffers(buffers, /*have_next_message=*/false, /*max_buffers=*/2));
+        BOOST_CHECK(buffers.empty());
+        BOOST_CHECK(sender->SetMessageToSend(msgs[0]));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
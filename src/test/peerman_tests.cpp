@@ -4,8 +4,13 @@
 
 #include <chainparams.h>
 #include <node/miner.h>
+#include <net.h>
 #include <net_processing.h>
+#include <netmessagemaker.h>
 #include <pow.h>
+#include <protocol.h>
+#include <sync.h>
+#include <test/util/net.h>
 #include <test/util/setup_common.h>
 #include <validation.h>
 
@@ -73,4 +78,54 @@ BOOST_AUTO_TEST_CASE(connections_desirable_service_flags)
     BOOST_CHECK(peerman->GetDesirableServiceFlags(peer_flags) == ServiceFlags(NODE_NETWORK | NODE_WITNESS));
 }
 
+static bool HasBytesToSend(CNode& node)
+{
+    LOCK(node.cs_vSend);
+    const auto& [to_send, _more, _msg_type] = node.m_transport->GetBytesToSend(/*have_next_message=*/!node.vSendMsg.empty());
+    return !to_send.empty() || !node.vSendMsg.empty();
+}
+
+// Blocks requested with getdata are left to ServeRequests(), so that they can be served without g_msgproc_mutex
+BOOST_AUTO_TEST_CASE(serve_blocks_concurrently)
+{
+    auto& connman{static_cast<ConnmanTestMsg&>(*m_node.connman)};
+    const auto peerman{PeerManager::make(connman, *m_node.addrman, nullptr, *m_node.chainman, *m_node.mempool, *m_node.warnings,
+                                         {.deterministic_rng = true, .serve_blocks_concurrently = true})};
+    connman.SetMsgProc(peerman.get());
+
+    CNode node{/*id=*/0,
+               /*sock=*/nullptr,
+               CAddress{},
+               /*nKeyedNetGroupIn=*/0,
+               /*nLocalHostNonceIn=*/0,
+               CAddress{},
+               /*addrNameIn=*/"",
+               ConnectionType::INBOUND,
+               /*inbound_onion=*/false};
+    {
+        LOCK(NetEventsInterface::g_msgproc_mutex);
+        connman.Handshake(node,
+                          /*successfully_connected=*/true,
+                          /*remote_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                          /*local_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                          /*version=*/PROTOCOL_VERSION,
+                          /*relay_txs=*/false);
+    }
+    connman.FlushSendBuffer(node);
+    node.fPauseSend = false;
+
+    const uint256 genesis_hash{m_node.chainman->GetParams().GenesisBlock().GetHash()};
+    (void)connman.ReceiveMsgFrom(node, NetMsg::Make(NetMsgType::GETDATA, std::vector<CInv>{{MSG_WITNESS_BLOCK, genesis_hash}}));
+
+    BOOST_CHECK(WITH_LOCK(NetEventsInterface::g_msgproc_mutex, return connman.ProcessMessagesOnce(node)));
+    BOOST_CHECK(!HasBytesToSend(node));
+
+    BOOST_CHECK(!connman.ServeRequestsOnce(node));
+    BOOST_CHECK(HasBytesToSend(node));
+    BOOST_CHECK(!WITH_LOCK(NetEventsInterface::g_msgproc_mutex, return connman.ProcessMessagesOnce(node)));
+
+    peerman->FinalizeNode(node);
+    connman.SetMsgProc(m_node.peerman.get());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
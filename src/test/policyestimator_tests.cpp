@@ -15,6 +15,10 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 BOOST_FIXTURE_TEST_SUITE(policyestimator_tests, ChainTestingSetup)
 
 BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
@@ -263,6 +267,131 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
     for (int i = 2; i < 9; i++) { // At 9, the original estimate was already at the bottom (b/c scale = 2)
         BOOST_CHECK(feeEst.estimateFee(i).GetFeePerK() < origFeeEst[i-1] - deltaFee);
     }
+
+    // Smart estimates for targets beyond the highest usable one (half of the 664 blocks
+    // recorded) are given at that target, and follow it as more blocks are processed
+    FeeCalculation feeCalc;
+    const CFeeRate maxTargetFee = feeEst.estimateSmartFee(1008, &feeCalc, /*conservative=*/false);
+    BOOST_CHECK_EQUAL(feeCalc.desiredTarget, 1008);
+    BOOST_CHECK_EQUAL(feeCalc.returnedTarget, 332);
+    BOOST_CHECK(feeEst.estimateSmartFee(332, &feeCalc, /*conservative=*/false) == maxTargetFee);
+    BOOST_CHECK_EQUAL(feeCalc.desiredTarget, 332);
+    BOOST_CHECK(feeEst.estimateSmartFee(1009, nullptr, /*conservative=*/false) == CFeeRate(0));
+    while (blocknum < 667) {
+        LOCK(mpool.cs);
+        mpool.removeForBlock(block, ++blocknum);
+    }
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    feeEst.estimateSmartFee(1008, &feeCalc, /*conservative=*/true);
+    BOOST_CHECK_EQUAL(feeCalc.returnedTarget, 333);
+}
+
+BOOST_AUTO_TEST_CASE(SmartFeeCacheMatchesRecomputation)
+{
+    // At low heights the circular buffers of the statistics wrap around, so that any transaction can change the
+    // estimates. Also cross the height of the longest tracked target, from which on adding a transaction at the
+    // tip height no longer does.
+    for (const unsigned int start_height : {100, 990}) {
+        using Event = std::function<void(CBlockPolicyEstimator&)>;
+        // Every event is applied to the estimator under test, and recorded so that it can be replayed on a new
+        // estimator, which has no cached estimateSmartFee results.
+        CBlockPolicyEstimator cached_est{m_args.GetDataDirBase() / "cached_fee_estimates.dat", DEFAULT_ACCEPT_STALE_FEE_ESTIMATES};
+        std::vector<Event> events;
+        const auto apply{[&](Event event) {
+            event(cached_est);
+            events.push_back(std::move(event));
+        }};
+        const auto check{[&] {
+            CBlockPolicyEstimator fresh_est{m_args.GetDataDirBase() / "fresh_fee_estimates.dat", DEFAULT_ACCEPT_STALE_FEE_ESTIMATES};
+            for (const Event& event : events) event(fresh_est);
+            for (const bool conservative : {false, true}) {
+                for (const int target : {1, 2, 3, 6, 12, 24, 48, 144, 504, 1008}) {
+                    // Unless the last event emptied the cache, this returns the result cached by the previous check.
+                    FeeCalculation cached_calc, fresh_calc;
+                    const CFeeRate cached{cached_est.estimateSmartFee(target, &cached_calc, conservative)};
+                    const CFeeRate fresh{fresh_est.estimateSmartFee(target, &fresh_calc, conservative)};
+                    BOOST_CHECK(cached == fresh);
+                    BOOST_CHECK_EQUAL(cached_calc.returnedTarget, fresh_calc.returnedTarget);
+                    BOOST_CHECK(cached_calc.reason == fresh_calc.reason);
+                    BOOST_CHECK(cached_est.estimateSmartFee(target, nullptr, conservative) == fresh);
+                }
+            }
+        }};
+
+        struct UnconfirmedTx {
+            CTransactionRef tx;
+            CAmount fee;
+            unsigned int height;
+        };
+        std::vector<UnconfirmedTx> unconfirmed;
+        TestMemPoolEntryHelper entry;
+        unsigned int height{start_height};
+        apply([height](CBlockPolicyEstimator& est) { est.processBlock({}, height); });
+        for (int block = 0; block < 30; ++block) {
+            for (int i = 0; i < 20; ++i) {
+                CMutableTransaction mtx;
+                mtx.vin.resize(1);
+                mtx.vin[0].prevout.n = 100 * block + i;
+                mtx.vout.resize(1);
+                const CTransactionRef tx{MakeTransactionRef(mtx)};
+                const CAmount fee{1000 * (i + 1)};
+                const NewMempoolTransactionInfo tx_info{tx, fee, GetVirtualTransactionSize(*tx), height,
+                                                        /*mempool_limit_bypassed=*/false,
+                                                        /*submitted_in_package=*/false,
+                                                        /*chainstate_is_current=*/true,
+                                                        /*has_no_mempool_parents=*/true};
+                apply([tx_info](CBlockPolicyEstimator& est) { est.processTransaction(tx_info); });
+                unconfirmed.push_back({tx, fee, height});
+                if (i == 0) check();
+            }
+            check();
+
+            // Remove a transaction for another reason than a block, alternately one that entered the mempool
+            // at the tip height and the oldest one that will eventually be mined.
+            const auto removed{block % 2 ? std::find_if(unconfirmed.begin(), unconfirmed.end(), [](const UnconfirmedTx& utx) { return utx.fee >= 5000; })
+                                         : unconfirmed.end() - 1};
+            const uint256 removed_hash{removed->tx->GetHash()};
+            unconfirmed.erase(removed);
+            apply([removed_hash](CBlockPolicyEstimator& est) { est.removeTx(removed_hash); });
+            check();
+
+            // Mine the transactions paying at least a fee that varies with the block, so that lower fees take
+            // longer to confirm.
+            const CAmount min_fee{1000 * (5 + block % 15)};
+            std::vector<RemovedMempoolTransactionInfo> block_txs;
+            block_txs.reserve(unconfirmed.size());
+            for (auto it{unconfirmed.begin()}; it != unconfirmed.end();) {
+                if (it->fee >= min_fee) {
+                    block_txs.emplace_back(entry.Fee(it->fee).Height(it->height).FromTx(it->tx));
+                    it = unconfirmed.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            ++height;
+            apply([block_txs, height](CBlockPolicyEstimator& est) { est.processBlock(block_txs, height); });
+            check();
+            if (block % 3 == 0) {
+                // A block without tracked transactions still decays the statistics.
+                ++height;
+                apply([height](CBlockPolicyEstimator& est) { est.processBlock({}, height); });
+                check();
+            }
+        }
+
+        // Evict the transactions that never confirmed, which counted as failures of their fee rates, one at a time.
+        for (const UnconfirmedTx& utx : unconfirmed) {
+            if (utx.fee >= 5000) continue;
+            const uint256 removed_hash{utx.tx->GetHash()};
+            apply([removed_hash](CBlockPolicyEstimator& est) { est.removeTx(removed_hash); });
+            check();
+        }
+
+        apply([](CBlockPolicyEstimator& est) { est.FlushUnconfirmed(); });
+        check();
+        // The transactions confirmed often enough to give an estimate.
+        BOOST_CHECK(cached_est.estimateSmartFee(6, nullptr, /*conservative=*/false) != CFeeRate(0));
+    }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -6,6 +6,7 @@
 #include <compat/compat.h>
 #include <test/util/setup_common.h>
 #include <util/sock.h>
+#include <util/sockepoll.h>
 #include <util/threadinterrupt.h>
 
 #include <boost/test/unit_test.hpp>
@@ -169,6 +170,61 @@ BOOST_AUTO_TEST_CASE(recv_until_terminator_limit)
     receiver.join();
 }
 
+#ifdef USE_EPOLL
+BOOST_AUTO_TEST_CASE(epoll_edge_triggered)
+{
+    int s[2];
+    CreateSocketPair(s);
+    Sock sock0(s[0]);
+    Sock sock1(s[1]);
+    BOOST_REQUIRE(sock0.SetNonBlocking());
+    BOOST_REQUIRE(sock1.SetNonBlocking());
+
+    auto epoll{SockEpoll::Create()};
+    BOOST_REQUIRE(epoll);
+    BOOST_REQUIRE(epoll->Add(sock0, 7, Sock::RECV | Sock::SEND, /*edge_triggered=*/true));
+    // Adding the same socket again fails.
+    BOOST_CHECK(!epoll->Add(sock0, 8, Sock::RECV, /*edge_triggered=*/true));
+
+    // Registration reports the current state: writable, nothing to read.
+    std::vector<SockEpoll::Ready> ready;
+    BOOST_REQUIRE(epoll->Wait(0ms, ready));
+    BOOST_REQUIRE_EQUAL(ready.size(), 1U);
+    BOOST_CHECK_EQUAL(ready[0].token, 7U);
+    BOOST_CHECK_EQUAL(ready[0].occurred, Sock::SEND);
+    // Nothing changed, so nothing is reported again.
+    BOOST_REQUIRE(epoll->Wait(0ms, ready));
+    BOOST_CHECK(ready.empty());
+
+    // Incoming data is reported once, even though it is not read.
+    BOOST_REQUIRE_EQUAL(sock1.Send("ab", 2, 0), 2);
+    BOOST_REQUIRE(epoll->Wait(1min, ready));
+    BOOST_REQUIRE_EQUAL(ready.size(), 1U);
+    BOOST_CHECK(ready[0].occurred & Sock::RECV);
+    BOOST_REQUIRE(epoll->Wait(0ms, ready));
+    BOOST_CHECK(ready.empty());
+
+    // New data is a new edge.
+    BOOST_REQUIRE_EQUAL(sock1.Send("c", 1, 0), 1);
+    BOOST_REQUIRE(epoll->Wait(1min, ready));
+    BOOST_REQUIRE_EQUAL(ready.size(), 1U);
+    BOOST_CHECK(ready[0].occurred & Sock::RECV);
+
+    // A level-triggered socket is reported for as long as it is ready.
+    BOOST_REQUIRE(epoll->Add(sock1, 9, Sock::SEND, /*edge_triggered=*/false));
+    for (int i{0}; i < 2; ++i) {
+        BOOST_REQUIRE(epoll->Wait(0ms, ready));
+        BOOST_REQUIRE_EQUAL(ready.size(), 1U);
+        BOOST_CHECK_EQUAL(ready[0].token, 9U);
+        BOOST_CHECK_EQUAL(ready[0].occurred, Sock::SEND);
+    }
+    BOOST_CHECK(epoll->Remove(sock1));
+    BOOST_REQUIRE(epoll->Wait(0ms, ready));
+    BOOST_CHECK(ready.empty());
+    BOOST_CHECK(!epoll->Remove(sock1));
+}
+#endif // USE_EPOLL
+
 #endif /* WIN32 */
 
 BOOST_AUTO_TEST_SUITE_END()
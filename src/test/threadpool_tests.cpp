@@ -0,0 +1,64 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+#include <util/threadpool.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(threadpool_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(submit_and_wait)
+{
+    ThreadPool pool{"test", 3};
+    BOOST_CHECK_EQUAL(pool.WorkerCount(), 3U);
+
+    std::atomic<int> counter{0};
+    std::vector<std::future<int>> futures;
+    for (int i{0}; i < 100; ++i) {
+        futures.push_back(pool.Submit([&counter, i] { ++counter; return i * i; }));
+    }
+    for (int i{0}; i < 100; ++i) {
+        BOOST_CHECK_EQUAL(futures[i].get(), i * i);
+    }
+    BOOST_CHECK_EQUAL(counter, 100);
+    BOOST_CHECK_EQUAL(pool.WorkQueueSize(), 0U);
+
+    // Exceptions are passed on to the caller
+    auto throwing{pool.Submit([]() -> int { throw std::runtime_error{"task failed"}; })};
+    BOOST_CHECK_THROW(throwing.get(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(discard_on_destruction)
+{
+    std::promise<void> started;
+    std::promise<void> release;
+    std::future<void> blocked;
+    std::future<void> pending;
+    {
+        ThreadPool pool{"test", 1};
+        blocked = pool.Submit([&started, released = release.get_future()] {
+            started.set_value();
+            released.wait();
+        });
+        started.get_future().wait();
+        pending = pool.Submit([] {});
+        BOOST_CHECK_EQUAL(pool.WorkQueueSize(), 1U);
+        release.set_value();
+    }
+    // The running task completes, the queued one may have been discarded
+    blocked.get();
+    try {
+        pending.get();
+    } catch (const std::future_error& e) {
+        BOOST_CHECK(e.code() == std::future_errc::broken_promise);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
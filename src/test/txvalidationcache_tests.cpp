@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <addresstype.h>
 #include <consensus/validation.h>
 #include <key.h>
 #include <random.h>
@@ -20,6 +21,11 @@ struct Dersig100Setup : public TestChain100Setup {
         : TestChain100Setup{ChainType::REGTEST, {.extra_args = {"-testactivationheight=dersig@102"}}} {}
 };
 
+struct NoScriptCheckThreads100Setup : public TestChain100Setup {
+    NoScriptCheckThreads100Setup()
+        : TestChain100Setup{ChainType::REGTEST, {.script_check_threads = false}} {}
+};
+
 bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
                        const CCoinsViewCache& inputs, unsigned int flags, bool cacheSigStore,
                        bool cacheFullScriptStore, PrecomputedTransactionData& txdata,
@@ -385,4 +391,146 @@ BOOST_FIXTURE_TEST_CASE(checkinputs_test, Dersig100Setup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(mempool_accept_batch, TestChain100Setup)
+{
+    // A batch gives the same results as accepting its transactions one by
+    // one, including children of earlier transactions and invalid ones.
+    const CScript spk{GetScriptForDestination(PKHash(coinbaseKey.GetPubKey()))};
+    const auto parent_a{MakeTransactionRef(CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/0, coinbaseKey, spk, 49 * COIN, /*submit=*/false))};
+    const auto parent_b{MakeTransactionRef(CreateValidMempoolTransaction(m_coinbase_txns[1], /*input_vout=*/0, /*input_height=*/0, coinbaseKey, spk, 49 * COIN, /*submit=*/false))};
+    const auto child{MakeTransactionRef(CreateValidMempoolTransaction(parent_a, /*input_vout=*/0, /*input_height=*/0, coinbaseKey, spk, 48 * COIN, /*submit=*/false))};
+    CMutableTransaction mtx_bad_sig{CreateValidMempoolTransaction(m_coinbase_txns[2], /*input_vout=*/0, /*input_height=*/0, coinbaseKey, spk, 49 * COIN, /*submit=*/false)};
+    mtx_bad_sig.vout[0].nValue -= 1;
+    const auto bad_sig{MakeTransactionRef(mtx_bad_sig)};
+    const auto double_spend{MakeTransactionRef(CreateValidMempoolTransaction(m_coinbase_txns[1], /*input_vout=*/0, /*input_height=*/0, coinbaseKey, spk, 49 * COIN + 50 * CENT, /*submit=*/false))};
+    const std::vector<CTransactionRef> batch{parent_a, parent_b, child, bad_sig, double_spend};
+
+    LOCK(cs_main);
+    const auto results{AcceptToMemoryPoolBatch(m_node.chainman->ActiveChainstate(), batch, GetTime(), /*bypass_limits=*/false, /*test_accept=*/false)};
+    BOOST_REQUIRE_EQUAL(results.size(), batch.size());
+    BOOST_CHECK(results[0].m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK(results[1].m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK(results[2].m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK(results[3].m_result_type == MempoolAcceptResult::ResultType::INVALID);
+    BOOST_CHECK(results[3].m_state.GetResult() == TxValidationResult::TX_CONSENSUS);
+    BOOST_CHECK(results[4].m_result_type == MempoolAcceptResult::ResultType::INVALID);
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 3U);
+}
+
+BOOST_FIXTURE_TEST_CASE(mempool_accept_batch_cold_cache, TestChain100Setup)
+{
+    // As when loading mempool.dat at startup, none of the spent coins are
+    // cached. The batch reads them itself, and evicts the coins of rejected
+    // transactions again.
+    const CScript spk{GetScriptForDestination(PKHash(coinbaseKey.GetPubKey()))};
+    const std::vector<CTxOut> fanout_outputs(2, CTxOut{CENT, spk});
+    const auto fanout{MakeTransactionRef(CreateValidMempoolTransaction({m_coinbase_txns[0]}, {COutPoint{m_coinbase_txns[0]->GetHash(), 0}},
+                                                                       /*input_height=*/1, {coinbaseKey}, fanout_outputs, /*submit=*/false))};
+    CreateAndProcessBlock({CMutableTransaction{*fanout}}, spk);
+    const auto good{MakeTransactionRef(CreateValidMempoolTransaction(fanout, /*input_vout=*/0, /*input_height=*/101, coinbaseKey, spk, CENT / 2, /*submit=*/false))};
+    CMutableTransaction mtx_bad_sig{CreateValidMempoolTransaction(fanout, /*input_vout=*/1, /*input_height=*/101, coinbaseKey, spk, CENT / 2, /*submit=*/false)};
+    mtx_bad_sig.vout[0].nValue -= 1;
+    const std::vector<CTransactionRef> batch{good, MakeTransactionRef(mtx_bad_sig)};
+
+    LOCK(cs_main);
+    CCoinsViewCache& coins_tip{m_node.chainman->ActiveChainstate().CoinsTip()};
+    BOOST_REQUIRE(coins_tip.Flush());
+    BOOST_CHECK(!coins_tip.HaveCoinInCache(COutPoint{fanout->GetHash(), 0}));
+    BOOST_CHECK(!coins_tip.HaveCoinInCache(COutPoint{fanout->GetHash(), 1}));
+
+    const auto results{AcceptToMemoryPoolBatch(m_node.chainman->ActiveChainstate(), batch, GetTime(), /*bypass_limits=*/false, /*test_accept=*/false)};
+    BOOST_REQUIRE_EQUAL(results.size(), batch.size());
+    BOOST_CHECK(results[0].m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK(results[1].m_result_type == MempoolAcceptResult::ResultType::INVALID);
+    BOOST_CHECK(coins_tip.HaveCoinInCache(COutPoint{fanout->GetHash(), 0}));
+    BOOST_CHECK(!coins_tip.HaveCoinInCache(COutPoint{fanout->GetHash(), 1}));
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 1U);
+}
+
+BOOST_FIXTURE_TEST_CASE(mempool_accept_batch_single_tx, TestChain100Setup)
+{
+    // A batch of one transaction is not pre-verified. Rejecting it, or only
+    // testing it for acceptance, must still be handled.
+    const CScript spk{GetScriptForDestination(PKHash(coinbaseKey.GetPubKey()))};
+    CMutableTransaction mtx_bad_sig{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/0, coinbaseKey, spk, 49 * COIN, /*submit=*/false)};
+    mtx_bad_sig.vout[0].nValue -= 1;
+    const std::vector<CTransactionRef> bad_batch{MakeTransactionRef(mtx_bad_sig)};
+    const std::vector<CTransactionRef> good_batch{MakeTransactionRef(CreateValidMempoolTransaction(m_coinbase_txns[1], /*input_vout=*/0, /*input_height=*/0, coinbaseKey, spk, 49 * COIN, /*submit=*/false))};
+
+    LOCK(cs_main);
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    const auto bad_results{AcceptToMemoryPoolBatch(chainstate, bad_batch, GetTime(), /*bypass_limits=*/false, /*test_accept=*/false)};
+    BOOST_REQUIRE_EQUAL(bad_results.size(), 1U);
+    BOOST_CHECK(bad_results[0].m_result_type == MempoolAcceptResult::ResultType::INVALID);
+
+    const auto test_results{AcceptToMemoryPoolBatch(chainstate, good_batch, GetTime(), /*bypass_limits=*/false, /*test_accept=*/true)};
+    BOOST_REQUIRE_EQUAL(test_results.size(), 1U);
+    BOOST_CHECK(test_results[0].m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 0U);
+
+    const auto results{AcceptToMemoryPoolBatch(chainstate, good_batch, GetTime(), /*bypass_limits=*/false, /*test_accept=*/false)};
+    BOOST_REQUIRE_EQUAL(results.size(), 1U);
+    BOOST_CHECK(results[0].m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 1U);
+}
+
+BOOST_FIXTURE_TEST_CASE(mempool_accept_batch_no_script_check_threads, NoScriptCheckThreads100Setup)
+{
+    // Without script check threads (-par=1) nothing is pre-verified, and the
+    // batch is accepted like one transaction at a time.
+    const CScript spk{GetScriptForDestination(PKHash(coinbaseKey.GetPubKey()))};
+    const auto parent{MakeTransactionRef(CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/0, coinbaseKey, spk, 49 * COIN, /*submit=*/false))};
+    const auto child{MakeTransactionRef(CreateValidMempoolTransaction(parent, /*input_vout=*/0, /*input_height=*/0, coinbaseKey, spk, 48 * COIN, /*submit=*/false))};
+    CMutableTransaction mtx_bad_sig{CreateValidMempoolTransaction(m_coinbase_txns[1], /*input_vout=*/0, /*input_height=*/0, coinbaseKey, spk, 49 * COIN, /*submit=*/false)};
+    mtx_bad_sig.vout[0].nValue -= 1;
+    const std::vector<CTransactionRef> batch{parent, child, MakeTransactionRef(mtx_bad_sig)};
+
+    LOCK(cs_main);
+    BOOST_REQUIRE(!m_node.chainman->GetCheckQueue().HasThreads());
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    const auto test_results{AcceptToMemoryPoolBatch(chainstate, batch, GetTime(), /*bypass_limits=*/false, /*test_accept=*/true)};
+    BOOST_REQUIRE_EQUAL(test_results.size(), batch.size());
+    BOOST_CHECK(test_results[0].m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 0U);
+
+    const auto results{AcceptToMemoryPoolBatch(chainstate, batch, GetTime(), /*bypass_limits=*/false, /*test_accept=*/false)};
+    BOOST_REQUIRE_EQUAL(results.size(), batch.size());
+    BOOST_CHECK(results[0].m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK(results[1].m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK(results[2].m_result_type == MempoolAcceptResult::ResultType::INVALID);
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 2U);
+}
+
+BOOST_FIXTURE_TEST_CASE(mempool_accept_many_inputs, TestChain100Setup)
+{
+    // Enough inputs for the script checks to run on the script check threads.
+    constexpr uint32_t NUM_INPUTS{20};
+    const CScript spk{GetScriptForDestination(PKHash(coinbaseKey.GetPubKey()))};
+    const std::vector<CTxOut> fanout_outputs(NUM_INPUTS, CTxOut{CENT, spk});
+    const auto fanout{MakeTransactionRef(CreateValidMempoolTransaction({m_coinbase_txns[0]}, {COutPoint{m_coinbase_txns[0]->GetHash(), 0}},
+                                                                       /*input_height=*/1, {coinbaseKey}, fanout_outputs, /*submit=*/false))};
+    CreateAndProcessBlock({CMutableTransaction{*fanout}}, spk);
+
+    std::vector<COutPoint> inputs;
+    for (uint32_t n = 0; n < NUM_INPUTS; ++n) inputs.emplace_back(fanout->GetHash(), n);
+    const std::vector<CKey> keys(NUM_INPUTS, coinbaseKey);
+    CMutableTransaction mtx{CreateValidMempoolTransaction({fanout}, inputs, /*input_height=*/101, keys, {CTxOut{NUM_INPUTS * CENT / 2, spk}}, /*submit=*/false)};
+
+    LOCK(cs_main);
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    BOOST_REQUIRE(m_node.chainman->GetCheckQueue().HasThreads());
+
+    // Invalidate the signature of the last input only.
+    CMutableTransaction mtx_bad_sig{mtx};
+    mtx_bad_sig.vin.back().scriptSig = mtx.vin.front().scriptSig;
+    const auto bad_result{AcceptToMemoryPool(chainstate, MakeTransactionRef(mtx_bad_sig), GetTime(), /*bypass_limits=*/false, /*test_accept=*/false)};
+    BOOST_CHECK(bad_result.m_result_type == MempoolAcceptResult::ResultType::INVALID);
+    BOOST_CHECK(bad_result.m_state.GetResult() == TxValidationResult::TX_CONSENSUS);
+    BOOST_CHECK(bad_result.m_state.GetRejectReason().starts_with("mandatory-script-verify-flag-failed"));
+
+    const auto result{AcceptToMemoryPool(chainstate, MakeTransactionRef(mtx), GetTime(), /*bypass_limits=*/false, /*test_accept=*/false)};
+    BOOST_CHECK(result.m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 1U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -153,6 +153,11 @@ ZeroSock::~ZeroSock() { m_socket = INVALID_SOCKET; }
 
 ssize_t ZeroSock::Send(const void*, size_t len, int) const { return len; }
 
+ssize_t ZeroSock::SendMsg(std::span<const std::span<const uint8_t>> buffers, int flags) const
+{
+    return SendEach(buffers, flags);
+}
+
 ssize_t ZeroSock::Recv(void* buf, size_t len, int flags) const
 {
     memset(buf, 0x0, len);
@@ -81,11 +81,21 @@ struct ConnmanTestMsg : public CConnman {
         return m_msgproc->ProcessMessages(&node, flagInterruptMsgProc);
     }
 
+    bool ServeRequestsOnce(CNode& node) EXCLUSIVE_LOCKS_REQUIRED(!NetEventsInterface::g_msgproc_mutex)
+    {
+        return m_msgproc->ServeRequests(&node, flagInterruptMsgProc);
+    }
+
     void NodeReceiveMsgBytes(CNode& node, std::span<const uint8_t> msg_bytes, bool& complete) const;
 
     bool ReceiveMsgFrom(CNode& node, CSerializedNetMsg&& ser_msg) const;
     void FlushSendBuffer(CNode& node) const;
 
+    std::pair<size_t, bool> SocketSendDataPublic(CNode& node) const EXCLUSIVE_LOCKS_REQUIRED(node.cs_vSend)
+    {
+        return SocketSendData(node);
+    }
+
     bool AlreadyConnectedPublic(const CAddress& addr) { return AlreadyConnectedToAddress(addr); };
 
     CNode* ConnectNodePublic(PeerManager& peerman, const char* pszDest, ConnectionType conn_type)
@@ -147,6 +157,8 @@ public:
 
     ssize_t Send(const void*, size_t len, int) const override;
 
+    ssize_t SendMsg(std::span<const std::span<const uint8_t>> buffers, int flags) const override;
+
     ssize_t Recv(void* buf, size_t len, int flags) const override;
 
     int Connect(const sockaddr*, socklen_t) const override;
@@ -56,6 +56,7 @@ struct TestOpts {
     bool setup_net{true};
     bool setup_validation_interface{true};
     bool min_validation_cache{false}; // Equivalent of -maxsigcachebytes=0
+    bool script_check_threads{true}; // False is equivalent of -par=1
 };
 
 /** Basic testing setup.
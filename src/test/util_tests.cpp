@@ -16,6 +16,7 @@
 #include <util/byte_units.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
+#include <util/lz.h>
 #include <util/moneystr.h>
 #include <util/overflow.h>
 #include <util/readwritefile.h>
@@ -1749,4 +1750,48 @@ BOOST_AUTO_TEST_CASE(mib_string_literal_test)
     BOOST_CHECK_EXCEPTION(operator""_MiB(static_cast<unsigned long long>(max_mib) + 1), std::overflow_error, HasReason("MiB value too large for size_t byte conversion"));
 }
 
+BOOST_AUTO_TEST_CASE(lz_roundtrip)
+{
+    std::vector<uint8_t> decompressed;
+
+    // Empty input
+    auto compressed{util::LZCompress({})};
+    BOOST_CHECK(util::LZDecompress(compressed, 0, decompressed));
+    BOOST_CHECK(decompressed.empty());
+
+    for (int i = 0; i < 100; ++i) {
+        // Mix random and repetitive data, with long literal runs and long matches.
+        std::vector<uint8_t> data;
+        while (data.size() < 10000) {
+            if (m_rng.randbool()) {
+                const auto random{m_rng.randbytes(m_rng.randrange(300))};
+                data.insert(data.end(), random.begin(), random.end());
+            } else {
+                data.insert(data.end(), m_rng.randrange(1000), m_rng.randbits(2));
+            }
+        }
+        compressed = util::LZCompress(data);
+        BOOST_CHECK(util::LZDecompress(compressed, data.size(), decompressed));
+        BOOST_CHECK(decompressed == data);
+
+        // The uncompressed size has to match exactly
+        BOOST_CHECK(!util::LZDecompress(compressed, data.size() - 1, decompressed));
+        BOOST_CHECK(!util::LZDecompress(compressed, data.size() + 1, decompressed));
+
+        // Corrupted or truncated data must not be read or written out of bounds
+        auto corrupted{compressed};
+        corrupted[m_rng.randrange(corrupted.size())] ^= 1 << m_rng.randrange(8);
+        (void)util::LZDecompress(corrupted, data.size(), decompressed);
+        corrupted.resize(m_rng.randrange(corrupted.size()));
+        BOOST_CHECK(!util::LZDecompress(corrupted, data.size(), decompressed));
+    }
+
+    // Repetitive data compresses well
+    const std::vector<uint8_t> zeros(1 << 20, 0);
+    compressed = util::LZCompress(zeros);
+    BOOST_CHECK_LT(compressed.size(), zeros.size() / 100);
+    BOOST_CHECK(util::LZDecompress(compressed, zeros.size(), decompressed));
+    BOOST_CHECK(decompressed == zeros);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -11,23 +11,29 @@
 #include <primitives/transaction.h>
 #include <random.h>
 #include <serialize.h>
+#include <tinyformat.h>
 #include <uint256.h>
+#include <util/threadpool.h>
 #include <util/vector.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <future>
 #include <iterator>
 #include <utility>
 
 static constexpr uint8_t DB_COIN{'C'};
 static constexpr uint8_t DB_BEST_BLOCK{'B'};
 static constexpr uint8_t DB_HEAD_BLOCKS{'H'};
+static constexpr uint8_t DB_SHARD_COUNT{'S'};
+static constexpr uint8_t DB_VERSION{'V'};
 // Keys used in previous version that might still be found in the DB:
 static constexpr uint8_t DB_COINS{'c'};
 
 bool CCoinsViewDB::NeedsUpgrade()
 {
-    std::unique_ptr<CDBIterator> cursor{m_db->NewIterator()};
+    std::unique_ptr<CDBIterator> cursor{m_shards.front()->NewIterator()};
     // DB_COINS was deprecated in v0.15.0, commit
     // 1088b02f0ccd7358d2b7076bb9e122d59d502d02
     cursor->Seek(std::make_pair(DB_COINS, uint256{}));
@@ -44,54 +50,179 @@ struct CoinEntry {
     SERIALIZE_METHODS(CoinEntry, obj) { READWRITE(obj.key, obj.outpoint->hash, VARINT(obj.outpoint->n)); }
 };
 
+fs::path ShardPath(const fs::path& db_path, int shard)
+{
+    return db_path / fs::u8path(strprintf("shard%d", shard));
+}
+
+/**
+ * A sharded database always stores this hash in front of its head blocks. The
+ * DB_HEAD_BLOCKS entry then never holds exactly two hashes, which versions
+ * that predate DB_VERSION reject as an unknown inconsistent state, instead of
+ * running on the part of the UTXO set in the first shard. Versions that know
+ * DB_VERSION refuse the database based on its format version instead.
+ */
+const uint256 SHARDED_HEAD_BLOCKS_MARKER{};
+
 } // namespace
 
+std::vector<fs::path> CoinsDBShardPaths(const fs::path& db_path)
+{
+    std::vector<fs::path> paths;
+    std::error_code ec;
+    for (fs::directory_iterator it{db_path, ec}; !ec && it != fs::directory_iterator{}; it.increment(ec)) {
+        if (it->is_directory() && fs::PathToString(it->path().filename()).starts_with("shard")) {
+            paths.push_back(it->path());
+        }
+    }
+    return paths;
+}
+
 CCoinsViewDB::CCoinsViewDB(DBParams db_params, CoinsViewOptions options) :
     m_db_params{std::move(db_params)},
-    m_options{std::move(options)},
-    m_db{std::make_unique<CDBWrapper>(m_db_params)} { }
+    m_options{std::move(options)}
+{
+    OpenShards();
+}
+
+CCoinsViewDB::~CCoinsViewDB() = default;
+
+void CCoinsViewDB::OpenShards()
+{
+    assert(m_shards.empty());
+    if (m_db_params.wipe_data && !m_db_params.memory_only) {
+        for (const fs::path& path : CoinsDBShardPaths(m_db_params.path)) {
+            LogPrintf("Wiping LevelDB in %s\n", fs::PathToString(path));
+            fs::remove_all(path);
+        }
+    }
+    // The cache is split evenly between the shards.
+    const auto open_shard{[&](const fs::path& path, int shard_count) {
+        DBParams params{m_db_params};
+        params.path = path;
+        params.cache_bytes = m_db_params.cache_bytes / shard_count;
+        m_shards.push_back(std::make_unique<CDBWrapper>(params));
+    }};
+
+    int shard_count{std::clamp(m_options.shards, 1, MAX_COINS_DB_SHARDS)};
+    open_shard(m_db_params.path, shard_count);
+
+    // Databases without a format version predate it and have version 0.
+    int version{0};
+    m_shards.front()->Read(DB_VERSION, version);
+    if (version > COINS_DB_VERSION) {
+        throw coinsdb_version_error(strprintf("Coins database %s has format version %d, but only versions up to %d are supported. "
+                                              "It was created by a newer version of the software, possibly with a different number of shards",
+                                              fs::PathToString(m_db_params.path), version, COINS_DB_VERSION));
+    }
+
+    // The number of shards is fixed when the database is created. Databases
+    // without a shard count predate sharding and consist of a single shard.
+    int stored_count{0};
+    const bool has_shard_count{m_shards.front()->Read(DB_SHARD_COUNT, stored_count)};
+    bool is_new{false};
+    if (!has_shard_count) {
+        std::unique_ptr<CDBIterator> cursor{m_shards.front()->NewIterator()};
+        cursor->Seek(DB_COIN);
+        uint8_t key;
+        const bool has_coins{cursor->Valid() && cursor->GetKey(key) && key == DB_COIN};
+        is_new = !has_coins && GetBestBlock().IsNull() && GetHeadBlocks().empty();
+        stored_count = is_new ? shard_count : 1;
+    }
+    if (stored_count < 1 || stored_count > MAX_COINS_DB_SHARDS) {
+        throw dbwrapper_error(strprintf("Unsupported number of coins database shards: %d", stored_count));
+    }
+    if (stored_count != shard_count) {
+        LogPrintf("Coins database %s consists of %d shard(s), ignoring -dbshards=%d\n",
+                  fs::PathToString(m_db_params.path), stored_count, m_options.shards);
+        shard_count = stored_count;
+        m_shards.clear();
+        open_shard(m_db_params.path, shard_count);
+    }
+
+    for (int shard{1}; shard < shard_count; ++shard) {
+        const fs::path path{ShardPath(m_db_params.path, shard)};
+        if (has_shard_count && !m_db_params.memory_only && !fs::exists(path)) {
+            throw dbwrapper_error(strprintf("Coins database shard %s is missing", fs::PathToString(path)));
+        }
+        open_shard(path, shard_count);
+    }
+    // Only record the shard count once all shards exist.
+    if (is_new || version < COINS_DB_VERSION) {
+        CDBBatch batch{*m_shards.front()};
+        batch.Write(DB_VERSION, COINS_DB_VERSION);
+        if (is_new) {
+            batch.Write(DB_SHARD_COUNT, shard_count);
+            if (shard_count > 1) batch.Write(DB_HEAD_BLOCKS, Vector(SHARDED_HEAD_BLOCKS_MARKER));
+        }
+        m_shards.front()->WriteBatch(batch, /*fSync=*/true);
+    }
+
+    m_write_pool.reset();
+    if (shard_count > 1) {
+        LogPrintf("Using %d coins database shards\n", shard_count);
+        m_write_pool = std::make_unique<ThreadPool>("coinsdb", shard_count);
+    }
+}
+
+CDBWrapper& CCoinsViewDB::Shard(const COutPoint& outpoint) const
+{
+    if (m_shards.size() == 1) return *m_shards.front();
+    return *m_shards[outpoint.hash.ToUint256().GetUint64(0) % m_shards.size()];
+}
 
 void CCoinsViewDB::ResizeCache(size_t new_cache_size)
 {
     // We can't do this operation with an in-memory DB since we'll lose all the coins upon
     // reset.
     if (!m_db_params.memory_only) {
-        // Have to do a reset first to get the original `m_db` state to release its
-        // filesystem lock.
-        m_db.reset();
+        // Have to do a reset first to get the original `m_shards` state to release
+        // their filesystem locks.
+        m_shards.clear();
         m_db_params.cache_bytes = new_cache_size;
         m_db_params.wipe_data = false;
-        m_db = std::make_unique<CDBWrapper>(m_db_params);
+        OpenShards();
     }
 }
 
 std::optional<Coin> CCoinsViewDB::GetCoin(const COutPoint& outpoint) const
 {
-    if (Coin coin; m_db->Read(CoinEntry(&outpoint), coin)) return coin;
+    if (Coin coin; Shard(outpoint).Read(CoinEntry(&outpoint), coin)) return coin;
     return std::nullopt;
 }
 
 bool CCoinsViewDB::HaveCoin(const COutPoint &outpoint) const {
-    return m_db->Exists(CoinEntry(&outpoint));
+    return Shard(outpoint).Exists(CoinEntry(&outpoint));
 }
 
 uint256 CCoinsViewDB::GetBestBlock() const {
     uint256 hashBestChain;
-    if (!m_db->Read(DB_BEST_BLOCK, hashBestChain))
+    if (!m_shards.front()->Read(DB_BEST_BLOCK, hashBestChain))
         return uint256();
     return hashBestChain;
 }
 
 std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
     std::vector<uint256> vhashHeadBlocks;
-    if (!m_db->Read(DB_HEAD_BLOCKS, vhashHeadBlocks)) {
+    if (!m_shards.front()->Read(DB_HEAD_BLOCKS, vhashHeadBlocks)) {
         return std::vector<uint256>();
     }
+    if (m_shards.size() > 1) {
+        if (vhashHeadBlocks.empty() || vhashHeadBlocks.front() != SHARDED_HEAD_BLOCKS_MARKER) {
+            throw dbwrapper_error("Coins database shards lack the sharding marker");
+        }
+        vhashHeadBlocks.erase(vhashHeadBlocks.begin());
+    }
     return vhashHeadBlocks;
 }
 
 bool CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) {
-    CDBBatch batch(*m_db);
+    const size_t shard_count{m_shards.size()};
+    std::vector<std::unique_ptr<CDBBatch>> batches;
+    for (const auto& shard : m_shards) batches.push_back(std::make_unique<CDBBatch>(*shard));
+    // Batch of each shard currently being written by m_write_pool
+    std::vector<std::future<bool>> pending(shard_count);
+    bool ret{true};
     size_t count = 0;
     size_t changed = 0;
     assert(!hashBlock.IsNull());
@@ -109,64 +240,101 @@ bool CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashB
         }
     }
 
+    // Write the batch of a shard, and start a new one. With several shards,
+    // the write happens in the background, overlapping with the writes of the
+    // other shards; at most one batch per shard is in flight.
+    const auto write_batch{[&](size_t shard, bool sync) {
+        if (pending[shard].valid()) ret &= pending[shard].get();
+        if (!m_write_pool) {
+            ret &= m_shards[shard]->WriteBatch(*batches[shard], sync);
+            batches[shard]->Clear();
+            return;
+        }
+        pending[shard] = m_write_pool->Submit([db = m_shards[shard].get(), batch = std::move(batches[shard]), sync] {
+            return db->WriteBatch(*batch, sync);
+        });
+        batches[shard] = std::make_unique<CDBBatch>(*m_shards[shard]);
+    }};
+
     // In the first batch, mark the database as being in the middle of a
     // transition from old_tip to hashBlock.
     // A vector is used for future extensibility, as we may want to support
     // interrupting after partial writes from multiple independent reorgs.
-    batch.Erase(DB_BEST_BLOCK);
-    batch.Write(DB_HEAD_BLOCKS, Vector(hashBlock, old_tip));
+    batches[0]->Erase(DB_BEST_BLOCK);
+    if (shard_count > 1) {
+        batches[0]->Write(DB_HEAD_BLOCKS, Vector(SHARDED_HEAD_BLOCKS_MARKER, hashBlock, old_tip));
+    } else {
+        batches[0]->Write(DB_HEAD_BLOCKS, Vector(hashBlock, old_tip));
+    }
+    if (shard_count > 1) {
+        // The shards are written independently, so the marker must be on disk
+        // before any of them is modified.
+        ret &= m_shards[0]->WriteBatch(*batches[0], /*fSync=*/true);
+        batches[0]->Clear();
+    }
 
+    const size_t batch_write_bytes{m_options.batch_write_bytes / shard_count};
     for (auto it{cursor.Begin()}; it != cursor.End();) {
         if (it->second.IsDirty()) {
             CoinEntry entry(&it->first);
+            const size_t shard{shard_count == 1 ? 0 : it->first.hash.ToUint256().GetUint64(0) % shard_count};
             if (it->second.coin.IsSpent()) {
-                batch.Erase(entry);
+                batches[shard]->Erase(entry);
             } else {
-                batch.Write(entry, it->second.coin);
+                batches[shard]->Write(entry, it->second.coin);
             }
 
             changed++;
-        }
-        count++;
-        it = cursor.NextAndMaybeErase(*it);
-        if (batch.ApproximateSize() > m_options.batch_write_bytes) {
-            LogDebug(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.ApproximateSize() * (1.0 / 1048576.0));
-
-            m_db->WriteBatch(batch);
-            batch.Clear();
-            if (m_options.simulate_crash_ratio) {
-                static FastRandomContext rng;
-                if (rng.randrange(m_options.simulate_crash_ratio) == 0) {
-                    LogPrintf("Simulating a crash. Goodbye.\n");
-                    _Exit(0);
+            if (batches[shard]->ApproximateSize() > batch_write_bytes) {
+                LogDebug(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batches[shard]->ApproximateSize() * (1.0 / 1048576.0));
+
+                write_batch(shard, /*sync=*/false);
+                if (m_options.simulate_crash_ratio) {
+                    static FastRandomContext rng;
+                    if (rng.randrange(m_options.simulate_crash_ratio) == 0) {
+                        LogPrintf("Simulating a crash. Goodbye.\n");
+                        _Exit(0);
+                    }
                 }
             }
         }
+        count++;
+        it = cursor.NextAndMaybeErase(*it);
+    }
+
+    if (shard_count > 1) {
+        // All shards must be on disk before the flush is marked as complete.
+        for (size_t shard{0}; shard < shard_count; ++shard) write_batch(shard, /*sync=*/true);
+        for (auto& write : pending) ret &= write.get();
     }
 
     // In the last batch, mark the database as consistent with hashBlock again.
-    batch.Erase(DB_HEAD_BLOCKS);
-    batch.Write(DB_BEST_BLOCK, hashBlock);
+    if (shard_count > 1) {
+        batches[0]->Write(DB_HEAD_BLOCKS, Vector(SHARDED_HEAD_BLOCKS_MARKER));
+    } else {
+        batches[0]->Erase(DB_HEAD_BLOCKS);
+    }
+    batches[0]->Write(DB_BEST_BLOCK, hashBlock);
 
-    LogDebug(BCLog::COINDB, "Writing final batch of %.2f MiB\n", batch.ApproximateSize() * (1.0 / 1048576.0));
-    bool ret = m_db->WriteBatch(batch);
+    LogDebug(BCLog::COINDB, "Writing final batch of %.2f MiB\n", batches[0]->ApproximateSize() * (1.0 / 1048576.0));
+    ret &= m_shards[0]->WriteBatch(*batches[0]);
     LogDebug(BCLog::COINDB, "Committed %u changed transaction outputs (out of %u) to coin database...\n", (unsigned int)changed, (unsigned int)count);
     return ret;
 }
 
 size_t CCoinsViewDB::EstimateSize() const
 {
-    return m_db->EstimateSize(DB_COIN, uint8_t(DB_COIN + 1));
+    size_t size{0};
+    for (const auto& shard : m_shards) size += shard->EstimateSize(DB_COIN, uint8_t(DB_COIN + 1));
+    return size;
 }
-
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
 class CCoinsViewDBCursor: public CCoinsViewCursor
 {
 public:
     // Prefer using CCoinsViewDB::Cursor() since we want to perform some
     // cache warmup on instantiation.
-    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256&hashBlockIn):
-        CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn) {}
+    CCoinsViewDBCursor(std::vector<std::unique_ptr<CDBIterator>> cursors, const uint256& hashBlockIn);
     ~CCoinsViewDBCursor() = default;
 
     bool GetKey(COutPoint &key) const override;
@@ -176,36 +344,61 @@ public:
     void Next() override;
 
 private:
-    std::unique_ptr<CDBIterator> pcursor;
-    std::pair<char, COutPoint> keyTmp;
-
-    friend class CCoinsViewDB;
+    //! One iterator per shard of the database
+    std::vector<std::unique_ptr<CDBIterator>> m_cursors;
+    //! Cached key of the current record of each iterator
+    std::vector<std::pair<char, COutPoint>> m_keys;
+    //! Iterator positioned at the smallest key
+    size_t m_current{0};
+
+    void CacheKey(size_t cursor);
+    void SelectCurrent();
 };
 
 std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
 {
-    auto i = std::make_unique<CCoinsViewDBCursor>(
-        const_cast<CDBWrapper&>(*m_db).NewIterator(), GetBestBlock());
-    /* It seems that there are no "const iterators" for LevelDB.  Since we
-       only need read operations on it, use a const-cast to get around
-       that restriction.  */
-    i->pcursor->Seek(DB_COIN);
-    // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
+    std::vector<std::unique_ptr<CDBIterator>> cursors;
+    for (const auto& shard : m_shards) {
+        cursors.emplace_back(shard->NewIterator());
+        cursors.back()->Seek(DB_COIN);
+    }
+    return std::make_unique<CCoinsViewDBCursor>(std::move(cursors), GetBestBlock());
+}
+
+CCoinsViewDBCursor::CCoinsViewDBCursor(std::vector<std::unique_ptr<CDBIterator>> cursors, const uint256& hashBlockIn)
+    : CCoinsViewCursor(hashBlockIn), m_cursors(std::move(cursors)), m_keys(m_cursors.size())
+{
+    // Cache key of first record of each shard
+    for (size_t i{0}; i < m_cursors.size(); ++i) CacheKey(i);
+    SelectCurrent();
+}
+
+void CCoinsViewDBCursor::CacheKey(size_t cursor)
+{
+    auto& key{m_keys[cursor]};
+    CoinEntry entry(&key.second);
+    if (!m_cursors[cursor]->Valid() || !m_cursors[cursor]->GetKey(entry)) {
+        key.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
     } else {
-        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
+        key.first = entry.key;
+    }
+}
+
+void CCoinsViewDBCursor::SelectCurrent()
+{
+    // Merge the shards in key order, which is the order of a single database.
+    // All outputs of a transaction live in the same shard.
+    for (size_t i{0}; i < m_keys.size(); ++i) {
+        if (m_keys[i].first != DB_COIN) continue;
+        if (m_keys[m_current].first != DB_COIN || m_keys[i].second < m_keys[m_current].second) m_current = i;
     }
-    return i;
 }
 
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
 {
     // Return cached key
-    if (keyTmp.first == DB_COIN) {
-        key = keyTmp.second;
+    if (Valid()) {
+        key = m_keys[m_current].second;
         return true;
     }
     return false;
@@ -213,21 +406,17 @@ bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
 
 bool CCoinsViewDBCursor::GetValue(Coin &coin) const
 {
-    return pcursor->GetValue(coin);
+    return m_cursors[m_current]->GetValue(coin);
 }
 
 bool CCoinsViewDBCursor::Valid() const
 {
-    return keyTmp.first == DB_COIN;
+    return m_keys[m_current].first == DB_COIN;
 }
 
 void CCoinsViewDBCursor::Next()
 {
-    pcursor->Next();
-    CoinEntry entry(&keyTmp.second);
-    if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
-        keyTmp.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
-    } else {
-        keyTmp.first = entry.key;
-    }
+    m_cursors[m_current]->Next();
+    CacheKey(m_current);
+    SelectCurrent();
 }
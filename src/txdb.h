@@ -19,10 +19,20 @@
 #include <vector>
 
 class COutPoint;
+class ThreadPool;
 class uint256;
 
 //! -dbbatchsize default (bytes)
 static const int64_t nDefaultDbBatchSize = 16 << 20;
+//! -dbshards default
+static constexpr int DEFAULT_COINS_DB_SHARDS{1};
+//! Maximum number of shards the coins database can be split into
+static constexpr int MAX_COINS_DB_SHARDS{16};
+//! Format version of the coins database written by this version. Version 1
+//! stores the shard count; databases without a version have version 0.
+static constexpr int COINS_DB_VERSION{1};
+//! -dbcompactionthreads default
+static constexpr int DEFAULT_COINS_DB_COMPACTION_THREADS{4};
 
 //! User-controlled performance and debug options.
 struct CoinsViewOptions {
@@ -31,17 +41,49 @@ struct CoinsViewOptions {
     //! If non-zero, randomly exit when the database is flushed with (1/ratio)
     //! probability.
     int simulate_crash_ratio = 0;
+    //! Number of LevelDB instances the coins are spread over when a new
+    //! database is created. Existing databases keep their number of shards.
+    int shards = DEFAULT_COINS_DB_SHARDS;
 };
 
-/** CCoinsView backed by the coin database (chainstate/) */
+/** Thrown when the coins database has a format version newer than COINS_DB_VERSION. */
+class coinsdb_version_error : public dbwrapper_error
+{
+public:
+    using dbwrapper_error::dbwrapper_error;
+};
+
+/**
+ * Directories of the additional shards of the coins database at db_path, which
+ * are stored in subdirectories of the first shard.
+ */
+std::vector<fs::path> CoinsDBShardPaths(const fs::path& db_path);
+
+/**
+ * CCoinsView backed by the coin database (chainstate/)
+ *
+ * The coins may be spread over several LevelDB instances (shards), selected by
+ * the txid of the outpoint, so that flushes can write to all of them in
+ * parallel. The first shard also holds the best block and the markers used to
+ * recover from an interrupted flush, and the format version of the database. It
+ * lives in the chainstate directory, where versions without sharding would find
+ * it, so a sharded database also marks its head blocks in a way versions that
+ * predate the format version refuse to load.
+ */
 class CCoinsViewDB final : public CCoinsView
 {
 protected:
     DBParams m_db_params;
     CoinsViewOptions m_options;
-    std::unique_ptr<CDBWrapper> m_db;
+    std::vector<std::unique_ptr<CDBWrapper>> m_shards;
+    //! Writes the batches of the shards in parallel, if there is more than one.
+    std::unique_ptr<ThreadPool> m_write_pool;
+
+    void OpenShards();
+    CDBWrapper& Shard(const COutPoint& outpoint) const;
 public:
     explicit CCoinsViewDB(DBParams db_params, CoinsViewOptions options);
+    ~CCoinsViewDB() override;
 
     std::optional<Coin> GetCoin(const COutPoint& outpoint) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
@@ -58,7 +100,9 @@ public:
     void ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     //! @returns filesystem path to on-disk storage or std::nullopt if in memory.
-    std::optional<fs::path> StoragePath() { return m_db->StoragePath(); }
+    std::optional<fs::path> StoragePath() { return m_shards.front()->StoragePath(); }
+
+    size_t ShardCount() const { return m_shards.size(); }
 };
 
 #endif // BITCOIN_TXDB_H
@@ -139,8 +139,8 @@ public:
     void Merge(TxGraphImpl& graph, Cluster& cluster) noexcept;
     /** Given a span of (parent, child) pairs that all belong to this Cluster, apply them. */
     void ApplyDependencies(TxGraphImpl& graph, std::span<std::pair<GraphIndex, GraphIndex>> to_apply) noexcept;
-    /** Improve the linearization of this Cluster. */
-    void Relinearize(TxGraphImpl& graph, uint64_t max_iters) noexcept;
+    /** Improve the linearization of this Cluster. Returns the number of iterations spent. */
+    uint64_t Relinearize(TxGraphImpl& graph, uint64_t max_iters) noexcept;
     /** For every chunk in the cluster, append its FeeFrac to ret. */
     void AppendChunkFeerates(std::vector<FeeFrac>& ret) const noexcept;
 
@@ -257,6 +257,8 @@ private:
     std::optional<ClusterSet> m_staging_clusterset;
     /** Next sequence number to assign to created Clusters. */
     uint64_t m_next_sequence_counter{0};
+    /** Position in the main ACCEPTABLE clusters where ImproveLinearizations() continues. */
+    ClusterSetIndex m_improve_index{0};
 
     /** Information about a chunk in the main graph. */
     struct ChunkData
@@ -532,6 +534,7 @@ public:
     void SetTransactionFee(const Ref&, int64_t fee) noexcept final;
 
     void DoWork() noexcept final;
+    bool ImproveLinearizations(uint64_t max_iters) noexcept final;
 
     void StartStaging() noexcept final;
     void CommitStaging() noexcept final;
@@ -554,6 +557,7 @@ public:
 
     std::unique_ptr<BlockBuilder> GetBlockBuilder() noexcept final;
     std::pair<std::vector<Ref*>, FeePerWeight> GetWorstMainChunk() noexcept final;
+    std::pair<GraphIndex, GraphIndex> GetMainClusterQualityCounts() const noexcept final;
 
     void SanityCheck() const final;
 };
@@ -1533,15 +1537,15 @@ void TxGraphImpl::ApplyDependencies(int level) noexcept
     clusterset.m_group_data = GroupData{};
 }
 
-void Cluster::Relinearize(TxGraphImpl& graph, uint64_t max_iters) noexcept
+uint64_t Cluster::Relinearize(TxGraphImpl& graph, uint64_t max_iters) noexcept
 {
     // We can only relinearize Clusters that do not need splitting.
     Assume(!NeedsSplitting());
     // No work is required for Clusters which are already optimally linearized.
-    if (IsOptimal()) return;
+    if (IsOptimal()) return 0;
     // Invoke the actual linearization algorithm (passing in the existing one).
     uint64_t rng_seed = graph.m_rng.rand64();
-    auto [linearization, optimal] = Linearize(m_depgraph, max_iters, rng_seed, m_linearization);
+    auto [linearization, optimal, cost] = Linearize(m_depgraph, max_iters, rng_seed, m_linearization);
     // Postlinearize if the result isn't optimal already. This guarantees (among other things)
     // that the chunks of the resulting linearization are all connected.
     if (!optimal) PostLinearize(m_depgraph, linearization);
@@ -1552,6 +1556,7 @@ void Cluster::Relinearize(TxGraphImpl& graph, uint64_t max_iters) noexcept
     graph.SetClusterQuality(m_level, m_quality, m_setindex, new_quality);
     // Update the Entry objects.
     Updated(graph);
+    return cost;
 }
 
 void TxGraphImpl::MakeAcceptable(Cluster& cluster) noexcept
@@ -2340,6 +2345,39 @@ void TxGraphImpl::DoWork() noexcept
     }
 }
 
+bool TxGraphImpl::ImproveLinearizations(uint64_t max_iters) noexcept
+{
+    // The main chunk index cannot be modified while BlockBuilders exist.
+    if (m_main_chunkindex_observers != 0) return false;
+    MakeAllAcceptable(0);
+    auto& clusterset = GetClusterSet(0);
+    if (clusterset.m_oversized == true) return false;
+    auto& queue = clusterset.m_clusters[int(QualityLevel::ACCEPTABLE)];
+    // Visit every Cluster at most once, continuing where the previous invocation stopped, so that
+    // Clusters which cannot be made optimal within the budget do not starve the others.
+    auto visits_left = queue.size();
+    while (visits_left > 0 && max_iters > 0 && !queue.empty()) {
+        --visits_left;
+        if (m_improve_index >= queue.size()) m_improve_index = 0;
+        Cluster& cluster = *queue[m_improve_index];
+        max_iters -= std::min(max_iters, cluster.Relinearize(*this, max_iters));
+        // If the Cluster became optimal, it left the queue and another Cluster took its place.
+        if (!cluster.IsOptimal()) ++m_improve_index;
+    }
+    return GetMainClusterQualityCounts().second == 0;
+}
+
+std::pair<TxGraph::GraphIndex, TxGraph::GraphIndex> TxGraphImpl::GetMainClusterQualityCounts() const noexcept
+{
+    const auto& clusterset = GetClusterSet(0);
+    GraphIndex optimal{0}, other{0};
+    for (int quality = 0; quality < int(QualityLevel::NONE); ++quality) {
+        auto count = clusterset.m_clusters[quality].size();
+        (quality == int(QualityLevel::OPTIMAL) ? optimal : other) += count;
+    }
+    return {optimal, other};
+}
+
 void BlockBuilderImpl::Next() noexcept
 {
     // Don't do anything if we're already done.
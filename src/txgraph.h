@@ -97,6 +97,13 @@ public:
      *  Calling DoWork will compute everything now, so that future operations are fast. This can be
      *  invoked while oversized. */
     virtual void DoWork() noexcept = 0;
+    /** Improve the linearizations of main graph clusters that are not known to be optimal,
+     *  spending approximately at most max_iters optimization steps in total. Unlike DoWork(),
+     *  this is meant to be invoked repeatedly with a small budget (e.g. by a background task
+     *  holding the owner's lock briefly each time), eventually making all clusters optimal.
+     *  Does nothing while oversized or while a BlockBuilder exists. Returns whether all main
+     *  graph clusters are known to be optimally linearized afterwards. */
+    virtual bool ImproveLinearizations(uint64_t max_iters) noexcept = 0;
 
     /** Create a staging graph (which cannot exist already). This acts as if a full copy of
      *  the transaction graph is made, upon which further modifications are made. This copy can
@@ -197,6 +204,10 @@ public:
      *  reverse-topological order, so every element is preceded by all its descendants. The main
      *  graph must not be oversized. If the graph is empty, {{}, FeePerWeight{}} is returned. */
     virtual std::pair<std::vector<Ref*>, FeePerWeight> GetWorstMainChunk() noexcept = 0;
+    /** Get the number of main graph clusters whose linearization is known to be optimal, and the
+     *  number of other clusters. Does not perform any work, so clusters which still need to be
+     *  split are counted once. */
+    virtual std::pair<GraphIndex, GraphIndex> GetMainClusterQualityCounts() const noexcept = 0;
 
     /** Perform an internal consistency check on this object. */
     virtual void SanityCheck() const = 0;
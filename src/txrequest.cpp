@@ -9,17 +9,18 @@
 #include <primitives/transaction.h>
 #include <random.h>
 #include <uint256.h>
+#include <util/hasher.h>
 
-#include <boost/multi_index/indexed_by.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/sequenced_index.hpp>
-#include <boost/multi_index/tag.hpp>
-#include <boost/multi_index_container.hpp>
-#include <boost/tuple/tuple.hpp>
-
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
+#include <limits>
+#include <map>
+#include <set>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <assert.h>
 
@@ -28,7 +29,8 @@ namespace {
 /** The various states a (txhash,peer) pair can be in.
  *
  * Note that CANDIDATE is split up into 3 substates (DELAYED, BEST, READY), allowing more efficient implementation.
- * Also note that the sorting order of ByTxHashView relies on the specific order of values in this enum.
+ * Also note that TxRequestTracker::Impl::SetState relies on REQUESTED and COMPLETED being the last values in this
+ * enum.
  *
  * Expected behaviour is:
  *   - When first announced by a peer, the state is CANDIDATE_DELAYED until reqtime is reached.
@@ -57,26 +59,47 @@ enum class State : uint8_t {
 //! Type alias for sequence numbers.
 using SequenceNumber = uint64_t;
 
+//! Type alias for priorities.
+using Priority = uint64_t;
+
+//! Type alias for positions of announcements in TxRequestTracker::Impl::m_announcements.
+using AnnouncementIndex = uint32_t;
+
+//! Placeholder for "no announcement".
+constexpr AnnouncementIndex NO_ANNOUNCEMENT{std::numeric_limits<AnnouncementIndex>::max()};
+
 /** An announcement. This is the data we track for each txid or wtxid that is announced to us by each peer. */
 struct Announcement {
     /** Txid or wtxid that was announced. */
-    const uint256 m_txhash;
+    uint256 m_txhash;
     /** For CANDIDATE_{DELAYED,BEST,READY} the reqtime; for REQUESTED the expiry. */
     std::chrono::microseconds m_time;
     /** What peer the request was from. */
-    const NodeId m_peer;
+    NodeId m_peer;
+    /** The priority of this announcement, see PriorityComputer. Cached as it never changes. */
+    Priority m_priority;
     /** What sequence number this announcement has. */
-    const SequenceNumber m_sequence : 59;
+    SequenceNumber m_sequence : 59;
     /** Whether the request is preferred. */
-    const bool m_preferred : 1;
+    bool m_preferred : 1;
     /** Whether this is a wtxid request. */
-    const bool m_is_wtxid : 1;
+    bool m_is_wtxid : 1;
 
     /** What state this announcement is in. */
     State m_state : 3 {State::CANDIDATE_DELAYED};
     State GetState() const { return m_state; }
     void SetState(State state) { m_state = state; }
 
+    /** For CANDIDATE_BEST announcements, the position in their peer's PeerData::m_best. */
+    uint32_t m_best_pos{0};
+    /** For CANDIDATE_READY announcements, the position in their txhash's TxHashEntry::m_ready. */
+    uint32_t m_ready_pos{0};
+    /** The position in its txhash's TxHashEntry::m_announcements. */
+    uint32_t m_txhash_pos{0};
+    /** Incremented whenever this slot is reused for another announcement, so that stale timer events for the
+     *  previous occupant can be recognized. */
+    uint32_t m_generation{0};
+
     /** Whether this announcement is selected. There can be at most 1 selected peer per txhash. */
     bool IsSelected() const
     {
@@ -97,14 +120,11 @@ struct Announcement {
 
     /** Construct a new announcement from scratch, initially in CANDIDATE_DELAYED state. */
     Announcement(const GenTxid& gtxid, NodeId peer, bool preferred, std::chrono::microseconds reqtime,
-                 SequenceNumber sequence)
-        : m_txhash(gtxid.GetHash()), m_time(reqtime), m_peer(peer), m_sequence(sequence), m_preferred(preferred),
-          m_is_wtxid{gtxid.IsWtxid()} {}
+                 SequenceNumber sequence, Priority priority)
+        : m_txhash(gtxid.GetHash()), m_time(reqtime), m_peer(peer), m_priority(priority), m_sequence(sequence),
+          m_preferred(preferred), m_is_wtxid{gtxid.IsWtxid()} {}
 };
 
-//! Type alias for priorities.
-using Priority = uint64_t;
-
 /** A functor with embedded salt that computes priority of an announcement.
  *
  * Higher priorities are selected first.
@@ -128,106 +148,176 @@ public:
     }
 };
 
-// Definitions for the 3 indexes used in the main data structure.
-//
-// Each index has a By* type to identify it, a By*View data type to represent the view of announcement it is sorted
-// by, and an By*ViewExtractor type to convert an announcement into the By*View type.
-// See https://www.boost.org/doc/libs/1_58_0/libs/multi_index/doc/reference/key_extraction.html#key_extractors
-// for more information about the key extraction concept.
-
-// The ByPeer index is sorted by (peer, state == CANDIDATE_BEST, txhash)
-//
-// Uses:
-// * Looking up existing announcements by peer/txhash, by checking both (peer, false, txhash) and
-//   (peer, true, txhash).
-// * Finding all CANDIDATE_BEST announcements for a given peer in GetRequestable.
-struct ByPeer {};
-using ByPeerView = std::tuple<NodeId, bool, const uint256&>;
-struct ByPeerViewExtractor
+/** A scheduled point in time at which an announcement (identified by its index and generation) may need to change
+ *  state. Events are never removed when the announcement changes state before its time; instead they are checked
+ *  against the announcement when they fire. */
+struct TimerEvent {
+    std::chrono::microseconds m_time;
+    AnnouncementIndex m_index;
+    uint32_t m_generation;
+};
+
+/** Hierarchical timing wheel holding TimerEvents.
+ *
+ * Times are bucketed into ticks of 2^TICK_BITS microseconds. Level l has SLOTS slots, each covering
+ * SLOTS^l ticks, and an event is stored at the lowest level in which it differs from the current tick (the
+ * highest 6-bit group in which the two tick values differ). Events further away than the highest level can
+ * represent go into an overflow list, and events whose tick has already been reached go into a due list. Advancing
+ * the wheel only touches non-empty slots whose range has been reached, and moves their events to lower levels (or
+ * the due list), so as long as time only goes forward, every event is moved at most LEVELS + 1 times before it
+ * fires.
+ *
+ * Time may go backwards: events are only returned when their exact time is reached. When it does, all events are
+ * placed again relative to the earlier time, so the due list only keeps events of the current tick that are not
+ * due yet, instead of every event scheduled between the earlier and the later time.
+ */
+class TimerWheel
 {
-    using result_type = ByPeerView;
-    result_type operator()(const Announcement& ann) const
+    static constexpr int TICK_BITS{14};
+    static constexpr int SLOT_BITS{6};
+    static constexpr int SLOTS{1 << SLOT_BITS};
+    static constexpr int LEVELS{5};
+
+    //! Tick that the levels are relative to, i.e. the tick of the last Advance() call.
+    uint64_t m_tick{0};
+    //! Events per level and slot.
+    std::array<std::array<std::vector<TimerEvent>, SLOTS>, LEVELS> m_slots;
+    //! Bitmask of non-empty slots per level.
+    std::array<uint64_t, LEVELS> m_occupied{};
+    //! Events that are beyond the range of the highest level.
+    std::vector<TimerEvent> m_overflow;
+    //! Events whose tick is not after m_tick.
+    std::vector<TimerEvent> m_due;
+    //! Scratch space used while advancing.
+    std::vector<TimerEvent> m_moving;
+    //! Number of events not returned by Advance() yet.
+    size_t m_size{0};
+
+    static uint64_t ToTick(std::chrono::microseconds time)
     {
-        return ByPeerView{ann.m_peer, ann.GetState() == State::CANDIDATE_BEST, ann.m_txhash};
+        // Map the signed time onto the unsigned range, preserving order.
+        return (static_cast<uint64_t>(time.count()) ^ (uint64_t{1} << 63)) >> TICK_BITS;
     }
-};
 
-// The ByTxHash index is sorted by (txhash, state, priority).
-//
-// Note: priority == 0 whenever state != CANDIDATE_READY.
-//
-// Uses:
-// * Deleting all announcements with a given txhash in ForgetTxHash.
-// * Finding the best CANDIDATE_READY to convert to CANDIDATE_BEST, when no other CANDIDATE_READY or REQUESTED
-//   announcement exists for that txhash.
-// * Determining when no more non-COMPLETED announcements for a given txhash exist, so the COMPLETED ones can be
-//   deleted.
-struct ByTxHash {};
-using ByTxHashView = std::tuple<const uint256&, State, Priority>;
-class ByTxHashViewExtractor {
-    const PriorityComputer& m_computer;
-public:
-    explicit ByTxHashViewExtractor(const PriorityComputer& computer) : m_computer(computer) {}
-    using result_type = ByTxHashView;
-    result_type operator()(const Announcement& ann) const
+    void Place(const TimerEvent& event)
     {
-        const Priority prio = (ann.GetState() == State::CANDIDATE_READY) ? m_computer(ann) : 0;
-        return ByTxHashView{ann.m_txhash, ann.GetState(), prio};
+        const uint64_t tick{ToTick(event.m_time)};
+        if (tick <= m_tick) {
+            m_due.push_back(event);
+            return;
+        }
+        const int level{(static_cast<int>(std::bit_width(tick ^ m_tick)) - 1) / SLOT_BITS};
+        if (level >= LEVELS) {
+            m_overflow.push_back(event);
+            return;
+        }
+        const int slot = (tick >> (level * SLOT_BITS)) & (SLOTS - 1);
+        m_slots[level][slot].push_back(event);
+        m_occupied[level] |= uint64_t{1} << slot;
     }
-};
 
-enum class WaitState {
-    //! Used for announcements that need efficient testing of "is their timestamp in the future?".
-    FUTURE_EVENT,
-    //! Used for announcements whose timestamp is not relevant.
-    NO_EVENT,
-    //! Used for announcements that need efficient testing of "is their timestamp in the past?".
-    PAST_EVENT,
-};
+public:
+    void Insert(std::chrono::microseconds time, AnnouncementIndex index, uint32_t generation)
+    {
+        Place(TimerEvent{time, index, generation});
+        ++m_size;
+    }
 
-WaitState GetWaitState(const Announcement& ann)
-{
-    if (ann.IsWaiting()) return WaitState::FUTURE_EVENT;
-    if (ann.IsSelectable()) return WaitState::PAST_EVENT;
-    return WaitState::NO_EVENT;
-}
+    //! Number of pending events, including ones that no longer apply to their announcement.
+    size_t Size() const { return m_size; }
 
-// The ByTime index is sorted by (wait_state, time).
-//
-// All announcements with a timestamp in the future can be found by iterating the index forward from the beginning.
-// All announcements with a timestamp in the past can be found by iterating the index backwards from the end.
-//
-// Uses:
-// * Finding CANDIDATE_DELAYED announcements whose reqtime has passed, and REQUESTED announcements whose expiry has
-//   passed.
-// * Finding CANDIDATE_READY/BEST announcements whose reqtime is in the future (when the clock time went backwards).
-struct ByTime {};
-using ByTimeView = std::pair<WaitState, std::chrono::microseconds>;
-struct ByTimeViewExtractor
-{
-    using result_type = ByTimeView;
-    result_type operator()(const Announcement& ann) const
+    //! Remove all events, and release the memory they used.
+    void Clear()
     {
-        return ByTimeView{GetWaitState(ann), ann.m_time};
+        m_slots = {};
+        m_occupied = {};
+        m_overflow = {};
+        m_due = {};
+        m_moving = {};
+        m_size = 0;
     }
-};
 
-struct Announcement_Indices final : boost::multi_index::indexed_by<
-    boost::multi_index::ordered_unique<boost::multi_index::tag<ByPeer>, ByPeerViewExtractor>,
-    boost::multi_index::ordered_non_unique<boost::multi_index::tag<ByTxHash>, ByTxHashViewExtractor>,
-    boost::multi_index::ordered_non_unique<boost::multi_index::tag<ByTime>, ByTimeViewExtractor>
->
-{};
+    /** Move all events with time <= now to due_events (which is cleared first), in no particular order. */
+    void Advance(std::chrono::microseconds now, std::vector<TimerEvent>& due_events)
+    {
+        due_events.clear();
+        const uint64_t tick{ToTick(now)};
+        if (tick < m_tick) {
+            // Time went backwards. Gather all events, including the due ones, as many of them may not be due
+            // anymore.
+            m_moving.clear();
+            for (int level = 0; level < LEVELS; ++level) {
+                uint64_t mask{m_occupied[level]};
+                m_occupied[level] = 0;
+                while (mask) {
+                    auto& slot = m_slots[level][std::countr_zero(mask)];
+                    m_moving.insert(m_moving.end(), slot.begin(), slot.end());
+                    slot.clear();
+                    mask &= mask - 1;
+                }
+            }
+            m_moving.insert(m_moving.end(), m_overflow.begin(), m_overflow.end());
+            m_overflow.clear();
+            m_moving.insert(m_moving.end(), m_due.begin(), m_due.end());
+            m_due.clear();
+            // Redistribute them relative to the earlier tick.
+            m_tick = tick;
+            for (const TimerEvent& event : m_moving) Place(event);
+        } else if (tick > m_tick) {
+            // Gather the events from all slots whose range has been (partially) reached.
+            m_moving.clear();
+            for (int level = 0; level < LEVELS; ++level) {
+                uint64_t mask{m_occupied[level]};
+                if ((tick >> ((level + 1) * SLOT_BITS)) == (m_tick >> ((level + 1) * SLOT_BITS))) {
+                    const int last_slot = (tick >> (level * SLOT_BITS)) & (SLOTS - 1);
+                    if (last_slot != SLOTS - 1) mask &= (uint64_t{2} << last_slot) - 1;
+                }
+                m_occupied[level] &= ~mask;
+                while (mask) {
+                    auto& slot = m_slots[level][std::countr_zero(mask)];
+                    m_moving.insert(m_moving.end(), slot.begin(), slot.end());
+                    slot.clear();
+                    mask &= mask - 1;
+                }
+            }
+            if ((tick >> (LEVELS * SLOT_BITS)) != (m_tick >> (LEVELS * SLOT_BITS))) {
+                m_moving.insert(m_moving.end(), m_overflow.begin(), m_overflow.end());
+                m_overflow.clear();
+            }
+            // Redistribute them relative to the new tick.
+            m_tick = tick;
+            for (const TimerEvent& event : m_moving) Place(event);
+        }
+        // Report the events in the due list whose time has been reached.
+        for (size_t i = 0; i < m_due.size();) {
+            if (m_due[i].m_time <= now) {
+                due_events.push_back(m_due[i]);
+                m_due[i] = m_due.back();
+                m_due.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        m_size -= due_events.size();
+    }
 
-/** Data type for the main data structure (Announcement objects with ByPeer/ByTxHash/ByTime indexes). */
-using Index = boost::multi_index_container<
-    Announcement,
-    Announcement_Indices
->;
+    //! Call fn for every pending event (testing only).
+    template<typename Fn>
+    void ForEachEvent(Fn fn) const
+    {
+        for (const auto& level : m_slots) {
+            for (const auto& slot : level) {
+                for (const TimerEvent& event : slot) fn(event);
+            }
+        }
+        for (const TimerEvent& event : m_overflow) fn(event);
+        for (const TimerEvent& event : m_due) fn(event);
+    }
+};
 
-/** Helper type to simplify syntax of iterator types. */
-template<typename Tag>
-using Iter = typename Index::index<Tag>::type::iterator;
+/** Number of stale timer events tolerated on top of the number of announcements, before TxRequestTracker
+ *  rebuilds its TimerWheel. */
+constexpr size_t STALE_TIMER_EVENTS_SLACK{1024};
 
 /** Per-peer statistics object. */
 struct PeerInfo {
@@ -236,6 +326,29 @@ struct PeerInfo {
     size_t m_requested = 0; //!< Number of REQUESTED announcements for this peer.
 };
 
+/** Per-peer statistics, plus the peer's announcements. */
+struct PeerData : PeerInfo {
+    //! All announcements for this peer, by txhash.
+    std::unordered_map<uint256, AnnouncementIndex, SaltedTxidHasher> m_announcements;
+    //! This peer's CANDIDATE_BEST announcements, in no particular order.
+    std::vector<AnnouncementIndex> m_best;
+
+    explicit PeerData(const SaltedTxidHasher& hasher) : m_announcements{0, hasher} {}
+};
+
+/** Per-txhash data. */
+struct TxHashEntry {
+    //! All announcements for this txhash, in no particular order.
+    std::vector<AnnouncementIndex> m_announcements;
+    //! The CANDIDATE_BEST or REQUESTED announcement for this txhash, if any.
+    AnnouncementIndex m_selected{NO_ANNOUNCEMENT};
+    //! The CANDIDATE_READY announcements for this txhash, as a binary max-heap by priority, so that the next
+    //! CANDIDATE_BEST can be found without going over all announcements.
+    std::vector<AnnouncementIndex> m_ready;
+    //! Number of announcements for this txhash that are not COMPLETED.
+    size_t m_non_completed{0};
+};
+
 /** Per-txhash statistics object. Only used for sanity checking. */
 struct TxHashInfo
 {
@@ -262,39 +375,39 @@ bool operator==(const PeerInfo& a, const PeerInfo& b)
            std::tie(b.m_total, b.m_completed, b.m_requested);
 };
 
-/** (Re)compute the PeerInfo map from the index. Only used for sanity checking. */
-std::unordered_map<NodeId, PeerInfo> RecomputePeerInfo(const Index& index)
+/** (Re)compute the PeerInfo map from a list of announcements. Only used for sanity checking. */
+std::unordered_map<NodeId, PeerInfo> RecomputePeerInfo(const std::vector<const Announcement*>& announcements)
 {
     std::unordered_map<NodeId, PeerInfo> ret;
-    for (const Announcement& ann : index) {
-        PeerInfo& info = ret[ann.m_peer];
+    for (const Announcement* ann : announcements) {
+        PeerInfo& info = ret[ann->m_peer];
         ++info.m_total;
-        info.m_requested += (ann.GetState() == State::REQUESTED);
-        info.m_completed += (ann.GetState() == State::COMPLETED);
+        info.m_requested += (ann->GetState() == State::REQUESTED);
+        info.m_completed += (ann->GetState() == State::COMPLETED);
     }
     return ret;
 }
 
 /** Compute the TxHashInfo map. Only used for sanity checking. */
-std::map<uint256, TxHashInfo> ComputeTxHashInfo(const Index& index, const PriorityComputer& computer)
+std::map<uint256, TxHashInfo> ComputeTxHashInfo(const std::vector<const Announcement*>& announcements)
 {
     std::map<uint256, TxHashInfo> ret;
-    for (const Announcement& ann : index) {
-        TxHashInfo& info = ret[ann.m_txhash];
+    for (const Announcement* ann : announcements) {
+        TxHashInfo& info = ret[ann->m_txhash];
         // Classify how many announcements of each state we have for this txhash.
-        info.m_candidate_delayed += (ann.GetState() == State::CANDIDATE_DELAYED);
-        info.m_candidate_ready += (ann.GetState() == State::CANDIDATE_READY);
-        info.m_candidate_best += (ann.GetState() == State::CANDIDATE_BEST);
-        info.m_requested += (ann.GetState() == State::REQUESTED);
+        info.m_candidate_delayed += (ann->GetState() == State::CANDIDATE_DELAYED);
+        info.m_candidate_ready += (ann->GetState() == State::CANDIDATE_READY);
+        info.m_candidate_best += (ann->GetState() == State::CANDIDATE_BEST);
+        info.m_requested += (ann->GetState() == State::REQUESTED);
         // And track the priority of the best CANDIDATE_READY/CANDIDATE_BEST announcements.
-        if (ann.GetState() == State::CANDIDATE_BEST) {
-            info.m_priority_candidate_best = computer(ann);
+        if (ann->GetState() == State::CANDIDATE_BEST) {
+            info.m_priority_candidate_best = ann->m_priority;
         }
-        if (ann.GetState() == State::CANDIDATE_READY) {
-            info.m_priority_best_candidate_ready = std::max(info.m_priority_best_candidate_ready, computer(ann));
+        if (ann->GetState() == State::CANDIDATE_READY) {
+            info.m_priority_best_candidate_ready = std::max(info.m_priority_best_candidate_ready, ann->m_priority);
         }
         // Also keep track of which peers this txhash has an announcement for (so we can detect duplicates).
-        info.m_peers.push_back(ann.m_peer);
+        info.m_peers.push_back(ann->m_peer);
     }
     return ret;
 }
@@ -306,7 +419,12 @@ GenTxid ToGenTxid(const Announcement& ann)
 
 }  // namespace
 
-/** Actual implementation for TxRequestTracker's data structure. */
+/** Actual implementation for TxRequestTracker's data structure.
+ *
+ * Announcements are stored in a vector (with a free list of unused slots), and referred to by their position in
+ * it. They are indexed per txhash (m_txhash_entries) and per peer (m_peerinfo) using hash tables, and the points
+ * in time at which CANDIDATE_DELAYED and REQUESTED announcements change state are kept in a TimerWheel.
+ */
 class TxRequestTracker::Impl {
     //! The current sequence number. Increases for every announcement. This is used to sort txhashes returned by
     //! GetRequestable in announcement order.
@@ -315,21 +433,60 @@ class TxRequestTracker::Impl {
     //! This tracker's priority computer.
     const PriorityComputer m_computer;
 
-    //! This tracker's main data structure. See SanityCheck() for the invariants that apply to it.
-    Index m_index;
+    //! Hasher shared by all hash tables keyed by txhash.
+    const SaltedTxidHasher m_hasher;
+
+    //! All announcements, including unused slots (listed in m_free). See SanityCheck() for the invariants that
+    //! apply to them.
+    std::vector<Announcement> m_announcements;
+
+    //! Unused slots in m_announcements.
+    std::vector<AnnouncementIndex> m_free;
+
+    //! Map with this tracker's per-txhash data.
+    std::unordered_map<uint256, TxHashEntry, SaltedTxidHasher> m_txhash_entries{0, m_hasher};
 
-    //! Map with this tracker's per-peer statistics.
-    std::unordered_map<NodeId, PeerInfo> m_peerinfo;
+    //! Map with this tracker's per-peer data.
+    std::unordered_map<NodeId, PeerData> m_peerinfo;
+
+    //! Times at which CANDIDATE_DELAYED and REQUESTED announcements need to be looked at.
+    TimerWheel m_timer;
+
+    //! The time passed to the last SetTimePoint call. No CANDIDATE_READY or CANDIDATE_BEST announcement has a
+    //! time after it.
+    std::chrono::microseconds m_last_time_point{std::chrono::microseconds::min()};
+
+    //! Scratch space for SetTimePoint.
+    std::vector<TimerEvent> m_due_events;
+
+    //! Gather pointers to all tracked announcements. Only used for sanity checking.
+    std::vector<const Announcement*> GetAnnouncements() const
+    {
+        std::vector<const Announcement*> ret;
+        for (const auto& [txhash, entry] : m_txhash_entries) {
+            for (AnnouncementIndex index : entry.m_announcements) ret.push_back(&m_announcements[index]);
+        }
+        return ret;
+    }
 
 public:
     void SanityCheck() const
     {
-        // Recompute m_peerdata from m_index. This verifies the data in it as it should just be caching statistics
-        // on m_index. It also verifies the invariant that no PeerInfo announcements with m_total==0 exist.
-        assert(m_peerinfo == RecomputePeerInfo(m_index));
+        const std::vector<const Announcement*> announcements{GetAnnouncements()};
+        assert(announcements.size() == Size());
+
+        // Recompute the statistics in m_peerinfo from the announcements. This verifies the data in it as it should
+        // just be caching statistics on them. It also verifies the invariant that no PeerData entries with
+        // m_total==0 exist.
+        const auto recomputed_peerinfo{RecomputePeerInfo(announcements)};
+        assert(m_peerinfo.size() == recomputed_peerinfo.size());
+        for (const auto& [peer, info] : recomputed_peerinfo) {
+            auto peerit = m_peerinfo.find(peer);
+            assert(peerit != m_peerinfo.end() && peerit->second == info);
+        }
 
-        // Calculate per-txhash statistics from m_index, and validate invariants.
-        for (auto& item : ComputeTxHashInfo(m_index, m_computer)) {
+        // Calculate per-txhash statistics from the announcements, and validate invariants.
+        for (auto& item : ComputeTxHashInfo(announcements)) {
             TxHashInfo& info = item.second;
 
             // Cannot have only COMPLETED peer (txhash should have been forgotten already)
@@ -354,134 +511,292 @@ public:
             std::sort(info.m_peers.begin(), info.m_peers.end());
             assert(std::adjacent_find(info.m_peers.begin(), info.m_peers.end()) == info.m_peers.end());
         }
+
+        // Every slot is either free, or referenced by exactly one txhash entry.
+        std::vector<int> references(m_announcements.size());
+        for (AnnouncementIndex index : m_free) ++references[index];
+        for (const auto& [txhash, entry] : m_txhash_entries) {
+            assert(!entry.m_announcements.empty());
+            size_t non_completed{0};
+            AnnouncementIndex selected{NO_ANNOUNCEMENT};
+            for (size_t pos = 0; pos < entry.m_announcements.size(); ++pos) {
+                const AnnouncementIndex index{entry.m_announcements[pos]};
+                ++references[index];
+                const Announcement& ann = m_announcements[index];
+                assert(ann.m_txhash == txhash);
+                assert(ann.m_txhash_pos == pos);
+                assert(ann.m_priority == m_computer(ann));
+                non_completed += ann.GetState() != State::COMPLETED;
+                if (ann.IsSelected()) selected = index;
+            }
+            assert(entry.m_non_completed == non_completed);
+            assert(entry.m_selected == selected);
+            // m_ready is a heap of exactly the CANDIDATE_READY announcements.
+            size_t ready{0};
+            for (AnnouncementIndex index : entry.m_announcements) ready += m_announcements[index].GetState() == State::CANDIDATE_READY;
+            assert(entry.m_ready.size() == ready);
+            for (size_t pos = 0; pos < entry.m_ready.size(); ++pos) {
+                const Announcement& ann = m_announcements[entry.m_ready[pos]];
+                assert(ann.m_txhash == txhash && ann.GetState() == State::CANDIDATE_READY && ann.m_ready_pos == pos);
+                if (pos > 0) assert(m_announcements[entry.m_ready[(pos - 1) / 2]].m_priority >= ann.m_priority);
+            }
+        }
+        assert(std::all_of(references.begin(), references.end(), [](int r) { return r == 1; }));
+
+        // The per-peer indexes are consistent with the announcements.
+        for (const auto& [peer, peerinfo] : m_peerinfo) {
+            assert(peerinfo.m_announcements.size() == peerinfo.m_total);
+            size_t best{0};
+            for (const auto& [txhash, index] : peerinfo.m_announcements) {
+                const Announcement& ann = m_announcements[index];
+                assert(ann.m_peer == peer && ann.m_txhash == txhash);
+                if (ann.GetState() == State::CANDIDATE_BEST) {
+                    ++best;
+                    assert(ann.m_best_pos < peerinfo.m_best.size() && peerinfo.m_best[ann.m_best_pos] == index);
+                }
+            }
+            assert(peerinfo.m_best.size() == best);
+        }
+
+        // Every announcement that is waiting for a time to pass has a matching timer event.
+        std::set<std::pair<AnnouncementIndex, uint32_t>> events;
+        m_timer.ForEachEvent([&](const TimerEvent& event) {
+            const Announcement& ann = m_announcements[event.m_index];
+            if (ann.IsWaiting() && ann.m_generation == event.m_generation && ann.m_time == event.m_time) {
+                events.emplace(event.m_index, event.m_generation);
+            }
+        });
+        for (const Announcement* ann : announcements) {
+            if (ann->IsWaiting()) assert(events.count({static_cast<AnnouncementIndex>(ann - m_announcements.data()), ann->m_generation}));
+        }
+        // Stale events are bounded.
+        assert(m_timer.Size() <= 2 * Size() + STALE_TIMER_EVENTS_SLACK);
     }
 
     void PostGetRequestableSanityCheck(std::chrono::microseconds now) const
     {
-        for (const Announcement& ann : m_index) {
-            if (ann.IsWaiting()) {
+        for (const Announcement* ann : GetAnnouncements()) {
+            if (ann->IsWaiting()) {
                 // REQUESTED and CANDIDATE_DELAYED must have a time in the future (they should have been converted
                 // to COMPLETED/CANDIDATE_READY respectively).
-                assert(ann.m_time > now);
-            } else if (ann.IsSelectable()) {
+                assert(ann->m_time > now);
+            } else if (ann->IsSelectable()) {
                 // CANDIDATE_READY and CANDIDATE_BEST cannot have a time in the future (they should have remained
                 // CANDIDATE_DELAYED, or should have been converted back to it if time went backwards).
-                assert(ann.m_time <= now);
+                assert(ann->m_time <= now);
             }
         }
     }
 
 private:
-    //! Wrapper around Index::...::erase that keeps m_peerinfo up to date.
-    template<typename Tag>
-    Iter<Tag> Erase(Iter<Tag> it)
+    //! Remove an announcement from its peer's data, and release its slot. Its txhash entry is left untouched.
+    void Release(AnnouncementIndex index)
+    {
+        Announcement& ann = m_announcements[index];
+        auto peerit = m_peerinfo.find(ann.m_peer);
+        PeerData& peerinfo = peerit->second;
+        if (ann.GetState() == State::CANDIDATE_BEST) RemoveBest(peerinfo, ann);
+        peerinfo.m_completed -= ann.GetState() == State::COMPLETED;
+        peerinfo.m_requested -= ann.GetState() == State::REQUESTED;
+        if (--peerinfo.m_total == 0) {
+            m_peerinfo.erase(peerit);
+        } else {
+            peerinfo.m_announcements.erase(ann.m_txhash);
+        }
+        ++ann.m_generation;
+        m_free.push_back(index);
+    }
+
+    //! Delete a single announcement.
+    void Erase(AnnouncementIndex index)
     {
-        auto peerit = m_peerinfo.find(it->m_peer);
-        peerit->second.m_completed -= it->GetState() == State::COMPLETED;
-        peerit->second.m_requested -= it->GetState() == State::REQUESTED;
-        if (--peerit->second.m_total == 0) m_peerinfo.erase(peerit);
-        return m_index.get<Tag>().erase(it);
+        auto entryit = m_txhash_entries.find(m_announcements[index].m_txhash);
+        TxHashEntry& entry = entryit->second;
+        if (entry.m_selected == index) entry.m_selected = NO_ANNOUNCEMENT;
+        if (m_announcements[index].GetState() == State::CANDIDATE_READY) RemoveReady(entry, index);
+        entry.m_non_completed -= m_announcements[index].GetState() != State::COMPLETED;
+        if (entry.m_announcements.size() == 1) {
+            m_txhash_entries.erase(entryit);
+        } else {
+            const uint32_t pos{m_announcements[index].m_txhash_pos};
+            const AnnouncementIndex moved{entry.m_announcements.back()};
+            entry.m_announcements[pos] = moved;
+            m_announcements[moved].m_txhash_pos = pos;
+            entry.m_announcements.pop_back();
+        }
+        Release(index);
+    }
+
+    //! Delete all announcements for a txhash.
+    void EraseTxHash(std::unordered_map<uint256, TxHashEntry, SaltedTxidHasher>::iterator entryit)
+    {
+        for (AnnouncementIndex index : entryit->second.m_announcements) Release(index);
+        m_txhash_entries.erase(entryit);
+    }
+
+    //! Remove a CANDIDATE_BEST announcement from its peer's m_best.
+    void RemoveBest(PeerData& peerinfo, const Announcement& ann)
+    {
+        const AnnouncementIndex moved{peerinfo.m_best.back()};
+        peerinfo.m_best[ann.m_best_pos] = moved;
+        m_announcements[moved].m_best_pos = ann.m_best_pos;
+        peerinfo.m_best.pop_back();
+    }
+
+    //! Move the announcement at position pos of entry.m_ready towards the root of the heap while it has a higher
+    //! priority than its parent, and return its new position.
+    size_t SiftUpReady(TxHashEntry& entry, size_t pos)
+    {
+        const AnnouncementIndex index{entry.m_ready[pos]};
+        const Priority priority{m_announcements[index].m_priority};
+        while (pos > 0) {
+            const size_t parent{(pos - 1) / 2};
+            if (m_announcements[entry.m_ready[parent]].m_priority >= priority) break;
+            entry.m_ready[pos] = entry.m_ready[parent];
+            m_announcements[entry.m_ready[pos]].m_ready_pos = pos;
+            pos = parent;
+        }
+        entry.m_ready[pos] = index;
+        m_announcements[index].m_ready_pos = pos;
+        return pos;
+    }
+
+    //! Move the announcement at position pos of entry.m_ready away from the root of the heap while one of its
+    //! children has a higher priority.
+    void SiftDownReady(TxHashEntry& entry, size_t pos)
+    {
+        const AnnouncementIndex index{entry.m_ready[pos]};
+        const Priority priority{m_announcements[index].m_priority};
+        while (true) {
+            size_t child{2 * pos + 1};
+            if (child >= entry.m_ready.size()) break;
+            if (child + 1 < entry.m_ready.size() &&
+                m_announcements[entry.m_ready[child + 1]].m_priority > m_announcements[entry.m_ready[child]].m_priority) {
+                ++child;
+            }
+            if (priority >= m_announcements[entry.m_ready[child]].m_priority) break;
+            entry.m_ready[pos] = entry.m_ready[child];
+            m_announcements[entry.m_ready[pos]].m_ready_pos = pos;
+            pos = child;
+        }
+        entry.m_ready[pos] = index;
+        m_announcements[index].m_ready_pos = pos;
     }
 
-    //! Wrapper around Index::...::modify that keeps m_peerinfo up to date.
-    template<typename Tag, typename Modifier>
-    void Modify(Iter<Tag> it, Modifier modifier)
+    //! Add a CANDIDATE_READY announcement to its txhash's m_ready heap.
+    void AddReady(TxHashEntry& entry, AnnouncementIndex index)
     {
-        auto peerit = m_peerinfo.find(it->m_peer);
-        peerit->second.m_completed -= it->GetState() == State::COMPLETED;
-        peerit->second.m_requested -= it->GetState() == State::REQUESTED;
-        m_index.get<Tag>().modify(it, std::move(modifier));
-        peerit->second.m_completed += it->GetState() == State::COMPLETED;
-        peerit->second.m_requested += it->GetState() == State::REQUESTED;
+        entry.m_ready.push_back(index);
+        SiftUpReady(entry, entry.m_ready.size() - 1);
+    }
+
+    //! Remove an announcement from its txhash's m_ready heap.
+    void RemoveReady(TxHashEntry& entry, AnnouncementIndex index)
+    {
+        const size_t pos{m_announcements[index].m_ready_pos};
+        const AnnouncementIndex moved{entry.m_ready.back()};
+        entry.m_ready.pop_back();
+        if (moved == index) return;
+        entry.m_ready[pos] = moved;
+        if (SiftUpReady(entry, pos) == pos) SiftDownReady(entry, pos);
+    }
+
+    //! Change the state of an announcement, keeping all per-peer and per-txhash data up to date, and scheduling a
+    //! timer event if the new state is waiting for m_time to pass.
+    void SetState(AnnouncementIndex index, TxHashEntry& entry, State state)
+    {
+        Announcement& ann = m_announcements[index];
+        const State old_state{ann.GetState()};
+        if (old_state == State::CANDIDATE_BEST || old_state >= State::REQUESTED ||
+            state == State::CANDIDATE_BEST || state >= State::REQUESTED) {
+            PeerData& peerinfo = m_peerinfo.find(ann.m_peer)->second;
+            if (old_state == State::CANDIDATE_BEST) RemoveBest(peerinfo, ann);
+            peerinfo.m_completed -= old_state == State::COMPLETED;
+            peerinfo.m_requested -= old_state == State::REQUESTED;
+            peerinfo.m_completed += state == State::COMPLETED;
+            peerinfo.m_requested += state == State::REQUESTED;
+            if (state == State::CANDIDATE_BEST) {
+                ann.m_best_pos = peerinfo.m_best.size();
+                peerinfo.m_best.push_back(index);
+            }
+        }
+        if (ann.IsSelected()) entry.m_selected = NO_ANNOUNCEMENT;
+        if (old_state == State::CANDIDATE_READY) RemoveReady(entry, index);
+        entry.m_non_completed -= old_state != State::COMPLETED;
+        entry.m_non_completed += state != State::COMPLETED;
+        ann.SetState(state);
+        if (ann.IsSelected()) entry.m_selected = index;
+        if (state == State::CANDIDATE_READY) AddReady(entry, index);
+        if (ann.IsWaiting()) m_timer.Insert(ann.m_time, index, ann.m_generation);
     }
 
     //! Convert a CANDIDATE_DELAYED announcement into a CANDIDATE_READY. If this makes it the new best
     //! CANDIDATE_READY (and no REQUESTED exists) and better than the CANDIDATE_BEST (if any), it becomes the new
     //! CANDIDATE_BEST.
-    void PromoteCandidateReady(Iter<ByTxHash> it)
-    {
-        assert(it != m_index.get<ByTxHash>().end());
-        assert(it->GetState() == State::CANDIDATE_DELAYED);
-        // Convert CANDIDATE_DELAYED to CANDIDATE_READY first.
-        Modify<ByTxHash>(it, [](Announcement& ann){ ann.SetState(State::CANDIDATE_READY); });
-        // The following code relies on the fact that the ByTxHash is sorted by txhash, and then by state (first
-        // _DELAYED, then _READY, then _BEST/REQUESTED). Within the _READY announcements, the best one (highest
-        // priority) comes last. Thus, if an existing _BEST exists for the same txhash that this announcement may
-        // be preferred over, it must immediately follow the newly created _READY.
-        auto it_next = std::next(it);
-        if (it_next == m_index.get<ByTxHash>().end() || it_next->m_txhash != it->m_txhash ||
-            it_next->GetState() == State::COMPLETED) {
+    void PromoteCandidateReady(AnnouncementIndex index, TxHashEntry& entry)
+    {
+        assert(m_announcements[index].GetState() == State::CANDIDATE_DELAYED);
+        if (entry.m_selected == NO_ANNOUNCEMENT) {
             // This is the new best CANDIDATE_READY, and there is no IsSelected() announcement for this txhash
             // already.
-            Modify<ByTxHash>(it, [](Announcement& ann){ ann.SetState(State::CANDIDATE_BEST); });
-        } else if (it_next->GetState() == State::CANDIDATE_BEST) {
-            Priority priority_old = m_computer(*it_next);
-            Priority priority_new = m_computer(*it);
-            if (priority_new > priority_old) {
-                // There is a CANDIDATE_BEST announcement already, but this one is better.
-                Modify<ByTxHash>(it_next, [](Announcement& ann){ ann.SetState(State::CANDIDATE_READY); });
-                Modify<ByTxHash>(it, [](Announcement& ann){ ann.SetState(State::CANDIDATE_BEST); });
-            }
+            SetState(index, entry, State::CANDIDATE_BEST);
+            return;
+        }
+        const AnnouncementIndex selected{entry.m_selected};
+        if (m_announcements[selected].GetState() == State::CANDIDATE_BEST &&
+            m_announcements[index].m_priority > m_announcements[selected].m_priority) {
+            // There is a CANDIDATE_BEST announcement already, but this one is better.
+            SetState(selected, entry, State::CANDIDATE_READY);
+            SetState(index, entry, State::CANDIDATE_BEST);
+        } else {
+            SetState(index, entry, State::CANDIDATE_READY);
         }
     }
 
-    //! Change the state of an announcement to something non-IsSelected(). If it was IsSelected(), the next best
-    //! announcement will be marked CANDIDATE_BEST.
-    void ChangeAndReselect(Iter<ByTxHash> it, State new_state)
+    //! Timer events are not removed when their announcement changes state or is deleted, so rebuild the timer
+    //! from the announcements once there are many more events than announcements. As at least Size() +
+    //! STALE_TIMER_EVENTS_SLACK events are inserted between two rebuilds, this costs amortized constant time.
+    void CompactTimerIfNeeded()
     {
-        assert(new_state == State::COMPLETED || new_state == State::CANDIDATE_DELAYED);
-        assert(it != m_index.get<ByTxHash>().end());
-        if (it->IsSelected() && it != m_index.get<ByTxHash>().begin()) {
-            auto it_prev = std::prev(it);
-            // The next best CANDIDATE_READY, if any, immediately precedes the REQUESTED or CANDIDATE_BEST
-            // announcement in the ByTxHash index.
-            if (it_prev->m_txhash == it->m_txhash && it_prev->GetState() == State::CANDIDATE_READY) {
-                // If one such CANDIDATE_READY exists (for this txhash), convert it to CANDIDATE_BEST.
-                Modify<ByTxHash>(it_prev, [](Announcement& ann){ ann.SetState(State::CANDIDATE_BEST); });
+        if (m_timer.Size() <= 2 * Size() + STALE_TIMER_EVENTS_SLACK) return;
+        m_timer.Clear();
+        for (const auto& [txhash, entry] : m_txhash_entries) {
+            for (AnnouncementIndex index : entry.m_announcements) {
+                const Announcement& ann = m_announcements[index];
+                if (ann.IsWaiting()) m_timer.Insert(ann.m_time, index, ann.m_generation);
             }
         }
-        Modify<ByTxHash>(it, [new_state](Announcement& ann){ ann.SetState(new_state); });
     }
 
-    //! Check if 'it' is the only announcement for a given txhash that isn't COMPLETED.
-    bool IsOnlyNonCompleted(Iter<ByTxHash> it)
+    //! Change the state of an announcement to something non-IsSelected(). If it was IsSelected(), the next best
+    //! announcement will be marked CANDIDATE_BEST.
+    void ChangeAndReselect(AnnouncementIndex index, TxHashEntry& entry, State new_state)
     {
-        assert(it != m_index.get<ByTxHash>().end());
-        assert(it->GetState() != State::COMPLETED); // Not allowed to call this on COMPLETED announcements.
-
-        // This announcement has a predecessor that belongs to the same txhash. Due to ordering, and the
-        // fact that 'it' is not COMPLETED, its predecessor cannot be COMPLETED here.
-        if (it != m_index.get<ByTxHash>().begin() && std::prev(it)->m_txhash == it->m_txhash) return false;
-
-        // This announcement has a successor that belongs to the same txhash, and is not COMPLETED.
-        if (std::next(it) != m_index.get<ByTxHash>().end() && std::next(it)->m_txhash == it->m_txhash &&
-            std::next(it)->GetState() != State::COMPLETED) return false;
-
-        return true;
+        assert(new_state == State::COMPLETED || new_state == State::CANDIDATE_DELAYED);
+        const bool was_selected{m_announcements[index].IsSelected()};
+        SetState(index, entry, new_state);
+        if (!was_selected) return;
+        // Convert the next best CANDIDATE_READY, if any, to CANDIDATE_BEST.
+        if (!entry.m_ready.empty()) SetState(entry.m_ready.front(), entry, State::CANDIDATE_BEST);
     }
 
     /** Convert any announcement to a COMPLETED one. If there are no non-COMPLETED announcements left for this
      *  txhash, they are deleted. If this was a REQUESTED announcement, and there are other CANDIDATEs left, the
      *  best one is made CANDIDATE_BEST. Returns whether the announcement still exists. */
-    bool MakeCompleted(Iter<ByTxHash> it)
+    bool MakeCompleted(AnnouncementIndex index)
     {
-        assert(it != m_index.get<ByTxHash>().end());
-
         // Nothing to be done if it's already COMPLETED.
-        if (it->GetState() == State::COMPLETED) return true;
+        if (m_announcements[index].GetState() == State::COMPLETED) return true;
 
-        if (IsOnlyNonCompleted(it)) {
+        auto entryit = m_txhash_entries.find(m_announcements[index].m_txhash);
+        if (entryit->second.m_non_completed == 1) {
             // This is the last non-COMPLETED announcement for this txhash. Delete all.
-            uint256 txhash = it->m_txhash;
-            do {
-                it = Erase<ByTxHash>(it);
-            } while (it != m_index.get<ByTxHash>().end() && it->m_txhash == txhash);
+            EraseTxHash(entryit);
             return false;
         }
 
-        // Mark the announcement COMPLETED, and select the next best announcement (the first CANDIDATE_READY) if
-        // needed.
-        ChangeAndReselect(it, State::COMPLETED);
+        // Mark the announcement COMPLETED, and select the next best announcement if needed.
+        ChangeAndReselect(index, entryit->second, State::COMPLETED);
 
         return true;
     }
@@ -494,112 +809,115 @@ private:
     {
         if (expired) expired->clear();
 
-        // Iterate over all CANDIDATE_DELAYED and REQUESTED from old to new, as long as they're in the past,
-        // and convert them to CANDIDATE_READY and COMPLETED respectively.
-        while (!m_index.empty()) {
-            auto it = m_index.get<ByTime>().begin();
-            if (it->GetState() == State::CANDIDATE_DELAYED && it->m_time <= now) {
-                PromoteCandidateReady(m_index.project<ByTxHash>(it));
-            } else if (it->GetState() == State::REQUESTED && it->m_time <= now) {
-                if (expired) expired->emplace_back(it->m_peer, ToGenTxid(*it));
-                MakeCompleted(m_index.project<ByTxHash>(it));
-            } else {
-                break;
+        // Process all timer events that are in the past, and convert the CANDIDATE_DELAYED and REQUESTED
+        // announcements they still apply to into CANDIDATE_READY and COMPLETED respectively. The resulting state
+        // does not depend on the order in which this happens.
+        m_timer.Advance(now, m_due_events);
+        for (const TimerEvent& event : m_due_events) {
+            const Announcement& ann = m_announcements[event.m_index];
+            if (ann.m_generation != event.m_generation || ann.m_time != event.m_time) continue;
+            if (ann.GetState() == State::CANDIDATE_DELAYED) {
+                PromoteCandidateReady(event.m_index, m_txhash_entries.find(ann.m_txhash)->second);
+            } else if (ann.GetState() == State::REQUESTED) {
+                if (expired) expired->emplace_back(ann.m_peer, ToGenTxid(ann));
+                MakeCompleted(event.m_index);
             }
         }
 
-        while (!m_index.empty()) {
+        if (now < m_last_time_point) {
             // If time went backwards, we may need to demote CANDIDATE_BEST and CANDIDATE_READY announcements back
-            // to CANDIDATE_DELAYED. This is an unusual edge case, and unlikely to matter in production. However,
-            // it makes it much easier to specify and test TxRequestTracker::Impl's behaviour.
-            auto it = std::prev(m_index.get<ByTime>().end());
-            if (it->IsSelectable() && it->m_time > now) {
-                ChangeAndReselect(m_index.project<ByTxHash>(it), State::CANDIDATE_DELAYED);
-            } else {
-                break;
+            // to CANDIDATE_DELAYED. This is an unusual edge case, and unlikely to matter in production, so simply
+            // go over all announcements. However, it makes it much easier to specify and test
+            // TxRequestTracker::Impl's behaviour.
+            for (auto& [txhash, entry] : m_txhash_entries) {
+                for (AnnouncementIndex index : entry.m_announcements) {
+                    const Announcement& ann = m_announcements[index];
+                    if (ann.IsSelectable() && ann.m_time > now) {
+                        ChangeAndReselect(index, entry, State::CANDIDATE_DELAYED);
+                    }
+                }
             }
         }
+        m_last_time_point = now;
+        CompactTimerIfNeeded();
     }
 
 public:
     explicit Impl(bool deterministic) :
-        m_computer(deterministic),
-        // Explicitly initialize m_index as we need to pass a reference to m_computer to ByTxHashViewExtractor.
-        m_index(boost::make_tuple(
-            boost::make_tuple(ByPeerViewExtractor(), std::less<ByPeerView>()),
-            boost::make_tuple(ByTxHashViewExtractor(m_computer), std::less<ByTxHashView>()),
-            boost::make_tuple(ByTimeViewExtractor(), std::less<ByTimeView>())
-        )) {}
-
-    // Disable copying and assigning (a default copy won't work due the stateful ByTxHashViewExtractor).
+        m_computer(deterministic) {}
+
+    // Disable copying and assigning.
     Impl(const Impl&) = delete;
     Impl& operator=(const Impl&) = delete;
 
     void DisconnectedPeer(NodeId peer)
     {
-        auto& index = m_index.get<ByPeer>();
-        auto it = index.lower_bound(ByPeerView{peer, false, uint256::ZERO});
-        while (it != index.end() && it->m_peer == peer) {
-            // Check what to continue with after this iteration. 'it' will be deleted in what follows, so we need to
-            // decide what to continue with afterwards. There are a number of cases to consider:
-            // - std::next(it) is end() or belongs to a different peer. In that case, this is the last iteration
-            //   of the loop (denote this by setting it_next to end()).
-            // - 'it' is not the only non-COMPLETED announcement for its txhash. This means it will be deleted, but
-            //   no other Announcement objects will be modified. Continue with std::next(it) if it belongs to the
-            //   same peer, but decide this ahead of time (as 'it' may change position in what follows).
-            // - 'it' is the only non-COMPLETED announcement for its txhash. This means it will be deleted along
-            //   with all other announcements for the same txhash - which may include std::next(it). However, other
-            //   than 'it', no announcements for the same peer can be affected (due to (peer, txhash) uniqueness).
-            //   In other words, the situation where std::next(it) is deleted can only occur if std::next(it)
-            //   belongs to a different peer but the same txhash as 'it'. This is covered by the first bulletpoint
-            //   already, and we'll have set it_next to end().
-            auto it_next = (std::next(it) == index.end() || std::next(it)->m_peer != peer) ? index.end() :
-                std::next(it);
+        auto peerit = m_peerinfo.find(peer);
+        if (peerit == m_peerinfo.end()) return;
+        // Copy the peer's announcements first, as processing them modifies (and eventually deletes) its PeerData.
+        // Making one announcement COMPLETED can delete other announcements for the same txhash, but never other
+        // announcements of the same peer (due to (peer, txhash) uniqueness), so all copied indexes remain valid.
+        std::vector<AnnouncementIndex> indexes;
+        indexes.reserve(peerit->second.m_announcements.size());
+        for (const auto& [txhash, index] : peerit->second.m_announcements) indexes.push_back(index);
+        for (AnnouncementIndex index : indexes) {
             // If the announcement isn't already COMPLETED, first make it COMPLETED (which will mark other
             // CANDIDATEs as CANDIDATE_BEST, or delete all of a txhash's announcements if no non-COMPLETED ones are
             // left).
-            if (MakeCompleted(m_index.project<ByTxHash>(it))) {
+            if (MakeCompleted(index)) {
                 // Then actually delete the announcement (unless it was already deleted by MakeCompleted).
-                Erase<ByPeer>(it);
+                Erase(index);
             }
-            it = it_next;
         }
     }
 
     void ForgetTxHash(const uint256& txhash)
     {
-        auto it = m_index.get<ByTxHash>().lower_bound(ByTxHashView{txhash, State::CANDIDATE_DELAYED, 0});
-        while (it != m_index.get<ByTxHash>().end() && it->m_txhash == txhash) {
-            it = Erase<ByTxHash>(it);
-        }
+        auto entryit = m_txhash_entries.find(txhash);
+        if (entryit != m_txhash_entries.end()) EraseTxHash(entryit);
     }
 
     void GetCandidatePeers(const uint256& txhash, std::vector<NodeId>& result_peers) const
     {
-        auto it = m_index.get<ByTxHash>().lower_bound(ByTxHashView{txhash, State::CANDIDATE_DELAYED, 0});
-        while (it != m_index.get<ByTxHash>().end() && it->m_txhash == txhash && it->GetState() != State::COMPLETED) {
-            result_peers.push_back(it->m_peer);
-            ++it;
+        auto entryit = m_txhash_entries.find(txhash);
+        if (entryit == m_txhash_entries.end()) return;
+        for (AnnouncementIndex index : entryit->second.m_announcements) {
+            const Announcement& ann = m_announcements[index];
+            if (ann.GetState() != State::COMPLETED) result_peers.push_back(ann.m_peer);
         }
     }
 
     void ReceivedInv(NodeId peer, const GenTxid& gtxid, bool preferred,
         std::chrono::microseconds reqtime)
     {
-        // Bail out if we already have a CANDIDATE_BEST announcement for this (txhash, peer) combination. The case
-        // where there is a non-CANDIDATE_BEST announcement already will be caught by the uniqueness property of the
-        // ByPeer index when we try to emplace the new object below.
-        if (m_index.get<ByPeer>().count(ByPeerView{peer, true, gtxid.GetHash()})) return;
-
-        // Try creating the announcement with CANDIDATE_DELAYED state (which will fail due to the uniqueness
-        // of the ByPeer index if a non-CANDIDATE_BEST announcement already exists with the same txhash and peer).
-        // Bail out in that case.
-        auto ret = m_index.get<ByPeer>().emplace(gtxid, peer, preferred, reqtime, m_current_sequence);
-        if (!ret.second) return;
+        // Bail out if we already have an announcement for this (txhash, peer) combination.
+        PeerData& peerinfo = m_peerinfo.try_emplace(peer, m_hasher).first->second;
+        auto [annit, inserted] = peerinfo.m_announcements.try_emplace(gtxid.GetHash(), NO_ANNOUNCEMENT);
+        if (!inserted) return;
+
+        // Create the announcement with CANDIDATE_DELAYED state, reusing a free slot if there is one.
+        Announcement ann{gtxid, peer, preferred, reqtime, m_current_sequence, m_computer(gtxid.GetHash(), peer, preferred)};
+        AnnouncementIndex index;
+        if (m_free.empty()) {
+            index = m_announcements.size();
+            m_announcements.push_back(ann);
+        } else {
+            index = m_free.back();
+            m_free.pop_back();
+            ann.m_generation = m_announcements[index].m_generation;
+            m_announcements[index] = ann;
+        }
+        annit->second = index;
 
         // Update accounting metadata.
-        ++m_peerinfo[peer].m_total;
+        ++peerinfo.m_total;
+        TxHashEntry& entry = m_txhash_entries[gtxid.GetHash()];
+        m_announcements[index].m_txhash_pos = entry.m_announcements.size();
+        entry.m_announcements.push_back(index);
+        ++entry.m_non_completed;
+        m_timer.Insert(reqtime, index, ann.m_generation);
         ++m_current_sequence;
+        CompactTimerIfNeeded();
     }
 
     //! Find the GenTxids to request now from peer.
@@ -611,11 +929,10 @@ public:
 
         // Find all CANDIDATE_BEST announcements for this peer.
         std::vector<const Announcement*> selected;
-        auto it_peer = m_index.get<ByPeer>().lower_bound(ByPeerView{peer, true, uint256::ZERO});
-        while (it_peer != m_index.get<ByPeer>().end() && it_peer->m_peer == peer &&
-            it_peer->GetState() == State::CANDIDATE_BEST) {
-            selected.emplace_back(&*it_peer);
-            ++it_peer;
+        auto peerit = m_peerinfo.find(peer);
+        if (peerit != m_peerinfo.end()) {
+            selected.reserve(peerit->second.m_best.size());
+            for (AnnouncementIndex index : peerit->second.m_best) selected.push_back(&m_announcements[index]);
         }
 
         // Sort by sequence number.
@@ -634,16 +951,21 @@ public:
 
     void RequestedTx(NodeId peer, const uint256& txhash, std::chrono::microseconds expiry)
     {
-        auto it = m_index.get<ByPeer>().find(ByPeerView{peer, true, txhash});
-        if (it == m_index.get<ByPeer>().end()) {
+        auto peerit = m_peerinfo.find(peer);
+        if (peerit == m_peerinfo.end()) return;
+        auto annit = peerit->second.m_announcements.find(txhash);
+        if (annit == peerit->second.m_announcements.end()) return;
+        const AnnouncementIndex index{annit->second};
+        TxHashEntry& entry = m_txhash_entries.find(txhash)->second;
+
+        const State state{m_announcements[index].GetState()};
+        if (state != State::CANDIDATE_BEST) {
             // There is no CANDIDATE_BEST announcement, look for a _READY or _DELAYED instead. If the caller only
             // ever invokes RequestedTx with the values returned by GetRequestable, and no other non-const functions
             // other than ForgetTxHash and GetRequestable in between, this branch will never execute (as txhashes
             // returned by GetRequestable always correspond to CANDIDATE_BEST announcements).
 
-            it = m_index.get<ByPeer>().find(ByPeerView{peer, false, txhash});
-            if (it == m_index.get<ByPeer>().end() || (it->GetState() != State::CANDIDATE_DELAYED &&
-                                                      it->GetState() != State::CANDIDATE_READY)) {
+            if (state != State::CANDIDATE_DELAYED && state != State::CANDIDATE_READY) {
                 // There is no CANDIDATE announcement tracked for this peer, so we have nothing to do. Either this
                 // txhash wasn't tracked at all (and the caller should have called ReceivedInv), or it was already
                 // requested and/or completed for other reasons and this is just a superfluous RequestedTx call.
@@ -653,38 +975,34 @@ public:
             // Look for an existing CANDIDATE_BEST or REQUESTED with the same txhash. We only need to do this if the
             // found announcement had a different state than CANDIDATE_BEST. If it did, invariants guarantee that no
             // other CANDIDATE_BEST or REQUESTED can exist.
-            auto it_old = m_index.get<ByTxHash>().lower_bound(ByTxHashView{txhash, State::CANDIDATE_BEST, 0});
-            if (it_old != m_index.get<ByTxHash>().end() && it_old->m_txhash == txhash) {
-                if (it_old->GetState() == State::CANDIDATE_BEST) {
+            if (entry.m_selected != NO_ANNOUNCEMENT) {
+                if (m_announcements[entry.m_selected].GetState() == State::CANDIDATE_BEST) {
                     // The data structure's invariants require that there can be at most one CANDIDATE_BEST or one
                     // REQUESTED announcement per txhash (but not both simultaneously), so we have to convert any
                     // existing CANDIDATE_BEST to another CANDIDATE_* when constructing another REQUESTED.
                     // It doesn't matter whether we pick CANDIDATE_READY or _DELAYED here, as SetTimePoint()
                     // will correct it at GetRequestable() time. If time only goes forward, it will always be
                     // _READY, so pick that to avoid extra work in SetTimePoint().
-                    Modify<ByTxHash>(it_old, [](Announcement& ann) { ann.SetState(State::CANDIDATE_READY); });
-                } else if (it_old->GetState() == State::REQUESTED) {
+                    SetState(entry.m_selected, entry, State::CANDIDATE_READY);
+                } else {
                     // As we're no longer waiting for a response to the previous REQUESTED announcement, convert it
                     // to COMPLETED. This also helps guaranteeing progress.
-                    Modify<ByTxHash>(it_old, [](Announcement& ann) { ann.SetState(State::COMPLETED); });
+                    SetState(entry.m_selected, entry, State::COMPLETED);
                 }
             }
         }
 
-        Modify<ByPeer>(it, [expiry](Announcement& ann) {
-            ann.SetState(State::REQUESTED);
-            ann.m_time = expiry;
-        });
+        m_announcements[index].m_time = expiry;
+        SetState(index, entry, State::REQUESTED);
+        CompactTimerIfNeeded();
     }
 
     void ReceivedResponse(NodeId peer, const uint256& txhash)
     {
-        // We need to search the ByPeer index for both (peer, false, txhash) and (peer, true, txhash).
-        auto it = m_index.get<ByPeer>().find(ByPeerView{peer, false, txhash});
-        if (it == m_index.get<ByPeer>().end()) {
-            it = m_index.get<ByPeer>().find(ByPeerView{peer, true, txhash});
-        }
-        if (it != m_index.get<ByPeer>().end()) MakeCompleted(m_index.project<ByTxHash>(it));
+        auto peerit = m_peerinfo.find(peer);
+        if (peerit == m_peerinfo.end()) return;
+        auto annit = peerit->second.m_announcements.find(txhash);
+        if (annit != peerit->second.m_announcements.end()) MakeCompleted(annit->second);
     }
 
     size_t CountInFlight(NodeId peer) const
@@ -709,7 +1027,7 @@ public:
     }
 
     //! Count how many announcements are being tracked in total across all peers and transactions.
-    size_t Size() const { return m_index.size(); }
+    size_t Size() const { return m_announcements.size() - m_free.size(); }
 
     uint64_t ComputePriority(const uint256& txhash, NodeId peer, bool preferred) const
     {
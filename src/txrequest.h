@@ -89,9 +89,15 @@
  *
  * Complexity:
  * - Memory usage is proportional to the total number of tracked announcements (Size()) plus the number of
- *   peers with a nonzero number of tracked announcements.
- * - CPU usage is generally logarithmic in the total number of tracked announcements, plus the number of
- *   announcements affected by an operation (amortized O(1) per announcement).
+ *   peers with a nonzero number of tracked announcements. Size() is at most the number of peers times
+ *   MAX_PEER_TX_ANNOUNCEMENTS, which net_processing enforces per peer. Timer events that became stale when their
+ *   announcement changed state or was deleted are kept until the timer is rebuilt, which happens once they make
+ *   up more than 2*Size() plus a constant.
+ * - CPU usage is generally (amortized) constant, plus the number of announcements affected by an operation.
+ *   Removing an announcement takes constant time. Changing whether an announcement is CANDIDATE_READY, including
+ *   selecting a new candidate for a txhash, takes time logarithmic in the number of announcements for that txhash,
+ *   which is at most one per peer. GetRequestable additionally sorts the returned announcements. Time going
+ *   backwards requires a pass over all announcements and timer events.
  *
  * Context:
  * - In an earlier version of the transaction request logic it was possible for a peer to prevent us from seeing a
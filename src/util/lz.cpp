@@ -0,0 +1,126 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/lz.h>
+
+#include <crypto/common.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace util {
+namespace {
+/** Number of bits of the hash table indexing recently seen 4-byte sequences. */
+constexpr int HASH_BITS{16};
+/** Largest distance a match can refer back to. */
+constexpr size_t MAX_OFFSET{0xFFFF};
+/** Value of a nibble indicating that extension bytes follow. */
+constexpr unsigned NIBBLE_MAX{15};
+
+inline uint32_t HashSequence(uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - HASH_BITS);
+}
+
+void WriteLength(std::vector<uint8_t>& out, size_t len)
+{
+    while (len >= 255) {
+        out.push_back(255);
+        len -= 255;
+    }
+    out.push_back(len);
+}
+
+void WriteSequence(std::vector<uint8_t>& out, std::span<const uint8_t> literals, size_t offset, size_t match_len)
+{
+    const size_t match_code{match_len ? match_len - LZ_MIN_MATCH : 0};
+    out.push_back((std::min<size_t>(literals.size(), NIBBLE_MAX) << 4) | std::min<size_t>(match_code, NIBBLE_MAX));
+    if (literals.size() >= NIBBLE_MAX) WriteLength(out, literals.size() - NIBBLE_MAX);
+    out.insert(out.end(), literals.begin(), literals.end());
+    if (match_len == 0) return; // last sequence
+    out.push_back(offset & 0xFF);
+    out.push_back(offset >> 8);
+    if (match_code >= NIBBLE_MAX) WriteLength(out, match_code - NIBBLE_MAX);
+}
+
+/** Read an extended length, returning false if the input ends or the length exceeds limit. */
+bool ReadLength(std::span<const uint8_t> in, size_t& pos, size_t& len, size_t limit)
+{
+    uint8_t b;
+    do {
+        if (pos >= in.size()) return false;
+        b = in[pos++];
+        len += b;
+        if (len > limit) return false;
+    } while (b == 255);
+    return true;
+}
+} // namespace
+
+std::vector<uint8_t> LZCompress(std::span<const uint8_t> data)
+{
+    std::vector<uint8_t> out;
+    out.reserve(data.size() + data.size() / 255 + 16);
+    // Positions (plus one, so zero means empty) of the last occurrence of each hashed 4-byte sequence.
+    std::vector<uint32_t> table(size_t{1} << HASH_BITS, 0);
+
+    size_t anchor{0};
+    size_t pos{0};
+    while (pos + LZ_MIN_MATCH <= data.size()) {
+        const uint32_t seq{ReadLE32(data.data() + pos)};
+        uint32_t& entry{table[HashSequence(seq)]};
+        const size_t candidate{entry};
+        entry = pos + 1;
+        if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET || ReadLE32(data.data() + candidate - 1) != seq) {
+            ++pos;
+            continue;
+        }
+        const size_t ref{candidate - 1};
+        size_t match_len{LZ_MIN_MATCH};
+        while (pos + match_len < data.size() && data[ref + match_len] == data[pos + match_len]) ++match_len;
+        WriteSequence(out, data.subspan(anchor, pos - anchor), pos - ref, match_len);
+        pos += match_len;
+        anchor = pos;
+    }
+    WriteSequence(out, data.subspan(anchor), 0, 0);
+    return out;
+}
+
+bool LZDecompress(std::span<const uint8_t> compressed, size_t raw_size, std::vector<uint8_t>& data)
+{
+    data.resize(raw_size);
+    size_t in_pos{0};
+    size_t out_pos{0};
+    while (true) {
+        if (in_pos >= compressed.size()) return false;
+        const uint8_t token{compressed[in_pos++]};
+
+        size_t literals{size_t{token} >> 4};
+        if (literals == NIBBLE_MAX && !ReadLength(compressed, in_pos, literals, raw_size)) return false;
+        if (literals > compressed.size() - in_pos || literals > raw_size - out_pos) return false;
+        std::copy_n(compressed.begin() + in_pos, literals, data.begin() + out_pos);
+        in_pos += literals;
+        out_pos += literals;
+
+        // The last sequence consists of literals only.
+        if (in_pos == compressed.size()) break;
+
+        if (compressed.size() - in_pos < 2) return false;
+        const size_t offset{compressed[in_pos] | (size_t{compressed[in_pos + 1]} << 8)};
+        in_pos += 2;
+        if (offset == 0 || offset > out_pos) return false;
+
+        size_t match_len{size_t{token} & NIBBLE_MAX};
+        if (match_len == NIBBLE_MAX && !ReadLength(compressed, in_pos, match_len, raw_size)) return false;
+        match_len += LZ_MIN_MATCH;
+        if (match_len > raw_size - out_pos) return false;
+        // Matches may overlap with the bytes they produce, so copy byte by byte.
+        for (size_t i{0}; i < match_len; ++i) {
+            data[out_pos + i] = data[out_pos - offset + i];
+        }
+        out_pos += match_len;
+    }
+    return out_pos == raw_size;
+}
+} // namespace util
@@ -0,0 +1,40 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_LZ_H
+#define BITCOIN_UTIL_LZ_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace util {
+/**
+ * Lightweight LZ77 compression, using a byte-oriented format modelled after
+ * the LZ4 block format. It trades compression ratio for speed, and
+ * decompression is a simple copy loop.
+ *
+ * The compressed data is a sequence of tokens, each consisting of:
+ * - a byte with the number of literals in the high nibble, and the match length
+ *   minus LZ_MIN_MATCH in the low nibble (15 meaning "extended by the following
+ *   bytes, each added until one is not 255")
+ * - the literal bytes
+ * - except for the last token: a 2-byte little-endian offset back into the
+ *   output, followed by the extension bytes of the match length, if any
+ *
+ * The uncompressed size is not part of the format and has to be stored by the caller.
+ */
+static constexpr size_t LZ_MIN_MATCH{4};
+
+/** Compress data. The result may be larger than the input for incompressible data. */
+std::vector<uint8_t> LZCompress(std::span<const uint8_t> data);
+
+/**
+ * Decompress data that was compressed by LZCompress() into exactly raw_size bytes.
+ * Returns false if the data is malformed or does not decompress to raw_size bytes.
+ */
+bool LZDecompress(std::span<const uint8_t> compressed, size_t raw_size, std::vector<uint8_t>& data);
+} // namespace util
+
+#endif // BITCOIN_UTIL_LZ_H
@@ -11,6 +11,7 @@
 #include <util/threadinterrupt.h>
 #include <util/time.h>
 
+#include <array>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -47,6 +48,44 @@ ssize_t Sock::Send(const void* data, size_t len, int flags) const
     return send(m_socket, static_cast<const char*>(data), len, flags);
 }
 
+ssize_t Sock::SendMsg(std::span<const std::span<const uint8_t>> buffers, int flags) const
+{
+#ifdef WIN32
+    return SendEach(buffers, flags);
+#else
+    std::array<iovec, SENDMSG_MAX_BUFFERS> iov;
+    size_t num_iov{0};
+    for (const auto& buffer : buffers) {
+        if (num_iov == iov.size()) break;
+        if (buffer.empty()) continue;
+        iov[num_iov].iov_base = const_cast<uint8_t*>(buffer.data());
+        iov[num_iov].iov_len = buffer.size();
+        ++num_iov;
+    }
+    msghdr msg{};
+    msg.msg_iov = iov.data();
+    msg.msg_iovlen = num_iov;
+    return sendmsg(m_socket, &msg, flags);
+#endif
+}
+
+ssize_t Sock::SendEach(std::span<const std::span<const uint8_t>> buffers, int flags) const
+{
+    ssize_t total{0};
+    size_t num_sent{0};
+    for (const auto& buffer : buffers) {
+        if (num_sent == SENDMSG_MAX_BUFFERS) break;
+        if (buffer.empty()) continue;
+        ++num_sent;
+        const ssize_t sent{Send(buffer.data(), buffer.size(), flags)};
+        // Report an error only if nothing was sent, like a single system call would.
+        if (sent < 0) return total > 0 ? total : sent;
+        total += sent;
+        if (size_t(sent) < buffer.size()) break;
+    }
+    return total;
+}
+
 ssize_t Sock::Recv(void* buf, size_t len, int flags) const
 {
     return recv(m_socket, static_cast<char*>(buf), len, flags);
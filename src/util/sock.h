@@ -11,6 +11,7 @@
 
 #include <chrono>
 #include <memory>
+#include <span>
 #include <string>
 #include <unordered_map>
 
@@ -64,6 +65,19 @@ public:
      */
     [[nodiscard]] virtual ssize_t Send(const void* data, size_t len, int flags) const;
 
+    /**
+     * Maximum number of buffers SendMsg() sends in one call.
+     */
+    static constexpr size_t SENDMSG_MAX_BUFFERS{64};
+
+    /**
+     * sendmsg(2) wrapper, sending the concatenation of up to SENDMSG_MAX_BUFFERS buffers with a single
+     * system call. Where sendmsg(2) is not available, the buffers are passed to Send() one by one
+     * until one is not sent completely. Returns the number of bytes sent like Send(). Code that uses
+     * this wrapper can be unit tested if this method is overridden by a mock Sock implementation.
+     */
+    [[nodiscard]] virtual ssize_t SendMsg(std::span<const std::span<const uint8_t>> buffers, int flags) const;
+
     /**
      * recv(2) wrapper. Equivalent to `recv(m_socket, buf, len, flags);`. Code that uses this
      * wrapper can be unit tested if this method is overridden by a mock Sock implementation.
@@ -274,6 +288,15 @@ protected:
      */
     SOCKET m_socket;
 
+    /** Registers `m_socket` with the kernel. */
+    friend class SockEpoll;
+
+    /**
+     * Implement SendMsg() by passing the buffers to Send() one by one, stopping at the first one
+     * that is not sent completely.
+     */
+    [[nodiscard]] ssize_t SendEach(std::span<const std::span<const uint8_t>> buffers, int flags) const;
+
 private:
     /**
      * Close `m_socket` if it is not `INVALID_SOCKET`.
@@ -0,0 +1,98 @@
+// Copyright (c) The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/sockepoll.h>
+
+#include <compat/compat.h>
+#include <logging.h>
+#include <util/syserror.h>
+#include <util/time.h>
+
+#include <array>
+#include <cerrno>
+
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+std::unique_ptr<SockEpoll> SockEpoll::Create()
+{
+#ifdef USE_EPOLL
+    const int fd{epoll_create1(EPOLL_CLOEXEC)};
+    if (fd == -1) {
+        LogPrintf("epoll_create1 failed: %s\n", SysErrorString(errno));
+        return nullptr;
+    }
+    return std::unique_ptr<SockEpoll>{new SockEpoll{fd}};
+#else
+    return nullptr;
+#endif
+}
+
+SockEpoll::~SockEpoll()
+{
+#ifdef USE_EPOLL
+    close(m_fd);
+#endif
+}
+
+bool SockEpoll::Add(const Sock& sock, Token token, Sock::Event requested, bool edge_triggered) const
+{
+#ifdef USE_EPOLL
+    epoll_event ev{};
+    if (requested & Sock::RECV) {
+        // EPOLLRDHUP: also report a peer shutdown, so that it is noticed by reading from the socket.
+        ev.events |= EPOLLIN | EPOLLRDHUP;
+    }
+    if (requested & Sock::SEND) {
+        ev.events |= EPOLLOUT;
+    }
+    if (edge_triggered) {
+        ev.events |= EPOLLET;
+    }
+    ev.data.u64 = token;
+    return epoll_ctl(m_fd, EPOLL_CTL_ADD, sock.m_socket, &ev) == 0;
+#else
+    return false;
+#endif
+}
+
+bool SockEpoll::Remove(const Sock& sock) const
+{
+#ifdef USE_EPOLL
+    return epoll_ctl(m_fd, EPOLL_CTL_DEL, sock.m_socket, nullptr) == 0;
+#else
+    return false;
+#endif
+}
+
+bool SockEpoll::Wait(std::chrono::milliseconds timeout, std::vector<Ready>& ready) const
+{
+    ready.clear();
+#ifdef USE_EPOLL
+    std::array<epoll_event, MAX_READY> events;
+    const int n{epoll_wait(m_fd, events.data(), events.size(), count_milliseconds(timeout))};
+    if (n == -1) {
+        return errno == EINTR;
+    }
+    ready.reserve(n);
+    for (int i{0}; i < n; ++i) {
+        Sock::Event occurred{0};
+        if (events[i].events & (EPOLLIN | EPOLLRDHUP)) {
+            occurred |= Sock::RECV;
+        }
+        if (events[i].events & EPOLLOUT) {
+            occurred |= Sock::SEND;
+        }
+        if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+            occurred |= Sock::ERR;
+        }
+        ready.push_back({events[i].data.u64, occurred});
+    }
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,81 @@
+// Copyright (c) The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_SOCKEPOLL_H
+#define BITCOIN_UTIL_SOCKEPOLL_H
+
+#include <util/sock.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * A persistent set of sockets to wait on, using epoll(7) (Linux only).
+ *
+ * `Sock::WaitMany()` hands all sockets to the kernel on every call, so its cost grows with the
+ * number of sockets, even if almost all of them are idle. Here sockets are registered once, and
+ * `Wait()` only returns the ones that have become ready. With edge-triggered registration, a
+ * socket is reported again only after new data arrived or send buffer space became available,
+ * so the caller must remember which sockets were left readable or writable.
+ */
+class SockEpoll
+{
+public:
+    /** Caller-chosen value identifying a registered socket in the results of `Wait()`. */
+    using Token = uint64_t;
+
+    struct Ready {
+        Token token;
+        Sock::Event occurred;
+    };
+
+    /**
+     * Create an empty set.
+     * @return nullptr if epoll is not available on this platform or cannot be initialized.
+     */
+    static std::unique_ptr<SockEpoll> Create();
+
+    ~SockEpoll();
+
+    SockEpoll(const SockEpoll&) = delete;
+    SockEpoll& operator=(const SockEpoll&) = delete;
+
+    /**
+     * Start watching a socket. It is removed automatically once it is closed.
+     * @param[in] sock The socket, must not already be in the set.
+     * @param[in] token Reported by `Wait()` for this socket.
+     * @param[in] requested Events to watch for, bitwise-or of `Sock::RECV` and `Sock::SEND`
+     * (`Sock::ERR` is always reported).
+     * @param[in] edge_triggered Report the socket only when it becomes ready, rather than for as
+     * long as it is.
+     * @return true on success
+     */
+    [[nodiscard]] bool Add(const Sock& sock, Token token, Sock::Event requested, bool edge_triggered) const;
+
+    /**
+     * Stop watching a socket.
+     * @return true on success
+     */
+    bool Remove(const Sock& sock) const;
+
+    /**
+     * Wait for at least one of the sockets in the set to become ready.
+     * @param[in] timeout Wait at most this long.
+     * @param[out] ready Replaced by the sockets that are ready and their events. Empty on timeout.
+     * At most `MAX_READY` are returned; any others are reported by the next call.
+     * @return true on success (or timeout), false otherwise
+     */
+    [[nodiscard]] bool Wait(std::chrono::milliseconds timeout, std::vector<Ready>& ready) const;
+
+    static constexpr int MAX_READY{256};
+
+private:
+    explicit SockEpoll(int fd) : m_fd{fd} {}
+
+    const int m_fd;
+};
+
+#endif // BITCOIN_UTIL_SOCKEPOLL_H
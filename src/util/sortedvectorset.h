@@ -0,0 +1,81 @@
+// Copyright (c) The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_SORTEDVECTORSET_H
+#define BITCOIN_UTIL_SORTEDVECTORSET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/** Data structure mimicking the parts of std::set that are needed for small sets, but storing its
+ *  elements in a sorted std::vector.
+ *
+ * - Needs sizeof(T) bytes per element plus a single allocation, instead of a separately
+ *   allocated tree node (three pointers and a color, plus malloc overhead) per element.
+ * - Lookups are O(log n), but insert() and erase() are O(n), so this is only suitable for sets
+ *   that stay small.
+ * - Iteration is in sorted order, like std::set. Only const iterators are provided, and they are
+ *   invalidated by insert() and erase().
+ * - Memory is only released when the last element is erased; see capacity().
+ */
+template<typename T, typename Compare = std::less<T>>
+class SortedVectorSet
+{
+    std::vector<T> m_data;
+    [[no_unique_address]] Compare m_comp;
+
+    auto LowerBound(const T& value) const { return std::lower_bound(m_data.begin(), m_data.end(), value, m_comp); }
+    bool Matches(typename std::vector<T>::const_iterator it, const T& value) const
+    {
+        return it != m_data.end() && !m_comp(value, *it);
+    }
+
+public:
+    using value_type = T;
+    using const_iterator = typename std::vector<T>::const_iterator;
+    using iterator = const_iterator;
+
+    const_iterator begin() const noexcept { return m_data.begin(); }
+    const_iterator end() const noexcept { return m_data.end(); }
+    const_iterator cbegin() const noexcept { return m_data.cbegin(); }
+    const_iterator cend() const noexcept { return m_data.cend(); }
+
+    size_t size() const noexcept { return m_data.size(); }
+    bool empty() const noexcept { return m_data.empty(); }
+    /** Number of elements memory is allocated for. */
+    size_t capacity() const noexcept { return m_data.capacity(); }
+    void clear() noexcept { m_data.clear(); }
+
+    /** Add value if not present. Returns an iterator to the element equal to value, and whether
+     *  it was inserted. */
+    std::pair<const_iterator, bool> insert(const T& value)
+    {
+        auto it = LowerBound(value);
+        if (Matches(it, value)) return {it, false};
+        return {m_data.insert(it, value), true};
+    }
+
+    /** Remove value if present. Returns the number of elements removed (0 or 1). */
+    size_t erase(const T& value)
+    {
+        auto it = LowerBound(value);
+        if (!Matches(it, value)) return 0;
+        m_data.erase(it);
+        if (m_data.empty()) std::vector<T>{}.swap(m_data);
+        return 1;
+    }
+
+    const_iterator find(const T& value) const
+    {
+        auto it = LowerBound(value);
+        return Matches(it, value) ? it : m_data.end();
+    }
+
+    size_t count(const T& value) const { return Matches(LowerBound(value), value); }
+};
+
+#endif // BITCOIN_UTIL_SORTEDVECTORSET_H
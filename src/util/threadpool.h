@@ -0,0 +1,116 @@
+// Copyright (c) 2025-present The ZiaCoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_THREADPOOL_H
+#define BITCOIN_UTIL_THREADPOOL_H
+
+#include <sync.h>
+#include <tinyformat.h>
+#include <util/threadnames.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Fixed-size pool of worker threads executing submitted tasks in FIFO order.
+ *
+ * Submit() returns a std::future for the result of the task. Tasks that have
+ * not started when the pool is destroyed are discarded; waiting on their
+ * future throws std::future_error (broken_promise).
+ */
+class ThreadPool
+{
+private:
+    //! Mutex to protect the inner state
+    Mutex m_mutex;
+
+    //! Worker threads block on this when out of work
+    std::condition_variable m_worker_cv;
+
+    //! Tasks not yet picked up by a worker
+    std::deque<std::function<void()>> m_work_queue GUARDED_BY(m_mutex);
+
+    bool m_request_stop GUARDED_BY(m_mutex){false};
+
+    std::vector<std::thread> m_worker_threads;
+
+    void Loop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            std::function<void()> task;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_worker_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_request_stop || !m_work_queue.empty(); });
+                if (m_request_stop) return;
+                task = std::move(m_work_queue.front());
+                m_work_queue.pop_front();
+            }
+            task();
+        }
+    }
+
+public:
+    //! Create a pool of worker_threads_num threads, named <name>.<n>
+    ThreadPool(const std::string& name, int worker_threads_num)
+    {
+        m_worker_threads.reserve(worker_threads_num);
+        for (int n = 0; n < worker_threads_num; ++n) {
+            m_worker_threads.emplace_back([this, name, n]() {
+                util::ThreadRename(strprintf("%s.%i", name, n));
+                Loop();
+            });
+        }
+    }
+
+    // Since this class manages its own resources, which is a thread
+    // pool `m_worker_threads`, copy and move operations are not appropriate.
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    ~ThreadPool()
+    {
+        WITH_LOCK(m_mutex, m_request_stop = true);
+        m_worker_cv.notify_all();
+        for (std::thread& t : m_worker_threads) {
+            t.join();
+        }
+    }
+
+    //! Queue fn for execution on one of the workers. Exceptions thrown by fn
+    //! are rethrown by std::future::get().
+    template <typename F>
+    std::future<std::invoke_result_t<F>> Submit(F&& fn) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        // std::function requires a copyable callable, so the move-only task is shared.
+        auto task{std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(fn))};
+        auto future{task->get_future()};
+        {
+            LOCK(m_mutex);
+            m_work_queue.emplace_back([task] { (*task)(); });
+        }
+        m_worker_cv.notify_one();
+        return future;
+    }
+
+    //! Number of tasks waiting for a worker
+    size_t WorkQueueSize() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        return WITH_LOCK(m_mutex, return m_work_queue.size());
+    }
+
+    size_t WorkerCount() const { return m_worker_threads.size(); }
+};
+
+#endif // BITCOIN_UTIL_THREADPOOL_H
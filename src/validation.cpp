@@ -68,12 +68,14 @@
 #include <cassert>
 #include <chrono>
 #include <deque>
+#include <functional>
 #include <numeric>
 #include <optional>
 #include <ranges>
 #include <span>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 
 using kernel::CCoinsStats;
@@ -112,6 +114,10 @@ const std::vector<std::string> CHECKLEVEL_DOC {
  *  noticeably interfere with the pruning mechanism.
  * */
 static constexpr int PRUNE_LOCK_BUFFER{10};
+/** Transactions with at least this many inputs have their scripts verified on
+ *  the script check threads during mempool acceptance. Below that, handing the
+ *  checks over costs more than it saves. */
+static constexpr size_t MEMPOOL_PARALLEL_SCRIPT_CHECK_MIN_INPUTS{16};
 
 TRACEPOINT_SEMAPHORE(validation, block_connected);
 TRACEPOINT_SEMAPHORE(utxocache, flush);
@@ -145,6 +151,10 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
                        std::vector<CScriptCheck>* pvChecks = nullptr)
                        EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+static bool InvalidInputScript(const CTransaction& tx, TxValidationState& state, unsigned int flags,
+                               ScriptFailure failure, bool cacheSigStore, PrecomputedTransactionData& txdata,
+                               SignatureCache& signature_cache);
+
 bool CheckFinalTxAtTip(const CBlockIndex& active_chain_tip, const CTransaction& tx)
 {
     AssertLockHeld(cs_main);
@@ -281,6 +291,73 @@ static void LimitMempoolSize(CTxMemPool& pool, CCoinsViewCache& coins_cache)
         coins_cache.Uncache(removed);
 }
 
+/**
+ * Verify the scripts of a batch of transactions on the script check worker
+ * threads, ahead of accepting them to the mempool one by one.
+ *
+ * Nothing is decided here: valid signatures end up in the signature cache, so
+ * that the sequential PolicyScriptChecks() mostly hit it. Spent outputs are
+ * looked up in the coins tip cache, the mempool and earlier transactions of the
+ * batch. If fetched_coins is given, missing coins are also read from disk, as
+ * AcceptToMemoryPool() would do, and the outpoints of the coins that this added
+ * to the cache are returned per transaction; it always has one (possibly empty)
+ * element per transaction, even if nothing was pre-verified. Otherwise
+ * transactions with uncached inputs are skipped.
+ */
+static void PreverifyTransactionScripts(Chainstate& active_chainstate, std::span<const CTransactionRef> txs,
+                                        std::vector<std::vector<COutPoint>>* fetched_coins = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    AssertLockHeld(cs_main);
+    if (fetched_coins) fetched_coins->assign(txs.size(), {});
+    auto& check_queue{active_chainstate.m_chainman.GetCheckQueue()};
+    const CTxMemPool* pool{active_chainstate.GetMempool()};
+    // Without worker threads this would only duplicate the sequential checks.
+    if (!check_queue.HasThreads() || !pool || txs.size() < 2) return;
+
+    const CCoinsViewCache& coins_tip{active_chainstate.CoinsTip()};
+    SignatureCache& signature_cache{active_chainstate.m_chainman.m_validation_cache.m_signature_cache};
+    std::unordered_map<Txid, const CTransaction*, SaltedTxidHasher> batch_txs;
+    // Referenced by the checks, so must not be resized once they are created.
+    std::vector<PrecomputedTransactionData> txdata(txs.size());
+    std::vector<CScriptCheck> checks;
+
+    LOCK(pool->cs);
+    for (size_t i = 0; i < txs.size(); ++i) {
+        const CTransaction& tx{*txs[i]};
+        if (tx.IsCoinBase()) continue;
+
+        std::vector<CTxOut> spent_outputs;
+        spent_outputs.reserve(tx.vin.size());
+        for (const CTxIn& txin : tx.vin) {
+            const COutPoint& prevout{txin.prevout};
+            if (coins_tip.HaveCoinInCache(prevout)) {
+                spent_outputs.push_back(coins_tip.AccessCoin(prevout).out);
+            } else if (const auto parent{pool->get(prevout.hash)}; parent && prevout.n < parent->vout.size()) {
+                spent_outputs.push_back(parent->vout[prevout.n]);
+            } else if (const auto it{batch_txs.find(prevout.hash)}; it != batch_txs.end() && prevout.n < it->second->vout.size()) {
+                spent_outputs.push_back(it->second->vout[prevout.n]);
+            } else if (const Coin* coin{fetched_coins ? &coins_tip.AccessCoin(prevout) : nullptr}; coin && !coin->IsSpent()) {
+                (*fetched_coins)[i].push_back(prevout);
+                spent_outputs.push_back(coin->out);
+            } else {
+                break;
+            }
+        }
+        batch_txs.emplace(tx.GetHash(), &tx);
+        if (spent_outputs.size() != tx.vin.size()) continue;
+
+        txdata[i].Init(tx, std::move(spent_outputs));
+        for (unsigned int n = 0; n < tx.vin.size(); ++n) {
+            checks.emplace_back(txdata[i].m_spent_outputs[n], tx, signature_cache, n, STANDARD_SCRIPT_VERIFY_FLAGS, /*cacheIn=*/true, &txdata[i]);
+        }
+    }
+
+    CCheckQueueControl<CScriptCheck> control{check_queue};
+    control.Add(std::move(checks));
+    // Failures are reported by the sequential checks.
+    (void)control.Complete();
+}
+
 static bool IsCurrentForFeeEstimation(Chainstate& active_chainstate) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
 {
     AssertLockHeld(cs_main);
@@ -311,6 +388,10 @@ void Chainstate::MaybeUpdateMempoolForReorg(
         // back to the mempool starting with the earliest transaction that had
         // been previously seen in a block.
         const auto queuedTx = disconnectpool.take();
+        if (fAddToMempool) {
+            const std::vector<CTransactionRef> resurrect(queuedTx.rbegin(), queuedTx.rend());
+            PreverifyTransactionScripts(*this, resurrect);
+        }
         auto it = queuedTx.rbegin();
         while (it != queuedTx.rend()) {
             // ignore validation errors in resurrected transactions
@@ -391,6 +472,41 @@ void Chainstate::MaybeUpdateMempoolForReorg(
     LimitMempoolSize(*m_mempool, this->CoinsTip());
 }
 
+/**
+ * Same as CheckInputScripts() without pvChecks, but the inputs of large
+ * transactions are verified on the script check threads. Signature and script
+ * execution caches are used and updated the same way. On failure, the error
+ * of whichever input the checks stopped at is reported, which need not be the
+ * first failing one.
+ */
+static bool CheckInputScriptsMaybeParallel(const CTransaction& tx, TxValidationState& state,
+                                           const CCoinsViewCache& inputs, unsigned int flags, bool cacheSigStore,
+                                           bool cacheFullScriptStore, PrecomputedTransactionData& txdata,
+                                           ValidationCache& validation_cache, CCheckQueue<CScriptCheck>& check_queue)
+                                           EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    AssertLockHeld(cs_main);
+    if (check_queue.HasThreads() && tx.vin.size() >= MEMPOOL_PARALLEL_SCRIPT_CHECK_MIN_INPUTS) {
+        std::vector<CScriptCheck> checks;
+        // Only collects the checks, which cannot fail.
+        CheckInputScripts(tx, state, inputs, flags, cacheSigStore, cacheFullScriptStore, txdata, validation_cache, &checks);
+        // Nothing to check if the script execution was cached.
+        if (checks.empty()) return true;
+
+        CCheckQueueControl<CScriptCheck> control{check_queue};
+        control.Add(std::move(checks));
+        auto failure{control.Complete()};
+        if (failure.has_value()) {
+            return InvalidInputScript(tx, state, flags, std::move(*failure), cacheSigStore, txdata, validation_cache.m_signature_cache);
+        }
+        if (cacheFullScriptStore) {
+            validation_cache.m_script_execution_cache.insert(validation_cache.ScriptExecutionCacheEntry(tx, flags));
+        }
+        return true;
+    }
+    return CheckInputScripts(tx, state, inputs, flags, cacheSigStore, cacheFullScriptStore, txdata, validation_cache);
+}
+
 /**
 * Checks to avoid mempool polluting consensus critical paths since cached
 * signature and script validity results will be reused if we validate this
@@ -399,7 +515,7 @@ void Chainstate::MaybeUpdateMempoolForReorg(
 static bool CheckInputsFromMempoolAndCache(const CTransaction& tx, TxValidationState& state,
                 const CCoinsViewCache& view, const CTxMemPool& pool,
                 unsigned int flags, PrecomputedTransactionData& txdata, CCoinsViewCache& coins_tip,
-                ValidationCache& validation_cache)
+                ValidationCache& validation_cache, CCheckQueue<CScriptCheck>& check_queue)
                 EXCLUSIVE_LOCKS_REQUIRED(cs_main, pool.cs)
 {
     AssertLockHeld(cs_main);
@@ -431,7 +547,7 @@ static bool CheckInputsFromMempoolAndCache(const CTransaction& tx, TxValidationS
     }
 
     // Call CheckInputScripts() to cache signature and script validity against current tip consensus rules.
-    return CheckInputScripts(tx, state, view, flags, /* cacheSigStore= */ true, /* cacheFullScriptStore= */ true, txdata, validation_cache);
+    return CheckInputScriptsMaybeParallel(tx, state, view, flags, /* cacheSigStore= */ true, /* cacheFullScriptStore= */ true, txdata, validation_cache, check_queue);
 }
 
 namespace {
@@ -1237,7 +1353,7 @@ bool MemPoolAccept::PolicyScriptChecks(const ATMPArgs& args, Workspace& ws)
 
     // Check input scripts and signatures.
     // This is done last to help prevent CPU exhaustion denial-of-service attacks.
-    if (!CheckInputScripts(tx, state, m_view, scriptVerifyFlags, true, false, ws.m_precomputed_txdata, GetValidationCache())) {
+    if (!CheckInputScriptsMaybeParallel(tx, state, m_view, scriptVerifyFlags, true, false, ws.m_precomputed_txdata, GetValidationCache(), m_active_chainstate.m_chainman.GetCheckQueue())) {
         // SCRIPT_VERIFY_CLEANSTACK requires SCRIPT_VERIFY_WITNESS, so we
         // need to turn both off, and compare against just turning off CLEANSTACK
         // to see if the failure is specifically due to witness validation.
@@ -1279,7 +1395,8 @@ bool MemPoolAccept::ConsensusScriptChecks(const ATMPArgs& args, Workspace& ws)
     // transactions into the mempool can be exploited as a DoS attack.
     unsigned int currentBlockScriptVerifyFlags{GetBlockScriptFlags(*m_active_chainstate.m_chain.Tip(), m_active_chainstate.m_chainman)};
     if (!CheckInputsFromMempoolAndCache(tx, state, m_view, m_pool, currentBlockScriptVerifyFlags,
-                                        ws.m_precomputed_txdata, m_active_chainstate.CoinsTip(), GetValidationCache())) {
+                                        ws.m_precomputed_txdata, m_active_chainstate.CoinsTip(), GetValidationCache(),
+                                        m_active_chainstate.m_chainman.GetCheckQueue())) {
         LogPrintf("BUG! PLEASE REPORT THIS! CheckInputScripts failed against latest-block but not STANDARD flags %s, %s\n", hash.ToString(), state.ToString());
         return Assume(false);
     }
@@ -1907,6 +2024,36 @@ MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTra
     return result;
 }
 
+std::vector<MempoolAcceptResult> AcceptToMemoryPoolBatch(Chainstate& active_chainstate, std::span<const CTransactionRef> txs,
+                                                         int64_t accept_time, bool bypass_limits, bool test_accept)
+{
+    const std::vector<int64_t> accept_times(txs.size(), accept_time);
+    return AcceptToMemoryPoolBatch(active_chainstate, txs, accept_times, bypass_limits, test_accept);
+}
+
+std::vector<MempoolAcceptResult> AcceptToMemoryPoolBatch(Chainstate& active_chainstate, std::span<const CTransactionRef> txs,
+                                                         std::span<const int64_t> accept_times, bool bypass_limits, bool test_accept)
+{
+    AssertLockHeld(::cs_main);
+    assert(accept_times.size() == txs.size());
+    // Coins are fetched here rather than in AcceptToMemoryPool(), so that
+    // transactions are pre-verified with a cold coins cache too.
+    std::vector<std::vector<COutPoint>> fetched_coins;
+    PreverifyTransactionScripts(active_chainstate, txs, &fetched_coins);
+    assert(fetched_coins.size() == txs.size());
+
+    std::vector<MempoolAcceptResult> results;
+    results.reserve(txs.size());
+    for (size_t i{0}; i < txs.size(); ++i) {
+        results.push_back(AcceptToMemoryPool(active_chainstate, txs[i], accept_times[i], bypass_limits, test_accept));
+        // Like AcceptToMemoryPool(), only keep the coins of accepted transactions cached.
+        if (results.back().m_result_type != MempoolAcceptResult::ResultType::VALID || test_accept) {
+            for (const COutPoint& outpoint : fetched_coins[i]) active_chainstate.CoinsTip().Uncache(outpoint);
+        }
+    }
+    return results;
+}
+
 PackageMempoolAcceptResult ProcessNewPackage(Chainstate& active_chainstate, CTxMemPool& pool,
                                                    const Package& package, bool test_accept, const std::optional<CFeeRate>& client_maxfeerate)
 {
@@ -2115,7 +2262,7 @@ void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, CTxUndo &txund
     AddCoins(inputs, tx, nHeight);
 }
 
-std::optional<std::pair<ScriptError, std::string>> CScriptCheck::operator()() {
+std::optional<ScriptFailure> CScriptCheck::operator()() {
     const CScript &scriptSig = ptxTo->vin[nIn].scriptSig;
     const CScriptWitness *witness = &ptxTo->vin[nIn].scriptWitness;
     ScriptError error{SCRIPT_ERR_UNKNOWN_ERROR};
@@ -2123,7 +2270,7 @@ std::optional<std::pair<ScriptError, std::string>> CScriptCheck::operator()() {
         return std::nullopt;
     } else {
         auto debug_str = strprintf("input %i of %s (wtxid %s), spending %s:%i", nIn, ptxTo->GetHash().ToString(), ptxTo->GetWitnessHash().ToString(), ptxTo->vin[nIn].prevout.hash.ToString(), ptxTo->vin[nIn].prevout.n);
-        return std::make_pair(error, std::move(debug_str));
+        return ScriptFailure{nIn, error, std::move(debug_str)};
     }
 }
 
@@ -2143,6 +2290,53 @@ ValidationCache::ValidationCache(const size_t script_execution_cache_bytes, cons
               approx_size_bytes >> 20, script_execution_cache_bytes >> 20, num_elems);
 }
 
+uint256 ValidationCache::ScriptExecutionCacheEntry(const CTransaction& tx, unsigned int flags) const
+{
+    uint256 entry;
+    CSHA256 hasher = ScriptExecutionCacheHasher();
+    hasher.Write(UCharCast(tx.GetWitnessHash().begin()), 32).Write((unsigned char*)&flags, sizeof(flags)).Finalize(entry.begin());
+    return entry;
+}
+
+/**
+ * Fill in state for a transaction whose script check of one input failed with the given flags, and return
+ * false. The reason is TX_NOT_STANDARD if the input only fails a non-mandatory script verification flag,
+ * for which that input is checked again with the mandatory flags alone.
+ */
+static bool InvalidInputScript(const CTransaction& tx, TxValidationState& state, unsigned int flags,
+                               ScriptFailure failure, bool cacheSigStore, PrecomputedTransactionData& txdata,
+                               SignatureCache& signature_cache)
+{
+    if (flags & STANDARD_NOT_MANDATORY_VERIFY_FLAGS) {
+        // Check whether the failure was caused by a
+        // non-mandatory script verification check, such as
+        // non-standard DER encodings or non-null dummy
+        // arguments; if so, ensure we return NOT_STANDARD
+        // instead of CONSENSUS to avoid downstream users
+        // splitting the network between upgraded and
+        // non-upgraded nodes by banning CONSENSUS-failing
+        // data providers.
+        CScriptCheck check2(txdata.m_spent_outputs[failure.input], tx, signature_cache, failure.input,
+                flags & ~STANDARD_NOT_MANDATORY_VERIFY_FLAGS, cacheSigStore, &txdata);
+        auto mandatory_result = check2();
+        if (!mandatory_result.has_value()) {
+            return state.Invalid(TxValidationResult::TX_NOT_STANDARD, strprintf("non-mandatory-script-verify-flag (%s)", ScriptErrorString(failure.error)), failure.debug_str);
+        } else {
+            // If the second check failed, it failed due to a mandatory script verification
+            // flag, but the first check might have failed on a non-mandatory script
+            // verification flag.
+            //
+            // Avoid reporting a mandatory script check failure with a non-mandatory error
+            // string by reporting the error from the second check.
+            failure = std::move(*mandatory_result);
+        }
+    }
+
+    // MANDATORY flag failures correspond to
+    // TxValidationResult::TX_CONSENSUS.
+    return state.Invalid(TxValidationResult::TX_CONSENSUS, strprintf("mandatory-script-verify-flag-failed (%s)", ScriptErrorString(failure.error)), failure.debug_str);
+}
+
 /**
  * Check whether all of this transaction's input scripts succeed.
  *
@@ -2179,9 +2373,7 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
     // correct (ie that the transaction hash which is in tx's prevouts
     // properly commits to the scriptPubKey in the inputs view of that
     // transaction).
-    uint256 hashCacheEntry;
-    CSHA256 hasher = validation_cache.ScriptExecutionCacheHasher();
-    hasher.Write(UCharCast(tx.GetWitnessHash().begin()), 32).Write((unsigned char*)&flags, sizeof(flags)).Finalize(hashCacheEntry.begin());
+    const uint256 hashCacheEntry{validation_cache.ScriptExecutionCacheEntry(tx, flags)};
     AssertLockHeld(cs_main); //TODO: Remove this requirement by making CuckooCache not require external locks
     if (validation_cache.m_script_execution_cache.contains(hashCacheEntry, !cacheFullScriptStore)) {
         return true;
@@ -2214,34 +2406,7 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
         if (pvChecks) {
             pvChecks->emplace_back(std::move(check));
         } else if (auto result = check(); result.has_value()) {
-            if (flags & STANDARD_NOT_MANDATORY_VERIFY_FLAGS) {
-                // Check whether the failure was caused by a
-                // non-mandatory script verification check, such as
-                // non-standard DER encodings or non-null dummy
-                // arguments; if so, ensure we return NOT_STANDARD
-                // instead of CONSENSUS to avoid downstream users
-                // splitting the network between upgraded and
-                // non-upgraded nodes by banning CONSENSUS-failing
-                // data providers.
-                CScriptCheck check2(txdata.m_spent_outputs[i], tx, validation_cache.m_signature_cache, i,
-                        flags & ~STANDARD_NOT_MANDATORY_VERIFY_FLAGS, cacheSigStore, &txdata);
-                auto mandatory_result = check2();
-                if (!mandatory_result.has_value()) {
-                    return state.Invalid(TxValidationResult::TX_NOT_STANDARD, strprintf("non-mandatory-script-verify-flag (%s)", ScriptErrorString(result->first)), result->second);
-                } else {
-                    // If the second check failed, it failed due to a mandatory script verification
-                    // flag, but the first check might have failed on a non-mandatory script
-                    // verification flag.
-                    //
-                    // Avoid reporting a mandatory script check failure with a non-mandatory error
-                    // string by reporting the error from the second check.
-                    result = mandatory_result;
-                }
-            }
-
-            // MANDATORY flag failures correspond to
-            // TxValidationResult::TX_CONSENSUS.
-            return state.Invalid(TxValidationResult::TX_CONSENSUS, strprintf("mandatory-script-verify-flag-failed (%s)", ScriptErrorString(result->first)), result->second);
+            return InvalidInputScript(tx, state, flags, std::move(*result), cacheSigStore, txdata, validation_cache.m_signature_cache);
         }
     }
 
@@ -2714,7 +2879,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     if (control) {
         auto parallel_result = control->Complete();
         if (parallel_result.has_value() && state.IsValid()) {
-            state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, strprintf("mandatory-script-verify-flag-failed (%s)", ScriptErrorString(parallel_result->first)), parallel_result->second);
+            state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, strprintf("mandatory-script-verify-flag-failed (%s)", ScriptErrorString(parallel_result->error)), parallel_result->debug_str);
         }
     }
     if (!state.IsValid()) {
@@ -4443,7 +4608,7 @@ void ChainstateManager::ReportHeadersPresync(const arith_uint256& work, int64_t
 }
 
 /** Store block on disk. If dbp is non-nullptr, the file is known to already reside on disk */
-bool ChainstateManager::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, BlockValidationState& state, CBlockIndex** ppindex, bool fRequested, const FlatFilePos* dbp, bool* fNewBlock, bool min_pow_checked)
+bool ChainstateManager::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, BlockValidationState& state, CBlockIndex** ppindex, bool fRequested, const StoredBlockPos* dbp, bool* fNewBlock, bool min_pow_checked)
 {
     const CBlock& block = *pblock;
 
@@ -4516,8 +4681,8 @@ bool ChainstateManager::AcceptBlock(const std::shared_ptr<const CBlock>& pblock,
     try {
         FlatFilePos blockPos{};
         if (dbp) {
-            blockPos = *dbp;
-            m_blockman.UpdateBlockInfo(block, pindex->nHeight, blockPos);
+            blockPos = dbp->pos;
+            m_blockman.UpdateBlockInfo(block, pindex->nHeight, blockPos, dbp->size);
         } else {
             blockPos = m_blockman.WriteBlock(block, pindex->nHeight);
             if (blockPos.IsNull()) {
@@ -4752,7 +4917,7 @@ VerifyDBResult CVerifyDB::VerifyDB(
         }
         CBlock block;
         // check level 0: read from disk
-        if (!chainstate.m_blockman.ReadBlock(block, *pindex)) {
+        if (!chainstate.m_blockman.ReadBlock(block, *pindex, /*use_arena=*/true)) {
             LogPrintf("Verification error: ReadBlock failed at %d, hash=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString());
             return VerifyDBResult::CORRUPTED_BLOCK_DB;
         }
@@ -4818,7 +4983,7 @@ VerifyDBResult CVerifyDB::VerifyDB(
             m_notifications.progress(_("Verifying blocks…"), percentageDone, false);
             pindex = chainstate.m_chain.Next(pindex);
             CBlock block;
-            if (!chainstate.m_blockman.ReadBlock(block, *pindex)) {
+            if (!chainstate.m_blockman.ReadBlock(block, *pindex, /*use_arena=*/true)) {
                 LogPrintf("Verification error: ReadBlock failed at %d, hash=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString());
                 return VerifyDBResult::CORRUPTED_BLOCK_DB;
             }
@@ -5032,183 +5197,288 @@ bool Chainstate::LoadGenesisBlock()
     return true;
 }
 
-void ChainstateManager::LoadExternalBlockFile(
+namespace {
+/**
+ * Locate the blocks in a file of concatenated {message start, size, block}
+ * records, as written to blk?????.dat files. For each block found,
+ * fn(header, size, read_block) is called, where size is the size of the block
+ * data in the file and read_block() deserializes the entire block. If dbp is given, it is set to the position of the block
+ * before the call. Scanning stops when fn returns false, or on interrupt.
+ */
+void ScanExternalBlockFile(
     AutoFile& file_in,
+    const MessageStartChars& message_start,
     FlatFilePos* dbp,
-    std::multimap<uint256, FlatFilePos>* blocks_with_unknown_parent)
+    const util::SignalInterrupt& interrupt,
+    const std::function<bool(const CBlockHeader&, unsigned int, const std::function<std::shared_ptr<CBlock>()>&)>& fn)
 {
-    // Either both should be specified (-reindex), or neither (-loadblock).
-    assert(!dbp == !blocks_with_unknown_parent);
+    BufferedFile blkdat{file_in, 2 * MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE + 8};
+    // nRewind indicates where to resume scanning in case something goes wrong,
+    // such as a block fails to deserialize.
+    uint64_t nRewind = blkdat.GetPos();
+    while (!blkdat.eof()) {
+        if (interrupt) return;
+
+        blkdat.SetPos(nRewind);
+        nRewind++; // start one byte further next time, in case of failure
+        blkdat.SetLimit(); // remove former limit
+        unsigned int nSize = 0;
+        bool compressed{false};
+        try {
+            // locate a header
+            MessageStartChars buf;
+            blkdat.FindByte(std::byte(message_start[0]));
+            nRewind = blkdat.GetPos() + 1;
+            blkdat >> buf;
+            if (buf != message_start) {
+                continue;
+            }
+            // read size
+            blkdat >> nSize;
+            compressed = (nSize & node::BLOCK_COMPRESSED_FLAG) != 0;
+            nSize &= ~node::BLOCK_COMPRESSED_FLAG;
+            if (nSize < 80 || nSize > MAX_BLOCK_SERIALIZED_SIZE)
+                continue;
+        } catch (const std::exception&) {
+            // no valid block header found; don't complain
+            // (this happens at the end of every blk.dat file)
+            break;
+        }
+        try {
+            // read block header
+            const uint64_t nBlockPos{blkdat.GetPos()};
+            if (dbp)
+                dbp->nPos = nBlockPos;
+            blkdat.SetLimit(nBlockPos + nSize);
+            CBlockHeader header;
+            // Blocks stored compressed are decompressed into block_data as a whole.
+            std::vector<uint8_t> block_data;
+            if (compressed) {
+                std::vector<uint8_t> compressed_data(nSize);
+                blkdat.read(MakeWritableByteSpan(compressed_data));
+                if (!node::DecompressBlockData(compressed_data, block_data)) {
+                    throw std::ios_base::failure("failed to decompress block data");
+                }
+                SpanReader{block_data} >> header;
+            } else {
+                blkdat >> header;
+            }
+            // Skip the rest of this block (this may read from disk into memory); position to the marker before the
+            // next block, but it's still possible to rewind to the start of the current block (without a disk read).
+            nRewind = nBlockPos + nSize;
+            blkdat.SkipTo(nRewind);
+
+            const auto read_block{[&] {
+                // Rewind to the start of the block, read and deserialize it.
+                auto pblock{std::make_shared<CBlock>()};
+                if (compressed) {
+                    SpanReader{block_data} >> TX_WITH_WITNESS(*pblock);
+                } else {
+                    blkdat.SetPos(nBlockPos);
+                    blkdat >> TX_WITH_WITNESS(*pblock);
+                    nRewind = blkdat.GetPos();
+                }
+                return pblock;
+            }};
+            if (!fn(header, nSize, read_block)) break;
+        } catch (const std::exception& e) {
+            // historical bugs added extra data to the block files that does not deserialize cleanly.
+            // commonly this data is between readable blocks, but it does not really matter. such data is not fatal to the import process.
+            // the code that reads the block files deals with invalid data by simply ignoring it.
+            // it continues to search for the next {4 byte magic message start bytes + 4 byte length + block} that does deserialize cleanly
+            // and passes all of the other block validation checks dealing with POW and the merkle root, etc...
+            // we merely note with this informational log message when unexpected data is encountered.
+            // we could also be experiencing a storage system read error, or a read of a previous bad write. these are possible, but
+            // less likely scenarios. we don't have enough information to tell a difference here.
+            // the reindex process is not the place to attempt to clean and/or compact the block files. if so desired, a studious node operator
+            // may use knowledge of the fact that the block files are not entirely pristine in order to prepare a set of pristine, and
+            // perhaps ordered, block files for later reindexing.
+            LogDebug(BCLog::REINDEX, "%s: unexpected data at file offset 0x%x - %s. continuing\n", __func__, (nRewind - 1), e.what());
+        }
+    }
+}
+} // namespace
 
-    const auto start{SteadyClock::now()};
+bool ChainstateManager::LoadExternalBlock(
+    const CBlockHeader& header,
+    const std::function<std::shared_ptr<CBlock>()>& read_block,
+    const StoredBlockPos* dbp,
+    std::multimap<uint256, StoredBlockPos>* blocks_with_unknown_parent,
+    int& nLoaded)
+{
     const CChainParams& params{GetParams()};
+    const uint256 hash{header.GetHash()};
 
-    int nLoaded = 0;
-    try {
-        BufferedFile blkdat{file_in, 2 * MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE + 8};
-        // nRewind indicates where to resume scanning in case something goes wrong,
-        // such as a block fails to deserialize.
-        uint64_t nRewind = blkdat.GetPos();
-        while (!blkdat.eof()) {
-            if (m_interrupt) return;
-
-            blkdat.SetPos(nRewind);
-            nRewind++; // start one byte further next time, in case of failure
-            blkdat.SetLimit(); // remove former limit
-            unsigned int nSize = 0;
-            try {
-                // locate a header
-                MessageStartChars buf;
-                blkdat.FindByte(std::byte(params.MessageStart()[0]));
-                nRewind = blkdat.GetPos() + 1;
-                blkdat >> buf;
-                if (buf != params.MessageStart()) {
-                    continue;
-                }
-                // read size
-                blkdat >> nSize;
-                if (nSize < 80 || nSize > MAX_BLOCK_SERIALIZED_SIZE)
-                    continue;
-            } catch (const std::exception&) {
-                // no valid block header found; don't complain
-                // (this happens at the end of every blk.dat file)
-                break;
+    std::shared_ptr<CBlock> pblock{}; // needs to remain available after the cs_main lock is released to avoid duplicate reads from disk
+
+    {
+        LOCK(cs_main);
+        // detect out of order blocks, and store them for later
+        if (hash != params.GetConsensus().hashGenesisBlock && !m_blockman.LookupBlockIndex(header.hashPrevBlock)) {
+            LogDebug(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
+                     header.hashPrevBlock.ToString());
+            if (dbp && blocks_with_unknown_parent) {
+                blocks_with_unknown_parent->emplace(header.hashPrevBlock, *dbp);
             }
-            try {
-                // read block header
-                const uint64_t nBlockPos{blkdat.GetPos()};
-                if (dbp)
-                    dbp->nPos = nBlockPos;
-                blkdat.SetLimit(nBlockPos + nSize);
-                CBlockHeader header;
-                blkdat >> header;
-                const uint256 hash{header.GetHash()};
-                // Skip the rest of this block (this may read from disk into memory); position to the marker before the
-                // next block, but it's still possible to rewind to the start of the current block (without a disk read).
-                nRewind = nBlockPos + nSize;
-                blkdat.SkipTo(nRewind);
-
-                std::shared_ptr<CBlock> pblock{}; // needs to remain available after the cs_main lock is released to avoid duplicate reads from disk
-
-                {
-                    LOCK(cs_main);
-                    // detect out of order blocks, and store them for later
-                    if (hash != params.GetConsensus().hashGenesisBlock && !m_blockman.LookupBlockIndex(header.hashPrevBlock)) {
-                        LogDebug(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
-                                 header.hashPrevBlock.ToString());
-                        if (dbp && blocks_with_unknown_parent) {
-                            blocks_with_unknown_parent->emplace(header.hashPrevBlock, *dbp);
-                        }
-                        continue;
-                    }
+            return true;
+        }
 
-                    // process in case the block isn't known yet
-                    const CBlockIndex* pindex = m_blockman.LookupBlockIndex(hash);
-                    if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
-                        // This block can be processed immediately; rewind to its start, read and deserialize it.
-                        blkdat.SetPos(nBlockPos);
-                        pblock = std::make_shared<CBlock>();
-                        blkdat >> TX_WITH_WITNESS(*pblock);
-                        nRewind = blkdat.GetPos();
-
-                        BlockValidationState state;
-                        if (AcceptBlock(pblock, state, nullptr, true, dbp, nullptr, true)) {
-                            nLoaded++;
-                        }
-                        if (state.IsError()) {
-                            break;
-                        }
-                    } else if (hash != params.GetConsensus().hashGenesisBlock && pindex->nHeight % 1000 == 0) {
-                        LogDebug(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", hash.ToString(), pindex->nHeight);
-                    }
-                }
+        // process in case the block isn't known yet
+        const CBlockIndex* pindex = m_blockman.LookupBlockIndex(hash);
+        if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
+            // This block can be processed immediately
+            pblock = read_block();
 
-                // Activate the genesis block so normal node progress can continue
-                // During first -reindex, this will only connect Genesis since
-                // ActivateBestChain only connects blocks which are in the block tree db,
-                // which only contains blocks whose parents are in it.
-                // But do this only if genesis isn't activated yet, to avoid connecting many blocks
-                // without assumevalid in the case of a continuation of a reindex that
-                // was interrupted by the user.
-                if (hash == params.GetConsensus().hashGenesisBlock && WITH_LOCK(::cs_main, return ActiveHeight()) == -1) {
-                    BlockValidationState state;
-                    if (!ActiveChainstate().ActivateBestChain(state, nullptr)) {
-                        break;
-                    }
-                }
+            BlockValidationState state;
+            if (AcceptBlock(pblock, state, nullptr, true, dbp, nullptr, true)) {
+                nLoaded++;
+            }
+            if (state.IsError()) {
+                return false;
+            }
+        } else if (hash != params.GetConsensus().hashGenesisBlock && pindex->nHeight % 1000 == 0) {
+            LogDebug(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", hash.ToString(), pindex->nHeight);
+        }
+    }
 
-                if (m_blockman.IsPruneMode() && m_blockman.m_blockfiles_indexed && pblock) {
-                    // must update the tip for pruning to work while importing with -loadblock.
-                    // this is a tradeoff to conserve disk space at the expense of time
-                    // spent updating the tip to be able to prune.
-                    // otherwise, ActivateBestChain won't be called by the import process
-                    // until after all of the block files are loaded. ActivateBestChain can be
-                    // called by concurrent network message processing. but, that is not
-                    // reliable for the purpose of pruning while importing.
-                    bool activation_failure = false;
-                    for (auto c : GetAll()) {
-                        BlockValidationState state;
-                        if (!c->ActivateBestChain(state, pblock)) {
-                            LogDebug(BCLog::REINDEX, "failed to activate chain (%s)\n", state.ToString());
-                            activation_failure = true;
-                            break;
-                        }
-                    }
-                    if (activation_failure) {
-                        break;
-                    }
-                }
+    // Activate the genesis block so normal node progress can continue
+    // During first -reindex, this will only connect Genesis since
+    // ActivateBestChain only connects blocks which are in the block tree db,
+    // which only contains blocks whose parents are in it.
+    // But do this only if genesis isn't activated yet, to avoid connecting many blocks
+    // without assumevalid in the case of a continuation of a reindex that
+    // was interrupted by the user.
+    if (hash == params.GetConsensus().hashGenesisBlock && WITH_LOCK(::cs_main, return ActiveHeight()) == -1) {
+        BlockValidationState state;
+        if (!ActiveChainstate().ActivateBestChain(state, nullptr)) {
+            return false;
+        }
+    }
 
-                NotifyHeaderTip();
-
-                if (!blocks_with_unknown_parent) continue;
-
-                // Recursively process earlier encountered successors of this block
-                std::deque<uint256> queue;
-                queue.push_back(hash);
-                while (!queue.empty()) {
-                    uint256 head = queue.front();
-                    queue.pop_front();
-                    auto range = blocks_with_unknown_parent->equal_range(head);
-                    while (range.first != range.second) {
-                        std::multimap<uint256, FlatFilePos>::iterator it = range.first;
-                        std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
-                        if (m_blockman.ReadBlock(*pblockrecursive, it->second)) {
-                            LogDebug(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, pblockrecursive->GetHash().ToString(),
-                                    head.ToString());
-                            LOCK(cs_main);
-                            BlockValidationState dummy;
-                            if (AcceptBlock(pblockrecursive, dummy, nullptr, true, &it->second, nullptr, true)) {
-                                nLoaded++;
-                                queue.push_back(pblockrecursive->GetHash());
-                            }
-                        }
-                        range.first++;
-                        blocks_with_unknown_parent->erase(it);
-                        NotifyHeaderTip();
-                    }
+    if (m_blockman.IsPruneMode() && m_blockman.m_blockfiles_indexed && pblock) {
+        // must update the tip for pruning to work while importing with -loadblock.
+        // this is a tradeoff to conserve disk space at the expense of time
+        // spent updating the tip to be able to prune.
+        // otherwise, ActivateBestChain won't be called by the import process
+        // until after all of the block files are loaded. ActivateBestChain can be
+        // called by concurrent network message processing. but, that is not
+        // reliable for the purpose of pruning while importing.
+        for (auto c : GetAll()) {
+            BlockValidationState state;
+            if (!c->ActivateBestChain(state, pblock)) {
+                LogDebug(BCLog::REINDEX, "failed to activate chain (%s)\n", state.ToString());
+                return false;
+            }
+        }
+    }
+
+    NotifyHeaderTip();
+
+    if (!blocks_with_unknown_parent) return true;
+
+    // Recursively process earlier encountered successors of this block
+    std::deque<uint256> queue;
+    queue.push_back(hash);
+    while (!queue.empty()) {
+        uint256 head = queue.front();
+        queue.pop_front();
+        auto range = blocks_with_unknown_parent->equal_range(head);
+        while (range.first != range.second) {
+            std::multimap<uint256, StoredBlockPos>::iterator it = range.first;
+            std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
+            if (m_blockman.ReadBlock(*pblockrecursive, it->second.pos)) {
+                LogDebug(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, pblockrecursive->GetHash().ToString(),
+                        head.ToString());
+                LOCK(cs_main);
+                BlockValidationState dummy;
+                if (AcceptBlock(pblockrecursive, dummy, nullptr, true, &it->second, nullptr, true)) {
+                    nLoaded++;
+                    queue.push_back(pblockrecursive->GetHash());
                 }
-            } catch (const std::exception& e) {
-                // historical bugs added extra data to the block files that does not deserialize cleanly.
-                // commonly this data is between readable blocks, but it does not really matter. such data is not fatal to the import process.
-                // the code that reads the block files deals with invalid data by simply ignoring it.
-                // it continues to search for the next {4 byte magic message start bytes + 4 byte length + block} that does deserialize cleanly
-                // and passes all of the other block validation checks dealing with POW and the merkle root, etc...
-                // we merely note with this informational log message when unexpected data is encountered.
-                // we could also be experiencing a storage system read error, or a read of a previous bad write. these are possible, but
-                // less likely scenarios. we don't have enough information to tell a difference here.
-                // the reindex process is not the place to attempt to clean and/or compact the block files. if so desired, a studious node operator
-                // may use knowledge of the fact that the block files are not entirely pristine in order to prepare a set of pristine, and
-                // perhaps ordered, block files for later reindexing.
-                LogDebug(BCLog::REINDEX, "%s: unexpected data at file offset 0x%x - %s. continuing\n", __func__, (nRewind - 1), e.what());
             }
+            range.first++;
+            blocks_with_unknown_parent->erase(it);
+            NotifyHeaderTip();
         }
+    }
+    return true;
+}
+
+void ChainstateManager::LoadExternalBlockFile(
+    AutoFile& file_in,
+    FlatFilePos* dbp,
+    std::multimap<uint256, StoredBlockPos>* blocks_with_unknown_parent)
+{
+    // Either both should be specified (-reindex), or neither (-loadblock).
+    assert(!dbp == !blocks_with_unknown_parent);
+
+    const auto start{SteadyClock::now()};
+
+    int nLoaded = 0;
+    try {
+        ScanExternalBlockFile(file_in, GetParams().MessageStart(), dbp, m_interrupt, [&](const CBlockHeader& header, unsigned int size, const auto& read_block) {
+            StoredBlockPos stored_pos;
+            if (dbp) stored_pos = {*dbp, size};
+            return LoadExternalBlock(header, read_block, dbp ? &stored_pos : nullptr, blocks_with_unknown_parent, nLoaded);
+        });
     } catch (const std::runtime_error& e) {
         GetNotifications().fatalError(strprintf(_("System error while loading external block file: %s"), e.what()));
     }
     LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
 }
 
+std::vector<ScannedBlock> ChainstateManager::ScanBlockFile(AutoFile& file_in, int file_num) const
+{
+    std::vector<ScannedBlock> blocks;
+    FlatFilePos pos{file_num, 0};
+    try {
+        ScanExternalBlockFile(file_in, GetParams().MessageStart(), &pos, m_interrupt, [&](const CBlockHeader& header, unsigned int size, const auto& read_block) {
+            // Blocks that are already stored are skipped by LoadExternalBlock(), so they are not read.
+            const bool have_data{WITH_LOCK(::cs_main, const CBlockIndex* pindex{m_blockman.LookupBlockIndex(header.GetHash())};
+                                            return pindex && (pindex->nStatus & BLOCK_HAVE_DATA))};
+            std::shared_ptr<CBlock> pblock;
+            if (!have_data) {
+                pblock = read_block();
+                // Do the context-free checks now, so that AcceptBlock() can skip them
+                BlockValidationState state;
+                CheckBlock(*pblock, state, GetConsensus());
+            }
+            blocks.push_back({{pos, size}, header, std::move(pblock)});
+            return true;
+        });
+    } catch (const std::runtime_error& e) {
+        GetNotifications().fatalError(strprintf(_("System error while loading external block file: %s"), e.what()));
+    }
+    return blocks;
+}
+
+void ChainstateManager::LoadScannedBlockFile(
+    std::span<ScannedBlock> blocks,
+    std::multimap<uint256, StoredBlockPos>& blocks_with_unknown_parent)
+{
+    const auto start{SteadyClock::now()};
+
+    int nLoaded = 0;
+    for (auto& [pos, header, pblock] : blocks) {
+        if (m_interrupt) return;
+        try {
+            const auto read_block{[&] {
+                // The block was skipped by the scan, but is needed after all
+                if (!pblock) {
+                    pblock = std::make_shared<CBlock>();
+                    if (!m_blockman.ReadBlock(*pblock, pos.pos)) throw std::runtime_error("failed to read block");
+                }
+                return pblock;
+            }};
+            if (!LoadExternalBlock(header, read_block, &pos, &blocks_with_unknown_parent, nLoaded)) break;
+        } catch (const std::exception& e) {
+            LogDebug(BCLog::REINDEX, "%s: error loading block at %s - %s. continuing\n", __func__, pos.pos.ToString(), e.what());
+        }
+        pblock.reset();
+    }
+    LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+}
+
 bool ChainstateManager::ShouldCheckBlockIndex() const
 {
     // Assert to verify Flatten() has been called.
@@ -5653,7 +5923,11 @@ Chainstate& ChainstateManager::InitializeChainstate(CTxMemPool* mempool)
 
     // We have to destruct before this call leveldb::DB in order to release the db
     // lock, otherwise `DestroyDB` will fail. See `leveldb::~DBImpl()`.
-    const bool destroyed = DestroyDB(path_str);
+    bool destroyed{true};
+    for (const fs::path& shard_path : CoinsDBShardPaths(db_path)) {
+        destroyed &= DestroyDB(fs::PathToString(shard_path));
+    }
+    destroyed &= DestroyDB(path_str);
 
     if (!destroyed) {
         LogPrintf("error: leveldb DestroyDB call failed on %s\n", path_str);
@@ -36,6 +36,7 @@
 #include <versionbits.h>
 
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
@@ -268,6 +269,24 @@ MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTra
                                        int64_t accept_time, bool bypass_limits, bool test_accept)
     EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+/**
+ * Try to add a batch of transactions to the mempool, in order. This is
+ * equivalent to calling AcceptToMemoryPool() for each of them, but their
+ * signatures are first verified in parallel on the script check threads. The
+ * coins they spend are read into the coins cache for that, and are evicted
+ * again for transactions that are not accepted.
+ *
+ * @returns one MempoolAcceptResult per transaction in txs.
+ */
+std::vector<MempoolAcceptResult> AcceptToMemoryPoolBatch(Chainstate& active_chainstate, std::span<const CTransactionRef> txs,
+                                                         int64_t accept_time, bool bypass_limits, bool test_accept)
+    EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+/** Like AcceptToMemoryPoolBatch() above, with a separate accept time for each transaction. */
+std::vector<MempoolAcceptResult> AcceptToMemoryPoolBatch(Chainstate& active_chainstate, std::span<const CTransactionRef> txs,
+                                                         std::span<const int64_t> accept_times, bool bypass_limits, bool test_accept)
+    EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
 /**
 * Validate (and maybe submit) a package to the mempool. See doc/policy/packages.md for full details
 * on package validation rules.
@@ -324,6 +343,15 @@ std::optional<LockPoints> CalculateLockPointsAtTip(
 bool CheckSequenceLocksAtTip(CBlockIndex* tip,
                              const LockPoints& lock_points);
 
+/** The failure of a CScriptCheck */
+struct ScriptFailure {
+    //! Index of the input whose script failed
+    unsigned int input;
+    ScriptError error;
+    //! Identifies the input and the transaction for debug messages
+    std::string debug_str;
+};
+
 /**
  * Closure representing one script verification
  * Note that this stores references to the spending transaction
@@ -348,7 +376,7 @@ public:
     CScriptCheck(CScriptCheck&&) = default;
     CScriptCheck& operator=(CScriptCheck&&) = default;
 
-    std::optional<std::pair<ScriptError, std::string>> operator()();
+    std::optional<ScriptFailure> operator()();
 };
 
 // CScriptCheck is used a lot in std::vector, make sure that's efficient
@@ -377,6 +405,9 @@ public:
 
     //! Return a copy of the pre-initialized hasher.
     CSHA256 ScriptExecutionCacheHasher() const { return m_script_execution_cache_hasher; }
+
+    //! Return the m_script_execution_cache entry for all input scripts of tx passing with flags.
+    uint256 ScriptExecutionCacheEntry(const CTransaction& tx, unsigned int flags) const;
 };
 
 /** Functions for validating blocks and updating the block tree */
@@ -835,6 +866,23 @@ enum class SnapshotCompletionResult {
     BASE_BLOCKHASH_MISMATCH,
 };
 
+/** Where a block found in a block file while reindexing is stored. */
+struct StoredBlockPos {
+    //! Position of the block data in the block file
+    FlatFilePos pos;
+    //! Size of the block data in the file, from its storage header. This is less
+    //! than the serialized size of the block if it is stored compressed.
+    unsigned int size{0};
+};
+
+/** A block found in a block file by ChainstateManager::ScanBlockFile(). */
+struct ScannedBlock {
+    StoredBlockPos pos;
+    CBlockHeader header;
+    //! The deserialized block, or nullptr if the block index already had its data when the file was scanned
+    std::shared_ptr<CBlock> block;
+};
+
 /**
  * Provides an interface for creating and interacting with one or two
  * chainstates: an IBD chainstate generated by downloading blocks, and
@@ -918,6 +966,19 @@ private:
         AutoFile& coins_file,
         const node::SnapshotMetadata& metadata);
 
+    /**
+     * Internal helper for LoadExternalBlockFile() and LoadScannedBlockFile(),
+     * processing one block found in a block file. read_block is only called
+     * if the block data is needed. Returns false if loading the file should
+     * stop.
+     */
+    bool LoadExternalBlock(
+        const CBlockHeader& header,
+        const std::function<std::shared_ptr<CBlock>()>& read_block,
+        const StoredBlockPos* dbp,
+        std::multimap<uint256, StoredBlockPos>* blocks_with_unknown_parent,
+        int& nLoaded) LOCKS_EXCLUDED(::cs_main);
+
     /**
      * If a block header hasn't already been seen, call CheckBlockHeader on it, ensure
      * that it doesn't descend from an invalid block, and then add it to m_block_index.
@@ -1178,7 +1239,30 @@ public:
     void LoadExternalBlockFile(
         AutoFile& file_in,
         FlatFilePos* dbp = nullptr,
-        std::multimap<uint256, FlatFilePos>* blocks_with_unknown_parent = nullptr);
+        std::multimap<uint256, StoredBlockPos>* blocks_with_unknown_parent = nullptr);
+
+    /**
+     * Read all blocks of a block file (datadir/blocks/blk?????.dat) into memory
+     * without processing them, and perform the context-free checks of
+     * CheckBlock() on them. Blocks whose data the block index already has are
+     * neither deserialized nor checked; only their header is returned. This
+     * does not modify the block index, so several files can be scanned
+     * concurrently while -reindex processes an earlier one.
+     *
+     * @param[in]     file_in       Block file to read
+     * @param[in]     file_num      Number of the block file, for the returned positions
+     * @returns the blocks found, in file order
+     */
+    std::vector<ScannedBlock> ScanBlockFile(AutoFile& file_in, int file_num) const;
+
+    /**
+     * Process the blocks returned by ScanBlockFile() in order, exactly like
+     * LoadExternalBlockFile() does during reindexing. Each block is released
+     * once it has been processed.
+     */
+    void LoadScannedBlockFile(
+        std::span<ScannedBlock> blocks,
+        std::multimap<uint256, StoredBlockPos>& blocks_with_unknown_parent);
 
     /**
      * Process an incoming block. This only returns after the best known valid
@@ -1239,7 +1323,7 @@ public:
      *
      * @returns   False if the block or header is invalid, or if saving to disk fails (likely a fatal error); true otherwise.
      */
-    bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, BlockValidationState& state, CBlockIndex** ppindex, bool fRequested, const FlatFilePos* dbp, bool* fNewBlock, bool min_pow_checked) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, BlockValidationState& state, CBlockIndex** ppindex, bool fRequested, const StoredBlockPos* dbp, bool* fNewBlock, bool min_pow_checked) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     void ReceivedBlockTransactions(const CBlock& block, CBlockIndex* pindexNew, const FlatFilePos& pos) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
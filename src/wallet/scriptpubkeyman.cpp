@@ -28,6 +28,10 @@ namespace wallet {
 
 typedef std::vector<unsigned char> valtype;
 
+//! Number of descriptor positions expanded from the cache at once. Bounds the memory
+//! used while hashing the keys of a large keypool in batches.
+static constexpr int32_t DESCRIPTOR_EXPAND_BATCH_SIZE{1000};
+
 // Legacy wallet IsMine(). Used only in migration
 // DO NOT USE ANYTHING IN THIS NAMESPACE OUTSIDE OF MIGRATION
 namespace {
@@ -1025,34 +1029,44 @@ bool DescriptorScriptPubKeyMan::TopUpWithDB(WalletBatch& batch, unsigned int siz
     provider.keys = GetKeys();
 
     uint256 id = GetID();
-    for (int32_t i = m_max_cached_index + 1; i < new_range_end; ++i) {
-        FlatSigningProvider out_keys;
-        std::vector<CScript> scripts_temp;
-        DescriptorCache temp_cache;
-        // Maybe we have a cached xpub and we can expand from the cache first
-        if (!m_wallet_descriptor.descriptor->ExpandFromCache(i, m_wallet_descriptor.cache, scripts_temp, out_keys)) {
-            if (!m_wallet_descriptor.descriptor->Expand(i, provider, scripts_temp, out_keys, &temp_cache)) return false;
-        }
-        // Add all of the scriptPubKeys to the scriptPubKey set
-        new_spks.insert(scripts_temp.begin(), scripts_temp.end());
-        for (const CScript& script : scripts_temp) {
-            m_map_script_pub_keys[script] = i;
-        }
-        for (const auto& pk_pair : out_keys.pubkeys) {
-            const CPubKey& pubkey = pk_pair.second;
-            if (m_map_pubkeys.count(pubkey) != 0) {
-                // We don't need to give an error here.
-                // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
-                continue;
+    while (m_max_cached_index + 1 < new_range_end) {
+        const int32_t batch_begin{m_max_cached_index + 1};
+        const int32_t batch_end{batch_begin + std::min(DESCRIPTOR_EXPAND_BATCH_SIZE, new_range_end - batch_begin)};
+        // Maybe we have a cached xpub and we can expand the whole batch from the cache first
+        std::vector<std::vector<CScript>> cached_scripts;
+        std::vector<FlatSigningProvider> cached_keys;
+        const bool from_cache{m_wallet_descriptor.descriptor->ExpandFromCacheRange(batch_begin, batch_end, m_wallet_descriptor.cache, cached_scripts, cached_keys)};
+        for (int32_t i = batch_begin; i < batch_end; ++i) {
+            FlatSigningProvider out_keys;
+            std::vector<CScript> scripts_temp;
+            DescriptorCache temp_cache;
+            if (from_cache) {
+                out_keys = std::move(cached_keys[i - batch_begin]);
+                scripts_temp = std::move(cached_scripts[i - batch_begin]);
+            } else if (!m_wallet_descriptor.descriptor->ExpandFromCache(i, m_wallet_descriptor.cache, scripts_temp, out_keys)) {
+                if (!m_wallet_descriptor.descriptor->Expand(i, provider, scripts_temp, out_keys, &temp_cache)) return false;
             }
-            m_map_pubkeys[pubkey] = i;
-        }
-        // Merge and write the cache
-        DescriptorCache new_items = m_wallet_descriptor.cache.MergeAndDiff(temp_cache);
-        if (!batch.WriteDescriptorCacheItems(id, new_items)) {
-            throw std::runtime_error(std::string(__func__) + ": writing cache items failed");
+            // Add all of the scriptPubKeys to the scriptPubKey set
+            new_spks.insert(scripts_temp.begin(), scripts_temp.end());
+            for (const CScript& script : scripts_temp) {
+                m_map_script_pub_keys[script] = i;
+            }
+            for (const auto& pk_pair : out_keys.pubkeys) {
+                const CPubKey& pubkey = pk_pair.second;
+                if (m_map_pubkeys.count(pubkey) != 0) {
+                    // We don't need to give an error here.
+                    // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
+                    continue;
+                }
+                m_map_pubkeys[pubkey] = i;
+            }
+            // Merge and write the cache
+            DescriptorCache new_items = m_wallet_descriptor.cache.MergeAndDiff(temp_cache);
+            if (!batch.WriteDescriptorCacheItems(id, new_items)) {
+                throw std::runtime_error(std::string(__func__) + ": writing cache items failed");
+            }
+            m_max_cached_index++;
         }
-        m_max_cached_index++;
     }
     m_wallet_descriptor.range_end = new_range_end;
     batch.WriteDescriptor(GetID(), m_wallet_descriptor);
@@ -1429,30 +1443,35 @@ void DescriptorScriptPubKeyMan::SetCache(const DescriptorCache& cache)
     LOCK(cs_desc_man);
     std::set<CScript> new_spks;
     m_wallet_descriptor.cache = cache;
-    for (int32_t i = m_wallet_descriptor.range_start; i < m_wallet_descriptor.range_end; ++i) {
-        FlatSigningProvider out_keys;
-        std::vector<CScript> scripts_temp;
-        if (!m_wallet_descriptor.descriptor->ExpandFromCache(i, m_wallet_descriptor.cache, scripts_temp, out_keys)) {
+    for (int32_t batch_begin = m_wallet_descriptor.range_start, batch_end; batch_begin < m_wallet_descriptor.range_end; batch_begin = batch_end) {
+        batch_end = batch_begin + std::min(DESCRIPTOR_EXPAND_BATCH_SIZE, m_wallet_descriptor.range_end - batch_begin);
+        std::vector<std::vector<CScript>> batch_scripts;
+        std::vector<FlatSigningProvider> batch_keys;
+        if (!m_wallet_descriptor.descriptor->ExpandFromCacheRange(batch_begin, batch_end, m_wallet_descriptor.cache, batch_scripts, batch_keys)) {
             throw std::runtime_error("Error: Unable to expand wallet descriptor from cache");
         }
-        // Add all of the scriptPubKeys to the scriptPubKey set
-        new_spks.insert(scripts_temp.begin(), scripts_temp.end());
-        for (const CScript& script : scripts_temp) {
-            if (m_map_script_pub_keys.count(script) != 0) {
-                throw std::runtime_error(strprintf("Error: Already loaded script at index %d as being at index %d", i, m_map_script_pub_keys[script]));
+        for (int32_t i = batch_begin; i < batch_end; ++i) {
+            const std::vector<CScript>& scripts_temp = batch_scripts[i - batch_begin];
+            const FlatSigningProvider& out_keys = batch_keys[i - batch_begin];
+            // Add all of the scriptPubKeys to the scriptPubKey set
+            new_spks.insert(scripts_temp.begin(), scripts_temp.end());
+            for (const CScript& script : scripts_temp) {
+                if (m_map_script_pub_keys.count(script) != 0) {
+                    throw std::runtime_error(strprintf("Error: Already loaded script at index %d as being at index %d", i, m_map_script_pub_keys[script]));
+                }
+                m_map_script_pub_keys[script] = i;
             }
-            m_map_script_pub_keys[script] = i;
-        }
-        for (const auto& pk_pair : out_keys.pubkeys) {
-            const CPubKey& pubkey = pk_pair.second;
-            if (m_map_pubkeys.count(pubkey) != 0) {
-                // We don't need to give an error here.
-                // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
-                continue;
+            for (const auto& pk_pair : out_keys.pubkeys) {
+                const CPubKey& pubkey = pk_pair.second;
+                if (m_map_pubkeys.count(pubkey) != 0) {
+                    // We don't need to give an error here.
+                    // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
+                    continue;
+                }
+                m_map_pubkeys[pubkey] = i;
             }
-            m_map_pubkeys[pubkey] = i;
+            m_max_cached_index++;
         }
-        m_max_cached_index++;
     }
     // Make sure the wallet knows about our new spks
     m_storage.TopUpCallback(new_spks, this);
@@ -73,7 +73,9 @@
 #include <algorithm>
 #include <cassert>
 #include <condition_variable>
+#include <deque>
 #include <exception>
+#include <future>
 #include <optional>
 #include <stdexcept>
 #include <thread>
@@ -1802,6 +1804,7 @@ int64_t CWallet::RescanFromTime(int64_t startTime, const WalletRescanReserver& r
 CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_block, int start_height, std::optional<int> max_height, const WalletRescanReserver& reserver, bool fUpdate, const bool save_progress)
 {
     constexpr auto INTERVAL_TIME{60s};
+    constexpr size_t RESCAN_READ_AHEAD_BLOCKS{8};
     auto current_time{reserver.now()};
     auto start_time{reserver.now()};
 
@@ -1816,6 +1819,10 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     WalletLogPrintf("Rescan started from block %s... (%s)\n", start_block.ToString(),
                     fast_rescan_filter ? "fast variant using block filters" : "slow variant inspecting all blocks");
 
+    // The slow variant reads every block. Keep the next blocks being read by
+    // the node while the current one is scanned.
+    std::deque<std::pair<uint256, std::future<std::optional<CBlock>>>> read_ahead;
+
     fAbortRescan = false;
     ShowProgress(strprintf("%s %s", GetDisplayName(), _("Rescanning…")), 0); // show rescan progress in GUI as dialog or on splashscreen, if rescan required on startup (e.g. due to corruption)
     uint256 tip_hash = WITH_LOCK(cs_wallet, return GetLastBlockHash());
@@ -1868,7 +1875,22 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
         if (fetch_block) {
             // Read block data
             CBlock block;
-            chain().findBlock(block_hash, FoundBlock().data(block));
+            if (!fast_rescan_filter) {
+                // Discard reads past a block that is no longer in the chain
+                if (!read_ahead.empty() && read_ahead.front().first != block_hash) read_ahead.clear();
+                if (read_ahead.empty()) read_ahead.emplace_back(block_hash, chain().readBlockAsync(block_hash));
+                int read_height{block_height + static_cast<int>(read_ahead.size())};
+                while (read_ahead.size() < RESCAN_READ_AHEAD_BLOCKS && (!max_height || read_height <= *max_height)) {
+                    uint256 read_hash;
+                    if (!chain().findAncestorByHeight(tip_hash, read_height, FoundBlock().hash(read_hash))) break;
+                    read_ahead.emplace_back(read_hash, chain().readBlockAsync(read_hash));
+                    ++read_height;
+                }
+                if (std::optional<CBlock> read_block{read_ahead.front().second.get()}) block = std::move(*read_block);
+                read_ahead.pop_front();
+            } else {
+                chain().findBlock(block_hash, FoundBlock().data(block));
+            }
 
             if (!block.IsNull()) {
                 LOCK(cs_wallet);
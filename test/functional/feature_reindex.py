@@ -8,14 +8,18 @@
 - Stop the node and restart it with -reindex. Verify that the node has reindexed up to block 3.
 - Stop the node and restart it with -reindex-chainstate. Verify that the node has reindexed up to block 3.
 - Verify that out-of-order blocks are correctly processed, see LoadExternalBlockFile()
+- Verify that reindexing block files with both compressed and uncompressed blocks (-blockcompression)
+  accounts for the space they take on disk.
 """
 
+from test_framework.blocktools import COINBASE_MATURITY
 from test_framework.test_framework import ZiaCoinTestFramework
 from test_framework.messages import MAGIC_BYTES
 from test_framework.util import (
     assert_equal,
     util_xor,
 )
+from test_framework.wallet import MiniWallet
 
 
 class ReindexTest(ZiaCoinTestFramework):
@@ -78,6 +82,24 @@ class ReindexTest(ZiaCoinTestFramework):
         # All blocks should be accepted and processed.
         assert_equal(self.nodes[0].getblockcount(), 12)
 
+    def mixed_compression(self):
+        node = self.nodes[0]
+        self.log.info("Reindex block files with both compressed and uncompressed blocks")
+        wallet = MiniWallet(node)
+        self.generate(wallet, COINBASE_MATURITY + 4)
+        for compress in [True, False, True]:
+            self.restart_node(0, extra_args=[f"-blockcompression={int(compress)}"])
+            for _ in range(2):
+                # Transactions with many identical outputs compress well
+                wallet.send_self_transfer_multi(from_node=node, num_outputs=50)
+                self.generate(node, 1)
+        best_block = node.getbestblockhash()
+        size_on_disk = node.getblockchaininfo()["size_on_disk"]
+
+        self.restart_node(0, extra_args=["-reindex"])
+        assert_equal(node.getbestblockhash(), best_block)
+        assert_equal(node.getblockchaininfo()["size_on_disk"], size_on_disk)
+
     def continue_reindex_after_shutdown(self):
         node = self.nodes[0]
         self.generate(node, 1500)
@@ -104,6 +126,7 @@ class ReindexTest(ZiaCoinTestFramework):
         self.reindex(True)
 
         self.out_of_order()
+        self.mixed_compression()
         self.continue_reindex_after_shutdown()
 
 
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+# Copyright (c) The ZiaCoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test streamed JSON-RPC replies.
+
+Large results of getrawmempool (verbose) and getblock (verbosity 2 and 3) are
+sent with chunked transfer encoding. Check that over raw HTTP, and that the
+result is the same as the one returned within a batch, which is never streamed.
+"""
+
+from decimal import Decimal
+import http.client
+import json
+import urllib.parse
+
+from test_framework.test_framework import ZiaCoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_greater_than,
+    str_to_b64str,
+)
+from test_framework.wallet import MiniWallet
+
+# Replies larger than this are sent in chunks (JSONStreamWriter::DEFAULT_FLUSH_THRESHOLD).
+FLUSH_THRESHOLD = 64 * 1024
+NUM_TXS = 300
+
+
+class HTTPChunkedTest(ZiaCoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.supports_cli = False
+
+    def post(self, request):
+        """Send a request over a new HTTP connection and return the response and its body."""
+        url = urllib.parse.urlparse(self.nodes[0].url)
+        headers = {"Authorization": f"Basic {str_to_b64str(f'{url.username}:{url.password}')}"}
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request('POST', '/', json.dumps(request), headers)
+        response = conn.getresponse()
+        body = response.read()
+        conn.close()
+        assert_equal(response.status, http.client.OK)
+        return response, body
+
+    def check_reply(self, method, params, *, chunked):
+        for version in [None, "2.0"]:
+            request = {"method": method, "params": params, "id": 1}
+            if version is not None:
+                request["jsonrpc"] = version
+            self.log.debug(f"Check {method} {params} with JSON-RPC version {version}")
+
+            response, body = self.post(request)
+            if chunked:
+                assert_equal(response.getheader("Transfer-Encoding"), "chunked")
+                assert_equal(response.getheader("Content-Length"), None)
+                assert_greater_than(len(body), FLUSH_THRESHOLD)
+            else:
+                assert_equal(response.getheader("Transfer-Encoding"), None)
+                assert_equal(int(response.getheader("Content-Length")), len(body))
+            assert_equal(response.getheader("Content-Type"), "application/json")
+            assert body.endswith(b"\n")
+            reply = json.loads(body, parse_float=Decimal)
+
+            _, batch_body = self.post([request])
+            batch_reply = json.loads(batch_body, parse_float=Decimal)
+            assert_equal(len(batch_reply), 1)
+            assert_equal(reply, batch_reply[0])
+            assert_equal(list(reply.keys()), list(batch_reply[0].keys()))
+        return reply["result"]
+
+    def run_test(self):
+        node = self.nodes[0]
+        wallet = MiniWallet(node)
+
+        self.log.info("Fill the mempool with independent transactions")
+        fanout = wallet.send_self_transfer_multi(from_node=node, num_outputs=NUM_TXS)
+        self.generate(node, 1)
+        txids = [wallet.send_self_transfer(from_node=node, utxo_to_spend=utxo)["txid"] for utxo in fanout["new_utxos"]]
+
+        self.log.info("Check that a large verbose getrawmempool result is streamed")
+        mempool = self.check_reply("getrawmempool", [True], chunked=True)
+        assert_equal(sorted(mempool.keys()), sorted(txids))
+        assert_equal(mempool, node.getrawmempool(True))
+
+        self.log.info("Check that the non-verbose getrawmempool result is not streamed")
+        self.check_reply("getrawmempool", [False, True], chunked=False)
+
+        self.log.info("Check that a large getblock result is streamed for verbosity 2 and 3")
+        blockhash = self.generate(node, 1)[0]
+        for verbosity in [2, 3]:
+            block = self.check_reply("getblock", [blockhash, verbosity], chunked=True)
+            assert_equal(len(block["tx"]), NUM_TXS + 1)
+            assert_equal(block, node.getblock(blockhash, verbosity))
+        self.check_reply("getblock", [blockhash, 1], chunked=False)
+
+        self.log.info("Check that small results are sent as a single reply")
+        self.check_reply("getrawmempool", [True], chunked=False)
+        self.check_reply("getblock", [node.getblockhash(1), 2], chunked=False)
+
+
+if __name__ == '__main__':
+    HTTPChunkedTest(__file__).main()